@@ -2213,6 +2213,27 @@ DECLSPEC int find_hash (PRIVATE_AS const u32 *digest, const u32 digests_cnt, GLO
 
   return (-1);
 }
+
+// digests_idx_bits != 0: the host appended a bucket index to the sorted digests (see hashes_init_digests_idx ())
+// entry k is the position of the first digest with the top digests_idx_bits of DGST_R3 >= k, so only one bucket is searched
+
+DECLSPEC int find_hash_idx (PRIVATE_AS const u32 *digest, const u32 digests_cnt, GLOBAL_AS const digest_t *digests_buf, const u32 digests_idx_bits)
+{
+  if (digests_idx_bits == 0) return find_hash (digest, digests_cnt, digests_buf);
+
+  GLOBAL_AS const u32 *digests_idx = (GLOBAL_AS const u32 *) (digests_buf + digests_cnt);
+
+  const u32 k = digest[3] >> (32 - digests_idx_bits);
+
+  const u32 l = digests_idx[k + 0];
+  const u32 r = digests_idx[k + 1];
+
+  const int pos = find_hash (digest, r - l, digests_buf + l);
+
+  if (pos == -1) return (-1);
+
+  return (l + pos);
+}
 #endif
 
 // Input has to be zero padded and buffer size has to be multiple of 4 and at least of length 24
@@ -2982,8 +3003,43 @@ DECLSPEC u32 check_bitmap (GLOBAL_AS const u32 *bitmap, const u32 bitmap_mask, c
   return (bitmap[(digest >> bitmap_shift) & bitmap_mask] & (1 << (digest & 0x1f)));
 }
 
-DECLSPEC u32 check (PRIVATE_AS const u32 *digest, GLOBAL_AS const u32 *bitmap_s1_a, GLOBAL_AS const u32 *bitmap_s1_b, GLOBAL_AS const u32 *bitmap_s1_c, GLOBAL_AS const u32 *bitmap_s1_d, GLOBAL_AS const u32 *bitmap_s2_a, GLOBAL_AS const u32 *bitmap_s2_b, GLOBAL_AS const u32 *bitmap_s2_c, GLOBAL_AS const u32 *bitmap_s2_d, const u32 bitmap_mask, const u32 bitmap_shift1, const u32 bitmap_shift2)
+DECLSPEC u32 check_bloom (GLOBAL_AS const u32 *bitmap, const u32 bitmap_mask, PRIVATE_AS const u32 *digest)
 {
+  // blocked bloom filter, see bloom_insert () in src/bitmap.c
+
+  GLOBAL_AS const u32 *block = bitmap + (((digest[0] >> 3) & bitmap_mask) * 8);
+
+  const u32 key = digest[1] ^ digest[2] ^ digest[3] ^ hc_rotl32_S (digest[0], 13);
+
+  if ((block[0] & (1u << ((key * 0x47b6137b) >> 27))) == 0) return (0);
+  if ((block[1] & (1u << ((key * 0x44974d91) >> 27))) == 0) return (0);
+  if ((block[2] & (1u << ((key * 0x8824ad5b) >> 27))) == 0) return (0);
+  if ((block[3] & (1u << ((key * 0xa2b7289d) >> 27))) == 0) return (0);
+  if ((block[4] & (1u << ((key * 0x705495c7) >> 27))) == 0) return (0);
+  if ((block[5] & (1u << ((key * 0x2df1424b) >> 27))) == 0) return (0);
+  if ((block[6] & (1u << ((key * 0x9efc4947) >> 27))) == 0) return (0);
+  if ((block[7] & (1u << ((key * 0x5c6bfb31) >> 27))) == 0) return (0);
+
+  return (1);
+}
+
+DECLSPEC u32 check (PRIVATE_AS const u32 *digest, GLOBAL_AS const u32 *bitmap_s1_a, GLOBAL_AS const u32 *bitmap_s1_b, GLOBAL_AS const u32 *bitmap_s1_c, GLOBAL_AS const u32 *bitmap_s1_d, GLOBAL_AS const u32 *bitmap_s2_a, GLOBAL_AS const u32 *bitmap_s2_b, GLOBAL_AS const u32 *bitmap_s2_c, GLOBAL_AS const u32 *bitmap_s2_d, const u32 bitmap_mask, const u32 bitmap_shift1, const u32 bitmap_shift2, const u32 bitmap_mode)
+{
+  if (bitmap_mode == 1)
+  {
+    switch (digest[0] & 7)
+    {
+      case 0: return check_bloom (bitmap_s1_a, bitmap_mask, digest);
+      case 1: return check_bloom (bitmap_s1_b, bitmap_mask, digest);
+      case 2: return check_bloom (bitmap_s1_c, bitmap_mask, digest);
+      case 3: return check_bloom (bitmap_s1_d, bitmap_mask, digest);
+      case 4: return check_bloom (bitmap_s2_a, bitmap_mask, digest);
+      case 5: return check_bloom (bitmap_s2_b, bitmap_mask, digest);
+      case 6: return check_bloom (bitmap_s2_c, bitmap_mask, digest);
+      case 7: return check_bloom (bitmap_s2_d, bitmap_mask, digest);
+    }
+  }
+
   if (check_bitmap (bitmap_s1_a, bitmap_mask, bitmap_shift1, digest[0]) == 0) return (0);
   if (check_bitmap (bitmap_s1_b, bitmap_mask, bitmap_shift1, digest[1]) == 0) return (0);
   if (check_bitmap (bitmap_s1_c, bitmap_mask, bitmap_shift1, digest[2]) == 0) return (0);
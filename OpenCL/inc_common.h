@@ -296,6 +296,7 @@ DECLSPEC int ffz (const u32 v);
 #ifdef KERNEL_STATIC
 DECLSPEC int hash_comp (PRIVATE_AS const u32 *d1, GLOBAL_AS const u32 *d2);
 DECLSPEC int find_hash (PRIVATE_AS const u32 *digest, const u32 digests_cnt, GLOBAL_AS const digest_t *digests_buf);
+DECLSPEC int find_hash_idx (PRIVATE_AS const u32 *digest, const u32 digests_cnt, GLOBAL_AS const digest_t *digests_buf, const u32 digests_idx_bits);
 #endif
 
 DECLSPEC int hc_enc_scan (PRIVATE_AS const u32 *buf, const int len);
@@ -312,7 +313,8 @@ DECLSPEC int pkcs_padding_bs16 (PRIVATE_AS const u32 *data_buf, const int data_l
 DECLSPEC int asn1_detect (PRIVATE_AS const u32 *buf, const int len);
 DECLSPEC int asn1_check_int_tag (PRIVATE_AS const u32 *buf, const int len);
 DECLSPEC u32 check_bitmap (GLOBAL_AS const u32 *bitmap, const u32 bitmap_mask, const u32 bitmap_shift, const u32 digest);
-DECLSPEC u32 check (PRIVATE_AS const u32 *digest, GLOBAL_AS const u32 *bitmap_s1_a, GLOBAL_AS const u32 *bitmap_s1_b, GLOBAL_AS const u32 *bitmap_s1_c, GLOBAL_AS const u32 *bitmap_s1_d, GLOBAL_AS const u32 *bitmap_s2_a, GLOBAL_AS const u32 *bitmap_s2_b, GLOBAL_AS const u32 *bitmap_s2_c, GLOBAL_AS const u32 *bitmap_s2_d, const u32 bitmap_mask, const u32 bitmap_shift1, const u32 bitmap_shift2);
+DECLSPEC u32 check_bloom (GLOBAL_AS const u32 *bitmap, const u32 bitmap_mask, PRIVATE_AS const u32 *digest);
+DECLSPEC u32 check (PRIVATE_AS const u32 *digest, GLOBAL_AS const u32 *bitmap_s1_a, GLOBAL_AS const u32 *bitmap_s1_b, GLOBAL_AS const u32 *bitmap_s1_c, GLOBAL_AS const u32 *bitmap_s1_d, GLOBAL_AS const u32 *bitmap_s2_a, GLOBAL_AS const u32 *bitmap_s2_b, GLOBAL_AS const u32 *bitmap_s2_c, GLOBAL_AS const u32 *bitmap_s2_d, const u32 bitmap_mask, const u32 bitmap_shift1, const u32 bitmap_shift2, const u32 bitmap_mode);
 DECLSPEC void mark_hash (GLOBAL_AS plain_t *plains_buf, GLOBAL_AS u32 *d_result, const u32 salt_pos, const u32 digests_cnt, const u32 digest_pos, const u32 hash_pos, const u64 gid, const u32 il_pos, const u32 extra1, const u32 extra2);
 DECLSPEC int hc_count_char (PRIVATE_AS const u32 *buf, const int elems, const u32 c);
 DECLSPEC float hc_get_entropy (PRIVATE_AS const u32 *buf, const int elems);
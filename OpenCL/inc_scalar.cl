@@ -25,9 +25,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp0, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);                     \
+    int digest_pos = find_hash_idx (digest_tp0, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
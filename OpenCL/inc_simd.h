@@ -35,9 +35,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp0, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);                \
+    int digest_pos = find_hash_idx (digest_tp0, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -95,9 +98,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp0, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);                \
+    int digest_pos = find_hash_idx (digest_tp0, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -115,9 +121,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp1, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);                \
+    int digest_pos = find_hash_idx (digest_tp1, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -195,9 +204,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp0, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);                \
+    int digest_pos = find_hash_idx (digest_tp0, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -215,9 +227,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp1, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);                \
+    int digest_pos = find_hash_idx (digest_tp1, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -235,9 +250,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp2, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);                \
+    int digest_pos = find_hash_idx (digest_tp2, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -255,9 +273,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp3, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);                \
+    int digest_pos = find_hash_idx (digest_tp3, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -378,9 +399,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp0, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);                \
+    int digest_pos = find_hash_idx (digest_tp0, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -398,9 +422,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp1, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);                \
+    int digest_pos = find_hash_idx (digest_tp1, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -418,9 +445,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp2, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);                \
+    int digest_pos = find_hash_idx (digest_tp2, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -438,9 +468,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp3, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);                \
+    int digest_pos = find_hash_idx (digest_tp3, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -457,9 +490,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp4, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);                \
+    int digest_pos = find_hash_idx (digest_tp4, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -477,9 +513,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp5, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);                \
+    int digest_pos = find_hash_idx (digest_tp5, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -497,9 +536,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp6, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);                \
+    int digest_pos = find_hash_idx (digest_tp6, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -517,9 +559,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp7, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);                \
+    int digest_pos = find_hash_idx (digest_tp7, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -728,9 +773,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp00, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);               \
+    int digest_pos = find_hash_idx (digest_tp00, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -748,9 +796,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp01, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);               \
+    int digest_pos = find_hash_idx (digest_tp01, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -768,9 +819,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp02, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);               \
+    int digest_pos = find_hash_idx (digest_tp02, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -788,9 +842,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp03, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);               \
+    int digest_pos = find_hash_idx (digest_tp03, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -808,9 +865,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp04, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);               \
+    int digest_pos = find_hash_idx (digest_tp04, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -828,9 +888,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp05, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);               \
+    int digest_pos = find_hash_idx (digest_tp05, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -848,9 +911,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp06, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);               \
+    int digest_pos = find_hash_idx (digest_tp06, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -868,9 +934,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp07, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);               \
+    int digest_pos = find_hash_idx (digest_tp07, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -888,9 +957,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp08, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);               \
+    int digest_pos = find_hash_idx (digest_tp08, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -908,9 +980,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp09, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);               \
+    int digest_pos = find_hash_idx (digest_tp09, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -928,9 +1003,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp10, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);               \
+    int digest_pos = find_hash_idx (digest_tp10, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -948,9 +1026,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp11, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);               \
+    int digest_pos = find_hash_idx (digest_tp11, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -968,9 +1049,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp12, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);               \
+    int digest_pos = find_hash_idx (digest_tp12, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -988,9 +1072,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp13, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);               \
+    int digest_pos = find_hash_idx (digest_tp13, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -1008,9 +1095,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp14, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);               \
+    int digest_pos = find_hash_idx (digest_tp14, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
@@ -1028,9 +1118,12 @@
              bitmaps_buf_s2_a, bitmaps_buf_s2_b, bitmaps_buf_s2_c, bitmaps_buf_s2_d,                        \
              BITMAP_MASK,                                                                                   \
              BITMAP_SHIFT1,                                                                                 \
-             BITMAP_SHIFT2))                                                                                \
+             BITMAP_SHIFT2,                                                                                 \
+             BITMAP_MODE))                                                                                 \
   {                                                                                                         \
-    int digest_pos = find_hash (digest_tp15, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST]);               \
+    int digest_pos = find_hash_idx (digest_tp15, DIGESTS_CNT, &digests_buf[DIGESTS_OFFSET_HOST], DIGESTS_IDX_BITS); \
+                                                                                                            \
+    if ((digest_pos == -1) && (BITMAP_COUNT_FP == 1)) hc_atomic_inc (&d_return_buf[1]);                     \
                                                                                                             \
     if (digest_pos != -1)                                                                                   \
     {                                                                                                       \
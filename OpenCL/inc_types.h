@@ -10,12 +10,15 @@
 #define BITMAP_MASK         kernel_param->bitmap_mask
 #define BITMAP_SHIFT1       kernel_param->bitmap_shift1
 #define BITMAP_SHIFT2       kernel_param->bitmap_shift2
+#define BITMAP_MODE         kernel_param->bitmap_mode
+#define BITMAP_COUNT_FP     kernel_param->bitmap_count_fp
 #define SALT_POS_HOST       (kernel_param->pws_pos + gid)
 #define SALT_POS_HOST_BID   (kernel_param->pws_pos + bid)
 #define LOOP_POS            kernel_param->loop_pos
 #define LOOP_CNT            kernel_param->loop_cnt
 #define IL_CNT              kernel_param->il_cnt
 #define DIGESTS_CNT         1
+#define DIGESTS_IDX_BITS    0
 #define DIGESTS_OFFSET_HOST     (kernel_param->pws_pos + gid)
 #define DIGESTS_OFFSET_HOST_BID (kernel_param->pws_pos + bid)
 #define COMBS_MODE          kernel_param->combs_mode
@@ -26,12 +29,15 @@
 #define BITMAP_MASK         kernel_param->bitmap_mask
 #define BITMAP_SHIFT1       kernel_param->bitmap_shift1
 #define BITMAP_SHIFT2       kernel_param->bitmap_shift2
+#define BITMAP_MODE         kernel_param->bitmap_mode
+#define BITMAP_COUNT_FP     kernel_param->bitmap_count_fp
 #define SALT_POS_HOST       kernel_param->salt_pos_host
 #define SALT_POS_HOST_BID   SALT_POS_HOST
 #define LOOP_POS            kernel_param->loop_pos
 #define LOOP_CNT            kernel_param->loop_cnt
 #define IL_CNT              kernel_param->il_cnt
 #define DIGESTS_CNT         kernel_param->digests_cnt
+#define DIGESTS_IDX_BITS    kernel_param->digests_idx_bits
 #define DIGESTS_OFFSET_HOST kernel_param->digests_offset_host
 #define DIGESTS_OFFSET_HOST_BID DIGESTS_OFFSET_HOST
 #define COMBS_MODE          kernel_param->combs_mode
@@ -1998,8 +2004,11 @@ typedef struct kernel_param
   u32 digests_offset_host;  // 32
   u32 combs_mode;           // 33
   u32 salt_repeat;          // 34
-  u64 pws_pos;              // 35
-  u64 gid_max;              // 36
+  u32 bitmap_mode;          // 35
+  u32 bitmap_count_fp;      // 36
+  u32 digests_idx_bits;     // 37
+  u64 pws_pos;              // 38
+  u64 gid_max;              // 39
 
 } kernel_param_t;
 
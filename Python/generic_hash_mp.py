@@ -36,6 +36,12 @@ def extract_esalts(esalts_buf):
 def kernel_loop(ctx,passwords,salt_id,is_selftest):
   return hcmp.handle_queue(ctx,passwords,salt_id,is_selftest)
 
+# Preferred by the bridge over kernel_loop() when present: the batch comes in as one writable buffer
+# and the workers exchange it through shared memory instead of pickled lists
+
+def kernel_loop_buf(ctx,io_buf,pws_cnt,salt_id,is_selftest):
+  return hcmp.handle_queue_buf(ctx,io_buf,pws_cnt,salt_id,is_selftest)
+
 def init(ctx):
   hcmp.init(ctx,extract_esalts)
 
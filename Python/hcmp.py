@@ -1,7 +1,43 @@
 import importlib
 import multiprocessing
+import multiprocessing.shared_memory
+import sys
+import time
 import hcshared
 
+# State of a pool worker, set once by _worker_init() so that the batches only carry offsets
+
+_worker = {}
+
+def _worker_init(module_name, salts, st_salts):
+    user_module = importlib.import_module(module_name)
+    _worker["calc_hash"] = getattr(user_module, "calc_hash")
+    _worker["salts"] = salts
+    _worker["st_salts"] = st_salts
+    _worker["shm"] = None
+
+def _worker_batch_list(chunk, salt_id, is_selftest):
+    return hcshared._worker_batch(chunk, salt_id, is_selftest, _worker["calc_hash"], _worker["salts"], _worker["st_salts"])
+
+def _worker_batch_shm(shm_name, io_size, start, end, salt_id, is_selftest):
+    t0 = time.perf_counter()
+    shm = _worker["shm"]
+    if shm is None or shm.name != shm_name:
+        if shm is not None:
+            shm.close()
+        # attach only, the owner is the bridge process
+        shm = multiprocessing.shared_memory.SharedMemory(name=shm_name, track=False) if sys.version_info >= (3, 13) else _shm_attach(shm_name)
+        _worker["shm"] = shm
+    hcshared._worker_batch_io(shm.buf, io_size, start, end, salt_id, is_selftest, _worker["calc_hash"], _worker["salts"], _worker["st_salts"])
+    return time.perf_counter() - t0
+
+def _shm_attach(shm_name):
+    # before 3.13 attaching registers the segment with the resource tracker, which would unlink it on worker exit
+    from multiprocessing import resource_tracker
+    shm = multiprocessing.shared_memory.SharedMemory(name=shm_name)
+    resource_tracker.unregister(shm._name, "shared_memory")
+    return shm
+
 def _worker_batch(chunk, salt_id, is_selftest, module_name, salts, st_salts):
     user_module = importlib.import_module(module_name)
     calc_hash = getattr(user_module, "calc_hash")
@@ -24,14 +60,12 @@ def init(ctx: dict, extract_esalts):
     ctx["st_salts"] = st_salts
     ctx["module_name"] = ctx.get("module_name", "__main__")
 
-    ctx["pool"] = multiprocessing.Pool(processes=ctx["parallelism"])
+    ctx["pool"] = multiprocessing.Pool(processes=ctx["parallelism"], initializer=_worker_init, initargs=(ctx["module_name"], salts, st_salts))
+    ctx["shm"] = None
     return
 
 def handle_queue(ctx: dict, passwords: list, salt_id: int, is_selftest: bool) -> list:
     pool = ctx["pool"]
-    salts = ctx["salts"]
-    st_salts = ctx["st_salts"]
-    module_name = ctx["module_name"]
     parallelism = ctx["parallelism"]
 
     chunk_size = (len(passwords) + parallelism - 1) // parallelism
@@ -41,8 +75,8 @@ def handle_queue(ctx: dict, passwords: list, salt_id: int, is_selftest: bool) ->
     for chunk in chunks:
         if chunk:
             jobs.append(pool.apply_async(
-                _worker_batch,
-                args=(chunk, salt_id, is_selftest, module_name, salts, st_salts)
+                _worker_batch_list,
+                args=(chunk, salt_id, is_selftest)
             ))
 
     hashes = []
@@ -50,9 +84,52 @@ def handle_queue(ctx: dict, passwords: list, salt_id: int, is_selftest: bool) ->
         hashes.extend(job.get())
     return hashes
 
+def handle_queue_buf(ctx: dict, io_buf, pws_cnt: int, salt_id: int, is_selftest: bool):
+    # io_buf is the bridge's array of generic_io_tmp_t, the workers read the passwords from
+    # and write the hashes to a shared memory copy of it, so only offsets go through the pipes
+    t0 = time.perf_counter()
+    pool = ctx["pool"]
+    parallelism = ctx["parallelism"]
+    io_size = ctx.get("io_size", 520)
+    io_len = pws_cnt * io_size
+    if io_len == 0:
+        return
+    shm = ctx["shm"]
+    if shm is None or shm.size < io_len:
+        if shm is not None:
+            shm.close()
+            shm.unlink()
+        shm = multiprocessing.shared_memory.SharedMemory(create=True, size=io_len)
+        ctx["shm"] = shm
+    shm.buf[:io_len] = io_buf[:io_len]
+
+    chunk_size = (pws_cnt + parallelism - 1) // parallelism
+
+    jobs = []
+    for start in range(0, pws_cnt, chunk_size):
+        end = min(start + chunk_size, pws_cnt)
+        jobs.append(pool.apply_async(
+            _worker_batch_shm,
+            args=(shm.name, io_size, start, end, salt_id, is_selftest)
+        ))
+
+    busy = 0.0
+    for job in jobs:
+        busy += job.get()
+    io_buf[:io_len] = shm.buf[:io_len]
+
+    if ctx.get("timings"):
+        wall = time.perf_counter() - t0
+        print(f"hcmp: {pws_cnt} pws, {len(jobs)} jobs, wall {wall * 1000:.2f} ms, busy {busy * 1000:.2f} ms, {pws_cnt / wall:.0f} H/s", file=sys.stderr)
+    return
+
 def term(ctx: dict):
     if "pool" in ctx:
         ctx["pool"].close()
         ctx["pool"].join()
         del ctx["pool"]
+    if ctx.get("shm") is not None:
+        ctx["shm"].close()
+        ctx["shm"].unlink()
+        ctx["shm"] = None
     return
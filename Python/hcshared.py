@@ -72,3 +72,26 @@ def _worker_batch(passwords, salt_id, is_selftest, user_fn, salts, st_salts):
             print(e, file=sys.stderr)
             hashes.append("invalid-password")
     return hashes
+
+# generic_io_tmp_t of the bridge: pw_buf[256], pw_len, out_buf[256], out_len
+
+IO_PW_BUF  = 0
+IO_PW_LEN  = 256
+IO_OUT_BUF = 260
+IO_OUT_LEN = 516
+
+def _worker_batch_io(io_buf, io_size, start, end, salt_id, is_selftest, user_fn, salts, st_salts):
+    salt = st_salts[salt_id] if is_selftest else salts[salt_id]
+    for i in range(start, end):
+        off = i * io_size
+        pw_len, = struct.unpack_from("<I", io_buf, off + IO_PW_LEN)
+        pw = bytes(io_buf[off + IO_PW_BUF:off + IO_PW_BUF + min(pw_len, 256)])
+        try:
+            hash=user_fn(pw, salt)
+        except Exception as e:
+            print(e, file=sys.stderr)
+            hash="invalid-password"
+        out = hash.encode() if isinstance(hash, str) else bytes(hash)
+        out = out[:256]
+        io_buf[off + IO_OUT_BUF:off + IO_OUT_BUF + len(out)] = out
+        struct.pack_into("<I", io_buf, off + IO_OUT_LEN, len(out))
@@ -7,8 +7,10 @@
 #define HC_BITMAP_H
 
 #include <string.h>
+#include <inttypes.h>
 
 int  bitmap_ctx_init    (hashcat_ctx_t *hashcat_ctx);
+void bitmap_ctx_update  (hashcat_ctx_t *hashcat_ctx);
 void bitmap_ctx_destroy (hashcat_ctx_t *hashcat_ctx);
 
 #endif // HC_BITMAP_H
@@ -31,7 +31,10 @@
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <signal.h>
+#include <sys/mman.h>
 #if defined (__linux__)
+#include <sys/epoll.h>
+#include <sys/resource.h>
 #define SEND_FLAGS MSG_NOSIGNAL
 #else
 #define SEND_FLAGS 0
@@ -44,9 +47,18 @@ static const int BRAIN_CLIENT_CONNECT_TIMEOUT     = 5;
 static const int BRAIN_SERVER_TIMER               = 5 * 60;
 static const int BRAIN_SERVER_SESSIONS_MAX        = 64;
 static const int BRAIN_SERVER_ATTACKS_MAX         = 64 * 1024;
+#if defined (__linux__)
+static const int BRAIN_SERVER_CLIENTS_MAX         = 4096;
+#else
 static const int BRAIN_SERVER_CLIENTS_MAX         = 256;
+#endif
+static const int BRAIN_SERVER_WORKERS_MIN         = 2;
 static const int BRAIN_SERVER_REALLOC_HASH_SIZE   = 1024 * 1024;
 static const int BRAIN_SERVER_REALLOC_ATTACK_SIZE = 1024;
+static const int BRAIN_SERVER_HASH_SHARDS_BITS    = 8;
+static const int BRAIN_SERVER_HASH_SHARDS         = 1 << 8;
+static const int BRAIN_SERVER_HASH_TABLE_MIN      = 1024;
+static const int BRAIN_SERVER_JOURNAL_RATIO       = 4;
 static const int BRAIN_HASH_SIZE                  = 2 * sizeof (u32);
 static const int BRAIN_LINK_VERSION_CUR           = 1;
 static const int BRAIN_LINK_VERSION_MIN           = 1;
@@ -68,6 +80,30 @@ typedef enum brain_client_feature
 
 } brain_client_feature_t;
 
+// the part of a message the brain server waits for on a client link
+
+typedef enum brain_server_stage
+{
+  BRAIN_SERVER_STAGE_VERSION     = 1, // u32 link version
+  BRAIN_SERVER_STAGE_RESPONSE    = 2, // u64 challenge response
+  BRAIN_SERVER_STAGE_SESSION     = 3, // u32 session, u32 attack, i64 passwords_max
+  BRAIN_SERVER_STAGE_OPERATION   = 4, // u8 operation
+  BRAIN_SERVER_STAGE_RESERVE     = 5, // u64 offset, u64 length
+  BRAIN_SERVER_STAGE_LOOKUP_SIZE = 6, // int size of the hashes
+  BRAIN_SERVER_STAGE_LOOKUP      = 7, // the hashes
+
+} brain_server_stage_t;
+
+// what a client link waits for after it was served
+
+typedef enum brain_server_link
+{
+  BRAIN_SERVER_LINK_CLOSE        = 0,
+  BRAIN_SERVER_LINK_READ         = 1,
+  BRAIN_SERVER_LINK_WRITE        = 2,
+
+} brain_server_link_t;
+
 typedef struct brain_server_attack_long
 {
   u64 offset;
@@ -127,21 +163,60 @@ typedef struct brain_server_db_attack
 
 } brain_server_db_attack_t;
 
-typedef struct brain_server_db_hash
-{
-  u32 brain_session;
+// the long-term memory of a session is split by the upper bits of the hash into shards,
+// each one a sorted array plus a hash table for the hashes committed since its last compaction
 
+typedef struct brain_server_db_shard
+{
   brain_server_hash_long_t *long_buf;
 
   i64 long_alloc;
   i64 long_cnt;
 
+  bool long_mapped; // long_buf points into the mapped dump, it's copied to the heap on the first merge
+
+  u64 *table_buf;
+
+  i64 table_size;
+  i64 table_cnt;
+
+  bool table_zero;
+
   int hb;
 
   hc_thread_mutex_t mux_hr;
   hc_thread_mutex_t mux_hg;
 
-  bool write_hashes;
+} brain_server_db_shard_t;
+
+typedef struct brain_server_db_hash
+{
+  u32 brain_session;
+
+  brain_server_db_shard_t *shard_buf;
+
+  i64 long_cnt;
+
+  hc_thread_mutex_t mux_hc;
+
+  // the compacted dump loaded at startup, the shards read from it until they change
+
+  void *map_buf;
+  u64   map_len;
+
+  // commits are appended to the journal, the dump is only rewritten once the journal has grown large enough
+
+  char journal_file[32];
+  char journal_file_old[32];
+
+  HCFILE journal_fp;
+
+  bool journal_open;
+
+  i64 journal_size;
+  i64 dump_size;
+
+  hc_thread_mutex_t mux_hj;
 
 } brain_server_db_hash_t;
 
@@ -189,8 +264,55 @@ typedef struct brain_server_client_options
   u32 *session_whitelist_buf;
   int  session_whitelist_cnt;
 
+  // only the thread currently serving the client touches any of the following
+
+  bool connected;
+
+  i64 passwords_max;
+
+  brain_server_db_hash_t   *brain_server_db_hash;
+  brain_server_db_attack_t *brain_server_db_attack;
+
+  brain_server_db_short_t brain_server_db_short;
+
+  // link state, on linux the socket is non-blocking and a message is collected part by part,
+  // a part is processed once it is complete. a reply the socket did not take at once is sent
+  // once the socket is writable again, nothing more is read from the client until then
+
+  int    stage;
+  u32    challenge;
+
+  u8     recv_head[16];
+  u8    *recv_ptr;
+  size_t recv_want;
+  size_t recv_have;
+
+  u8     send_head[16];
+  u8    *send_ptr;
+  size_t send_want;
+  size_t send_done;
+  bool   send_close;
+
+  u32   *recv_buf;  // hashes of a lookup
+  u8    *send_buf;  // size and rejects of a lookup
+
 } brain_server_client_options_t;
 
+// a thread serving clients, either one client for its lifetime or any client with a complete message part (epoll)
+// the temp buffer is sized for the largest client served so far
+
+typedef struct brain_server_worker
+{
+  brain_server_client_options_t *brain_server_client_options;
+
+  int epoll_fd;
+
+  brain_server_hash_unique_t *temp_buf;
+
+  i64 passwords_max;
+
+} brain_server_worker_t;
+
 int   brain_logging                     (FILE *stream, const int client_idx, const char *format, ...);
 
 u32   brain_compute_session             (hashcat_ctx_t *hashcat_ctx);
@@ -208,16 +330,26 @@ bool  brain_send_all                    (int sockfd, void *buf, size_t len, int
 
 bool  brain_client_reserve              (hc_device_param_t *device_param, const status_ctx_t *status_ctx, u64 words_off, u64 work, u64 *overlap);
 bool  brain_client_commit               (hc_device_param_t *device_param, const status_ctx_t *status_ctx);
+bool  brain_client_commit_next          (hc_device_param_t *device_param, const status_ctx_t *status_ctx);
 bool  brain_client_lookup               (hc_device_param_t *device_param, const status_ctx_t *status_ctx);
+bool  brain_client_lookup_link          (hc_device_param_t *device_param, const status_ctx_t *status_ctx);
+void  brain_client_lookup_start         (hc_device_param_t *device_param, const status_ctx_t *status_ctx);
+bool  brain_client_lookup_wait          (hc_device_param_t *device_param);
 bool  brain_client_connect              (hc_device_param_t *device_param, const status_ctx_t *status_ctx, const char *host, const int port, const char *password, u32 brain_session, u32 brain_attack, i64 passwords_max, u64 *highest);
+int   brain_client_connect_link         (hc_device_param_t *device_param, const status_ctx_t *status_ctx, const char *host, const int port, const char *password, u32 brain_session, u32 brain_attack, i64 passwords_max, u64 *highest);
 void  brain_client_disconnect           (hc_device_param_t *device_param);
+void  brain_client_swap                 (hc_device_param_t *device_param);
 void  brain_client_generate_hash        (u64 *hash, const char *line_buf, const size_t line_len);
 
 int   brain_server                      (const char *listen_host, const int listen_port, const char *brain_password, const char *brain_session_whitelist, const u32 brain_server_timer);
 bool  brain_server_read_hash_dumps      (brain_server_dbs_t *brain_server_dbs, const char *path);
-bool  brain_server_write_hash_dumps     (brain_server_dbs_t *brain_server_dbs, const char *path);
+bool  brain_server_write_hash_dumps     (brain_server_dbs_t *brain_server_dbs, const char *path, const bool force);
 bool  brain_server_read_hash_dump       (brain_server_db_hash_t *brain_server_db_hash, const char *file);
+bool  brain_server_map_hash_dump        (brain_server_db_hash_t *brain_server_db_hash, const char *file);
 bool  brain_server_write_hash_dump      (brain_server_db_hash_t *brain_server_db_hash, const char *file);
+bool  brain_server_read_hash_journal    (brain_server_db_hash_t *brain_server_db_hash, const char *file);
+bool  brain_server_write_hash_journal   (brain_server_db_hash_t *brain_server_db_hash, const brain_server_hash_short_t *short_buf, const i64 short_cnt);
+bool  brain_server_rotate_hash_journal  (brain_server_db_hash_t *brain_server_db_hash, i64 *journal_size);
 bool  brain_server_read_attack_dumps    (brain_server_dbs_t *brain_server_dbs, const char *path);
 bool  brain_server_write_attack_dumps   (brain_server_dbs_t *brain_server_dbs, const char *path);
 bool  brain_server_read_attack_dump     (brain_server_db_attack_t *brain_server_db_attack, const char *file);
@@ -239,14 +371,37 @@ int   brain_server_sort_hash            (const void *v1, const void *v2);
 int   brain_server_sort_hash_long       (const void *v1, const void *v2);
 int   brain_server_sort_hash_short      (const void *v1, const void *v2);
 int   brain_server_sort_hash_unique     (const void *v1, const void *v2);
+int   brain_server_sort_hash_u64        (const void *v1, const void *v2);
 void  brain_server_handle_signal        (int signo);
 HC_API_CALL
+void *brain_client_lookup_thread        (void *p);
+HC_API_CALL
 void *brain_server_handle_client        (void *p);
 HC_API_CALL
+void *brain_server_handle_events        (void *p);
+HC_API_CALL
 void *brain_server_handle_dumps         (void *p);
+bool  brain_server_client_handshake     (brain_server_client_options_t *brain_server_client_options);
+bool  brain_server_client_operation     (brain_server_client_options_t *brain_server_client_options, brain_server_worker_t *brain_server_worker);
+int   brain_server_client_serve         (brain_server_client_options_t *brain_server_client_options, brain_server_worker_t *brain_server_worker);
+int   brain_server_client_recv          (brain_server_client_options_t *brain_server_client_options);
+int   brain_server_client_send          (brain_server_client_options_t *brain_server_client_options);
+void  brain_server_client_expect        (brain_server_client_options_t *brain_server_client_options, const int stage, void *buf, const size_t len);
+void  brain_server_client_reply         (brain_server_client_options_t *brain_server_client_options, const void *buf, const size_t len);
+void  brain_server_client_open          (brain_server_client_options_t *brain_server_client_options, const int client_fd);
+void  brain_server_client_close         (brain_server_client_options_t *brain_server_client_options);
+bool  brain_server_worker_realloc       (brain_server_worker_t *brain_server_worker, const i64 passwords_max);
+void  brain_server_worker_free          (brain_server_worker_t *brain_server_worker);
 void  brain_server_db_hash_init         (brain_server_db_hash_t *brain_server_db_hash, const u32 brain_session);
-bool  brain_server_db_hash_realloc      (brain_server_db_hash_t *brain_server_db_hash, const i64 new_long_cnt);
 void  brain_server_db_hash_free         (brain_server_db_hash_t *brain_server_db_hash);
+i64   brain_server_db_hash_lookup       (brain_server_db_hash_t *brain_server_db_hash, brain_server_hash_unique_t *temp_buf, const i64 temp_cnt, u8 *send_buf);
+bool  brain_server_db_hash_commit       (brain_server_db_hash_t *brain_server_db_hash, const brain_server_hash_short_t *short_buf, const i64 short_cnt);
+u32   brain_server_db_shard_idx         (const u32 *hash);
+bool  brain_server_db_shard_realloc     (brain_server_db_shard_t *brain_server_db_shard, const i64 new_long_cnt);
+bool  brain_server_db_shard_table_put   (u64 *table_buf, const i64 table_size, const u64 hash);
+bool  brain_server_db_shard_insert      (brain_server_db_shard_t *brain_server_db_shard, const u32 *hash);
+bool  brain_server_db_shard_find        (const brain_server_db_shard_t *brain_server_db_shard, const u32 *hash);
+bool  brain_server_db_shard_compact     (brain_server_db_shard_t *brain_server_db_shard);
 void  brain_server_db_attack_init       (brain_server_db_attack_t *brain_server_db_attack, const u32 brain_attack);
 bool  brain_server_db_attack_realloc    (brain_server_db_attack_t *brain_server_db_attack, const i64 new_long_cnt, const i64 new_short_cnt);
 void  brain_server_db_attack_free       (brain_server_db_attack_t *brain_server_db_attack);
@@ -0,0 +1,18 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+#ifndef HC_CPU_SCRYPT_MB_H
+#define HC_CPU_SCRYPT_MB_H
+
+// multi-buffer scrypt ROMix (salsa20/8 only), runs SCRYPT_MB_LANES_MAX candidates at most in lockstep,
+// one candidate per 32 bit element of a SIMD register
+
+#define SCRYPT_MB_LANES_MAX 16
+
+int  scrypt_mb_lanes_supported (const int lanes);
+int  scrypt_mb_lanes_best      (void);
+void scrypt_mb_romix           (u32 **B, const int lanes, u32 *V, u32 *XY, const u32 N, const u32 r);
+
+#endif // HC_CPU_SCRYPT_MB_H
@@ -0,0 +1,175 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+// included by cpu_scrypt_mb.c once per SIMD width, expects:
+//
+// MB_LANES      number of candidates, equals the number of 32 bit elements of MB_VEC
+// MB_VEC        vector type of MB_LANES u32 (gcc vector extension)
+// MB_TARGET     function attribute enabling the instruction set
+// MB_TRANSPOSE  transposes MB_LANES vectors of MB_LANES elements in place
+// MB_FN(name)   makes the function names unique
+
+static inline __attribute__ ((always_inline)) MB_TARGET void MB_FN (salsa20_8) (MB_VEC B[16])
+{
+  MB_VEC x[16];
+
+  for (int i = 0; i < 16; i++) x[i] = B[i];
+
+  #define MB_R(a,b) (((a) << (b)) | ((a) >> (32 - (b))))
+
+  for (int i = 0; i < 8; i += 2)
+  {
+    x[ 4] ^= MB_R (x[ 0] + x[12],  7); x[ 8] ^= MB_R (x[ 4] + x[ 0],  9);
+    x[12] ^= MB_R (x[ 8] + x[ 4], 13); x[ 0] ^= MB_R (x[12] + x[ 8], 18);
+    x[ 9] ^= MB_R (x[ 5] + x[ 1],  7); x[13] ^= MB_R (x[ 9] + x[ 5],  9);
+    x[ 1] ^= MB_R (x[13] + x[ 9], 13); x[ 5] ^= MB_R (x[ 1] + x[13], 18);
+    x[14] ^= MB_R (x[10] + x[ 6],  7); x[ 2] ^= MB_R (x[14] + x[10],  9);
+    x[ 6] ^= MB_R (x[ 2] + x[14], 13); x[10] ^= MB_R (x[ 6] + x[ 2], 18);
+    x[ 3] ^= MB_R (x[15] + x[11],  7); x[ 7] ^= MB_R (x[ 3] + x[15],  9);
+    x[11] ^= MB_R (x[ 7] + x[ 3], 13); x[15] ^= MB_R (x[11] + x[ 7], 18);
+
+    x[ 1] ^= MB_R (x[ 0] + x[ 3],  7); x[ 2] ^= MB_R (x[ 1] + x[ 0],  9);
+    x[ 3] ^= MB_R (x[ 2] + x[ 1], 13); x[ 0] ^= MB_R (x[ 3] + x[ 2], 18);
+    x[ 6] ^= MB_R (x[ 5] + x[ 4],  7); x[ 7] ^= MB_R (x[ 6] + x[ 5],  9);
+    x[ 4] ^= MB_R (x[ 7] + x[ 6], 13); x[ 5] ^= MB_R (x[ 4] + x[ 7], 18);
+    x[11] ^= MB_R (x[10] + x[ 9],  7); x[ 8] ^= MB_R (x[11] + x[10],  9);
+    x[ 9] ^= MB_R (x[ 8] + x[11], 13); x[10] ^= MB_R (x[ 9] + x[ 8], 18);
+    x[12] ^= MB_R (x[15] + x[14],  7); x[13] ^= MB_R (x[12] + x[15],  9);
+    x[14] ^= MB_R (x[13] + x[12], 13); x[15] ^= MB_R (x[14] + x[13], 18);
+  }
+
+  #undef MB_R
+
+  for (int i = 0; i < 16; i++) B[i] += x[i];
+}
+
+// Y = BlockMix (X), X and Y are 2r blocks of 16 words, interleaved by lane
+
+static inline MB_TARGET void MB_FN (blockmix) (MB_VEC *Y, const MB_VEC *X, const u32 r)
+{
+  MB_VEC T[16];
+
+  for (int k = 0; k < 16; k++) T[k] = X[(2 * r - 1) * 16 + k];
+
+  for (u32 i = 0; i < 2 * r; i++)
+  {
+    for (int k = 0; k < 16; k++) T[k] ^= X[i * 16 + k];
+
+    MB_FN (salsa20_8) (T);
+
+    // even blocks go to the first half, odd blocks to the second half
+
+    MB_VEC *dst = Y + ((i / 2) + ((i & 1) * r)) * 16;
+
+    for (int k = 0; k < 16; k++) dst[k] = T[k];
+  }
+}
+
+// 16 words per lane at p[lane] <-> 16 vectors of one word per lane
+
+static inline MB_TARGET void MB_FN (load_block) (MB_VEC x[16], u32 *const p[MB_LANES])
+{
+  for (int g = 0; g < 16; g += MB_LANES)
+  {
+    MB_VEC rows[MB_LANES];
+
+    for (int l = 0; l < MB_LANES; l++) memcpy (&rows[l], p[l] + g, sizeof (MB_VEC));
+
+    MB_TRANSPOSE (rows);
+
+    for (int w = 0; w < MB_LANES; w++) x[g + w] = rows[w];
+  }
+}
+
+static inline MB_TARGET void MB_FN (xor_block) (MB_VEC x[16], u32 *const p[MB_LANES])
+{
+  for (int g = 0; g < 16; g += MB_LANES)
+  {
+    MB_VEC rows[MB_LANES];
+
+    for (int l = 0; l < MB_LANES; l++) memcpy (&rows[l], p[l] + g, sizeof (MB_VEC));
+
+    MB_TRANSPOSE (rows);
+
+    for (int w = 0; w < MB_LANES; w++) x[g + w] ^= rows[w];
+  }
+}
+
+static inline MB_TARGET void MB_FN (store_block) (const MB_VEC x[16], u32 *const p[MB_LANES])
+{
+  for (int g = 0; g < 16; g += MB_LANES)
+  {
+    MB_VEC rows[MB_LANES];
+
+    for (int w = 0; w < MB_LANES; w++) rows[w] = x[g + w];
+
+    MB_TRANSPOSE (rows);
+
+    for (int l = 0; l < MB_LANES; l++) memcpy (p[l] + g, &rows[l], sizeof (MB_VEC));
+  }
+}
+
+// B[lane] = ROMix (B[lane]), V holds N * 32r words per lane, XY holds 2 * 32r vectors
+
+static MB_TARGET void MB_FN (romix) (u32 **B, u32 *V, MB_VEC *XY, const u32 N, const u32 r)
+{
+  const u32 blocks      = 2 * r;
+  const u32 chunk_words = 16 * blocks;
+
+  MB_VEC *X = XY;
+  MB_VEC *Y = XY + chunk_words;
+
+  u32 *p[MB_LANES];
+
+  for (u32 b = 0; b < blocks; b++)
+  {
+    for (int l = 0; l < MB_LANES; l++) p[l] = B[l] + b * 16;
+
+    MB_FN (load_block) (X + b * 16, p);
+  }
+
+  // V_i = X, X = BlockMix (X)
+
+  for (u32 i = 0; i < N; i++)
+  {
+    for (u32 b = 0; b < blocks; b++)
+    {
+      for (int l = 0; l < MB_LANES; l++) p[l] = V + (((u64) l * N) + i) * chunk_words + b * 16;
+
+      MB_FN (store_block) (X + b * 16, p);
+    }
+
+    MB_FN (blockmix) (Y, X, r);
+
+    MB_VEC *T = X; X = Y; Y = T;
+  }
+
+  // j = Integerify (X) mod N, X = BlockMix (X ^ V_j)
+
+  for (u32 i = 0; i < N; i++)
+  {
+    u32 j[MB_LANES];
+
+    memcpy (j, &X[(blocks - 1) * 16], sizeof (j));
+
+    for (u32 b = 0; b < blocks; b++)
+    {
+      for (int l = 0; l < MB_LANES; l++) p[l] = V + (((u64) l * N) + (j[l] & (N - 1))) * chunk_words + b * 16;
+
+      MB_FN (xor_block) (X + b * 16, p);
+    }
+
+    MB_FN (blockmix) (Y, X, r);
+
+    MB_VEC *T = X; X = Y; Y = T;
+  }
+
+  for (u32 b = 0; b < blocks; b++)
+  {
+    for (int l = 0; l < MB_LANES; l++) p[l] = B[l] + b * 16;
+
+    MB_FN (store_block) (X + b * 16, p);
+  }
+}
@@ -20,6 +20,9 @@
 #define DICTSTAT_FILENAME "hashcat.dictstat2"
 #define DICTSTAT_VERSION  (0x6863646963743200 | 0x03)
 
+#define DICTSTAT_IDX_FOLDER  "dictstat"
+#define DICTSTAT_IDX_VERSION (0x6863696478000000 | 0x01)
+
 int sort_by_dictstat (const void *s1, const void *s2);
 
 int  dictstat_init    (hashcat_ctx_t *hashcat_ctx);
@@ -29,4 +32,8 @@ int  dictstat_write   (hashcat_ctx_t *hashcat_ctx);
 u64  dictstat_find    (hashcat_ctx_t *hashcat_ctx, dictstat_t *d);
 void dictstat_append  (hashcat_ctx_t *hashcat_ctx, dictstat_t *d);
 
+void                  dictstat_idx_add  (hashcat_ctx_t *hashcat_ctx, const char *dictfile, const dictstat_t *d, dictstat_chkpt_t *chkpts, const u64 chkpts_cnt);
+void                  dictstat_idx_load (hashcat_ctx_t *hashcat_ctx, const char *dictfile, const dictstat_t *d);
+const dictstat_idx_t *dictstat_idx_find (hashcat_ctx_t *hashcat_ctx, const char *dictfile);
+
 #endif // HC_DICTSTAT_H
@@ -0,0 +1,41 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+#ifndef HC_EXT_LZ4_H
+#define HC_EXT_LZ4_H
+
+/**
+ * from lz4frame.h (lz4 1.9), liblz4 is loaded at runtime
+ */
+
+#define LZ4F_MAGICNUMBER  0x184D2204
+#define LZ4F_VERSION      100
+
+typedef struct LZ4F_dctx_s LZ4F_dctx;
+
+typedef size_t LZ4F_errorCode_t;
+
+typedef LZ4F_errorCode_t (*HC_LZ4F_CREATEDECOMPRESSIONCONTEXT) (LZ4F_dctx **, unsigned);
+typedef LZ4F_errorCode_t (*HC_LZ4F_FREEDECOMPRESSIONCONTEXT)   (LZ4F_dctx *);
+typedef size_t           (*HC_LZ4F_DECOMPRESS)                 (LZ4F_dctx *, void *, size_t *, const void *, size_t *, const void *);
+typedef unsigned         (*HC_LZ4F_ISERROR)                    (LZ4F_errorCode_t);
+
+typedef struct hc_lz4_lib
+{
+  hc_dynlib_t lib;
+
+  HC_LZ4F_CREATEDECOMPRESSIONCONTEXT  LZ4F_createDecompressionContext;
+  HC_LZ4F_FREEDECOMPRESSIONCONTEXT    LZ4F_freeDecompressionContext;
+  HC_LZ4F_DECOMPRESS                  LZ4F_decompress;
+  HC_LZ4F_ISERROR                     LZ4F_isError;
+
+} hc_lz4_lib_t;
+
+typedef hc_lz4_lib_t LZ4_PTR;
+
+int  lz4_init  (LZ4_PTR *lz4);
+void lz4_close (LZ4_PTR *lz4);
+
+#endif // HC_EXT_LZ4_H
@@ -0,0 +1,69 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+#ifndef HC_EXT_ZSTD_H
+#define HC_EXT_ZSTD_H
+
+/**
+ * from zstd.h (zstd 1.5), libzstd is loaded at runtime
+ */
+
+#define ZSTD_MAGICNUMBER            0xFD2FB528
+#define ZSTD_MAGIC_SKIPPABLE_START  0x184D2A50
+
+// seekable format (contrib/seekable_format), the seek table is a skippable frame at the end of the file
+
+#define ZSTD_SEEKABLE_MAGICNUMBER   0x8F92EAB1
+#define ZSTD_SEEKABLE_SKIPPABLE     0x184D2A5E
+#define ZSTD_SEEKABLE_FOOTER_SIZE   9
+
+typedef struct ZSTD_DCtx_s ZSTD_DStream;
+
+typedef struct ZSTD_inBuffer_s
+{
+  const void *src;
+  size_t      size;
+  size_t      pos;
+
+} ZSTD_inBuffer;
+
+typedef struct ZSTD_outBuffer_s
+{
+  void       *dst;
+  size_t      size;
+  size_t      pos;
+
+} ZSTD_outBuffer;
+
+typedef ZSTD_DStream *(*HC_ZSTD_CREATEDSTREAM)    (void);
+typedef size_t        (*HC_ZSTD_FREEDSTREAM)      (ZSTD_DStream *);
+typedef size_t        (*HC_ZSTD_INITDSTREAM)      (ZSTD_DStream *);
+typedef size_t        (*HC_ZSTD_DECOMPRESSSTREAM) (ZSTD_DStream *, ZSTD_outBuffer *, ZSTD_inBuffer *);
+typedef size_t        (*HC_ZSTD_DECOMPRESS)       (void *, size_t, const void *, size_t);
+typedef size_t        (*HC_ZSTD_DSTREAMINSIZE)    (void);
+typedef size_t        (*HC_ZSTD_DSTREAMOUTSIZE)   (void);
+typedef unsigned      (*HC_ZSTD_ISERROR)          (size_t);
+
+typedef struct hc_zstd_lib
+{
+  hc_dynlib_t lib;
+
+  HC_ZSTD_CREATEDSTREAM     ZSTD_createDStream;
+  HC_ZSTD_FREEDSTREAM       ZSTD_freeDStream;
+  HC_ZSTD_INITDSTREAM       ZSTD_initDStream;
+  HC_ZSTD_DECOMPRESSSTREAM  ZSTD_decompressStream;
+  HC_ZSTD_DECOMPRESS        ZSTD_decompress;
+  HC_ZSTD_DSTREAMINSIZE     ZSTD_DStreamInSize;
+  HC_ZSTD_DSTREAMOUTSIZE    ZSTD_DStreamOutSize;
+  HC_ZSTD_ISERROR           ZSTD_isError;
+
+} hc_zstd_lib_t;
+
+typedef hc_zstd_lib_t ZSTD_PTR;
+
+int  zstd_init  (ZSTD_PTR *zstd);
+void zstd_close (ZSTD_PTR *zstd);
+
+#endif // HC_EXT_ZSTD_H
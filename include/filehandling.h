@@ -20,6 +20,7 @@ bool   hc_fopen_raw (HCFILE *fp, const char *path, const char *mode);
 int    hc_fscanf    (HCFILE *fp, const char *format, void *ptr);
 int    hc_fprintf   (HCFILE *fp, const char *format, ...);
 int    hc_vfprintf  (HCFILE *fp, const char *format, va_list ap);
+bool   hc_fseekable (const HCFILE *fp);
 int    hc_fseek     (HCFILE *fp, off_t offset, int whence);
 void   hc_rewind    (HCFILE *fp);
 int    hc_fstat     (HCFILE *fp, struct stat *buf);
@@ -34,6 +35,17 @@ char  *hc_fgets     (char *buf, int len, HCFILE *fp);
 size_t hc_fwrite    (const void *ptr, size_t size, size_t nmemb, HCFILE *fp);
 size_t hc_fread     (void *ptr, size_t size, size_t nmemb, HCFILE *fp);
 
+bool   hc_fread_ahead (HCFILE *fp, const u32 blocks_cnt, const size_t block_size);
+
+bool   hc_fmap        (HCFILE *fp);
+char  *hc_fmap_window (HCFILE *fp, const size_t max_len, size_t *len);
+void   hc_fmap_drop   (const HCFILE *fp, const u64 offset, const u64 len);
+
+void   hc_line_reader_init    (hc_line_reader_t *lr, HCFILE *fp, const size_t line_sz);
+bool   hc_line_reader_next    (hc_line_reader_t *lr, char **line_buf, size_t *line_len);
+off_t  hc_line_reader_tell    (hc_line_reader_t *lr);
+void   hc_line_reader_destroy (hc_line_reader_t *lr);
+
 size_t fgetl        (HCFILE *fp, char *line_buf, const size_t line_sz);
 u64    count_lines  (HCFILE *fp);
 size_t in_superchop (char *buf);
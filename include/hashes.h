@@ -6,6 +6,12 @@
 #ifndef HC_HASHES_H
 #define HC_HASHES_H
 
+#define INCR_HASHLIST_ERRORS 1000
+
+#define HASHLIST_CHUNK_SIZE (1024 * 1024)
+
+#define HASHLIST_RADIX_MIN (64 * 1024)
+
 int sort_by_digest_p0p1  (const void *v1, const void *v2, void *v3);
 int sort_by_salt         (const void *v1, const void *v2);
 int sort_by_hash         (const void *v1, const void *v2, void *v3);
@@ -28,6 +34,7 @@ int hashes_init_stage4    (hashcat_ctx_t *hashcat_ctx);
 int hashes_init_stage5    (hashcat_ctx_t *hashcat_ctx);
 int hashes_init_selftest  (hashcat_ctx_t *hashcat_ctx);
 int hashes_init_benchmark (hashcat_ctx_t *hashcat_ctx);
+int hashes_init_digests_idx (hashcat_ctx_t *hashcat_ctx);
 int hashes_init_zerohash  (hashcat_ctx_t *hashcat_ctx);
 
 void hashes_destroy (hashcat_ctx_t *hashcat_ctx);
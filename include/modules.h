@@ -87,5 +87,6 @@ int         module_build_plain_postprocess  (MAYBE_UNUSED const hashconfig_t *ha
 bool        module_unstable_warning         (MAYBE_UNUSED const hashconfig_t *hashconfig, MAYBE_UNUSED const user_options_t *user_options, MAYBE_UNUSED const user_options_extra_t *user_options_extra, MAYBE_UNUSED const hc_device_param_t *device_param);
 
 bool        module_potfile_custom_check     (MAYBE_UNUSED const hashconfig_t *hashconfig, MAYBE_UNUSED const hash_t *db, MAYBE_UNUSED const hash_t *entry_hash, MAYBE_UNUSED const void *entry_tmps);
+u64         module_potfile_custom_key       (MAYBE_UNUSED const hashconfig_t *hashconfig, MAYBE_UNUSED const hash_t *hash);
 
 #endif // HC_MODULES_H
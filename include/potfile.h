@@ -9,10 +9,11 @@
 #include <stdio.h>
 #include <stddef.h>
 #include <errno.h>
-#include <search.h>
 
 #define INCR_POT 1000
 
+#define POTFILE_CHUNK_SIZE (1024 * 1024)
+
 int  potfile_init             (hashcat_ctx_t *hashcat_ctx);
 int  potfile_read_open        (hashcat_ctx_t *hashcat_ctx);
 void potfile_read_close       (hashcat_ctx_t *hashcat_ctx);
@@ -25,11 +26,13 @@ int  potfile_handle_show      (hashcat_ctx_t *hashcat_ctx);
 int  potfile_handle_left      (hashcat_ctx_t *hashcat_ctx);
 
 void potfile_update_hash      (hashcat_ctx_t *hashcat_ctx, hash_t *found,  char *line_pw_buf, int line_pw_len);
-void potfile_update_hashes    (hashcat_ctx_t *hashcat_ctx, hash_t *hash_buf, char *line_pw_buf, int line_pw_len, pot_tree_entry_t *tree);
+void potfile_update_hashes    (hashcat_ctx_t *hashcat_ctx, hash_t *hash_buf, char *line_pw_buf, int line_pw_len, const pot_hash_index_t *index, const bool all);
 
-void pot_tree_destroy      (pot_tree_entry_t *tree);
+void    pot_hash_index_init    (pot_hash_index_t *index, hash_t *hashes_buf, const u32 hashes_cnt, const hashconfig_t *hashconfig);
+void    pot_hash_index_destroy (pot_hash_index_t *index);
+hash_t *pot_hash_index_find    (const pot_hash_index_t *index, const hash_t *hash_buf);
 
-int  sort_pot_tree_by_hash (const void *v1, const void *v2);
+int  sort_pot_custom_key   (const void *v1, const void *v2);
 int  sort_pot_orig_line    (const void *v1, const void *v2);
 
 #endif // HC_POTFILE_H
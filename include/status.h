@@ -64,6 +64,8 @@ double      status_get_progress_finished_percent      (const hashcat_ctx_t *hash
 u64         status_get_progress_done                  (const hashcat_ctx_t *hashcat_ctx);
 u64         status_get_progress_rejected              (const hashcat_ctx_t *hashcat_ctx);
 double      status_get_progress_rejected_percent      (const hashcat_ctx_t *hashcat_ctx);
+u64         status_get_bitmap_fp                      (const hashcat_ctx_t *hashcat_ctx);
+double      status_get_bitmap_fp_percent              (const hashcat_ctx_t *hashcat_ctx);
 u64         status_get_progress_restored              (const hashcat_ctx_t *hashcat_ctx);
 u64         status_get_progress_cur                   (const hashcat_ctx_t *hashcat_ctx);
 u64         status_get_progress_end                   (const hashcat_ctx_t *hashcat_ctx);
@@ -103,6 +105,7 @@ char       *status_get_brain_link_recv_bytes_sec_dev  (const hashcat_ctx_t *hash
 char       *status_get_brain_link_send_bytes_sec_dev  (const hashcat_ctx_t *hashcat_ctx, const int backend_devices_idx);
 char       *status_get_brain_rx_all                   (const hashcat_ctx_t *hashcat_ctx);
 char       *status_get_brain_tx_all                   (const hashcat_ctx_t *hashcat_ctx);
+double      status_get_brain_wait_all                 (const hashcat_ctx_t *hashcat_ctx);
 #endif
 #if defined(__APPLE__)
 char       *status_get_hwmon_fan_dev                  (const hashcat_ctx_t *hashcat_ctx);
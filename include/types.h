@@ -702,6 +702,9 @@ typedef enum user_options_defaults
   BENCHMARK_MAX            = 99999,
   BENCHMARK_MIN            = 0,
   BENCHMARK                = false,
+  BITMAP_BLOOM             = false,
+  BITMAP_BLOOM_FPR         = 16,
+  BITMAP_FP_COUNT          = false,
   BITMAP_MAX               = 18,
   BITMAP_MIN               = 16,
   #ifdef WITH_BRAIN
@@ -714,6 +717,7 @@ typedef enum user_options_defaults
   COLOR_CRACKED            = false,
   DEBUG_MODE               = 0,
   DEPRECATED_CHECK         = true,
+  DIGESTS_INDEX            = true,
   DYNAMIC_X                = false,
   FORCE                    = false,
   HWMON                    = true,
@@ -797,6 +801,8 @@ typedef enum user_options_defaults
   VERACRYPT_PIM_START      = 485,
   VERACRYPT_PIM_STOP       = 485,
   WORDLIST_AUTOHEX         = true,
+  WORDLIST_READ_AHEAD      = 8,
+  WORDLIST_READ_AHEAD_SIZE = 4,
   WORKLOAD_PROFILE         = 2,
 
 } user_options_defaults_t;
@@ -819,6 +825,9 @@ typedef enum user_options_map
   IDX_BENCHMARK_MAX             = 0xff56,
   IDX_BENCHMARK_MIN             = 0xff57,
   IDX_BENCHMARK                 = 'b',
+  IDX_BITMAP_BLOOM              = 0xff88,
+  IDX_BITMAP_BLOOM_FPR          = 0xff89,
+  IDX_BITMAP_FP_COUNT           = 0xff8a,
   IDX_BITMAP_MAX                = 0xff07,
   IDX_BITMAP_MIN                = 0xff08,
   #ifdef WITH_BRAIN
@@ -851,6 +860,7 @@ typedef enum user_options_map
   IDX_DEBUG_FILE                = 0xff12,
   IDX_DEBUG_MODE                = 0xff13,
   IDX_DEPRECATED_CHECK_DISABLE  = 0xff14,
+  IDX_DIGESTS_INDEX_DISABLE     = 0xff8b,
   IDX_DYNAMIC_X                 = 0xff55,
   IDX_ENCODING_FROM             = 0xff15,
   IDX_ENCODING_TO               = 0xff16,
@@ -940,6 +950,8 @@ typedef enum user_options_map
   IDX_VERSION_LOWER             = 'v',
   IDX_VERSION                   = 'V',
   IDX_WORDLIST_AUTOHEX_DISABLE  = 0xff54,
+  IDX_WORDLIST_READ_AHEAD       = 0xff86,
+  IDX_WORDLIST_READ_AHEAD_SIZE  = 0xff87,
   IDX_WORKLOAD_PROFILE          = 'w',
 
 } user_options_map_t;
@@ -1076,6 +1088,9 @@ typedef struct hashes
   void        *digests_buf;
   u32         *digests_shown;
 
+  u32         *digests_idx;      // bucket index, copied behind digests_buf to the device (see hashes_init_digests_idx ())
+  u32          digests_idx_bits; // 0 = no index, binary search over all digests
+
   u32          salts_cnt;
   u32          salts_done;
 
@@ -1220,6 +1235,8 @@ typedef struct link_speed
 // file handling
 
 typedef struct xzfile xzfile_t;
+typedef struct zfile  zfile_t;
+typedef struct hc_fra hc_fra_t;
 
 typedef struct hc_fp
 {
@@ -1229,6 +1246,14 @@ typedef struct hc_fp
   gzFile      gfp; //  gzip fp
   unzFile     ufp; //   zip fp
   xzfile_t   *xfp; //    xz fp
+  zfile_t    *zfp; // zstd/lz4 fp
+
+  hc_fra_t   *rfp; // read-ahead (compressed files only, see hc_fread_ahead)
+
+  char       *mfp; //  mmap fp (plain files only, see hc_fmap)
+  u64         mfp_len;
+  u64         mfp_pos;
+  u64         mfp_rel;
 
   int         bom_size;
 
@@ -1239,6 +1264,19 @@ typedef struct hc_fp
 
 } HCFILE;
 
+typedef struct hc_line_reader
+{
+  HCFILE *fp;
+
+  char   *buf;
+  size_t  buf_sz;  // longest line, longer lines are truncated just like fgetl () does
+  size_t  buf_len;
+  size_t  buf_pos;
+
+  bool    eof;
+
+} hc_line_reader_t;
+
 #include "ext_nvrtc.h"
 #include "ext_hiprtc.h"
 
@@ -1450,6 +1488,13 @@ typedef struct hc_device_param
   u64  size_brain_link_out;
 
   int           brain_link_client_fd;
+  int           brain_link_client_fd_next;    // second link for the pipelined lookups
+  bool          brain_link_async;
+  hc_thread_t   brain_link_lookup_thread;
+  bool          brain_link_lookup_active;
+  bool          brain_link_lookup_rc;
+  const struct status_ctx *brain_link_lookup_status_ctx;
+  double        brain_link_wait_ms;           // time calc () spent waiting on the brain server
   link_speed_t  brain_link_recv_speed;
   link_speed_t  brain_link_send_speed;
   bool          brain_link_recv_active;
@@ -1482,6 +1527,9 @@ typedef struct hc_device_param
   u64     words_off;
   u64     words_done;
 
+  u64     bitmap_fp; // candidates passing the bitmaps without matching a digest, only counted with --bitmap-fp-count
+  u32     bitmap_gen; // generation of the bitmaps on the device, compared with bitmap_ctx->bitmap_gen
+
   u64     outerloop_pos;
   u64     outerloop_left;
   double  outerloop_msec;
@@ -2190,6 +2238,24 @@ typedef struct dictstat
 
 } dictstat_t;
 
+typedef struct dictstat_chkpt
+{
+  u64 offset; // byte offset of a line start in the wordlist
+  u64 words;  // number of words (as returned by get_next_word) before that line
+
+} dictstat_chkpt_t;
+
+typedef struct dictstat_idx
+{
+  char *dictfile;
+
+  dictstat_t d;
+
+  dictstat_chkpt_t *chkpts;
+  u64               chkpts_cnt;
+
+} dictstat_idx_t;
+
 typedef struct hashdump
 {
   int version;
@@ -2212,6 +2278,13 @@ typedef struct dictstat_ctx
   size_t cnt;
   #endif
 
+  // wordlist checkpoints collected by count_words (), in memory for this session and persisted in idx_folder
+
+  char *idx_folder;
+
+  dictstat_idx_t *idx;
+  u32             idx_cnt;
+
 } dictstat_ctx_t;
 
 typedef struct loopback_ctx
@@ -2269,31 +2342,40 @@ typedef struct potfile_ctx
 
 } potfile_ctx_t;
 
-// this is a linked list structure of all the hashes with the same "key" (hash or hash + salt)
+// open-addressing index over the loaded hashes, keyed by hash + salt (the same key sort_by_hash () compares)
+// there could be multiple hashes for each identical hash+salt combination
+// (e.g. same hashes, but different user names... with --show and --username we want to print all of them!)
+// that is why hashes with the same key are chained
 
-typedef struct pot_hash_node
+typedef struct pot_hash_index
 {
-  hash_t *hash_buf;
+  u32 *slots; // hashes_buf position + 1 of the most recently added hash of a key, 0 = empty
+  u32 *next;  // hashes_buf position + 1 of the next hash with the same key, 0 = end of chain
+  u64  mask;
 
-  struct pot_hash_node *next;
+  const hash_t       *hashes_buf;
+  const hashconfig_t *hashconfig;
 
-} pot_hash_node_t;
+} pot_hash_index_t;
 
-// Attention: this is only used when --show and --username are used together
-// there could be multiple entries for each identical hash+salt combination
-// (e.g. same hashes, but different user names... we want to print all of them!)
-// that is why we use a linked list here
+// a potfile line decoded by one of the potfile threads that matched a loaded hash
 
-typedef struct pot_tree_entry
+typedef struct pot_match
 {
-  pot_hash_node_t *nodes; // head of the linked list (under the field "hash_buf" it contains the sorting keys)
+  u32 hash_pos; // hashes_buf position of the head of the chain
+  u32 pw_len;
+  u64 pw_off;   // offset of the plain in the mapped potfile
 
-  // the hashconfig is required to distinguish between salted and non-salted hashes and to make sure
-  // we compare the correct dgst_pos0...dgst_pos3
+} pot_match_t;
 
-  hashconfig_t *hashconfig;
+// the key module_potfile_custom_key () returned for a loaded hash, used to find the candidates for module_potfile_custom_check ()
 
-} pot_tree_entry_t;
+typedef struct pot_custom_key
+{
+  u64 key;
+  u32 hash_pos;
+
+} pot_custom_key_t;
 
 typedef struct pot_orig_line_entry
 {
@@ -2398,21 +2480,36 @@ typedef struct tuning_db
 
 } tuning_db_t;
 
+typedef struct wl_word
+{
+  u64 off;
+  u64 len;
+
+} wl_word_t;
+
 typedef struct wl_data
 {
   bool enabled;
 
   char *buf;
+  char *seg; // current segment, either buf or a window into a mmap'd wordlist
   u64  incr;
   u64  avail;
   u64  cnt;
   u64  pos;
 
+  wl_word_t *words; // batch of (offset, length) pairs into seg, filled by split
+  u64        words_cnt;
+  u64        words_pos;
+
   bool    iconv_enabled;
   iconv_t iconv_ctx;
   char   *iconv_tmp;
 
-  void (*func) (char *, u64, u64 *, u64 *);
+  void (*func)     (char *, u64, u64 *, u64 *);
+  u64  (*split)    (const struct wl_data *, char *, u64 *, const u64, wl_word_t *, const u64);
+  u64  (*split_nl) (char *, u64 *, const u64, wl_word_t *, const u64);
+  void (*upper)    (char *, const u64);
 
 } wl_data_t;
 
@@ -2463,6 +2560,8 @@ typedef struct user_options
   bool         advice;
   bool         benchmark;
   bool         benchmark_all;
+  bool         bitmap_bloom;
+  bool         bitmap_fp_count;
   #ifdef WITH_BRAIN
   bool         brain_client;
   bool         brain_server;
@@ -2470,6 +2569,7 @@ typedef struct user_options
   bool         color_cracked;
   bool         force;
   bool         deprecated_check;
+  bool         digests_index;
   bool         dynamic_x;
   bool         hwmon;
   bool         hex_charset;
@@ -2558,6 +2658,7 @@ typedef struct user_options
   u32          backend_info;
   u32          benchmark_max;
   u32          benchmark_min;
+  u32          bitmap_bloom_fpr;
   u32          bitmap_max;
   u32          bitmap_min;
   #ifdef WITH_BRAIN
@@ -2597,6 +2698,8 @@ typedef struct user_options
   u32          metal_compiler_runtime;
   u32          scrypt_tmto;
   u32          segment_size;
+  u32          wordlist_read_ahead;
+  u32          wordlist_read_ahead_size;
   u32          status_timer;
   u32          stdin_timeout_abort;
   u32          usage;
@@ -2643,6 +2746,12 @@ typedef struct bitmap_ctx
   u32   bitmap_mask;
   u32   bitmap_shift1;
   u32   bitmap_shift2;
+  u32   bitmap_mode;  // 0 = bitmaps, 1 = blocked bloom filter (see bitmap.c)
+
+  double bitmap_fpr;  // expected false positive rate of the bloom filter
+
+  u32   bitmap_gen;         // incremented each time the bitmaps are rebuilt from the uncracked digests
+  u32   bitmap_digests_cnt; // digests in the bitmaps
 
   u32  *bitmap_s1_a;
   u32  *bitmap_s1_b;
@@ -2819,6 +2928,7 @@ typedef struct hashcat_status
   int         brain_attack;
   char       *brain_rx_all;
   char       *brain_tx_all;
+  double      brain_wait_all;
   #endif
   const char *status_string;
   int         status_number;
@@ -2849,6 +2959,8 @@ typedef struct hashcat_status
   u64         progress_ignore;
   u64         progress_rejected;
   double      progress_rejected_percent;
+  u64         bitmap_fp;
+  double      bitmap_fp_percent;
   u64         progress_restored;
   u64         progress_skip;
   u64         restore_point;
@@ -3152,6 +3264,7 @@ typedef struct module_ctx
   bool        (*module_unstable_warning)        (const hashconfig_t *, const user_options_t *, const user_options_extra_t *, const hc_device_param_t *);
 
   bool        (*module_potfile_custom_check)    (const hashconfig_t *, const hash_t *, const hash_t *, const void *);
+  u64         (*module_potfile_custom_key)      (const hashconfig_t *, const hash_t *);
 
   u64         (*module_bridge_type)             (const hashconfig_t *, const user_options_t *, const user_options_extra_t *);
   const char *(*module_bridge_name)             (const hashconfig_t *, const user_options_t *, const user_options_extra_t *);
@@ -3203,6 +3316,104 @@ typedef struct thread_param
 
 } thread_param_t;
 
+typedef struct pot_thread_param
+{
+  int tid;
+  int tsz;
+
+  hashcat_ctx_t *hashcat_ctx;
+
+  const pot_hash_index_t *index;
+
+  const char *map;
+  const u64  *chunks_off;
+  u64         chunks_cnt;
+
+  pot_match_t **chunks_matches;
+  u64          *chunks_matches_cnt;
+  bool         *chunks_done;
+
+  hc_thread_mutex_t *mux_done;
+
+} pot_thread_param_t;
+
+typedef struct hash_sort_rec
+{
+  u32 key[4]; // digest at dgst_pos0 .. dgst_pos3, least significant first
+  u32 hash_pos;
+
+} hash_sort_rec_t;
+
+typedef struct hash_sort_thread_param
+{
+  int tid;
+  int tsz;
+
+  const hash_sort_rec_t *src;
+        hash_sort_rec_t *dst;
+
+  u64  cnt;
+  u32  pass;
+  bool scatter;
+
+  u64 *hist; // 256 entries per thread, counts first and then scatter offsets
+
+} hash_sort_thread_param_t;
+
+typedef struct hashlist_parse_error
+{
+  u32   line_num;
+  int   parser_status;
+  bool  fmt_error;
+  char *line_buf; // already shortened for the terminal
+
+} hashlist_parse_error_t;
+
+typedef struct hashlist_thread_param
+{
+  int tid;
+  int tsz;
+
+  hashcat_ctx_t *hashcat_ctx;
+
+  u32 hashlist_format;
+
+  const char *map;
+  const u64  *chunks_off;
+  const u64  *chunks_line;
+  u64         chunks_cnt;
+
+  u64  slots_per_line;
+  u8  *lines_parsed;
+
+  hashlist_parse_error_t **chunks_errors;
+  u64                     *chunks_errors_cnt;
+  bool                    *chunks_done;
+
+  hc_thread_mutex_t *mux_done;
+
+} hashlist_thread_param_t;
+
+typedef struct wl_count_thread_param
+{
+  int tid;
+  int tsz;
+
+  hashcat_ctx_t hashcat_ctx; // private copy pointing to wl_data below
+  wl_data_t     wl_data;
+
+  const HCFILE *fp;
+
+  const u64 *chunks_off;
+  u64       *chunks_words;
+  u64       *chunks_words2;
+  u64        chunks_cnt;
+
+  u64  comp;
+  bool done;
+
+} wl_count_thread_param_t;
+
 typedef struct hook_thread_param
 {
   int tid;
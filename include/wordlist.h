@@ -15,13 +15,20 @@ void pw_pre_add  (hc_device_param_t *device_param, const u8 *pw_buf, const int p
 void pw_base_add (hc_device_param_t *device_param, pw_pre_t *pw_pre);
 void pw_add      (hc_device_param_t *device_param, const u8 *pw_buf, const int pw_len);
 
+#define WL_WORDS_MAX 4096
+
 void get_next_word_lm  (char *buf, u64 sz, u64 *len, u64 *off);
 void get_next_word_uc  (char *buf, u64 sz, u64 *len, u64 *off);
 void get_next_word_std (char *buf, u64 sz, u64 *len, u64 *off);
 
+u64  wl_split_func (const wl_data_t *wl_data, char *buf, u64 *pos, const u64 sz, wl_word_t *words, const u64 words_max);
+u64  wl_split_std  (const wl_data_t *wl_data, char *buf, u64 *pos, const u64 sz, wl_word_t *words, const u64 words_max);
+u64  wl_split_uc   (const wl_data_t *wl_data, char *buf, u64 *pos, const u64 sz, wl_word_t *words, const u64 words_max);
+
 void get_next_word   (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, char **out_buf, u32 *out_len);
 int  load_segment    (hashcat_ctx_t *hashcat_ctx, HCFILE *fp);
 int  count_words     (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, u64 *result);
+u64  skip_words      (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, u64 words_cur, const u64 words_off);
 
 int  wl_data_init    (hashcat_ctx_t *hashcat_ctx);
 void wl_data_destroy (hashcat_ctx_t *hashcat_ctx);
@@ -4086,8 +4086,129 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
   return 0;
 }
 
+// bitmap_ctx_update () rebuilt the bitmaps from the uncracked digests, upload them before the next kernel run
+
+static int run_copy_bitmaps (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  bitmap_ctx_t *bitmap_ctx = hashcat_ctx->bitmap_ctx;
+  status_ctx_t *status_ctx = hashcat_ctx->status_ctx;
+
+  int rc = 0;
+
+  hc_thread_mutex_lock (status_ctx->mux_display);
+
+  const u32 *bitmaps[8] =
+  {
+    bitmap_ctx->bitmap_s1_a,
+    bitmap_ctx->bitmap_s1_b,
+    bitmap_ctx->bitmap_s1_c,
+    bitmap_ctx->bitmap_s1_d,
+    bitmap_ctx->bitmap_s2_a,
+    bitmap_ctx->bitmap_s2_b,
+    bitmap_ctx->bitmap_s2_c,
+    bitmap_ctx->bitmap_s2_d,
+  };
+
+  if (device_param->is_cuda == true)
+  {
+    CUdeviceptr bitmaps_dev[8] =
+    {
+      device_param->cuda_d_bitmap_s1_a,
+      device_param->cuda_d_bitmap_s1_b,
+      device_param->cuda_d_bitmap_s1_c,
+      device_param->cuda_d_bitmap_s1_d,
+      device_param->cuda_d_bitmap_s2_a,
+      device_param->cuda_d_bitmap_s2_b,
+      device_param->cuda_d_bitmap_s2_c,
+      device_param->cuda_d_bitmap_s2_d,
+    };
+
+    for (int i = 0; i < 8; i++)
+    {
+      rc = hc_cuMemcpyHtoD (hashcat_ctx, bitmaps_dev[i], bitmaps[i], bitmap_ctx->bitmap_size);
+
+      if (rc == -1) break;
+    }
+  }
+
+  if (device_param->is_hip == true)
+  {
+    hipDeviceptr_t bitmaps_dev[8] =
+    {
+      device_param->hip_d_bitmap_s1_a,
+      device_param->hip_d_bitmap_s1_b,
+      device_param->hip_d_bitmap_s1_c,
+      device_param->hip_d_bitmap_s1_d,
+      device_param->hip_d_bitmap_s2_a,
+      device_param->hip_d_bitmap_s2_b,
+      device_param->hip_d_bitmap_s2_c,
+      device_param->hip_d_bitmap_s2_d,
+    };
+
+    for (int i = 0; i < 8; i++)
+    {
+      rc = hc_hipMemcpyHtoD (hashcat_ctx, bitmaps_dev[i], bitmaps[i], bitmap_ctx->bitmap_size);
+
+      if (rc == -1) break;
+    }
+  }
+
+  #if defined (__APPLE__)
+  if (device_param->is_metal == true)
+  {
+    mtl_mem_t bitmaps_dev[8] =
+    {
+      device_param->metal_d_bitmap_s1_a,
+      device_param->metal_d_bitmap_s1_b,
+      device_param->metal_d_bitmap_s1_c,
+      device_param->metal_d_bitmap_s1_d,
+      device_param->metal_d_bitmap_s2_a,
+      device_param->metal_d_bitmap_s2_b,
+      device_param->metal_d_bitmap_s2_c,
+      device_param->metal_d_bitmap_s2_d,
+    };
+
+    for (int i = 0; i < 8; i++)
+    {
+      rc = hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, bitmaps_dev[i], 0, bitmaps[i], bitmap_ctx->bitmap_size);
+
+      if (rc == -1) break;
+    }
+  }
+  #endif
+
+  if (device_param->is_opencl == true)
+  {
+    cl_mem bitmaps_dev[8] =
+    {
+      device_param->opencl_d_bitmap_s1_a,
+      device_param->opencl_d_bitmap_s1_b,
+      device_param->opencl_d_bitmap_s1_c,
+      device_param->opencl_d_bitmap_s1_d,
+      device_param->opencl_d_bitmap_s2_a,
+      device_param->opencl_d_bitmap_s2_b,
+      device_param->opencl_d_bitmap_s2_c,
+      device_param->opencl_d_bitmap_s2_d,
+    };
+
+    for (int i = 0; i < 8; i++)
+    {
+      rc = hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, bitmaps_dev[i], CL_TRUE, 0, bitmap_ctx->bitmap_size, bitmaps[i], 0, NULL, NULL);
+
+      if (rc == -1) break;
+    }
+  }
+
+  if (rc == 0) device_param->bitmap_gen = bitmap_ctx->bitmap_gen;
+
+  hc_thread_mutex_unlock (status_ctx->mux_display);
+
+  return rc;
+}
+
 int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 pws_pos, const u64 pws_cnt)
 {
+  bitmap_ctx_t          *bitmap_ctx         = hashcat_ctx->bitmap_ctx;
   combinator_ctx_t      *combinator_ctx     = hashcat_ctx->combinator_ctx;
   hashconfig_t          *hashconfig         = hashcat_ctx->hashconfig;
   hashes_t              *hashes             = hashcat_ctx->hashes;
@@ -4792,6 +4913,11 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
 
       check_cracked (hashcat_ctx, device_param);
 
+      if (device_param->bitmap_gen != bitmap_ctx->bitmap_gen)
+      {
+        if (run_copy_bitmaps (hashcat_ctx, device_param) == -1) return -1;
+      }
+
       if (status_ctx->run_thread_level2 == false) break;
     }
 
@@ -10887,7 +11013,9 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
     device_param->size_root_css   = size_root_css;
     device_param->size_markov_css = size_markov_css;
 
-    u64 size_results = sizeof (u32);
+    // number of cracks, followed by the bitmap false positives counted with --bitmap-fp-count
+
+    u64 size_results = 2 * sizeof (u32);
 
     device_param->size_results = size_results;
 
@@ -10906,6 +11034,10 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
     u64 size_shown   = (u64) hashes->digests_cnt * sizeof (u32);
     u64 size_digests = (u64) hashes->digests_cnt * (u64) hashconfig->dgst_size;
 
+    // the bucket index for the digest lookup is stored behind the digests in the same buffer (see find_hash_idx ())
+
+    u64 size_digests_idx = (hashes->digests_idx_bits > 0) ? ((1ULL << hashes->digests_idx_bits) + 1) * sizeof (u32) : 0;
+
     device_param->size_plains   = size_plains;
     device_param->size_digests  = size_digests;
     device_param->size_shown    = size_shown;
@@ -11940,6 +12072,7 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
       + bitmap_ctx->bitmap_size
       + size_plains
       + size_digests
+      + size_digests_idx
       + size_shown
       + size_salts
       + size_results
@@ -11979,7 +12112,7 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
       if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s2_c,    bitmap_ctx->bitmap_size) == -1) return -1;
       if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s2_d,    bitmap_ctx->bitmap_size) == -1) return -1;
       if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_plain_bufs,     size_plains)             == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_digests_buf,    size_digests)            == -1) return -1;
+      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_digests_buf,    size_digests + size_digests_idx) == -1) return -1;
       if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_digests_shown,  size_shown)              == -1) return -1;
       if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_salt_bufs,      size_salts)              == -1) return -1;
       if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_result,         size_results)            == -1) return -1;
@@ -12002,6 +12135,11 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
       if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_digests_buf, hashes->digests_buf,     size_digests)            == -1) return -1;
       if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_salt_bufs,   hashes->salts_buf,       size_salts)              == -1) return -1;
 
+      if (size_digests_idx > 0)
+      {
+        if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_digests_buf + size_digests, hashes->digests_idx, size_digests_idx) == -1) return -1;
+      }
+
       /**
        * special buffers
        */
@@ -12090,7 +12228,7 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
       if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s2_c,    bitmap_ctx->bitmap_size) == -1) return -1;
       if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s2_d,    bitmap_ctx->bitmap_size) == -1) return -1;
       if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_plain_bufs,     size_plains)             == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_digests_buf,    size_digests)            == -1) return -1;
+      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_digests_buf,    size_digests + size_digests_idx) == -1) return -1;
       if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_digests_shown,  size_shown)              == -1) return -1;
       if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_salt_bufs,      size_salts)              == -1) return -1;
       if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_result,         size_results)            == -1) return -1;
@@ -12113,6 +12251,11 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
       if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_digests_buf, hashes->digests_buf,     size_digests)            == -1) return -1;
       if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_salt_bufs,   hashes->salts_buf,       size_salts)              == -1) return -1;
 
+      if (size_digests_idx > 0)
+      {
+        if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_digests_buf + size_digests, hashes->digests_idx, size_digests_idx) == -1) return -1;
+      }
+
       /**
        * special buffers
        */
@@ -12202,7 +12345,7 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
       HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_c);
       HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_d);
       HC_MTL_CREATEBUFFER(hashcat_ctx, size_plains,             NULL, plain_bufs);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_digests,            NULL, digests_buf);
+      HC_MTL_CREATEBUFFER(hashcat_ctx, size_digests + size_digests_idx, NULL, digests_buf);
       HC_MTL_CREATEBUFFER(hashcat_ctx, size_shown,              NULL, digests_shown);
       HC_MTL_CREATEBUFFER(hashcat_ctx, size_salts,              NULL, salt_bufs);
       HC_MTL_CREATEBUFFER(hashcat_ctx, size_results,            NULL, result);
@@ -12225,6 +12368,11 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
       if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_digests_buf, 0, hashes->digests_buf,     size_digests)            == -1) return -1;
       if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_salt_bufs,   0, hashes->salts_buf,       size_salts)              == -1) return -1;
 
+      if (size_digests_idx > 0)
+      {
+        if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_digests_buf, size_digests, hashes->digests_idx, size_digests_idx) == -1) return -1;
+      }
+
       /**
        * special buffers
        */
@@ -12292,7 +12440,7 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
       HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_c);
       HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_d);
       HC_OCL_CREATEBUFFER(hashcat_ctx, size_plains,             NULL, plain_bufs);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_digests,            NULL, digests_buf);
+      HC_OCL_CREATEBUFFER(hashcat_ctx, size_digests + size_digests_idx, NULL, digests_buf);
       HC_OCL_CREATEBUFFER(hashcat_ctx, size_shown,              NULL, digests_shown);
       HC_OCL_CREATEBUFFER(hashcat_ctx, size_salts,              NULL, salt_bufs);
       HC_OCL_CREATEBUFFER(hashcat_ctx, size_results,            NULL, result);
@@ -12315,6 +12463,11 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
       if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_digests_buf, CL_TRUE, 0, size_digests,            hashes->digests_buf,     0, NULL, NULL) == -1) return -1;
       if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_salt_bufs,   CL_TRUE, 0, size_salts,              hashes->salts_buf,       0, NULL, NULL) == -1) return -1;
 
+      if (size_digests_idx > 0)
+      {
+        if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_digests_buf, CL_TRUE, size_digests, size_digests_idx, hashes->digests_idx, 0, NULL, NULL) == -1) return -1;
+      }
+
       /**
        * special buffers
        */
@@ -12389,6 +12542,11 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
     device_param->kernel_param.salt_repeat         = 0;
     device_param->kernel_param.combs_mode          = 0;
     device_param->kernel_param.salt_repeat         = 0;
+    device_param->kernel_param.bitmap_mode         = bitmap_ctx->bitmap_mode;
+    device_param->kernel_param.bitmap_count_fp     = (user_options->bitmap_fp_count == true) ? 1 : 0;
+    device_param->kernel_param.digests_idx_bits    = hashes->digests_idx_bits;
+
+    device_param->bitmap_gen = bitmap_ctx->bitmap_gen;
     device_param->kernel_param.pws_pos             = 0;
     device_param->kernel_param.gid_max             = 0;
 
@@ -16405,7 +16563,8 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
         if (bitmap_ctx->bitmap_size > undocumented_single_allocation_apple) memory_limit_hit = 1;
         if (size_bfs                > undocumented_single_allocation_apple) memory_limit_hit = 1;
         if (size_combs              > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_digests            > undocumented_single_allocation_apple) memory_limit_hit = 1;
+        if (size_digests
+          + size_digests_idx        > undocumented_single_allocation_apple) memory_limit_hit = 1;
         if (size_esalts             > undocumented_single_allocation_apple) memory_limit_hit = 1;
         if (size_hooks              > undocumented_single_allocation_apple) memory_limit_hit = 1;
         if (size_markov_css         > undocumented_single_allocation_apple) memory_limit_hit = 1;
@@ -16444,6 +16603,7 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
         + size_bfs
         + size_combs
         + size_digests
+        + size_digests_idx
         + size_esalts
         + size_hooks
         + size_markov_css
@@ -17363,6 +17523,8 @@ void backend_session_reset (hashcat_ctx_t *hashcat_ctx)
     device_param->words_off  = 0;
     device_param->words_done = 0;
 
+    device_param->bitmap_fp = 0;
+
     #if defined (_WIN)
     device_param->timer_speed.QuadPart = 0;
     #else
@@ -17371,6 +17533,10 @@ void backend_session_reset (hashcat_ctx_t *hashcat_ctx)
 
     device_param->kernel_power   = 0;
     device_param->hardware_power = 0;
+
+    #ifdef WITH_BRAIN
+    device_param->brain_link_wait_ms = 0;
+    #endif
   }
 
   backend_ctx->kernel_power_all   = 0;
@@ -7,9 +7,10 @@
 #include "types.h"
 #include "memory.h"
 #include "event.h"
+#include "bitops.h"
 #include "bitmap.h"
 
-static void selftest_to_bitmap (const u32 dgst_shifts, char *digests_buf_ptr, const u32 dgst_pos0, const u32 dgst_pos1, const u32 dgst_pos2, const u32 dgst_pos3, const u32 bitmap_mask, u32 *bitmap_a, u32 *bitmap_b, u32 *bitmap_c, u32 *bitmap_d)
+static void digest_to_bitmap (const u32 dgst_shifts, char *digests_buf_ptr, const u32 dgst_pos0, const u32 dgst_pos1, const u32 dgst_pos2, const u32 dgst_pos3, const u32 bitmap_mask, u32 *bitmap_a, u32 *bitmap_b, u32 *bitmap_c, u32 *bitmap_d)
 {
   u32 *digest_ptr = (u32 *) digests_buf_ptr;
 
@@ -70,6 +71,126 @@ static bool generate_bitmaps (const u32 digests_cnt, const u32 dgst_size, const
   return false;
 }
 
+// blocked bloom filter (split block variant): the lowest 3 bits of the first digest word select one of the 8 bitmap buffers,
+// the next bits a block of 8 words in there, and the remaining digest words set one bit in each of these words
+// it keeps a candidate to a single 32 byte read and is sized from digests_cnt instead of being capped by --bitmap-max
+// the same hashing is done in check () in OpenCL/inc_common.cl
+
+#define BLOOM_BLOCK_WORDS     8
+#define BLOOM_BLOCKS_BITS_MAX 23
+
+static const u32 BLOOM_SALT[BLOOM_BLOCK_WORDS] = { 0x47b6137b, 0x44974d91, 0x8824ad5b, 0xa2b7289d, 0x705495c7, 0x2df1424b, 0x9efc4947, 0x5c6bfb31 };
+
+static void bloom_insert (const u32 *digest_ptr, const u32 dgst_pos0, const u32 dgst_pos1, const u32 dgst_pos2, const u32 dgst_pos3, const u32 bitmap_mask, u32 **bitmaps)
+{
+  const u32 d0 = digest_ptr[dgst_pos0];
+
+  const u32 key = digest_ptr[dgst_pos1] ^ digest_ptr[dgst_pos2] ^ digest_ptr[dgst_pos3] ^ rotl32 (d0, 13);
+
+  u32 *block = bitmaps[d0 & 7] + (((d0 >> 3) & bitmap_mask) * BLOOM_BLOCK_WORDS);
+
+  for (int i = 0; i < BLOOM_BLOCK_WORDS; i++)
+  {
+    block[i] |= 1U << ((key * BLOOM_SALT[i]) >> 27);
+  }
+}
+
+// expected false positive rate, the digests per block follow a poisson distribution (evaluated in log space, lambda can be large)
+
+static double bloom_fpr (const u64 digests_cnt, const u64 blocks_cnt)
+{
+  if (digests_cnt == 0) return 0;
+
+  const double lambda = (double) digests_cnt / (double) blocks_cnt;
+
+  const double j_min = MAX (lambda - (10 * sqrt (lambda)) - 10, 0);
+  const double j_max = lambda + (10 * sqrt (lambda)) + 64;
+
+  double fpr = 0;
+
+  for (double j = floor (j_min); j <= j_max; j++)
+  {
+    const double p = exp ((j * log (lambda)) - lambda - lgamma (j + 1));
+
+    fpr += p * pow (1 - pow (1 - (1.0 / 32), j), BLOOM_BLOCK_WORDS);
+  }
+
+  return fpr;
+}
+
+static int bitmap_ctx_init_bloom (hashcat_ctx_t *hashcat_ctx)
+{
+  hashes_t       *hashes       = hashcat_ctx->hashes;
+  bitmap_ctx_t   *bitmap_ctx   = hashcat_ctx->bitmap_ctx;
+  hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+  user_options_t *user_options = hashcat_ctx->user_options;
+
+  const double fpr_max = 1.0 / (double) (1U << user_options->bitmap_bloom_fpr);
+
+  u32 bitmap_bits;
+
+  for (bitmap_bits = 0; bitmap_bits < BLOOM_BLOCKS_BITS_MAX; bitmap_bits++)
+  {
+    if (bloom_fpr (hashes->digests_cnt, 8ULL << bitmap_bits) <= fpr_max) break;
+  }
+
+  const double fpr = bloom_fpr (hashes->digests_cnt, 8ULL << bitmap_bits);
+
+  if (fpr > fpr_max)
+  {
+    event_log_warning (hashcat_ctx, "Bloom filter capped at %" PRIu64 " bytes, the expected false positive rate is %.2e.", (u64) (8ULL << bitmap_bits) * BLOOM_BLOCK_WORDS * sizeof (u32), fpr);
+    event_log_warning (hashcat_ctx, NULL);
+  }
+
+  const u32 bitmap_nums = (1U << bitmap_bits) * BLOOM_BLOCK_WORDS;
+  const u32 bitmap_mask = (1U << bitmap_bits) - 1;
+  const u32 bitmap_size = bitmap_nums * sizeof (u32);
+
+  u32 *bitmaps[8];
+
+  for (int i = 0; i < 8; i++)
+  {
+    bitmaps[i] = (u32 *) hccalloc (bitmap_nums, sizeof (u32));
+  }
+
+  char *digests_buf_ptr = (char *) hashes->digests_buf;
+
+  for (u32 i = 0; i < hashes->digests_cnt; i++)
+  {
+    bloom_insert ((const u32 *) digests_buf_ptr, hashconfig->dgst_pos0, hashconfig->dgst_pos1, hashconfig->dgst_pos2, hashconfig->dgst_pos3, bitmap_mask, bitmaps);
+
+    digests_buf_ptr += hashconfig->dgst_size;
+  }
+
+  if (hashconfig->st_hash != NULL)
+  {
+    bloom_insert ((const u32 *) hashes->st_digests_buf, hashconfig->dgst_pos0, hashconfig->dgst_pos1, hashconfig->dgst_pos2, hashconfig->dgst_pos3, bitmap_mask, bitmaps);
+  }
+
+  bitmap_ctx->bitmap_bits   = bitmap_bits;
+  bitmap_ctx->bitmap_nums   = bitmap_nums;
+  bitmap_ctx->bitmap_size   = bitmap_size;
+  bitmap_ctx->bitmap_mask   = bitmap_mask;
+  bitmap_ctx->bitmap_shift1 = 0;
+  bitmap_ctx->bitmap_shift2 = 0;
+  bitmap_ctx->bitmap_mode   = 1;
+  bitmap_ctx->bitmap_fpr    = fpr;
+
+  bitmap_ctx->bitmap_gen         = 0;
+  bitmap_ctx->bitmap_digests_cnt = hashes->digests_cnt;
+
+  bitmap_ctx->bitmap_s1_a   = bitmaps[0];
+  bitmap_ctx->bitmap_s1_b   = bitmaps[1];
+  bitmap_ctx->bitmap_s1_c   = bitmaps[2];
+  bitmap_ctx->bitmap_s1_d   = bitmaps[3];
+  bitmap_ctx->bitmap_s2_a   = bitmaps[4];
+  bitmap_ctx->bitmap_s2_b   = bitmaps[5];
+  bitmap_ctx->bitmap_s2_c   = bitmaps[6];
+  bitmap_ctx->bitmap_s2_d   = bitmaps[7];
+
+  return 0;
+}
+
 int bitmap_ctx_init (hashcat_ctx_t *hashcat_ctx)
 {
   hashes_t       *hashes       = hashcat_ctx->hashes;
@@ -91,6 +212,17 @@ int bitmap_ctx_init (hashcat_ctx_t *hashcat_ctx)
 
   bitmap_ctx->enabled = true;
 
+  if (user_options->bitmap_bloom == true)
+  {
+    if (bitmap_ctx_init_bloom (hashcat_ctx) == -1) return -1;
+
+    // drop the digests already cracked (potfile)
+
+    bitmap_ctx_update (hashcat_ctx);
+
+    return 0;
+  }
+
   /**
    * generate bitmap tables
    */
@@ -145,8 +277,8 @@ int bitmap_ctx_init (hashcat_ctx_t *hashcat_ctx)
 
   if (hashconfig->st_hash != NULL)
   {
-    selftest_to_bitmap (bitmap_shift1, (char *) hashes->st_digests_buf, hashconfig->dgst_pos0, hashconfig->dgst_pos1, hashconfig->dgst_pos2, hashconfig->dgst_pos3, bitmap_mask, bitmap_s1_a, bitmap_s1_b, bitmap_s1_c, bitmap_s1_d);
-    selftest_to_bitmap (bitmap_shift2, (char *) hashes->st_digests_buf, hashconfig->dgst_pos0, hashconfig->dgst_pos1, hashconfig->dgst_pos2, hashconfig->dgst_pos3, bitmap_mask, bitmap_s2_a, bitmap_s2_b, bitmap_s2_c, bitmap_s2_d);
+    digest_to_bitmap (bitmap_shift1, (char *) hashes->st_digests_buf, hashconfig->dgst_pos0, hashconfig->dgst_pos1, hashconfig->dgst_pos2, hashconfig->dgst_pos3, bitmap_mask, bitmap_s1_a, bitmap_s1_b, bitmap_s1_c, bitmap_s1_d);
+    digest_to_bitmap (bitmap_shift2, (char *) hashes->st_digests_buf, hashconfig->dgst_pos0, hashconfig->dgst_pos1, hashconfig->dgst_pos2, hashconfig->dgst_pos3, bitmap_mask, bitmap_s2_a, bitmap_s2_b, bitmap_s2_c, bitmap_s2_d);
   }
 
   bitmap_ctx->bitmap_bits   = bitmap_bits;
@@ -156,6 +288,9 @@ int bitmap_ctx_init (hashcat_ctx_t *hashcat_ctx)
   bitmap_ctx->bitmap_shift1 = bitmap_shift1;
   bitmap_ctx->bitmap_shift2 = bitmap_shift2;
 
+  bitmap_ctx->bitmap_gen         = 0;
+  bitmap_ctx->bitmap_digests_cnt = hashes->digests_cnt;
+
   bitmap_ctx->bitmap_s1_a   = bitmap_s1_a;
   bitmap_ctx->bitmap_s1_b   = bitmap_s1_b;
   bitmap_ctx->bitmap_s1_c   = bitmap_s1_c;
@@ -165,9 +300,101 @@ int bitmap_ctx_init (hashcat_ctx_t *hashcat_ctx)
   bitmap_ctx->bitmap_s2_c   = bitmap_s2_c;
   bitmap_ctx->bitmap_s2_d   = bitmap_s2_d;
 
+  // drop the digests already cracked (potfile)
+
+  bitmap_ctx_update (hashcat_ctx);
+
   return 0;
 }
 
+// rebuild the bitmaps from the uncracked digests each time their number halved, so cracked digests stop passing check ()
+// the digests keep their positions on the device, only the bitmaps change (same size, mask and shifts)
+// called with mux_display locked, the device threads upload the new generation in run_cracker ()
+
+#define BITMAP_UPDATE_MIN 1024
+
+void bitmap_ctx_update (hashcat_ctx_t *hashcat_ctx)
+{
+  bitmap_ctx_t *bitmap_ctx = hashcat_ctx->bitmap_ctx;
+  hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
+  hashes_t     *hashes     = hashcat_ctx->hashes;
+
+  if (bitmap_ctx->enabled == false) return;
+
+  if (hashconfig->opts_type & OPTS_TYPE_PT_NEVERCRACK) return;
+
+  const u32 digests_left = hashes->digests_cnt - hashes->digests_done;
+
+  if ((bitmap_ctx->bitmap_digests_cnt - digests_left) < BITMAP_UPDATE_MIN) return;
+
+  if (digests_left > (bitmap_ctx->bitmap_digests_cnt / 2)) return;
+
+  u32 *bitmaps[8] =
+  {
+    bitmap_ctx->bitmap_s1_a,
+    bitmap_ctx->bitmap_s1_b,
+    bitmap_ctx->bitmap_s1_c,
+    bitmap_ctx->bitmap_s1_d,
+    bitmap_ctx->bitmap_s2_a,
+    bitmap_ctx->bitmap_s2_b,
+    bitmap_ctx->bitmap_s2_c,
+    bitmap_ctx->bitmap_s2_d,
+  };
+
+  for (int i = 0; i < 8; i++)
+  {
+    memset (bitmaps[i], 0, bitmap_ctx->bitmap_size);
+  }
+
+  const u32 bitmap_mask   = bitmap_ctx->bitmap_mask;
+  const u32 bitmap_shift1 = bitmap_ctx->bitmap_shift1;
+  const u32 bitmap_shift2 = bitmap_ctx->bitmap_shift2;
+
+  const u32 dgst_pos0 = hashconfig->dgst_pos0;
+  const u32 dgst_pos1 = hashconfig->dgst_pos1;
+  const u32 dgst_pos2 = hashconfig->dgst_pos2;
+  const u32 dgst_pos3 = hashconfig->dgst_pos3;
+
+  char *digests_buf_ptr = (char *) hashes->digests_buf;
+
+  for (u32 i = 0; i < hashes->digests_cnt; i++, digests_buf_ptr += hashconfig->dgst_size)
+  {
+    if (hashes->digests_shown[i] == 1) continue;
+
+    if (bitmap_ctx->bitmap_mode == 1)
+    {
+      bloom_insert ((const u32 *) digests_buf_ptr, dgst_pos0, dgst_pos1, dgst_pos2, dgst_pos3, bitmap_mask, bitmaps);
+    }
+    else
+    {
+      digest_to_bitmap (bitmap_shift1, digests_buf_ptr, dgst_pos0, dgst_pos1, dgst_pos2, dgst_pos3, bitmap_mask, bitmaps[0], bitmaps[1], bitmaps[2], bitmaps[3]);
+      digest_to_bitmap (bitmap_shift2, digests_buf_ptr, dgst_pos0, dgst_pos1, dgst_pos2, dgst_pos3, bitmap_mask, bitmaps[4], bitmaps[5], bitmaps[6], bitmaps[7]);
+    }
+  }
+
+  if (hashconfig->st_hash != NULL)
+  {
+    if (bitmap_ctx->bitmap_mode == 1)
+    {
+      bloom_insert ((const u32 *) hashes->st_digests_buf, dgst_pos0, dgst_pos1, dgst_pos2, dgst_pos3, bitmap_mask, bitmaps);
+    }
+    else
+    {
+      digest_to_bitmap (bitmap_shift1, (char *) hashes->st_digests_buf, dgst_pos0, dgst_pos1, dgst_pos2, dgst_pos3, bitmap_mask, bitmaps[0], bitmaps[1], bitmaps[2], bitmaps[3]);
+      digest_to_bitmap (bitmap_shift2, (char *) hashes->st_digests_buf, dgst_pos0, dgst_pos1, dgst_pos2, dgst_pos3, bitmap_mask, bitmaps[4], bitmaps[5], bitmaps[6], bitmaps[7]);
+    }
+  }
+
+  if (bitmap_ctx->bitmap_mode == 1)
+  {
+    bitmap_ctx->bitmap_fpr = bloom_fpr (digests_left, 8ULL << bitmap_ctx->bitmap_bits);
+  }
+
+  bitmap_ctx->bitmap_digests_cnt = digests_left;
+
+  bitmap_ctx->bitmap_gen++;
+}
+
 void bitmap_ctx_destroy (hashcat_ctx_t *hashcat_ctx)
 {
   bitmap_ctx_t *bitmap_ctx = hashcat_ctx->bitmap_ctx;
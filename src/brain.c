@@ -999,22 +999,43 @@ bool brain_recv_all (int sockfd, void *buf, size_t len, int flags, hc_device_par
 
 bool brain_client_connect (hc_device_param_t *device_param, const status_ctx_t *status_ctx, const char *host, const int port, const char *password, u32 brain_session, u32 brain_attack, i64 passwords_max, u64 *highest)
 {
-  device_param->brain_link_client_fd   = 0;
-  device_param->brain_link_recv_bytes  = 0;
-  device_param->brain_link_send_bytes  = 0;
-  device_param->brain_link_recv_active = false;
-  device_param->brain_link_send_active = false;
+  device_param->brain_link_client_fd      = -1;
+  device_param->brain_link_client_fd_next = -1;
+  device_param->brain_link_recv_bytes     = 0;
+  device_param->brain_link_send_bytes     = 0;
+  device_param->brain_link_recv_active    = false;
+  device_param->brain_link_send_active    = false;
 
   memset (&device_param->brain_link_recv_speed, 0, sizeof (link_speed_t));
   memset (&device_param->brain_link_send_speed, 0, sizeof (link_speed_t));
 
+  device_param->brain_link_client_fd = brain_client_connect_link (device_param, status_ctx, host, port, password, brain_session, brain_attack, passwords_max, highest);
+
+  if (device_param->brain_link_client_fd == -1) return false;
+
+  // with pipelined lookups the batches alternate between two links, each link has its own short-term memory on the server
+
+  if (device_param->brain_link_async == true)
+  {
+    u64 highest_next = 0;
+
+    device_param->brain_link_client_fd_next = brain_client_connect_link (device_param, status_ctx, host, port, password, brain_session, brain_attack, passwords_max, &highest_next);
+
+    if (device_param->brain_link_client_fd_next == -1) return false;
+  }
+
+  return true;
+}
+
+int brain_client_connect_link (hc_device_param_t *device_param, const status_ctx_t *status_ctx, const char *host, const int port, const char *password, u32 brain_session, u32 brain_attack, i64 passwords_max, u64 *highest)
+{
   const int brain_link_client_fd = socket (AF_INET, SOCK_STREAM, 0);
 
   if (brain_link_client_fd == -1)
   {
     brain_logging (stderr, 0, "socket: %s\n", strerror (errno));
 
-    return false;
+    return -1;
   }
 
   #if defined (__linux__)
@@ -1026,7 +1047,7 @@ bool brain_client_connect (hc_device_param_t *device_param, const status_ctx_t *
 
     close (brain_link_client_fd);
 
-    return false;
+    return -1;
   }
   #else
 
@@ -1075,18 +1096,16 @@ bool brain_client_connect (hc_device_param_t *device_param, const status_ctx_t *
 
     close (brain_link_client_fd);
 
-    return false;
+    return -1;
   }
 
   if (connected == false)
   {
     close (brain_link_client_fd);
 
-    return false;
+    return -1;
   }
 
-  device_param->brain_link_client_fd = brain_link_client_fd;
-
   u32 brain_link_version = BRAIN_LINK_VERSION_CUR;
 
   if (brain_send (brain_link_client_fd, &brain_link_version, sizeof (brain_link_version), 0, NULL, NULL) == false)
@@ -1095,7 +1114,7 @@ bool brain_client_connect (hc_device_param_t *device_param, const status_ctx_t *
 
     close (brain_link_client_fd);
 
-    return false;
+    return -1;
   }
 
   u32 brain_link_version_ok = 0;
@@ -1106,7 +1125,7 @@ bool brain_client_connect (hc_device_param_t *device_param, const status_ctx_t *
 
     close (brain_link_client_fd);
 
-    return false;
+    return -1;
   }
 
   if (brain_link_version_ok == 0)
@@ -1115,7 +1134,7 @@ bool brain_client_connect (hc_device_param_t *device_param, const status_ctx_t *
 
     close (brain_link_client_fd);
 
-    return false;
+    return -1;
   }
 
   u32 challenge = 0;
@@ -1126,7 +1145,7 @@ bool brain_client_connect (hc_device_param_t *device_param, const status_ctx_t *
 
     close (brain_link_client_fd);
 
-    return false;
+    return -1;
   }
 
   u64 response = brain_auth_hash (challenge, password, strlen (password));
@@ -1137,7 +1156,7 @@ bool brain_client_connect (hc_device_param_t *device_param, const status_ctx_t *
 
     close (brain_link_client_fd);
 
-    return false;
+    return -1;
   }
 
   u32 password_ok = 0;
@@ -1148,7 +1167,7 @@ bool brain_client_connect (hc_device_param_t *device_param, const status_ctx_t *
 
     close (brain_link_client_fd);
 
-    return false;
+    return -1;
   }
 
   if (password_ok == 0)
@@ -1157,7 +1176,7 @@ bool brain_client_connect (hc_device_param_t *device_param, const status_ctx_t *
 
     close (brain_link_client_fd);
 
-    return false;
+    return -1;
   }
 
   if (brain_send (brain_link_client_fd, &brain_session, sizeof (brain_session), SEND_FLAGS, device_param, status_ctx) == false)
@@ -1166,7 +1185,7 @@ bool brain_client_connect (hc_device_param_t *device_param, const status_ctx_t *
 
     close (brain_link_client_fd);
 
-    return false;
+    return -1;
   }
 
   if (brain_send (brain_link_client_fd, &brain_attack, sizeof (brain_attack), SEND_FLAGS, device_param, status_ctx) == false)
@@ -1175,7 +1194,7 @@ bool brain_client_connect (hc_device_param_t *device_param, const status_ctx_t *
 
     close (brain_link_client_fd);
 
-    return false;
+    return -1;
   }
 
   if (brain_send (brain_link_client_fd, &passwords_max, sizeof (passwords_max), SEND_FLAGS, device_param, status_ctx) == false)
@@ -1184,7 +1203,7 @@ bool brain_client_connect (hc_device_param_t *device_param, const status_ctx_t *
 
     close (brain_link_client_fd);
 
-    return false;
+    return -1;
   }
 
   if (brain_recv (brain_link_client_fd, highest, sizeof (u64), 0, NULL, NULL) == false)
@@ -1193,20 +1212,40 @@ bool brain_client_connect (hc_device_param_t *device_param, const status_ctx_t *
 
     close (brain_link_client_fd);
 
-    return false;
+    return -1;
   }
 
-  return true;
+  return brain_link_client_fd;
 }
 
 void brain_client_disconnect (hc_device_param_t *device_param)
 {
+  // the lookup thread must be done with the links before they are closed
+
+  if (device_param->brain_link_lookup_active == true) brain_client_lookup_wait (device_param);
+
   if (device_param->brain_link_client_fd > 2)
   {
     close (device_param->brain_link_client_fd);
   }
 
-  device_param->brain_link_client_fd = -1;
+  if (device_param->brain_link_client_fd_next > 2)
+  {
+    close (device_param->brain_link_client_fd_next);
+  }
+
+  device_param->brain_link_client_fd      = -1;
+  device_param->brain_link_client_fd_next = -1;
+}
+
+void brain_client_swap (hc_device_param_t *device_param)
+{
+  if (device_param->brain_link_async == false) return;
+
+  const int brain_link_client_fd = device_param->brain_link_client_fd;
+
+  device_param->brain_link_client_fd      = device_param->brain_link_client_fd_next;
+  device_param->brain_link_client_fd_next = brain_link_client_fd;
 }
 
 bool brain_client_reserve (hc_device_param_t *device_param, const status_ctx_t *status_ctx, u64 words_off, u64 work, u64 *overlap)
@@ -1215,15 +1254,23 @@ bool brain_client_reserve (hc_device_param_t *device_param, const status_ctx_t *
 
   if (brain_link_client_fd == -1) return false;
 
+  hc_timer_t timer_wait;
+
+  hc_timer_set (&timer_wait);
+
   u8 operation = BRAIN_OPERATION_ATTACK_RESERVE;
 
-  if (brain_send (brain_link_client_fd, &operation, sizeof (operation), SEND_FLAGS, device_param, status_ctx) == false) return false;
-  if (brain_send (brain_link_client_fd, &words_off, sizeof (words_off),          0, device_param, status_ctx) == false) return false;
-  if (brain_send (brain_link_client_fd, &work,           sizeof (work),          0, device_param, status_ctx) == false) return false;
+  bool rc = true;
 
-  if (brain_recv (brain_link_client_fd, overlap,          sizeof (u64),          0, device_param, status_ctx) == false) return false;
+  if (rc == true) rc = brain_send (brain_link_client_fd, &operation, sizeof (operation), SEND_FLAGS, device_param, status_ctx);
+  if (rc == true) rc = brain_send (brain_link_client_fd, &words_off, sizeof (words_off),          0, device_param, status_ctx);
+  if (rc == true) rc = brain_send (brain_link_client_fd, &work,           sizeof (work),          0, device_param, status_ctx);
 
-  return true;
+  if (rc == true) rc = brain_recv (brain_link_client_fd, overlap,          sizeof (u64),          0, device_param, status_ctx);
+
+  device_param->brain_link_wait_ms += hc_timer_get (timer_wait);
+
+  return rc;
 }
 
 bool brain_client_commit (hc_device_param_t *device_param, const status_ctx_t *status_ctx)
@@ -1241,7 +1288,79 @@ bool brain_client_commit (hc_device_param_t *device_param, const status_ctx_t *s
   return true;
 }
 
+bool brain_client_commit_next (hc_device_param_t *device_param, const status_ctx_t *status_ctx)
+{
+  // the batch on the device was looked up on the other link, the current one belongs to the batch looked up right now.
+  // the lookup thread may be busy on the current link, so the link stats are left to it
+
+  if (device_param->pws_cnt == 0) return true;
+
+  const int brain_link_client_fd = device_param->brain_link_client_fd_next;
+
+  if (brain_link_client_fd == -1) return false;
+
+  u8 operation = BRAIN_OPERATION_COMMIT;
+
+  if (brain_send (brain_link_client_fd, &operation, sizeof (operation), SEND_FLAGS, NULL, status_ctx) == false) return false;
+
+  return true;
+}
+
 bool brain_client_lookup (hc_device_param_t *device_param, const status_ctx_t *status_ctx)
+{
+  hc_timer_t timer_wait;
+
+  hc_timer_set (&timer_wait);
+
+  const bool rc = brain_client_lookup_link (device_param, status_ctx);
+
+  device_param->brain_link_wait_ms += hc_timer_get (timer_wait);
+
+  return rc;
+}
+
+HC_API_CALL void *brain_client_lookup_thread (void *p)
+{
+  hc_device_param_t *device_param = (hc_device_param_t *) p;
+
+  device_param->brain_link_lookup_rc = brain_client_lookup_link (device_param, device_param->brain_link_lookup_status_ctx);
+
+  return NULL;
+}
+
+void brain_client_lookup_start (hc_device_param_t *device_param, const status_ctx_t *status_ctx)
+{
+  // the thread works on brain_link_out_buf and brain_link_in_buf only, calc () keeps its hands off them until brain_client_lookup_wait ()
+
+  device_param->brain_link_lookup_rc = true;
+
+  if (device_param->pws_pre_cnt == 0) return;
+
+  device_param->brain_link_lookup_status_ctx = status_ctx;
+
+  device_param->brain_link_lookup_active = true;
+
+  hc_thread_create (device_param->brain_link_lookup_thread, brain_client_lookup_thread, device_param);
+}
+
+bool brain_client_lookup_wait (hc_device_param_t *device_param)
+{
+  if (device_param->brain_link_lookup_active == false) return device_param->brain_link_lookup_rc;
+
+  hc_timer_t timer_wait;
+
+  hc_timer_set (&timer_wait);
+
+  hc_thread_wait (1, &device_param->brain_link_lookup_thread);
+
+  device_param->brain_link_wait_ms += hc_timer_get (timer_wait);
+
+  device_param->brain_link_lookup_active = false;
+
+  return device_param->brain_link_lookup_rc;
+}
+
+bool brain_client_lookup_link (hc_device_param_t *device_param, const status_ctx_t *status_ctx)
 {
   if (device_param->pws_pre_cnt == 0) return true;
 
@@ -1281,226 +1400,561 @@ void brain_server_db_hash_init (brain_server_db_hash_t *brain_server_db_hash, co
 {
   brain_server_db_hash->brain_session = brain_session;
 
-  brain_server_db_hash->hb           = 0;
-  brain_server_db_hash->long_cnt     = 0;
-  brain_server_db_hash->long_buf     = NULL;
-  brain_server_db_hash->long_alloc   = 0;
-  brain_server_db_hash->write_hashes = false;
+  brain_server_db_hash->long_cnt = 0;
 
-  hc_thread_mutex_init (brain_server_db_hash->mux_hr);
-  hc_thread_mutex_init (brain_server_db_hash->mux_hg);
-}
+  brain_server_db_hash->map_buf = NULL;
+  brain_server_db_hash->map_len = 0;
 
-bool brain_server_db_hash_realloc (brain_server_db_hash_t *brain_server_db_hash, const i64 new_long_cnt)
-{
-  if ((brain_server_db_hash->long_cnt + new_long_cnt) > brain_server_db_hash->long_alloc)
-  {
-    const i64 realloc_size_total = (i64) mydivc64 ((const u64) new_long_cnt, (const u64) BRAIN_SERVER_REALLOC_HASH_SIZE) * BRAIN_SERVER_REALLOC_HASH_SIZE;
+  snprintf (brain_server_db_hash->journal_file,     sizeof (brain_server_db_hash->journal_file),     "brain.%08x.ljnl",     brain_session);
+  snprintf (brain_server_db_hash->journal_file_old, sizeof (brain_server_db_hash->journal_file_old), "brain.%08x.ljnl.old", brain_session);
 
-    brain_server_hash_long_t *long_buf = (brain_server_hash_long_t *) hcrealloc (brain_server_db_hash->long_buf, brain_server_db_hash->long_alloc * sizeof (brain_server_hash_long_t), realloc_size_total * sizeof (brain_server_hash_long_t));
+  brain_server_db_hash->journal_open = false;
+  brain_server_db_hash->journal_size = 0;
+  brain_server_db_hash->dump_size    = 0;
 
-    if (long_buf == NULL) return false;
+  brain_server_db_hash->shard_buf = (brain_server_db_shard_t *) hccalloc (BRAIN_SERVER_HASH_SHARDS, sizeof (brain_server_db_shard_t));
 
-    brain_server_db_hash->long_buf    = long_buf;
-    brain_server_db_hash->long_alloc += realloc_size_total;
+  for (int shard_idx = 0; shard_idx < BRAIN_SERVER_HASH_SHARDS; shard_idx++)
+  {
+    brain_server_db_shard_t *brain_server_db_shard = &brain_server_db_hash->shard_buf[shard_idx];
+
+    hc_thread_mutex_init (brain_server_db_shard->mux_hr);
+    hc_thread_mutex_init (brain_server_db_shard->mux_hg);
   }
 
-  return true;
+  hc_thread_mutex_init (brain_server_db_hash->mux_hc);
+  hc_thread_mutex_init (brain_server_db_hash->mux_hj);
 }
 
 void brain_server_db_hash_free (brain_server_db_hash_t *brain_server_db_hash)
 {
-  hc_thread_mutex_delete (brain_server_db_hash->mux_hg);
-  hc_thread_mutex_delete (brain_server_db_hash->mux_hr);
+  if (brain_server_db_hash->journal_open == true)
+  {
+    hc_fclose (&brain_server_db_hash->journal_fp);
 
-  hcfree (brain_server_db_hash->long_buf);
+    brain_server_db_hash->journal_open = false;
+  }
+
+  hc_thread_mutex_delete (brain_server_db_hash->mux_hj);
+  hc_thread_mutex_delete (brain_server_db_hash->mux_hc);
+
+  for (int shard_idx = 0; shard_idx < BRAIN_SERVER_HASH_SHARDS; shard_idx++)
+  {
+    brain_server_db_shard_t *brain_server_db_shard = &brain_server_db_hash->shard_buf[shard_idx];
+
+    hc_thread_mutex_delete (brain_server_db_shard->mux_hg);
+    hc_thread_mutex_delete (brain_server_db_shard->mux_hr);
+
+    if (brain_server_db_shard->long_mapped == false) hcfree (brain_server_db_shard->long_buf);
+
+    hcfree (brain_server_db_shard->table_buf);
+  }
 
-  brain_server_db_hash->hb            = 0;
+  hcfree (brain_server_db_hash->shard_buf);
+
+  #if defined (_POSIX)
+  if (brain_server_db_hash->map_buf != NULL) munmap (brain_server_db_hash->map_buf, brain_server_db_hash->map_len);
+  #endif
+
+  brain_server_db_hash->map_buf       = NULL;
+  brain_server_db_hash->map_len       = 0;
+  brain_server_db_hash->shard_buf     = NULL;
   brain_server_db_hash->long_cnt      = 0;
-  brain_server_db_hash->long_buf      = NULL;
-  brain_server_db_hash->long_alloc    = 0;
-  brain_server_db_hash->write_hashes  = false;
+  brain_server_db_hash->journal_size  = 0;
+  brain_server_db_hash->dump_size     = 0;
   brain_server_db_hash->brain_session = 0;
 }
 
-void brain_server_db_attack_init (brain_server_db_attack_t *brain_server_db_attack, const u32 brain_attack)
+u32 brain_server_db_shard_idx (const u32 *hash)
 {
-  brain_server_db_attack->brain_attack = brain_attack;
-
-  brain_server_db_attack->ab            = 0;
-  brain_server_db_attack->short_cnt     = 0;
-  brain_server_db_attack->short_buf     = NULL;
-  brain_server_db_attack->short_alloc   = 0;
-  brain_server_db_attack->long_cnt      = 0;
-  brain_server_db_attack->long_buf      = NULL;
-  brain_server_db_attack->long_alloc    = 0;
-  brain_server_db_attack->write_attacks = false;
+  // the shards follow the sort order, hash[1] is the upper half
 
-  hc_thread_mutex_init (brain_server_db_attack->mux_ar);
-  hc_thread_mutex_init (brain_server_db_attack->mux_ag);
+  return hash[1] >> (32 - BRAIN_SERVER_HASH_SHARDS_BITS);
 }
 
-bool brain_server_db_attack_realloc (brain_server_db_attack_t *brain_server_db_attack, const i64 new_long_cnt, const i64 new_short_cnt)
+bool brain_server_db_shard_realloc (brain_server_db_shard_t *brain_server_db_shard, const i64 new_long_cnt)
 {
-  if ((brain_server_db_attack->long_cnt + new_long_cnt) > brain_server_db_attack->long_alloc)
+  if (brain_server_db_shard->long_mapped == true)
   {
-    const i64 realloc_size_total = (i64) mydivc64 ((const u64) new_long_cnt, (const u64) BRAIN_SERVER_REALLOC_ATTACK_SIZE) * BRAIN_SERVER_REALLOC_ATTACK_SIZE;
+    // the mapping is read-only, the shard moves to the heap and the page cache can drop its part of the dump
 
-    brain_server_attack_long_t *long_buf = (brain_server_attack_long_t *) hcrealloc (brain_server_db_attack->long_buf, brain_server_db_attack->long_alloc * sizeof (brain_server_attack_long_t), realloc_size_total * sizeof (brain_server_attack_long_t));
+    const i64 long_alloc = brain_server_db_shard->long_cnt + MAX (new_long_cnt, brain_server_db_shard->long_cnt / 4);
+
+    brain_server_hash_long_t *long_buf = (brain_server_hash_long_t *) hcmalloc (long_alloc * sizeof (brain_server_hash_long_t));
 
     if (long_buf == NULL) return false;
 
-    brain_server_db_attack->long_buf    = long_buf;
-    brain_server_db_attack->long_alloc += realloc_size_total;
+    memcpy (long_buf, brain_server_db_shard->long_buf, brain_server_db_shard->long_cnt * sizeof (brain_server_hash_long_t));
+
+    brain_server_db_shard->long_buf    = long_buf;
+    brain_server_db_shard->long_alloc  = long_alloc;
+    brain_server_db_shard->long_mapped = false;
   }
 
-  if ((brain_server_db_attack->short_cnt + new_short_cnt) > brain_server_db_attack->short_alloc)
+  if ((brain_server_db_shard->long_cnt + new_long_cnt) > brain_server_db_shard->long_alloc)
   {
-    const i64 realloc_size_total = (i64) mydivc64 ((const u64) new_short_cnt, (const u64) BRAIN_SERVER_REALLOC_ATTACK_SIZE) * BRAIN_SERVER_REALLOC_ATTACK_SIZE;
+    // grow by a quarter at least, a shard is compacted over and over again
 
-    brain_server_attack_short_t *short_buf = (brain_server_attack_short_t *) hcrealloc (brain_server_db_attack->short_buf, brain_server_db_attack->short_alloc * sizeof (brain_server_attack_short_t), realloc_size_total * sizeof (brain_server_attack_short_t));
+    const i64 realloc_size_min   = BRAIN_SERVER_REALLOC_HASH_SIZE / BRAIN_SERVER_HASH_SHARDS;
+    const i64 realloc_size_total = MAX ((i64) mydivc64 ((const u64) new_long_cnt, (const u64) realloc_size_min) * realloc_size_min, brain_server_db_shard->long_alloc / 4);
 
-    if (short_buf == NULL) return false;
+    brain_server_hash_long_t *long_buf = (brain_server_hash_long_t *) hcrealloc (brain_server_db_shard->long_buf, brain_server_db_shard->long_alloc * sizeof (brain_server_hash_long_t), realloc_size_total * sizeof (brain_server_hash_long_t));
 
-    brain_server_db_attack->short_buf    = short_buf;
-    brain_server_db_attack->short_alloc += realloc_size_total;
+    if (long_buf == NULL) return false;
+
+    brain_server_db_shard->long_buf    = long_buf;
+    brain_server_db_shard->long_alloc += realloc_size_total;
   }
 
   return true;
 }
 
-void brain_server_db_attack_free (brain_server_db_attack_t *brain_server_db_attack)
+bool brain_server_db_shard_table_put (u64 *table_buf, const i64 table_size, const u64 hash)
 {
-  hc_thread_mutex_delete (brain_server_db_attack->mux_ag);
-  hc_thread_mutex_delete (brain_server_db_attack->mux_ar);
+  // the hashes are XXH64, so the lower bits are good enough as index
 
-  hcfree (brain_server_db_attack->long_buf);
-  hcfree (brain_server_db_attack->short_buf);
+  for (i64 idx = (i64) (hash & (u64) (table_size - 1));; idx = (idx + 1) & (table_size - 1))
+  {
+    if (table_buf[idx] == hash) return false;
 
-  brain_server_db_attack->ab            = 0;
-  brain_server_db_attack->long_cnt      = 0;
-  brain_server_db_attack->long_buf      = NULL;
-  brain_server_db_attack->long_alloc    = 0;
-  brain_server_db_attack->short_cnt     = 0;
-  brain_server_db_attack->short_buf     = NULL;
-  brain_server_db_attack->short_alloc   = 0;
-  brain_server_db_attack->brain_attack  = 0;
-  brain_server_db_attack->write_attacks = false;
+    if (table_buf[idx] == 0)
+    {
+      table_buf[idx] = hash;
+
+      return true;
+    }
+  }
 }
 
-u64 brain_server_highest_attack (const brain_server_db_attack_t *buf)
+bool brain_server_db_shard_insert (brain_server_db_shard_t *brain_server_db_shard, const u32 *hash)
 {
-  const brain_server_attack_long_t  *long_buf  = buf->long_buf;
-  const brain_server_attack_short_t *short_buf = buf->short_buf;
+  const u64 hash64 = ((u64) hash[1] << 32) | hash[0];
 
-  const u64 long_cnt  = buf->long_cnt;
-  const u64 short_cnt = buf->short_cnt;
+  // keep the load factor below 3/4
 
-  u64 highest_long  = brain_server_highest_attack_long  (long_buf,  long_cnt,  0);
-  u64 highest_short = brain_server_highest_attack_short (short_buf, short_cnt, 0);
+  if (((brain_server_db_shard->table_cnt + 1) * 4) > (brain_server_db_shard->table_size * 3))
+  {
+    const i64 table_size = (brain_server_db_shard->table_size) ? brain_server_db_shard->table_size * 2 : BRAIN_SERVER_HASH_TABLE_MIN;
 
-  u64 highest = MAX (highest_long, highest_short);
+    u64 *table_buf = (u64 *) hccalloc (table_size, sizeof (u64));
 
-  highest_long  = brain_server_highest_attack_long  (long_buf,  long_cnt,  highest);
-  highest_short = brain_server_highest_attack_short (short_buf, short_cnt, highest);
+    if (table_buf == NULL) return false;
 
-  highest = MAX (highest_long, highest_short);
+    for (i64 idx = 0; idx < brain_server_db_shard->table_size; idx++)
+    {
+      if (brain_server_db_shard->table_buf[idx] == 0) continue;
 
-  return highest;
-}
+      brain_server_db_shard_table_put (table_buf, table_size, brain_server_db_shard->table_buf[idx]);
+    }
 
-u64 brain_server_highest_attack_long (const brain_server_attack_long_t *buf, const i64 cnt, const u64 start)
-{
-  u64 highest = start;
+    hcfree (brain_server_db_shard->table_buf);
 
-  for (i64 idx = 0; idx < cnt; idx++)
+    brain_server_db_shard->table_buf  = table_buf;
+    brain_server_db_shard->table_size = table_size;
+  }
+
+  // zero marks an empty slot of the table
+
+  if (hash64 == 0)
   {
-    const u64 offset = buf[idx].offset;
-    const u64 length = buf[idx].length;
+    if (brain_server_db_shard->table_zero == false)
+    {
+      brain_server_db_shard->table_zero = true;
 
-    if (offset > highest) break;
+      brain_server_db_shard->table_cnt++;
+    }
 
-    const u64 next = offset + length;
+    return true;
+  }
 
-    highest = MAX (highest, next);
+  if (brain_server_db_shard_table_put (brain_server_db_shard->table_buf, brain_server_db_shard->table_size, hash64) == true)
+  {
+    brain_server_db_shard->table_cnt++;
   }
 
-  return highest;
+  return true;
 }
 
-u64 brain_server_highest_attack_short (const brain_server_attack_short_t *buf, const i64 cnt, const u64 start)
+bool brain_server_db_shard_find (const brain_server_db_shard_t *brain_server_db_shard, const u32 *hash)
 {
-  u64 highest = start;
+  const u64 hash64 = ((u64) hash[1] << 32) | hash[0];
 
-  for (i64 idx = 0; idx < cnt; idx++)
+  if (hash64 == 0)
   {
-    const u64 offset = buf[idx].offset;
-    const u64 length = buf[idx].length;
-
-    if (offset > highest) break;
+    if (brain_server_db_shard->table_zero == true) return true;
+  }
+  else if (brain_server_db_shard->table_size)
+  {
+    const i64 table_mask = brain_server_db_shard->table_size - 1;
 
-    const u64 next = offset + length;
+    for (i64 idx = (i64) (hash64 & (u64) table_mask);; idx = (idx + 1) & table_mask)
+    {
+      if (brain_server_db_shard->table_buf[idx] == hash64) return true;
 
-    highest = MAX (highest, next);
+      if (brain_server_db_shard->table_buf[idx] == 0) break;
+    }
   }
 
-  return highest;
+  return (brain_server_find_hash_long (hash, brain_server_db_shard->long_buf, brain_server_db_shard->long_cnt) != -1);
 }
 
-u64 brain_server_find_attack_long (const brain_server_attack_long_t *buf, const i64 cnt, const u64 offset, const u64 length)
+bool brain_server_db_shard_compact (brain_server_db_shard_t *brain_server_db_shard)
 {
-  const u64 end = offset + length;
-
-  u64 overlap = 0;
+  const i64 table_cnt = brain_server_db_shard->table_cnt;
 
-  for (i64 idx = 0; idx < cnt; idx++)
-  {
-    const u64 element_length = buf[idx].length;
+  if (table_cnt == 0) return true;
 
-    if (element_length == 0) continue;
+  if (brain_server_db_shard_realloc (brain_server_db_shard, table_cnt) == false) return false;
 
-    const u64 element_start = buf[idx].offset;
-    const u64 element_end   = element_start + element_length;
+  // the table is dropped anyway, so its hashes are moved to the front and sorted in place,
+  // the u64 order is the same as the one of brain_server_sort_hash ()
 
-    const u64 start = offset + overlap;
+  u64 *table_buf = brain_server_db_shard->table_buf;
 
-    if (element_start > start) break; // we can't ever do it since this list is sorted
+  i64 sorted_cnt = 0;
 
-    if (element_end > start)
-    {
-      const u64 limited_end = MIN (end, element_end);
+  for (i64 idx = 0; idx < brain_server_db_shard->table_size; idx++)
+  {
+    const u64 hash64 = table_buf[idx];
 
-      overlap += limited_end - start;
+    if (hash64 == 0) continue;
 
-      if (overlap == length) break;
-    }
+    table_buf[sorted_cnt++] = hash64;
   }
 
-  return overlap;
-}
+  // the load factor leaves room for it
 
-u64 brain_server_find_attack_short (const brain_server_attack_short_t *buf, const i64 cnt, const u64 offset, const u64 length)
-{
-  const u64 end = offset + length;
+  if (brain_server_db_shard->table_zero == true) table_buf[sorted_cnt++] = 0;
 
-  u64 overlap = 0;
+  qsort (table_buf, sorted_cnt, sizeof (u64), brain_server_sort_hash_u64);
 
-  for (i64 idx = 0; idx < cnt; idx++)
-  {
-    const u64 element_length = buf[idx].length;
+  // merge from the back, the table hashes are new to the shard as they were checked on insert
 
-    if (element_length == 0) continue;
+  brain_server_hash_long_t *long_buf = brain_server_db_shard->long_buf;
 
-    const u64 element_start = buf[idx].offset;
-    const u64 element_end   = element_start + element_length;
+  i64 long_left  = brain_server_db_shard->long_cnt - 1;
+  i64 table_left = sorted_cnt - 1;
 
-    const u64 start = offset + overlap;
+  for (i64 out_idx = brain_server_db_shard->long_cnt + sorted_cnt - 1; table_left >= 0; out_idx--)
+  {
+    const u64 hash64 = table_buf[table_left];
 
-    if (element_start > start) break; // we can't ever do it since this list is sorted
+    u32 hash[2];
 
-    if (element_end > start)
+    hash[0] = (u32) (hash64 >>  0);
+    hash[1] = (u32) (hash64 >> 32);
+
+    if ((long_left >= 0) && (brain_server_sort_hash (long_buf[long_left].hash, hash) == 1))
     {
-      const u64 limited_end = MIN (end, element_end);
+      long_buf[out_idx] = long_buf[long_left];
+
+      long_left--;
+    }
+    else
+    {
+      long_buf[out_idx].hash[0] = hash[0];
+      long_buf[out_idx].hash[1] = hash[1];
+
+      table_left--;
+    }
+  }
+
+  brain_server_db_shard->long_cnt += sorted_cnt;
+
+  memset (table_buf, 0, brain_server_db_shard->table_size * sizeof (u64));
+
+  brain_server_db_shard->table_cnt  = 0;
+  brain_server_db_shard->table_zero = false;
+
+  return true;
+}
+
+i64 brain_server_db_hash_lookup (brain_server_db_hash_t *brain_server_db_hash, brain_server_hash_unique_t *temp_buf, const i64 temp_cnt, u8 *send_buf)
+{
+  // temp_buf is sorted, so the hashes of a shard are next to each other and each shard is locked once
+
+  i64 temp_idx_new = 0;
+
+  for (i64 temp_idx = 0; temp_idx < temp_cnt;)
+  {
+    const u32 shard_idx = brain_server_db_shard_idx (temp_buf[temp_idx].hash);
+
+    brain_server_db_shard_t *brain_server_db_shard = &brain_server_db_hash->shard_buf[shard_idx];
+
+    hc_thread_mutex_lock (brain_server_db_shard->mux_hr);
+
+    brain_server_db_shard->hb++;
+
+    if (brain_server_db_shard->hb == 1)
+    {
+      hc_thread_mutex_lock (brain_server_db_shard->mux_hg);
+    }
+
+    hc_thread_mutex_unlock (brain_server_db_shard->mux_hr);
+
+    for (; temp_idx < temp_cnt; temp_idx++)
+    {
+      brain_server_hash_unique_t *cur = &temp_buf[temp_idx];
+
+      if (brain_server_db_shard_idx (cur->hash) != shard_idx) break;
+
+      if (brain_server_db_shard_find (brain_server_db_shard, cur->hash) == true)
+      {
+        send_buf[cur->hash_idx] = 1;
+      }
+      else
+      {
+        brain_server_hash_unique_t *save = temp_buf + temp_idx_new;
+
+        temp_idx_new++;
+
+        save->hash[0] = cur->hash[0];
+        save->hash[1] = cur->hash[1];
+
+        save->hash_idx = cur->hash_idx; // we need this in a later stage
+      }
+    }
+
+    hc_thread_mutex_lock (brain_server_db_shard->mux_hr);
+
+    brain_server_db_shard->hb--;
+
+    if (brain_server_db_shard->hb == 0)
+    {
+      hc_thread_mutex_unlock (brain_server_db_shard->mux_hg);
+    }
+
+    hc_thread_mutex_unlock (brain_server_db_shard->mux_hr);
+  }
+
+  return temp_idx_new;
+}
+
+bool brain_server_db_hash_commit (brain_server_db_hash_t *brain_server_db_hash, const brain_server_hash_short_t *short_buf, const i64 short_cnt)
+{
+  // the cost depends on the number of hashes committed, not on the size of the long-term memory:
+  // the table of a shard is only merged into its sorted array once it has grown to a quarter of it
+
+  bool rc = true;
+
+  i64 long_cnt_diff = 0;
+
+  for (i64 short_idx = 0; short_idx < short_cnt;)
+  {
+    const u32 shard_idx = brain_server_db_shard_idx (short_buf[short_idx].hash);
+
+    brain_server_db_shard_t *brain_server_db_shard = &brain_server_db_hash->shard_buf[shard_idx];
+
+    hc_thread_mutex_lock (brain_server_db_shard->mux_hg);
+
+    const i64 shard_cnt_prev = brain_server_db_shard->long_cnt + brain_server_db_shard->table_cnt;
+
+    for (; short_idx < short_cnt; short_idx++)
+    {
+      if (brain_server_db_shard_idx (short_buf[short_idx].hash) != shard_idx) break;
+
+      if (brain_server_db_shard_find (brain_server_db_shard, short_buf[short_idx].hash) == true) continue;
+
+      if (brain_server_db_shard_insert (brain_server_db_shard, short_buf[short_idx].hash) == false) rc = false;
+    }
+
+    if (brain_server_db_shard->table_cnt >= MAX (BRAIN_SERVER_HASH_TABLE_MIN, brain_server_db_shard->long_cnt / 4))
+    {
+      if (brain_server_db_shard_compact (brain_server_db_shard) == false) rc = false;
+    }
+
+    long_cnt_diff += (brain_server_db_shard->long_cnt + brain_server_db_shard->table_cnt) - shard_cnt_prev;
+
+    hc_thread_mutex_unlock (brain_server_db_shard->mux_hg);
+  }
+
+  hc_thread_mutex_lock (brain_server_db_hash->mux_hc);
+
+  brain_server_db_hash->long_cnt += long_cnt_diff;
+
+  hc_thread_mutex_unlock (brain_server_db_hash->mux_hc);
+
+  return rc;
+}
+
+void brain_server_db_attack_init (brain_server_db_attack_t *brain_server_db_attack, const u32 brain_attack)
+{
+  brain_server_db_attack->brain_attack = brain_attack;
+
+  brain_server_db_attack->ab            = 0;
+  brain_server_db_attack->short_cnt     = 0;
+  brain_server_db_attack->short_buf     = NULL;
+  brain_server_db_attack->short_alloc   = 0;
+  brain_server_db_attack->long_cnt      = 0;
+  brain_server_db_attack->long_buf      = NULL;
+  brain_server_db_attack->long_alloc    = 0;
+  brain_server_db_attack->write_attacks = false;
+
+  hc_thread_mutex_init (brain_server_db_attack->mux_ar);
+  hc_thread_mutex_init (brain_server_db_attack->mux_ag);
+}
+
+bool brain_server_db_attack_realloc (brain_server_db_attack_t *brain_server_db_attack, const i64 new_long_cnt, const i64 new_short_cnt)
+{
+  if ((brain_server_db_attack->long_cnt + new_long_cnt) > brain_server_db_attack->long_alloc)
+  {
+    const i64 realloc_size_total = (i64) mydivc64 ((const u64) new_long_cnt, (const u64) BRAIN_SERVER_REALLOC_ATTACK_SIZE) * BRAIN_SERVER_REALLOC_ATTACK_SIZE;
+
+    brain_server_attack_long_t *long_buf = (brain_server_attack_long_t *) hcrealloc (brain_server_db_attack->long_buf, brain_server_db_attack->long_alloc * sizeof (brain_server_attack_long_t), realloc_size_total * sizeof (brain_server_attack_long_t));
+
+    if (long_buf == NULL) return false;
+
+    brain_server_db_attack->long_buf    = long_buf;
+    brain_server_db_attack->long_alloc += realloc_size_total;
+  }
+
+  if ((brain_server_db_attack->short_cnt + new_short_cnt) > brain_server_db_attack->short_alloc)
+  {
+    const i64 realloc_size_total = (i64) mydivc64 ((const u64) new_short_cnt, (const u64) BRAIN_SERVER_REALLOC_ATTACK_SIZE) * BRAIN_SERVER_REALLOC_ATTACK_SIZE;
+
+    brain_server_attack_short_t *short_buf = (brain_server_attack_short_t *) hcrealloc (brain_server_db_attack->short_buf, brain_server_db_attack->short_alloc * sizeof (brain_server_attack_short_t), realloc_size_total * sizeof (brain_server_attack_short_t));
+
+    if (short_buf == NULL) return false;
+
+    brain_server_db_attack->short_buf    = short_buf;
+    brain_server_db_attack->short_alloc += realloc_size_total;
+  }
+
+  return true;
+}
+
+void brain_server_db_attack_free (brain_server_db_attack_t *brain_server_db_attack)
+{
+  hc_thread_mutex_delete (brain_server_db_attack->mux_ag);
+  hc_thread_mutex_delete (brain_server_db_attack->mux_ar);
+
+  hcfree (brain_server_db_attack->long_buf);
+  hcfree (brain_server_db_attack->short_buf);
+
+  brain_server_db_attack->ab            = 0;
+  brain_server_db_attack->long_cnt      = 0;
+  brain_server_db_attack->long_buf      = NULL;
+  brain_server_db_attack->long_alloc    = 0;
+  brain_server_db_attack->short_cnt     = 0;
+  brain_server_db_attack->short_buf     = NULL;
+  brain_server_db_attack->short_alloc   = 0;
+  brain_server_db_attack->brain_attack  = 0;
+  brain_server_db_attack->write_attacks = false;
+}
+
+u64 brain_server_highest_attack (const brain_server_db_attack_t *buf)
+{
+  const brain_server_attack_long_t  *long_buf  = buf->long_buf;
+  const brain_server_attack_short_t *short_buf = buf->short_buf;
+
+  const u64 long_cnt  = buf->long_cnt;
+  const u64 short_cnt = buf->short_cnt;
+
+  u64 highest_long  = brain_server_highest_attack_long  (long_buf,  long_cnt,  0);
+  u64 highest_short = brain_server_highest_attack_short (short_buf, short_cnt, 0);
+
+  u64 highest = MAX (highest_long, highest_short);
+
+  highest_long  = brain_server_highest_attack_long  (long_buf,  long_cnt,  highest);
+  highest_short = brain_server_highest_attack_short (short_buf, short_cnt, highest);
+
+  highest = MAX (highest_long, highest_short);
+
+  return highest;
+}
+
+u64 brain_server_highest_attack_long (const brain_server_attack_long_t *buf, const i64 cnt, const u64 start)
+{
+  u64 highest = start;
+
+  for (i64 idx = 0; idx < cnt; idx++)
+  {
+    const u64 offset = buf[idx].offset;
+    const u64 length = buf[idx].length;
+
+    if (offset > highest) break;
+
+    const u64 next = offset + length;
+
+    highest = MAX (highest, next);
+  }
+
+  return highest;
+}
+
+u64 brain_server_highest_attack_short (const brain_server_attack_short_t *buf, const i64 cnt, const u64 start)
+{
+  u64 highest = start;
+
+  for (i64 idx = 0; idx < cnt; idx++)
+  {
+    const u64 offset = buf[idx].offset;
+    const u64 length = buf[idx].length;
+
+    if (offset > highest) break;
+
+    const u64 next = offset + length;
+
+    highest = MAX (highest, next);
+  }
+
+  return highest;
+}
+
+u64 brain_server_find_attack_long (const brain_server_attack_long_t *buf, const i64 cnt, const u64 offset, const u64 length)
+{
+  const u64 end = offset + length;
+
+  u64 overlap = 0;
+
+  for (i64 idx = 0; idx < cnt; idx++)
+  {
+    const u64 element_length = buf[idx].length;
+
+    if (element_length == 0) continue;
+
+    const u64 element_start = buf[idx].offset;
+    const u64 element_end   = element_start + element_length;
+
+    const u64 start = offset + overlap;
+
+    if (element_start > start) break; // we can't ever do it since this list is sorted
+
+    if (element_end > start)
+    {
+      const u64 limited_end = MIN (end, element_end);
+
+      overlap += limited_end - start;
+
+      if (overlap == length) break;
+    }
+  }
+
+  return overlap;
+}
+
+u64 brain_server_find_attack_short (const brain_server_attack_short_t *buf, const i64 cnt, const u64 offset, const u64 length)
+{
+  const u64 end = offset + length;
+
+  u64 overlap = 0;
+
+  for (i64 idx = 0; idx < cnt; idx++)
+  {
+    const u64 element_length = buf[idx].length;
+
+    if (element_length == 0) continue;
+
+    const u64 element_start = buf[idx].offset;
+    const u64 element_end   = element_start + element_length;
+
+    const u64 start = offset + overlap;
+
+    if (element_start > start) break; // we can't ever do it since this list is sorted
+
+    if (element_end > start)
+    {
+      const u64 limited_end = MIN (end, element_end);
 
       overlap += limited_end - start;
 
@@ -1568,6 +2022,17 @@ int brain_server_sort_attack_short (const void *v1, const void *v2)
   return 0;
 }
 
+int brain_server_sort_hash_u64 (const void *v1, const void *v2)
+{
+  const u64 h1 = *((const u64 *) v1);
+  const u64 h2 = *((const u64 *) v2);
+
+  if (h1 > h2) return  1;
+  if (h1 < h2) return -1;
+
+  return 0;
+}
+
 int brain_server_sort_hash_long (const void *v1, const void *v2)
 {
   const brain_server_hash_long_t *d1 = (const brain_server_hash_long_t *) v1;
@@ -1614,6 +2079,12 @@ bool brain_server_read_hash_dumps (brain_server_dbs_t *brain_server_dbs, const c
     return false;
   }
 
+  // a session can have a dump, a journal and the journal of an unfinished dump
+
+  u32 *session_buf = (u32 *) hccalloc (BRAIN_SERVER_SESSIONS_MAX, sizeof (u32));
+
+  int session_cnt = 0;
+
   struct dirent *entry;
 
   while ((entry = readdir (dirp)) != NULL)
@@ -1622,7 +2093,7 @@ bool brain_server_read_hash_dumps (brain_server_dbs_t *brain_server_dbs, const c
 
     const size_t len = strlen (file);
 
-    if (len != 19) continue;
+    if (len < 19) continue;
 
     if (file[ 0] != 'b') continue;
     if (file[ 1] != 'r') continue;
@@ -1632,34 +2103,101 @@ bool brain_server_read_hash_dumps (brain_server_dbs_t *brain_server_dbs, const c
     if (file[ 5] != '.') continue;
 
     if (file[14] != '.') continue;
-    if (file[15] != 'l') continue;
-    if (file[16] != 'd') continue;
-    if (file[17] != 'm') continue;
-    if (file[18] != 'p') continue;
+
+    if ((strcmp (file + 15, "ldmp") != 0) && (strcmp (file + 15, "ljnl") != 0) && (strcmp (file + 15, "ljnl.old") != 0)) continue;
 
     const u32 brain_session = byte_swap_32 (hex_to_u32 ((const u8 *) file + 6));
 
+    int session_idx;
+
+    for (session_idx = 0; session_idx < session_cnt; session_idx++)
+    {
+      if (session_buf[session_idx] == brain_session) break;
+    }
+
+    if (session_idx < session_cnt) continue;
+
+    if (session_cnt == BRAIN_SERVER_SESSIONS_MAX)
+    {
+      brain_logging (stderr, 0, "too many sessions\n");
+
+      break;
+    }
+
+    session_buf[session_cnt] = brain_session;
+
+    session_cnt++;
+  }
+
+  closedir (dirp);
+
+  for (int session_idx = 0; session_idx < session_cnt; session_idx++)
+  {
+    const u32 brain_session = session_buf[session_idx];
+
     brain_server_db_hash_t *brain_server_db_hash = &brain_server_dbs->hash_buf[brain_server_dbs->hash_cnt];
 
     brain_server_db_hash_init (brain_server_db_hash, brain_session);
 
-    if (brain_server_read_hash_dump (brain_server_db_hash, file) == false) continue;
+    char file[32];
+
+    snprintf (file, sizeof (file), "brain.%08x.ldmp", brain_session);
+
+    // the dump first, then the journal that was rotated for the last dump and then the current one
+
+    bool rc = true;
+
+    if (hc_path_exist (file) == true)
+    {
+      if (brain_server_map_hash_dump (brain_server_db_hash, file) == false)
+      {
+        rc = brain_server_read_hash_dump (brain_server_db_hash, file);
+      }
+    }
+
+    if ((rc == true) && (hc_path_exist (brain_server_db_hash->journal_file_old) == true))
+    {
+      rc = brain_server_read_hash_journal (brain_server_db_hash, brain_server_db_hash->journal_file_old);
+    }
+
+    if ((rc == true) && (hc_path_exist (brain_server_db_hash->journal_file) == true))
+    {
+      rc = brain_server_read_hash_journal (brain_server_db_hash, brain_server_db_hash->journal_file);
+    }
+
+    if (rc == false)
+    {
+      brain_server_db_hash_free (brain_server_db_hash);
+
+      continue;
+    }
 
     brain_server_dbs->hash_cnt++;
   }
 
-  closedir (dirp);
+  hcfree (session_buf);
 
   return true;
 }
 
-bool brain_server_write_hash_dumps (brain_server_dbs_t *brain_server_dbs, const char *path)
+bool brain_server_write_hash_dumps (brain_server_dbs_t *brain_server_dbs, const char *path, const bool force)
 {
   for (i64 idx = 0; idx < brain_server_dbs->hash_cnt; idx++)
   {
     brain_server_db_hash_t *brain_server_db_hash = &brain_server_dbs->hash_buf[idx];
 
-    hc_thread_mutex_lock (brain_server_db_hash->mux_hg);
+    // the journal keeps the commits anyway, so the timer only rewrites a dump once its journal has grown large
+    // compared to it. on shutdown it's always rewritten, the next start then only has to map it
+
+    hc_thread_mutex_lock (brain_server_db_hash->mux_hj);
+
+    const i64 journal_size = brain_server_db_hash->journal_size;
+
+    hc_thread_mutex_unlock (brain_server_db_hash->mux_hj);
+
+    if (journal_size == 0) continue;
+
+    if ((force == false) && ((journal_size * BRAIN_SERVER_JOURNAL_RATIO) < brain_server_db_hash->dump_size)) continue;
 
     char file[100];
 
@@ -1668,11 +2206,122 @@ bool brain_server_write_hash_dumps (brain_server_dbs_t *brain_server_dbs, const
     snprintf (file, sizeof (file), "%s/brain.%08x.ldmp", path, brain_server_db_hash->brain_session);
 
     brain_server_write_hash_dump (brain_server_db_hash, file);
+  }
+
+  return true;
+}
+
+bool brain_server_map_hash_dump (brain_server_db_hash_t *brain_server_db_hash, const char *file)
+{
+  #if defined (_POSIX)
+
+  hc_timer_t timer_dump;
+
+  hc_timer_set (&timer_dump);
+
+  const int fd = open (file, O_RDONLY);
+
+  if (fd == -1) return false;
+
+  struct stat sb;
 
-    hc_thread_mutex_unlock (brain_server_db_hash->mux_hg);
+  memset (&sb, 0, sizeof (struct stat));
+
+  if (fstat (fd, &sb) == -1)
+  {
+    close (fd);
+
+    return false;
+  }
+
+  // empty and truncated dumps are left to brain_server_read_hash_dump ()
+
+  if ((sb.st_size == 0) || ((sb.st_size % sizeof (brain_server_hash_long_t)) != 0))
+  {
+    close (fd);
+
+    return false;
   }
 
+  void *map_buf = mmap (NULL, (size_t) sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+  close (fd);
+
+  if (map_buf == MAP_FAILED) return false;
+
+  // the lookups are binary searches, read-ahead would only pull in pages nobody asked for
+
+  madvise (map_buf, (size_t) sb.st_size, MADV_RANDOM);
+
+  brain_server_hash_long_t *long_buf = (brain_server_hash_long_t *) map_buf;
+
+  const i64 long_cnt = (i64) sb.st_size / (i64) sizeof (brain_server_hash_long_t);
+
+  // the shards follow the sort order, so each of them is a slice of the dump. checking every hash would
+  // read the whole file, so only the slice ends are checked, unsorted dumps from other tools fail there
+
+  i64 shard_start[BRAIN_SERVER_HASH_SHARDS + 1];
+
+  for (int shard_idx = 0; shard_idx < BRAIN_SERVER_HASH_SHARDS; shard_idx++)
+  {
+    i64 l = (shard_idx == 0) ? 0 : shard_start[shard_idx - 1];
+    i64 r = long_cnt;
+
+    while (l < r)
+    {
+      const i64 m = l + ((r - l) / 2);
+
+      if (brain_server_db_shard_idx (long_buf[m].hash) < (u32) shard_idx) l = m + 1; else r = m;
+    }
+
+    shard_start[shard_idx] = l;
+  }
+
+  shard_start[BRAIN_SERVER_HASH_SHARDS] = long_cnt;
+
+  for (int shard_idx = 0; shard_idx < BRAIN_SERVER_HASH_SHARDS; shard_idx++)
+  {
+    const i64 first = shard_start[shard_idx];
+    const i64 last  = shard_start[shard_idx + 1] - 1;
+
+    if (first > last) continue;
+
+    if ((brain_server_db_shard_idx (long_buf[first].hash) != (u32) shard_idx)
+     || (brain_server_db_shard_idx (long_buf[last].hash)  != (u32) shard_idx)
+     || (brain_server_sort_hash (long_buf[first].hash, long_buf[last].hash) == 1))
+    {
+      munmap (map_buf, (size_t) sb.st_size);
+
+      return false;
+    }
+  }
+
+  for (int shard_idx = 0; shard_idx < BRAIN_SERVER_HASH_SHARDS; shard_idx++)
+  {
+    brain_server_db_shard_t *brain_server_db_shard = &brain_server_db_hash->shard_buf[shard_idx];
+
+    brain_server_db_shard->long_buf    = long_buf + shard_start[shard_idx];
+    brain_server_db_shard->long_cnt    = shard_start[shard_idx + 1] - shard_start[shard_idx];
+    brain_server_db_shard->long_alloc  = brain_server_db_shard->long_cnt;
+    brain_server_db_shard->long_mapped = true;
+  }
+
+  brain_server_db_hash->map_buf   = map_buf;
+  brain_server_db_hash->map_len   = (u64) sb.st_size;
+  brain_server_db_hash->long_cnt  = long_cnt;
+  brain_server_db_hash->dump_size = (i64) sb.st_size;
+
+  const double ms = hc_timer_get (timer_dump);
+
+  brain_logging (stdout, 0, "Mapped %" PRIu64 " bytes from session 0x%08x in %.2f ms\n", (u64) sb.st_size, brain_server_db_hash->brain_session, ms);
+
   return true;
+
+  #else
+
+  return false;
+
+  #endif
 }
 
 bool brain_server_read_hash_dump (brain_server_db_hash_t *brain_server_db_hash, const char *file)
@@ -1703,30 +2352,99 @@ bool brain_server_read_hash_dump (brain_server_db_hash_t *brain_server_db_hash,
     return false;
   }
 
-  i64 temp_cnt = (u64) sb.st_size / sizeof (brain_server_hash_long_t);
+  // the dump is sorted, so the hashes are simply appended to their shards
+
+  const i64 temp_cnt = (u64) sb.st_size / sizeof (brain_server_hash_long_t);
+
+  brain_server_hash_long_t *temp_buf = (brain_server_hash_long_t *) hccalloc (BRAIN_SERVER_REALLOC_HASH_SIZE, sizeof (brain_server_hash_long_t));
 
-  if (brain_server_db_hash_realloc (brain_server_db_hash, temp_cnt) == false)
+  bool *shard_unsorted = (bool *) hccalloc (BRAIN_SERVER_HASH_SHARDS, sizeof (bool));
+
+  for (i64 temp_done = 0; temp_done < temp_cnt;)
   {
-    brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+    const i64 chunk_cnt = MIN (temp_cnt - temp_done, BRAIN_SERVER_REALLOC_HASH_SIZE);
 
-    hc_fclose (&fp);
+    const size_t nread = hc_fread (temp_buf, sizeof (brain_server_hash_long_t), chunk_cnt, &fp);
 
-    return false;
+    if (nread != (size_t) chunk_cnt)
+    {
+      brain_logging (stderr, 0, "%s: only %" PRIu64 " bytes read\n", file, (u64) (temp_done + nread) * sizeof (brain_server_hash_long_t));
+
+      hcfree (shard_unsorted);
+      hcfree (temp_buf);
+
+      hc_fclose (&fp);
+
+      return false;
+    }
+
+    for (i64 chunk_idx = 0; chunk_idx < chunk_cnt; chunk_idx++)
+    {
+      const u32 shard_idx = brain_server_db_shard_idx (temp_buf[chunk_idx].hash);
+
+      brain_server_db_shard_t *brain_server_db_shard = &brain_server_db_hash->shard_buf[shard_idx];
+
+      if (brain_server_db_shard_realloc (brain_server_db_shard, 1) == false)
+      {
+        brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+
+        hcfree (shard_unsorted);
+        hcfree (temp_buf);
+
+        hc_fclose (&fp);
+
+        return false;
+      }
+
+      if (brain_server_db_shard->long_cnt)
+      {
+        const brain_server_hash_long_t *prev = &brain_server_db_shard->long_buf[brain_server_db_shard->long_cnt - 1];
+
+        if (brain_server_sort_hash (prev->hash, temp_buf[chunk_idx].hash) != -1) shard_unsorted[shard_idx] = true;
+      }
+
+      brain_server_db_shard->long_buf[brain_server_db_shard->long_cnt] = temp_buf[chunk_idx];
+
+      brain_server_db_shard->long_cnt++;
+    }
+
+    temp_done += chunk_cnt;
   }
 
-  const size_t nread = hc_fread (brain_server_db_hash->long_buf, sizeof (brain_server_hash_long_t), temp_cnt, &fp);
+  hcfree (temp_buf);
 
-  if (nread != (size_t) temp_cnt)
+  // dumps from other tools may not be sorted or unique
+
+  brain_server_db_hash->long_cnt = 0;
+
+  for (int shard_idx = 0; shard_idx < BRAIN_SERVER_HASH_SHARDS; shard_idx++)
   {
-    brain_logging (stderr, 0, "%s: only %" PRIu64 " bytes read\n", file, (u64) nread * sizeof (brain_server_hash_long_t));
+    brain_server_db_shard_t *brain_server_db_shard = &brain_server_db_hash->shard_buf[shard_idx];
 
-    hc_fclose (&fp);
+    if (shard_unsorted[shard_idx] == true)
+    {
+      qsort (brain_server_db_shard->long_buf, brain_server_db_shard->long_cnt, sizeof (brain_server_hash_long_t), brain_server_sort_hash_long);
 
-    return false;
+      i64 long_cnt = 0;
+
+      for (i64 long_idx = 0; long_idx < brain_server_db_shard->long_cnt; long_idx++)
+      {
+        if ((long_cnt > 0) && (brain_server_sort_hash (brain_server_db_shard->long_buf[long_cnt - 1].hash, brain_server_db_shard->long_buf[long_idx].hash) == 0)) continue;
+
+        brain_server_db_shard->long_buf[long_cnt] = brain_server_db_shard->long_buf[long_idx];
+
+        long_cnt++;
+      }
+
+      brain_server_db_shard->long_cnt = long_cnt;
+    }
+
+    brain_server_db_hash->long_cnt += brain_server_db_shard->long_cnt;
   }
 
-  brain_server_db_hash->long_cnt     = temp_cnt;
-  brain_server_db_hash->write_hashes = false;
+  hcfree (shard_unsorted);
+
+  brain_server_db_hash->dump_size = (i64) sb.st_size;
 
   hc_fclose (&fp);
 
@@ -1739,54 +2457,374 @@ bool brain_server_read_hash_dump (brain_server_db_hash_t *brain_server_db_hash,
 
 bool brain_server_write_hash_dump (brain_server_db_hash_t *brain_server_db_hash, const char *file)
 {
-  if (brain_server_db_hash->write_hashes == false) return true;
-
   hc_timer_t timer_dump;
 
-  hc_timer_set (&timer_dump);
+  hc_timer_set (&timer_dump);
+
+  // commits from now on go to a new journal, the ones in the rotated journal are in memory already
+  // and make it into this dump
+
+  i64 journal_size = 0;
+
+  if (brain_server_rotate_hash_journal (brain_server_db_hash, &journal_size) == false) return false;
+
+  // write to a temporary file, the old dump stays valid until the new one is complete
+
+  char file_tmp[128];
+
+  snprintf (file_tmp, sizeof (file_tmp), "%s.tmp", file);
+
+  HCFILE fp;
+
+  if (hc_fopen_raw (&fp, file_tmp, "wb") == false)
+  {
+    brain_logging (stderr, 0, "%s: %s\n", file_tmp, strerror (errno));
+
+    return false;
+  }
+
+  // the shards are compacted one after the other and written while the clients keep working on the others,
+  // as they follow the sort order, the dump is one sorted array just like before. only the compaction
+  // blocks the commits to a shard, the lookups continue while it is written
+
+  i64 dump_size = 0;
+
+  for (int shard_idx = 0; shard_idx < BRAIN_SERVER_HASH_SHARDS; shard_idx++)
+  {
+    brain_server_db_shard_t *brain_server_db_shard = &brain_server_db_hash->shard_buf[shard_idx];
+
+    hc_thread_mutex_lock (brain_server_db_shard->mux_hg);
+
+    const bool rc_compact = brain_server_db_shard_compact (brain_server_db_shard);
+
+    hc_thread_mutex_unlock (brain_server_db_shard->mux_hg);
+
+    if (rc_compact == false)
+    {
+      brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+
+      hc_fclose (&fp);
+
+      unlink (file_tmp);
+
+      return false;
+    }
+
+    hc_thread_mutex_lock (brain_server_db_shard->mux_hr);
+
+    brain_server_db_shard->hb++;
+
+    if (brain_server_db_shard->hb == 1)
+    {
+      hc_thread_mutex_lock (brain_server_db_shard->mux_hg);
+    }
+
+    hc_thread_mutex_unlock (brain_server_db_shard->mux_hr);
+
+    const i64 long_cnt = brain_server_db_shard->long_cnt;
+
+    // hc_fwrite () fails on the buffer of a shard that never had a hash
+
+    const size_t nwrite = (long_cnt) ? hc_fwrite (brain_server_db_shard->long_buf, sizeof (brain_server_hash_long_t), long_cnt, &fp) : 0;
+
+    hc_thread_mutex_lock (brain_server_db_shard->mux_hr);
+
+    brain_server_db_shard->hb--;
+
+    if (brain_server_db_shard->hb == 0)
+    {
+      hc_thread_mutex_unlock (brain_server_db_shard->mux_hg);
+    }
+
+    hc_thread_mutex_unlock (brain_server_db_shard->mux_hr);
+
+    if (nwrite != (size_t) long_cnt)
+    {
+      brain_logging (stderr, 0, "%s: only %" PRIu64 " bytes written\n", file_tmp, (u64) (dump_size + nwrite * sizeof (brain_server_hash_long_t)));
+
+      hc_fclose (&fp);
+
+      unlink (file_tmp);
+
+      return false;
+    }
+
+    dump_size += long_cnt * sizeof (brain_server_hash_long_t);
+  }
+
+  hc_fflush (&fp);
+  hc_fsync  (&fp);
+  hc_fclose (&fp);
+
+  #if defined (_WIN)
+  unlink (file);
+  #endif
+
+  if (rename (file_tmp, file) == -1)
+  {
+    brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
+
+    unlink (file_tmp);
+
+    return false;
+  }
+
+  // the rotated journal is part of the dump now
+
+  hc_thread_mutex_lock (brain_server_db_hash->mux_hj);
+
+  unlink (brain_server_db_hash->journal_file_old);
+
+  brain_server_db_hash->journal_size -= journal_size;
+
+  hc_thread_mutex_unlock (brain_server_db_hash->mux_hj);
+
+  brain_server_db_hash->dump_size = dump_size;
+
+  // stats
+
+  const double ms = hc_timer_get (timer_dump);
+
+  brain_logging (stdout, 0, "Wrote %" PRIu64 " bytes from session 0x%08x in %.2f ms (journal: %" PRIu64 " bytes)\n", (u64) dump_size, brain_server_db_hash->brain_session, ms, (u64) journal_size);
+
+  return true;
+}
+
+bool brain_server_read_hash_journal (brain_server_db_hash_t *brain_server_db_hash, const char *file)
+{
+  hc_timer_t timer_journal;
+
+  hc_timer_set (&timer_journal);
+
+  struct stat sb;
+
+  memset (&sb, 0, sizeof (struct stat));
+
+  if (stat (file, &sb) == -1)
+  {
+    brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
+
+    return false;
+  }
+
+  HCFILE fp;
+
+  if (hc_fopen_raw (&fp, file, "rb") == false)
+  {
+    brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
+
+    return false;
+  }
+
+  // a batch cut short by a crash leaves a partial hash at the end, it's ignored
+
+  const i64 temp_cnt = (u64) sb.st_size / sizeof (brain_server_hash_short_t);
+
+  brain_server_hash_short_t *temp_buf  = (brain_server_hash_short_t *) hccalloc (BRAIN_SERVER_REALLOC_HASH_SIZE, sizeof (brain_server_hash_short_t));
+  brain_server_hash_short_t *shard_buf = (brain_server_hash_short_t *) hccalloc (BRAIN_SERVER_REALLOC_HASH_SIZE, sizeof (brain_server_hash_short_t));
+
+  i64 *shard_pos = (i64 *) hccalloc (BRAIN_SERVER_HASH_SHARDS, sizeof (i64));
+
+  for (i64 temp_done = 0; temp_done < temp_cnt;)
+  {
+    const i64 chunk_cnt = MIN (temp_cnt - temp_done, BRAIN_SERVER_REALLOC_HASH_SIZE);
+
+    const size_t nread = hc_fread (temp_buf, sizeof (brain_server_hash_short_t), chunk_cnt, &fp);
+
+    if (nread != (size_t) chunk_cnt)
+    {
+      brain_logging (stderr, 0, "%s: only %" PRIu64 " bytes read\n", file, (u64) (temp_done + nread) * sizeof (brain_server_hash_short_t));
+
+      hcfree (shard_pos);
+      hcfree (shard_buf);
+      hcfree (temp_buf);
+
+      hc_fclose (&fp);
+
+      return false;
+    }
+
+    // a chunk spans many batches, brain_server_db_hash_commit () handles one shard after the other,
+    // so the hashes are grouped by shard, that's enough and cheaper than sorting them
+
+    memset (shard_pos, 0, BRAIN_SERVER_HASH_SHARDS * sizeof (i64));
+
+    for (i64 chunk_idx = 0; chunk_idx < chunk_cnt; chunk_idx++)
+    {
+      shard_pos[brain_server_db_shard_idx (temp_buf[chunk_idx].hash)]++;
+    }
+
+    i64 shard_start = 0;
+
+    for (int shard_idx = 0; shard_idx < BRAIN_SERVER_HASH_SHARDS; shard_idx++)
+    {
+      const i64 shard_cnt = shard_pos[shard_idx];
+
+      shard_pos[shard_idx] = shard_start;
+
+      shard_start += shard_cnt;
+    }
+
+    for (i64 chunk_idx = 0; chunk_idx < chunk_cnt; chunk_idx++)
+    {
+      shard_buf[shard_pos[brain_server_db_shard_idx (temp_buf[chunk_idx].hash)]++] = temp_buf[chunk_idx];
+    }
+
+    if (brain_server_db_hash_commit (brain_server_db_hash, shard_buf, chunk_cnt) == false)
+    {
+      brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+
+      hcfree (shard_pos);
+      hcfree (shard_buf);
+      hcfree (temp_buf);
+
+      hc_fclose (&fp);
+
+      return false;
+    }
+
+    temp_done += chunk_cnt;
+  }
+
+  hcfree (shard_pos);
+  hcfree (shard_buf);
+  hcfree (temp_buf);
+
+  hc_fclose (&fp);
+
+  brain_server_db_hash->journal_size += (i64) sb.st_size;
+
+  const double ms = hc_timer_get (timer_journal);
+
+  brain_logging (stdout, 0, "Replayed %" PRIu64 " bytes from session 0x%08x in %.2f ms\n", (u64) sb.st_size, brain_server_db_hash->brain_session, ms);
+
+  return true;
+}
+
+bool brain_server_write_hash_journal (brain_server_db_hash_t *brain_server_db_hash, const brain_server_hash_short_t *short_buf, const i64 short_cnt)
+{
+  // called after the hashes went to the long-term memory, so a dump that rotates the journal in between has them
+
+  hc_thread_mutex_lock (brain_server_db_hash->mux_hj);
+
+  if (brain_server_db_hash->journal_open == false)
+  {
+    if (hc_fopen_raw (&brain_server_db_hash->journal_fp, brain_server_db_hash->journal_file, "ab") == false)
+    {
+      brain_logging (stderr, 0, "%s: %s\n", brain_server_db_hash->journal_file, strerror (errno));
+
+      hc_thread_mutex_unlock (brain_server_db_hash->mux_hj);
+
+      return false;
+    }
+
+    brain_server_db_hash->journal_open = true;
+  }
+
+  const size_t nwrite = hc_fwrite (short_buf, sizeof (brain_server_hash_short_t), short_cnt, &brain_server_db_hash->journal_fp);
+
+  hc_fflush (&brain_server_db_hash->journal_fp);
+
+  brain_server_db_hash->journal_size += (i64) (nwrite * sizeof (brain_server_hash_short_t));
+
+  hc_thread_mutex_unlock (brain_server_db_hash->mux_hj);
+
+  if (nwrite != (size_t) short_cnt)
+  {
+    brain_logging (stderr, 0, "%s: only %" PRIu64 " bytes written\n", brain_server_db_hash->journal_file, (u64) nwrite * sizeof (brain_server_hash_short_t));
+
+    return false;
+  }
+
+  return true;
+}
+
+bool brain_server_rotate_hash_journal (brain_server_db_hash_t *brain_server_db_hash, i64 *journal_size)
+{
+  // the current journal becomes the old one, which is removed once the dump is written.
+  // if the last dump failed, the old one is still there and the current one is appended to it
+
+  hc_thread_mutex_lock (brain_server_db_hash->mux_hj);
+
+  if (brain_server_db_hash->journal_open == true)
+  {
+    hc_fclose (&brain_server_db_hash->journal_fp);
+
+    brain_server_db_hash->journal_open = false;
+  }
+
+  if (hc_path_exist (brain_server_db_hash->journal_file) == true)
+  {
+    if (hc_path_exist (brain_server_db_hash->journal_file_old) == true)
+    {
+      HCFILE fp_src;
+      HCFILE fp_dst;
+
+      if (hc_fopen_raw (&fp_src, brain_server_db_hash->journal_file, "rb") == false)
+      {
+        brain_logging (stderr, 0, "%s: %s\n", brain_server_db_hash->journal_file, strerror (errno));
+
+        hc_thread_mutex_unlock (brain_server_db_hash->mux_hj);
+
+        return false;
+      }
 
-  // write to file
+      if (hc_fopen_raw (&fp_dst, brain_server_db_hash->journal_file_old, "ab") == false)
+      {
+        brain_logging (stderr, 0, "%s: %s\n", brain_server_db_hash->journal_file_old, strerror (errno));
 
-  HCFILE fp;
+        hc_fclose (&fp_src);
 
-  if (hc_fopen (&fp, file, "wb") == false)
-  {
-    brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
+        hc_thread_mutex_unlock (brain_server_db_hash->mux_hj);
 
-    return false;
-  }
+        return false;
+      }
 
-  const size_t nwrite = hc_fwrite (brain_server_db_hash->long_buf, sizeof (brain_server_hash_long_t), brain_server_db_hash->long_cnt, &fp);
+      char *copy_buf = (char *) hcmalloc (BUFSIZ);
 
-  if (nwrite != (size_t) brain_server_db_hash->long_cnt)
-  {
-    brain_logging (stderr, 0, "%s: only %" PRIu64 " bytes written\n", file, (u64) nwrite * sizeof (brain_server_hash_long_t));
+      bool rc = true;
 
-    hc_fclose (&fp);
+      size_t nread;
 
-    return false;
-  }
+      while ((nread = hc_fread (copy_buf, 1, BUFSIZ, &fp_src)) > 0)
+      {
+        if (hc_fwrite (copy_buf, 1, nread, &fp_dst) != nread) rc = false;
+      }
 
-  hc_fclose (&fp);
+      hcfree (copy_buf);
 
-  brain_server_db_hash->write_hashes = false;
+      hc_fclose (&fp_dst);
+      hc_fclose (&fp_src);
 
-  // stats
+      if (rc == false)
+      {
+        brain_logging (stderr, 0, "%s: %s\n", brain_server_db_hash->journal_file_old, strerror (errno));
 
-  const double ms = hc_timer_get (timer_dump);
+        hc_thread_mutex_unlock (brain_server_db_hash->mux_hj);
 
-  struct stat sb;
+        return false;
+      }
 
-  memset (&sb, 0, sizeof (struct stat));
+      unlink (brain_server_db_hash->journal_file);
+    }
+    else
+    {
+      if (rename (brain_server_db_hash->journal_file, brain_server_db_hash->journal_file_old) == -1)
+      {
+        brain_logging (stderr, 0, "%s: %s\n", brain_server_db_hash->journal_file_old, strerror (errno));
 
-  if (stat (file, &sb) == -1)
-  {
-    brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
+        hc_thread_mutex_unlock (brain_server_db_hash->mux_hj);
 
-    return false;
+        return false;
+      }
+    }
   }
 
-  brain_logging (stdout, 0, "Wrote %" PRIu64 " bytes from session 0x%08x in %.2f ms\n", (u64) sb.st_size, brain_server_db_hash->brain_session, ms);
+  // the size covers the old journal too, it's subtracted once the dump is written
+
+  *journal_size = brain_server_db_hash->journal_size;
+
+  hc_thread_mutex_unlock (brain_server_db_hash->mux_hj);
 
   return true;
 }
@@ -2075,7 +3113,7 @@ HC_API_CALL void *brain_server_handle_dumps (void *p)
   {
     if (i == brain_server_timer)
     {
-      brain_server_write_hash_dumps   (brain_server_dbs, ".");
+      brain_server_write_hash_dumps   (brain_server_dbs, ".", false);
       brain_server_write_attack_dumps (brain_server_dbs, ".");
 
       i = 0;
@@ -2091,138 +3129,80 @@ HC_API_CALL void *brain_server_handle_dumps (void *p)
   return NULL;
 }
 
-HC_API_CALL void *brain_server_handle_client (void *p)
+bool brain_server_client_handshake (brain_server_client_options_t *brain_server_client_options)
 {
-  brain_server_client_options_t *brain_server_client_options = (brain_server_client_options_t *) p;
-
   const int   client_idx            = brain_server_client_options->client_idx;
-  const int   client_fd             = brain_server_client_options->client_fd;
   const char *auth_password         = brain_server_client_options->auth_password;
   const u32  *session_whitelist_buf = brain_server_client_options->session_whitelist_buf;
   const int   session_whitelist_cnt = brain_server_client_options->session_whitelist_cnt;
 
   brain_server_dbs_t *brain_server_dbs = brain_server_client_options->brain_server_dbs;
 
-  // client configuration
-
-  #if defined (__linux__)
-  const int one = 1;
-
-  if (setsockopt (client_fd, SOL_TCP, TCP_NODELAY, &one, sizeof (one)) == -1)
-  {
-    brain_logging (stderr, client_idx, "setsockopt: %s\n", strerror (errno));
-
-    brain_server_dbs->client_slots[client_idx] = 0;
-
-    close (client_fd);
-
-    return NULL;
-  }
-  #else
-
-  #endif
-
-  u32 brain_link_version = 0;
-
-  if (brain_recv (client_fd, &brain_link_version, sizeof (brain_link_version), 0, NULL, NULL) == false)
-  {
-    brain_logging (stderr, client_idx, "brain_recv: %s\n", strerror (errno));
-
-    brain_server_dbs->client_slots[client_idx] = 0;
-
-    close (client_fd);
+  const u8 *recv_head = brain_server_client_options->recv_head;
 
-    return NULL;
-  }
-
-  u32 brain_link_version_ok = (brain_link_version >= (u32) BRAIN_LINK_VERSION_MIN) ? 1 : 0;
-
-  if (brain_send (client_fd, &brain_link_version_ok, sizeof (brain_link_version_ok), 0, NULL, NULL) == false)
+  if (brain_server_client_options->stage == BRAIN_SERVER_STAGE_VERSION)
   {
-    brain_logging (stderr, client_idx, "brain_send: %s\n", strerror (errno));
-
-    brain_server_dbs->client_slots[client_idx] = 0;
+    u32 brain_link_version = 0;
 
-    close (client_fd);
+    memcpy (&brain_link_version, recv_head, sizeof (brain_link_version));
 
-    return NULL;
-  }
-
-  if (brain_link_version_ok == 0)
-  {
-    brain_logging (stderr, client_idx, "Invalid version\n");
+    u32 brain_link_version_ok = (brain_link_version >= (u32) BRAIN_LINK_VERSION_MIN) ? 1 : 0;
 
-    brain_server_dbs->client_slots[client_idx] = 0;
+    brain_server_client_reply (brain_server_client_options, &brain_link_version_ok, sizeof (brain_link_version_ok));
 
-    close (client_fd);
+    if (brain_link_version_ok == 0)
+    {
+      brain_logging (stderr, client_idx, "Invalid version\n");
 
-    return NULL;
-  }
+      brain_server_client_options->send_close = true;
 
-  u32 challenge = brain_auth_challenge ();
+      return true;
+    }
 
-  if (brain_send (client_fd, &challenge, sizeof (challenge), 0, NULL, NULL) == false)
-  {
-    brain_logging (stderr, client_idx, "brain_send: %s\n", strerror (errno));
+    brain_server_client_options->challenge = brain_auth_challenge ();
 
-    brain_server_dbs->client_slots[client_idx] = 0;
+    brain_server_client_reply (brain_server_client_options, &brain_server_client_options->challenge, sizeof (brain_server_client_options->challenge));
 
-    close (client_fd);
+    brain_server_client_expect (brain_server_client_options, BRAIN_SERVER_STAGE_RESPONSE, brain_server_client_options->recv_head, sizeof (u64));
 
-    return NULL;
+    return true;
   }
 
-  u64 response = 0;
-
-  if (brain_recv (client_fd, &response, sizeof (response), 0, NULL, NULL) == false)
+  if (brain_server_client_options->stage == BRAIN_SERVER_STAGE_RESPONSE)
   {
-    brain_logging (stderr, client_idx, "brain_recv: %s\n", strerror (errno));
+    u64 response = 0;
 
-    brain_server_dbs->client_slots[client_idx] = 0;
+    memcpy (&response, recv_head, sizeof (response));
 
-    close (client_fd);
+    u64 auth_hash = brain_auth_hash (brain_server_client_options->challenge, auth_password, strlen (auth_password));
 
-    return NULL;
-  }
+    u32 password_ok = (auth_hash == response) ? 1 : 0;
 
-  u64 auth_hash = brain_auth_hash (challenge, auth_password, strlen (auth_password));
+    brain_server_client_reply (brain_server_client_options, &password_ok, sizeof (password_ok));
 
-  u32 password_ok = (auth_hash == response) ? 1 : 0;
+    if (password_ok == 0)
+    {
+      brain_logging (stderr, client_idx, "Invalid password\n");
 
-  if (brain_send (client_fd, &password_ok, sizeof (password_ok), 0, NULL, NULL) == false)
-  {
-    brain_logging (stderr, client_idx, "brain_send: %s\n", strerror (errno));
+      brain_server_client_options->send_close = true;
 
-    brain_server_dbs->client_slots[client_idx] = 0;
+      return true;
+    }
 
-    close (client_fd);
+    brain_server_client_expect (brain_server_client_options, BRAIN_SERVER_STAGE_SESSION, brain_server_client_options->recv_head, sizeof (u32) + sizeof (u32) + sizeof (i64));
 
-    return NULL;
+    return true;
   }
 
-  if (password_ok == 0)
-  {
-    brain_logging (stderr, client_idx, "Invalid password\n");
-
-    brain_server_dbs->client_slots[client_idx] = 0;
-
-    close (client_fd);
-
-    return NULL;
-  }
+  if (brain_server_client_options->stage != BRAIN_SERVER_STAGE_SESSION) return false;
 
   u32 brain_session = 0;
+  u32 brain_attack  = 0;
+  i64 passwords_max = 0;
 
-  if (brain_recv (client_fd, &brain_session, sizeof (brain_session), 0, NULL, NULL) == false)
-  {
-    brain_logging (stderr, client_idx, "brain_recv: %s\n", strerror (errno));
-
-    brain_server_dbs->client_slots[client_idx] = 0;
-
-    close (client_fd);
-
-    return NULL;
-  }
+  memcpy (&brain_session, recv_head + 0, sizeof (brain_session));
+  memcpy (&brain_attack,  recv_head + 4, sizeof (brain_attack));
+  memcpy (&passwords_max, recv_head + 8, sizeof (passwords_max));
 
   if (session_whitelist_cnt > 0)
   {
@@ -2242,49 +3222,22 @@ HC_API_CALL void *brain_server_handle_client (void *p)
     {
       brain_logging (stderr, client_idx, "Invalid brain session: 0x%08x\n", brain_session);
 
-      brain_server_dbs->client_slots[client_idx] = 0;
-
-      close (client_fd);
-
-      return NULL;
+      return false;
     }
   }
 
-  u32 brain_attack = 0;
-
-  if (brain_recv (client_fd, &brain_attack, sizeof (brain_attack), 0, NULL, NULL) == false)
-  {
-    brain_logging (stderr, client_idx, "brain_recv: %s\n", strerror (errno));
-
-    brain_server_dbs->client_slots[client_idx] = 0;
-
-    close (client_fd);
-
-    return NULL;
-  }
-
-  i64 passwords_max = 0;
-
-  if (brain_recv (client_fd, &passwords_max, sizeof (passwords_max), 0, NULL, NULL) == false)
+  if (passwords_max <= 0)
   {
-    brain_logging (stderr, client_idx, "brain_recv: %s\n", strerror (errno));
-
-    brain_server_dbs->client_slots[client_idx] = 0;
+    brain_logging (stderr, client_idx, "Invalid candidate allocation buffer size\n");
 
-    close (client_fd);
-
-    return NULL;
+    return false;
   }
 
   if (passwords_max >= BRAIN_LINK_CANDIDATES_MAX)
   {
     brain_logging (stderr, client_idx, "Too large candidate allocation buffer size\n");
 
-    brain_server_dbs->client_slots[client_idx] = 0;
-
-    close (client_fd);
-
-    return NULL;
+    return false;
   }
 
   brain_logging (stdout, client_idx, "Session: 0x%08x, Attack: 0x%08x, Kernel-power: %" PRIu64 "\n", brain_session, brain_attack, passwords_max);
@@ -2313,13 +3266,9 @@ HC_API_CALL void *brain_server_handle_client (void *p)
     {
       brain_logging (stderr, 0, "too many sessions\n");
 
-      brain_server_dbs->client_slots[client_idx] = 0;
-
       hc_thread_mutex_unlock (brain_server_dbs->mux_dbs);
 
-      close (client_fd);
-
-      return NULL;
+      return false;
     }
 
     brain_server_db_hash = &brain_server_dbs->hash_buf[brain_server_dbs->hash_cnt];
@@ -2349,13 +3298,9 @@ HC_API_CALL void *brain_server_handle_client (void *p)
     {
       brain_logging (stderr, 0, "too many attacks\n");
 
-      brain_server_dbs->client_slots[client_idx] = 0;
-
       hc_thread_mutex_unlock (brain_server_dbs->mux_dbs);
 
-      close (client_fd);
-
-      return NULL;
+      return false;
     }
 
     brain_server_db_attack = &brain_server_dbs->attack_buf[brain_server_dbs->attack_cnt];
@@ -2367,689 +3312,807 @@ HC_API_CALL void *brain_server_handle_client (void *p)
 
   hc_thread_mutex_unlock (brain_server_dbs->mux_dbs);
 
+  // short global alloc and the buffers of a lookup, a partly received lookup has to stay with the client
+
+  brain_server_db_short_t *brain_server_db_short = &brain_server_client_options->brain_server_db_short;
+
+  brain_server_db_short->short_cnt = 0;
+  brain_server_db_short->short_buf = (brain_server_hash_short_t *) hccalloc (passwords_max, sizeof (brain_server_hash_short_t));
+
+  brain_server_client_options->recv_buf = (u32 *) hcmalloc (passwords_max * BRAIN_HASH_SIZE);
+  brain_server_client_options->send_buf = (u8  *) hcmalloc (sizeof (int) + passwords_max); // we can reduce this to 1/8 if we use bits instead of bytes
+
+  if ((brain_server_db_short->short_buf == NULL) || (brain_server_client_options->recv_buf == NULL) || (brain_server_client_options->send_buf == NULL))
+  {
+    brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+
+    return false;
+  }
+
   // highest position of that attack
 
   u64 highest = brain_server_highest_attack (brain_server_db_attack);
 
-  if (brain_send (client_fd, &highest, sizeof (highest), 0, NULL, NULL) == false)
-  {
-    brain_logging (stderr, client_idx, "brain_send: %s\n", strerror (errno));
+  brain_server_client_reply (brain_server_client_options, &highest, sizeof (highest));
 
-    brain_server_dbs->client_slots[client_idx] = 0;
+  brain_server_client_options->passwords_max          = passwords_max;
+  brain_server_client_options->brain_server_db_hash   = brain_server_db_hash;
+  brain_server_client_options->brain_server_db_attack = brain_server_db_attack;
 
-    close (client_fd);
+  brain_server_client_options->connected = true;
 
-    return NULL;
-  }
+  brain_server_client_expect (brain_server_client_options, BRAIN_SERVER_STAGE_OPERATION, brain_server_client_options->recv_head, sizeof (u8));
+
+  return true;
+}
+
+bool brain_server_client_operation (brain_server_client_options_t *brain_server_client_options, brain_server_worker_t *brain_server_worker)
+{
+  const int client_idx    = brain_server_client_options->client_idx;
+  const i64 passwords_max = brain_server_client_options->passwords_max;
 
-  // recv
+  brain_server_db_hash_t   *brain_server_db_hash   = brain_server_client_options->brain_server_db_hash;
+  brain_server_db_attack_t *brain_server_db_attack = brain_server_client_options->brain_server_db_attack;
+  brain_server_db_short_t  *brain_server_db_short  = &brain_server_client_options->brain_server_db_short;
 
   const size_t recv_size = passwords_max * BRAIN_HASH_SIZE;
 
-  u32 *recv_buf = (u32 *) hcmalloc (recv_size);
+  u8 *recv_head = brain_server_client_options->recv_head;
 
-  if (recv_buf == NULL)
+  const int stage = brain_server_client_options->stage;
+
+  // the operation byte only tells which part comes next
+
+  if (stage == BRAIN_SERVER_STAGE_OPERATION)
   {
-    brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+    const u8 operation = recv_head[0];
+
+    if (operation == BRAIN_OPERATION_ATTACK_RESERVE)
+    {
+      brain_server_client_expect (brain_server_client_options, BRAIN_SERVER_STAGE_RESERVE, recv_head, sizeof (u64) + sizeof (u64));
+
+      return true;
+    }
 
-    brain_server_dbs->client_slots[client_idx] = 0;
+    if (operation == BRAIN_OPERATION_HASH_LOOKUP)
+    {
+      brain_server_client_expect (brain_server_client_options, BRAIN_SERVER_STAGE_LOOKUP_SIZE, recv_head, sizeof (int));
 
-    close (client_fd);
+      return true;
+    }
 
-    return NULL;
+    if (operation != BRAIN_OPERATION_COMMIT) return false;
   }
 
-  // send
+  if (stage == BRAIN_SERVER_STAGE_LOOKUP_SIZE)
+  {
+    int in_size = 0;
+
+    memcpy (&in_size, recv_head, sizeof (in_size));
 
-  const size_t send_size = passwords_max * sizeof (char);
+    if (in_size == 0)
+    {
+      brain_logging (stderr, client_idx, "Zero in_size value\n");
 
-  u8 *send_buf = (u8  *) hcmalloc (send_size); // we can reduce this to 1/8 if we use bits instead of bytes
+      return false;
+    }
 
-  if (send_buf == NULL)
-  {
-    brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+    if ((in_size < 0) || (in_size > (int) recv_size)) return false;
+
+    brain_server_client_expect (brain_server_client_options, BRAIN_SERVER_STAGE_LOOKUP, brain_server_client_options->recv_buf, (size_t) in_size);
+
+    return true;
+  }
+
+  // the message is complete, the next one starts with an operation byte again
+
+  const size_t in_size = brain_server_client_options->recv_want;
+
+  brain_server_client_expect (brain_server_client_options, BRAIN_SERVER_STAGE_OPERATION, recv_head, sizeof (u8));
+
+  // U = update
+  // R = request
+  // C = commit
+
+  /**
+   * L = lookup
+   *
+   * In this section the client sends a number of password hashes (max = passwords_max).
+   * The goal is to check them against the long-term memory
+   * to find out if the password is either reserved by any client (can be the same, too)
+   * or if it was already checked in the past and then to send a reject.
+   * This is a complicated process as we have to deal with lots of duplicate data
+   * and with lots of clients both at the same time.
+   * We also have to be very fast in looking up the information otherwise the clients
+   * lose too much performance.
+   * Once a client sends a commit message, all short-term data related to the client
+   * is moved to the long-term memory.
+   * To do that in the commit section, we're storing each hash in the short-term memory
+   * along with client_fd.
+   * The short-term memory itself is limited in size. That's possible because each client
+   * tells the server in the handshake the maximum number of passwords it will send
+   * before it will either disconnect or send a commit signal.
+   * The first procedure for each package of hashes sent by the client is to sort them.
+   * This is done in the client thread and without any mutex barriers, therefore the server
+   * is able to use multiple threads for this action.
+   * This is the only time in the entire process when data is being sorted because
+   * of a smart way of using the data in the following process up to
+   * and later even in the commit process.
+   * We need to make sure that a hash which is stored in the short-term memory is not
+   * already in both the short-term and the long-term memory otherwise we end up in a
+   * corrupted database.
+   * Therefor, as a first step after the data has been sorted, we need to remove all duplicates.
+   * Such duplicates can occur easily in hashcat, for example if hashcat uses a 's' rule.
+   * If such a 's' rule searches for a character which does not exist in the base word
+   * the password is not changed.
+   * If we have multiple of such rules we create lots of duplicates.
+   * As to this point there was no need to use any mutex.
+   * But from now on we need a mutex because we will access two shared memory regions
+   * which both can be written to from any other client.
+   * We'll check the both databases and remove any existing hashes before the go into
+   * the short-term memory but at the same time, update the send[] buffer in case we
+   * need to reject the hash.
+   * This is possible because along with the hash, we also keep track of its original position
+   * in the client stream.
+   * No we ne'll add the remaining hashes to the short-term memory.
+   * This process needs no additional sorting, but we need to update the hashes
+   * at the correct position because this is important for the binary tree search.
+   * So we can not simply append it to the end.
+   * We do not need to care about the short-term memory size because it was preallocated
+   * and it is safe the client does not send more hashes that max_passwords.
+   * The trick here is, since all data at this point is sorted, to merge them in a reverse order.
+   * Using the reverse order allows us to reuse the existing memory, we do not need to
+   * have two buffer allocated. This is more important to the long-term memory which is
+   * using the same technique but has an always growing size.
+   * Basically what we do is that we will use the hashes of the current one of the new hash array
+   * and the current one of the short-term memory as a representation of a pure number.
+   * We take the larger on (a comparison can always be only smaller or larger, not equal)
+   * and store it at the highest array index. We repeat this process till both buffers
+   * have iterate through all of their elements.
+   * It's like a broken zipper.
+   */
+
+  if (stage == BRAIN_SERVER_STAGE_RESERVE)
+  {
+    u64 offset = 0;
+    u64 length = 0;
+
+    memcpy (&offset, recv_head + 0, sizeof (offset));
+    memcpy (&length, recv_head + 8, sizeof (length));
+
+    // time the lookups for debugging
+
+    hc_timer_t timer_reserved;
+
+    hc_timer_set (&timer_reserved);
 
-    brain_server_dbs->client_slots[client_idx] = 0;
+    hc_thread_mutex_lock (brain_server_db_attack->mux_ag);
 
-    close (client_fd);
+    u64 overlap = 0;
 
-    return NULL;
-  }
+    overlap += brain_server_find_attack_short (brain_server_db_attack->short_buf, brain_server_db_attack->short_cnt, offset, length);
+    overlap += brain_server_find_attack_long  (brain_server_db_attack->long_buf,  brain_server_db_attack->long_cnt,  offset + overlap, length - overlap);
 
-  // temp
+    if (overlap < length)
+    {
+      if (brain_server_db_attack_realloc (brain_server_db_attack, 0, 1) == true)
+      {
+        brain_server_db_attack->short_buf[brain_server_db_attack->short_cnt].offset     = offset + overlap;
+        brain_server_db_attack->short_buf[brain_server_db_attack->short_cnt].length     = length - overlap;
+        brain_server_db_attack->short_buf[brain_server_db_attack->short_cnt].client_idx = client_idx;
 
-  brain_server_hash_unique_t *temp_buf = (brain_server_hash_unique_t *) hccalloc (passwords_max, sizeof (brain_server_hash_unique_t));
+        brain_server_db_attack->short_cnt++;
 
-  if (temp_buf == NULL)
-  {
-    brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+        qsort (brain_server_db_attack->short_buf, brain_server_db_attack->short_cnt, sizeof (brain_server_attack_short_t), brain_server_sort_attack_short);
+      }
+    }
 
-    brain_server_dbs->client_slots[client_idx] = 0;
+    hc_thread_mutex_unlock (brain_server_db_attack->mux_ag);
+
+    brain_server_client_reply (brain_server_client_options, &overlap, sizeof (overlap));
 
-    close (client_fd);
+    const double ms = hc_timer_get (timer_reserved);
 
-    return NULL;
+    brain_logging (stdout, client_idx, "R | %8.2f ms | Offset: %" PRIu64 ", Length: %" PRIu64 ", Overlap: %" PRIu64 "\n", ms, offset, length, overlap);
   }
+  else if (stage == BRAIN_SERVER_STAGE_OPERATION)
+  {
+    // commit
+    // time the lookups for debugging
 
-  // short global alloc
+    hc_timer_t timer_commit;
 
-  brain_server_db_short_t *brain_server_db_short = (brain_server_db_short_t *) hcmalloc (sizeof (brain_server_db_short_t));
+    hc_timer_set (&timer_commit);
 
-  brain_server_db_short->short_cnt = 0;
-  brain_server_db_short->short_buf = (brain_server_hash_short_t *) hccalloc (passwords_max, sizeof (brain_server_hash_short_t));
+    hc_thread_mutex_lock (brain_server_db_attack->mux_ag);
 
-  if (brain_server_db_short->short_buf == NULL)
-  {
-    brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+    i64 new_attacks = 0;
 
-    brain_server_dbs->client_slots[client_idx] = 0;
+    for (i64 idx = 0; idx < brain_server_db_attack->short_cnt; idx++)
+    {
+      if (brain_server_db_attack->short_buf[idx].client_idx == client_idx)
+      {
+        if (brain_server_db_attack_realloc (brain_server_db_attack, 1, 0) == true)
+        {
+          brain_server_db_attack->long_buf[brain_server_db_attack->long_cnt].offset = brain_server_db_attack->short_buf[idx].offset;
+          brain_server_db_attack->long_buf[brain_server_db_attack->long_cnt].length = brain_server_db_attack->short_buf[idx].length;
 
-    close (client_fd);
+          brain_server_db_attack->long_cnt++;
 
-    return NULL;
-  }
+          qsort (brain_server_db_attack->long_buf, brain_server_db_attack->long_cnt, sizeof (brain_server_attack_long_t), brain_server_sort_attack_long);
+        }
+        else
+        {
+          brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+        }
 
-  // main loop
+        brain_server_db_attack->short_buf[idx].offset     = 0;
+        brain_server_db_attack->short_buf[idx].length     = 0;
+        brain_server_db_attack->short_buf[idx].client_idx = 0;
 
-  while (keep_running == true)
+        new_attacks++;
+      }
+    }
+
+    brain_server_db_attack->write_attacks = true;
+
+    hc_thread_mutex_unlock (brain_server_db_attack->mux_ag);
+
+    if (new_attacks)
+    {
+      const double ms_attacks = hc_timer_get (timer_commit);
+
+      brain_logging (stdout, client_idx, "C | %8.2f ms | Attacks: %" PRIi64 "\n", ms_attacks, new_attacks);
+    }
+
+    // time the lookups for debugging
+
+    hc_timer_set (&timer_commit);
+
+    // long-term memory merge
+
+    if (brain_server_db_short->short_cnt)
+    {
+      if (brain_server_db_hash_commit (brain_server_db_hash, brain_server_db_short->short_buf, brain_server_db_short->short_cnt) == false)
+      {
+        brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+      }
+
+      brain_server_write_hash_journal (brain_server_db_hash, brain_server_db_short->short_buf, brain_server_db_short->short_cnt);
+    }
+
+    if (brain_server_db_short->short_cnt)
+    {
+      const double ms_hashes = hc_timer_get (timer_commit);
+
+      brain_logging (stdout, client_idx, "C | %8.2f ms | Hashes: %" PRIi64 "\n", ms_hashes, brain_server_db_short->short_cnt);
+    }
+
+    brain_server_db_short->short_cnt = 0;
+  }
+  else if (stage == BRAIN_SERVER_STAGE_LOOKUP)
   {
-    // wait for client to send data, but not too long
+    if (brain_server_worker_realloc (brain_server_worker, passwords_max) == false)
+    {
+      brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
 
-    const int rc_select = select_read_timeout (client_fd, 1);
+      return false;
+    }
 
-    if (rc_select == -1) break;
+    const u32                  *recv_buf = brain_server_client_options->recv_buf;
+    u8                         *send_buf = brain_server_client_options->send_buf + sizeof (int);
+    brain_server_hash_unique_t *temp_buf = brain_server_worker->temp_buf;
 
-    if (rc_select == 0) continue;
+    const int hashes_cnt = (int) in_size / BRAIN_HASH_SIZE;
 
-    // there's data
-
-    u8 operation = 0;
-
-    if (brain_recv (client_fd, &operation, sizeof (operation), 0, NULL, NULL) == false) break;
-
-    // U = update
-    // R = request
-    // C = commit
-
-    /**
-     * L = lookup
-     *
-     * In this section the client sends a number of password hashes (max = passwords_max).
-     * The goal is to check them against the long-term memory
-     * to find out if the password is either reserved by any client (can be the same, too)
-     * or if it was already checked in the past and then to send a reject.
-     * This is a complicated process as we have to deal with lots of duplicate data
-     * and with lots of clients both at the same time.
-     * We also have to be very fast in looking up the information otherwise the clients
-     * lose too much performance.
-     * Once a client sends a commit message, all short-term data related to the client
-     * is moved to the long-term memory.
-     * To do that in the commit section, we're storing each hash in the short-term memory
-     * along with client_fd.
-     * The short-term memory itself is limited in size. That's possible because each client
-     * tells the server in the handshake the maximum number of passwords it will send
-     * before it will either disconnect or send a commit signal.
-     * The first procedure for each package of hashes sent by the client is to sort them.
-     * This is done in the client thread and without any mutex barriers, therefore the server
-     * is able to use multiple threads for this action.
-     * This is the only time in the entire process when data is being sorted because
-     * of a smart way of using the data in the following process up to
-     * and later even in the commit process.
-     * We need to make sure that a hash which is stored in the short-term memory is not
-     * already in both the short-term and the long-term memory otherwise we end up in a
-     * corrupted database.
-     * Therefor, as a first step after the data has been sorted, we need to remove all duplicates.
-     * Such duplicates can occur easily in hashcat, for example if hashcat uses a 's' rule.
-     * If such a 's' rule searches for a character which does not exist in the base word
-     * the password is not changed.
-     * If we have multiple of such rules we create lots of duplicates.
-     * As to this point there was no need to use any mutex.
-     * But from now on we need a mutex because we will access two shared memory regions
-     * which both can be written to from any other client.
-     * We'll check the both databases and remove any existing hashes before the go into
-     * the short-term memory but at the same time, update the send[] buffer in case we
-     * need to reject the hash.
-     * This is possible because along with the hash, we also keep track of its original position
-     * in the client stream.
-     * No we ne'll add the remaining hashes to the short-term memory.
-     * This process needs no additional sorting, but we need to update the hashes
-     * at the correct position because this is important for the binary tree search.
-     * So we can not simply append it to the end.
-     * We do not need to care about the short-term memory size because it was preallocated
-     * and it is safe the client does not send more hashes that max_passwords.
-     * The trick here is, since all data at this point is sorted, to merge them in a reverse order.
-     * Using the reverse order allows us to reuse the existing memory, we do not need to
-     * have two buffer allocated. This is more important to the long-term memory which is
-     * using the same technique but has an always growing size.
-     * Basically what we do is that we will use the hashes of the current one of the new hash array
-     * and the current one of the short-term memory as a representation of a pure number.
-     * We take the larger on (a comparison can always be only smaller or larger, not equal)
-     * and store it at the highest array index. We repeat this process till both buffers
-     * have iterate through all of their elements.
-     * It's like a broken zipper.
-     */
+    if (hashes_cnt == 0)
+    {
+      brain_logging (stderr, client_idx, "Zero passwords\n");
 
-    if (operation == BRAIN_OPERATION_ATTACK_RESERVE)
+      return false;
+    }
+
+    if ((brain_server_db_short->short_cnt + hashes_cnt) > passwords_max)
+    {
+      brain_logging (stderr, client_idx, "Too many passwords\n");
+
+      return false;
+    }
+
+    // time the lookups for debugging
+
+    hc_timer_t timer_lookup;
+
+    hc_timer_set (&timer_lookup);
+
+    // make it easier to work with
+
+    for (int hash_idx = 0, recv_idx = 0; hash_idx < hashes_cnt; hash_idx += 1, recv_idx += 2)
     {
-      u64 offset = 0;
-      u64 length = 0;
+      temp_buf[hash_idx].hash[0] = recv_buf[recv_idx + 0];
+      temp_buf[hash_idx].hash[1] = recv_buf[recv_idx + 1];
 
-      if (brain_recv (client_fd, &offset, sizeof (offset), 0, NULL, NULL) == false) break;
-      if (brain_recv (client_fd, &length, sizeof (length), 0, NULL, NULL) == false) break;
+      temp_buf[hash_idx].hash_idx = hash_idx;
 
-      // time the lookups for debugging
+      send_buf[hash_idx] = 0;
+    }
 
-      hc_timer_t timer_reserved;
+    // unique temp memory
 
-      hc_timer_set (&timer_reserved);
+    i64 temp_cnt = 0;
 
-      hc_thread_mutex_lock (brain_server_db_attack->mux_ag);
+    qsort (temp_buf, hashes_cnt, sizeof (brain_server_hash_unique_t), brain_server_sort_hash_unique);
 
-      u64 overlap = 0;
+    brain_server_hash_unique_t *prev = temp_buf + temp_cnt;
 
-      overlap += brain_server_find_attack_short (brain_server_db_attack->short_buf, brain_server_db_attack->short_cnt, offset, length);
-      overlap += brain_server_find_attack_long  (brain_server_db_attack->long_buf,  brain_server_db_attack->long_cnt,  offset + overlap, length - overlap);
+    for (i64 temp_idx = 1; temp_idx < hashes_cnt; temp_idx++)
+    {
+      brain_server_hash_unique_t *cur = temp_buf + temp_idx;
 
-      if (overlap < length)
+      if ((cur->hash[0] == prev->hash[0]) && (cur->hash[1] == prev->hash[1]))
       {
-        if (brain_server_db_attack_realloc (brain_server_db_attack, 0, 1) == true)
-        {
-          brain_server_db_attack->short_buf[brain_server_db_attack->short_cnt].offset     = offset + overlap;
-          brain_server_db_attack->short_buf[brain_server_db_attack->short_cnt].length     = length - overlap;
-          brain_server_db_attack->short_buf[brain_server_db_attack->short_cnt].client_idx = client_idx;
+        send_buf[cur->hash_idx] = 1;
+      }
+      else
+      {
+        temp_cnt++;
 
-          brain_server_db_attack->short_cnt++;
+        prev = temp_buf + temp_cnt;
 
-          qsort (brain_server_db_attack->short_buf, brain_server_db_attack->short_cnt, sizeof (brain_server_attack_short_t), brain_server_sort_attack_short);
-        }
+        prev->hash[0] = cur->hash[0];
+        prev->hash[1] = cur->hash[1];
+
+        prev->hash_idx = cur->hash_idx; // we need this in a later stage
       }
+    }
 
-      hc_thread_mutex_unlock (brain_server_db_attack->mux_ag);
+    temp_cnt++;
 
-      if (brain_send (client_fd, &overlap, sizeof (overlap), SEND_FLAGS, NULL, NULL) == false) break;
+    // check if they are in long term memory
 
-      const double ms = hc_timer_get (timer_reserved);
+    temp_cnt = brain_server_db_hash_lookup (brain_server_db_hash, temp_buf, temp_cnt, send_buf);
 
-      brain_logging (stdout, client_idx, "R | %8.2f ms | Offset: %" PRIu64 ", Length: %" PRIu64 ", Overlap: %" PRIu64 "\n", ms, offset, length, overlap);
-    }
-    else if (operation == BRAIN_OPERATION_COMMIT)
+    // check if they are in short term memory
+
+    if (temp_cnt > 0)
     {
-      // time the lookups for debugging
+      i64 temp_idx_new = 0;
+
+      for (i64 temp_idx = 0; temp_idx < temp_cnt; temp_idx++)
+      {
+        brain_server_hash_unique_t *cur = &temp_buf[temp_idx];
+
+        const i64 r = brain_server_find_hash_short (cur->hash, brain_server_db_short->short_buf, brain_server_db_short->short_cnt);
+
+        if (r != -1)
+        {
+          send_buf[cur->hash_idx] = 1;
+        }
+        else
+        {
+          brain_server_hash_unique_t *save = temp_buf + temp_idx_new;
 
-      hc_timer_t timer_commit;
+          temp_idx_new++;
 
-      hc_timer_set (&timer_commit);
+          save->hash[0] = cur->hash[0];
+          save->hash[1] = cur->hash[1];
 
-      hc_thread_mutex_lock (brain_server_db_attack->mux_ag);
+          save->hash_idx = cur->hash_idx; // we need this in a later stage
+        }
+      }
+
+      temp_cnt = temp_idx_new;
+    }
 
-      i64 new_attacks = 0;
+    // update remaining
+
+    if (temp_cnt > 0)
+    {
+      if (brain_server_db_short->short_cnt == 0)
+      {
+        for (i64 idx = 0; idx < temp_cnt; idx++)
+        {
+          brain_server_db_short->short_buf[idx].hash[0] = temp_buf[idx].hash[0];
+          brain_server_db_short->short_buf[idx].hash[1] = temp_buf[idx].hash[1];
+        }
 
-      for (i64 idx = 0; idx < brain_server_db_attack->short_cnt; idx++)
+        brain_server_db_short->short_cnt = temp_cnt;
+      }
+      else
       {
-        if (brain_server_db_attack->short_buf[idx].client_idx == client_idx)
+        const i64 cnt_total = brain_server_db_short->short_cnt + temp_cnt;
+
+        i64 short_left  = brain_server_db_short->short_cnt - 1;
+        i64 unique_left = temp_cnt - 1;
+
+        for (i64 idx = cnt_total - 1; idx >= 0; idx--)
         {
-          if (brain_server_db_attack_realloc (brain_server_db_attack, 1, 0) == true)
+          const brain_server_hash_short_t  *short_entry  = brain_server_db_short->short_buf + short_left;
+          const brain_server_hash_unique_t *unique_entry = temp_buf + unique_left;
+
+          int rc = 0;
+
+          if ((short_left >= 0) && (unique_left >= 0))
+          {
+            rc = brain_server_sort_hash (short_entry->hash, unique_entry->hash);
+          }
+          else if (short_left >= 0)
+          {
+            rc = 1;
+          }
+          else if (unique_left >= 0)
+          {
+            rc = -1;
+          }
+          else
+          {
+            brain_logging (stderr, client_idx, "unexpected remaining buffers in compare: %" PRIi64 " - %" PRIi64 "\n", short_left, unique_left);
+          }
+
+          brain_server_hash_short_t *next = brain_server_db_short->short_buf + idx;
+
+          if (rc == -1)
           {
-            brain_server_db_attack->long_buf[brain_server_db_attack->long_cnt].offset = brain_server_db_attack->short_buf[idx].offset;
-            brain_server_db_attack->long_buf[brain_server_db_attack->long_cnt].length = brain_server_db_attack->short_buf[idx].length;
+            next->hash[0] = unique_entry->hash[0];
+            next->hash[1] = unique_entry->hash[1];
 
-            brain_server_db_attack->long_cnt++;
+            unique_left--;
+          }
+          else if (rc == 1)
+          {
+            next->hash[0] = short_entry->hash[0];
+            next->hash[1] = short_entry->hash[1];
 
-            qsort (brain_server_db_attack->long_buf, brain_server_db_attack->long_cnt, sizeof (brain_server_attack_long_t), brain_server_sort_attack_long);
+            short_left--;
           }
           else
           {
-            brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+            brain_logging (stderr, client_idx, "unexpected zero comparison in commit\n");
           }
+        }
 
-          brain_server_db_attack->short_buf[idx].offset     = 0;
-          brain_server_db_attack->short_buf[idx].length     = 0;
-          brain_server_db_attack->short_buf[idx].client_idx = 0;
-
-          new_attacks++;
+        if ((short_left != -1) || (unique_left != -1))
+        {
+          brain_logging (stderr, client_idx, "unexpected remaining buffers in commit: %" PRIi64 " - %" PRIi64 "\n", short_left, unique_left);
         }
+
+        brain_server_db_short->short_cnt = cnt_total;
       }
+    }
 
-      brain_server_db_attack->write_attacks = true;
+    // opportunity to set counters for stats
 
-      hc_thread_mutex_unlock (brain_server_db_attack->mux_ag);
+    int local_lookup_new = 0;
 
-      if (new_attacks)
+    for (i64 hashes_idx = 0; hashes_idx < hashes_cnt; hashes_idx++)
+    {
+      if (send_buf[hashes_idx] == 0)
       {
-        const double ms_attacks = hc_timer_get (timer_commit);
-
-        brain_logging (stdout, client_idx, "C | %8.2f ms | Attacks: %" PRIi64 "\n", ms_attacks, new_attacks);
+        local_lookup_new++;
       }
+    }
 
-      // time the lookups for debugging
+    // needs anti-flood fix
 
-      hc_timer_set (&timer_commit);
+    const double ms = hc_timer_get (timer_lookup);
 
-      hc_thread_mutex_lock (brain_server_db_hash->mux_hg);
+    brain_logging (stdout, client_idx, "L | %8.2f ms | Long: %" PRIi64 ", Inc: %d, New: %d\n", ms, brain_server_db_hash->long_cnt, hashes_cnt, local_lookup_new);
 
-      // long-term memory merge
+    // send
 
-      if (brain_server_db_short->short_cnt)
-      {
-        if (brain_server_db_hash_realloc (brain_server_db_hash, brain_server_db_short->short_cnt) == true)
-        {
-          if (brain_server_db_hash->long_cnt == 0)
-          {
-            for (i64 idx = 0; idx < brain_server_db_short->short_cnt; idx++)
-            {
-              brain_server_db_hash->long_buf[idx].hash[0] = brain_server_db_short->short_buf[idx].hash[0];
-              brain_server_db_hash->long_buf[idx].hash[1] = brain_server_db_short->short_buf[idx].hash[1];
-            }
+    int out_size = hashes_cnt;
 
-            brain_server_db_hash->long_cnt = brain_server_db_short->short_cnt;
-          }
-          else
-          {
-            const i64 cnt_total = brain_server_db_hash->long_cnt + brain_server_db_short->short_cnt;
-
-            i64 long_left  = brain_server_db_hash->long_cnt - 1;
-            i64 short_left = brain_server_db_short->short_cnt - 1;
-            i64 long_dupes = 0;
-
-            for (i64 idx = cnt_total - 1; idx >= long_dupes; idx--)
-            {
-              const brain_server_hash_long_t  *long_entry  = &brain_server_db_hash->long_buf[long_left];
-              const brain_server_hash_short_t *short_entry = &brain_server_db_short->short_buf[short_left];
-
-              int rc = 0;
-
-              if ((long_left >= 0) && (short_left >= 0))
-              {
-                rc = brain_server_sort_hash (long_entry->hash, short_entry->hash);
-              }
-              else if (long_left >= 0)
-              {
-                rc = 1;
-              }
-              else if (short_left >= 0)
-              {
-                rc = -1;
-              }
-              else
-              {
-                brain_logging (stderr, client_idx, "unexpected remaining buffers in compare: %" PRIi64 " - %" PRIi64 "\n", long_left, short_left);
-              }
-
-              brain_server_hash_long_t *next = &brain_server_db_hash->long_buf[idx];
-
-              if (rc == -1)
-              {
-                next->hash[0] = short_entry->hash[0];
-                next->hash[1] = short_entry->hash[1];
-
-                short_left--;
-              }
-              else if (rc == 1)
-              {
-                next->hash[0] = long_entry->hash[0];
-                next->hash[1] = long_entry->hash[1];
-
-                long_left--;
-              }
-              else
-              {
-                next->hash[0] = long_entry->hash[0];
-                next->hash[1] = long_entry->hash[1];
-
-                short_left--;
-                long_left--;
-
-                long_dupes++;
-              }
-            }
-
-            if ((long_left != -1) || (short_left != -1))
-            {
-              brain_logging (stderr, client_idx, "unexpected remaining buffers in commit: %" PRIi64 " - %" PRIi64 "\n", long_left, short_left);
-            }
-
-            brain_server_db_hash->long_cnt = cnt_total - long_dupes;
-
-            if (long_dupes)
-            {
-              for (i64 idx = 0; idx < brain_server_db_hash->long_cnt; idx++)
-              {
-                brain_server_db_hash->long_buf[idx].hash[0] = brain_server_db_hash->long_buf[long_dupes + idx].hash[0];
-                brain_server_db_hash->long_buf[idx].hash[1] = brain_server_db_hash->long_buf[long_dupes + idx].hash[1];
-              }
-            }
-          }
-        }
-        else
-        {
-          brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
-        }
+    memcpy (brain_server_client_options->send_buf, &out_size, sizeof (out_size));
 
-        brain_server_db_hash->write_hashes = true;
-      }
+    brain_server_client_options->send_ptr  = brain_server_client_options->send_buf;
+    brain_server_client_options->send_want = sizeof (out_size) + out_size;
+    brain_server_client_options->send_done = 0;
+  }
+  else
+  {
+    return false;
+  }
 
-      hc_thread_mutex_unlock (brain_server_db_hash->mux_hg);
+  return true;
+}
 
-      if (brain_server_db_short->short_cnt)
-      {
-        const double ms_hashes = hc_timer_get (timer_commit);
+int brain_server_client_serve (brain_server_client_options_t *brain_server_client_options, brain_server_worker_t *brain_server_worker)
+{
+  // a reply the socket did not take at once goes out first
 
-        brain_logging (stdout, client_idx, "C | %8.2f ms | Hashes: %" PRIi64 "\n", ms_hashes, brain_server_db_short->short_cnt);
-      }
+  const int rc_flush = brain_server_client_send (brain_server_client_options);
 
-      brain_server_db_short->short_cnt = 0;
-    }
-    else if (operation == BRAIN_OPERATION_HASH_LOOKUP)
-    {
-      int in_size = 0;
+  if (rc_flush == -1) return BRAIN_SERVER_LINK_CLOSE;
+  if (rc_flush ==  0) return BRAIN_SERVER_LINK_WRITE;
 
-      if (brain_recv (client_fd, &in_size, sizeof (in_size), 0, NULL, NULL) == false) break;
+  if (brain_server_client_options->send_close == true) return BRAIN_SERVER_LINK_CLOSE;
 
-      if (in_size == 0)
-      {
-        brain_logging (stderr, client_idx, "Zero in_size value\n");
+  // the parts of one message often arrive together, the next message has to wait for the next round
 
-        break;
-      }
+  do
+  {
+    const int rc_recv = brain_server_client_recv (brain_server_client_options);
 
-      if (in_size > (int) recv_size) break;
+    if (rc_recv == -1) return BRAIN_SERVER_LINK_CLOSE;
+    if (rc_recv ==  0) return BRAIN_SERVER_LINK_READ;
 
-      if (brain_recv (client_fd, recv_buf, (size_t) in_size, 0, NULL, NULL) == false) break;
+    bool rc = false;
 
-      const int hashes_cnt = in_size / BRAIN_HASH_SIZE;
+    if (brain_server_client_options->connected == false)
+    {
+      rc = brain_server_client_handshake (brain_server_client_options);
+    }
+    else
+    {
+      rc = brain_server_client_operation (brain_server_client_options, brain_server_worker);
+    }
 
-      if (hashes_cnt == 0)
-      {
-        brain_logging (stderr, client_idx, "Zero passwords\n");
+    if (rc == false) return BRAIN_SERVER_LINK_CLOSE;
 
-        break;
-      }
+  } while ((brain_server_client_options->send_want == 0) && (brain_server_client_options->stage != BRAIN_SERVER_STAGE_OPERATION));
 
-      if ((brain_server_db_short->short_cnt + hashes_cnt) > passwords_max)
-      {
-        brain_logging (stderr, client_idx, "Too many passwords\n");
+  const int rc_send = brain_server_client_send (brain_server_client_options);
 
-        break;
-      }
+  if (rc_send == -1) return BRAIN_SERVER_LINK_CLOSE;
+  if (rc_send ==  0) return BRAIN_SERVER_LINK_WRITE;
 
-      // time the lookups for debugging
+  if (brain_server_client_options->send_close == true) return BRAIN_SERVER_LINK_CLOSE;
 
-      hc_timer_t timer_lookup;
+  return BRAIN_SERVER_LINK_READ;
+}
 
-      hc_timer_set (&timer_lookup);
+int brain_server_client_recv (brain_server_client_options_t *brain_server_client_options)
+{
+  // 1 = the part is complete, 0 = the socket has no more data for now, -1 = the link is gone
 
-      // make it easier to work with
+  while (brain_server_client_options->recv_have < brain_server_client_options->recv_want)
+  {
+    char *ptr = (char *) brain_server_client_options->recv_ptr + brain_server_client_options->recv_have;
 
-      for (int hash_idx = 0, recv_idx = 0; hash_idx < hashes_cnt; hash_idx += 1, recv_idx += 2)
-      {
-        temp_buf[hash_idx].hash[0] = recv_buf[recv_idx + 0];
-        temp_buf[hash_idx].hash[1] = recv_buf[recv_idx + 1];
+    const ssize_t nrecv = recv (brain_server_client_options->client_fd, ptr, brain_server_client_options->recv_want - brain_server_client_options->recv_have, 0);
 
-        temp_buf[hash_idx].hash_idx = hash_idx;
+    if (nrecv == 0) return -1;
 
-        send_buf[hash_idx] = 0;
-      }
+    if (nrecv < 0)
+    {
+      if (errno == EINTR) continue;
 
-      // unique temp memory
+      if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) return 0;
 
-      i64 temp_cnt = 0;
+      return -1;
+    }
 
-      qsort (temp_buf, hashes_cnt, sizeof (brain_server_hash_unique_t), brain_server_sort_hash_unique);
+    brain_server_client_options->recv_have += nrecv;
+  }
 
-      brain_server_hash_unique_t *prev = temp_buf + temp_cnt;
+  return 1;
+}
 
-      for (i64 temp_idx = 1; temp_idx < hashes_cnt; temp_idx++)
-      {
-        brain_server_hash_unique_t *cur = temp_buf + temp_idx;
+int brain_server_client_send (brain_server_client_options_t *brain_server_client_options)
+{
+  // 1 = nothing left to send, 0 = the socket buffer is full, -1 = the link is gone
 
-        if ((cur->hash[0] == prev->hash[0]) && (cur->hash[1] == prev->hash[1]))
-        {
-          send_buf[cur->hash_idx] = 1;
-        }
-        else
-        {
-          temp_cnt++;
+  while (brain_server_client_options->send_done < brain_server_client_options->send_want)
+  {
+    const char *ptr = (const char *) brain_server_client_options->send_ptr + brain_server_client_options->send_done;
 
-          prev = temp_buf + temp_cnt;
+    const ssize_t nsend = send (brain_server_client_options->client_fd, ptr, brain_server_client_options->send_want - brain_server_client_options->send_done, SEND_FLAGS);
 
-          prev->hash[0] = cur->hash[0];
-          prev->hash[1] = cur->hash[1];
+    if (nsend < 0)
+    {
+      if (errno == EINTR) continue;
 
-          prev->hash_idx = cur->hash_idx; // we need this in a later stage
-        }
-      }
+      if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) return 0;
 
-      temp_cnt++;
+      return -1;
+    }
 
-      // check if they are in long term memory
+    brain_server_client_options->send_done += nsend;
+  }
 
-      hc_thread_mutex_lock (brain_server_db_hash->mux_hr);
+  brain_server_client_options->send_want = 0;
+  brain_server_client_options->send_done = 0;
 
-      brain_server_db_hash->hb++;
+  return 1;
+}
 
-      if (brain_server_db_hash->hb == 1)
-      {
-        hc_thread_mutex_lock (brain_server_db_hash->mux_hg);
-      }
+void brain_server_client_expect (brain_server_client_options_t *brain_server_client_options, const int stage, void *buf, const size_t len)
+{
+  brain_server_client_options->stage     = stage;
+  brain_server_client_options->recv_ptr  = (u8 *) buf;
+  brain_server_client_options->recv_want = len;
+  brain_server_client_options->recv_have = 0;
+}
 
-      hc_thread_mutex_unlock (brain_server_db_hash->mux_hr);
+void brain_server_client_reply (brain_server_client_options_t *brain_server_client_options, const void *buf, const size_t len)
+{
+  // small replies only, they are queued in send_head
 
-      if (temp_cnt > 0)
-      {
-        i64 temp_idx_new = 0;
+  if ((brain_server_client_options->send_want + len) > sizeof (brain_server_client_options->send_head)) return;
 
-        for (i64 temp_idx = 0; temp_idx < temp_cnt; temp_idx++)
-        {
-          brain_server_hash_unique_t *cur = &temp_buf[temp_idx];
+  memcpy (brain_server_client_options->send_head + brain_server_client_options->send_want, buf, len);
 
-          const i64 r = brain_server_find_hash_long (cur->hash, brain_server_db_hash->long_buf, brain_server_db_hash->long_cnt);
+  brain_server_client_options->send_ptr   = brain_server_client_options->send_head;
+  brain_server_client_options->send_want += len;
+}
 
-          if (r != -1)
-          {
-            send_buf[cur->hash_idx] = 1;
-          }
-          else
-          {
-            brain_server_hash_unique_t *save = temp_buf + temp_idx_new;
+void brain_server_client_open (brain_server_client_options_t *brain_server_client_options, const int client_fd)
+{
+  brain_server_client_options->client_fd  = client_fd;
+  brain_server_client_options->send_want  = 0;
+  brain_server_client_options->send_done  = 0;
+  brain_server_client_options->send_close = false;
 
-            temp_idx_new++;
+  brain_server_client_expect (brain_server_client_options, BRAIN_SERVER_STAGE_VERSION, brain_server_client_options->recv_head, sizeof (u32));
+}
 
-            save->hash[0] = cur->hash[0];
-            save->hash[1] = cur->hash[1];
+void brain_server_client_close (brain_server_client_options_t *brain_server_client_options)
+{
+  const int client_idx = brain_server_client_options->client_idx;
 
-            save->hash_idx = cur->hash_idx; // we need this in a later stage
-          }
-        }
+  brain_server_dbs_t *brain_server_dbs = brain_server_client_options->brain_server_dbs;
 
-        temp_cnt = temp_idx_new;
-      }
+  // client reservations
 
-      hc_thread_mutex_lock (brain_server_db_hash->mux_hr);
+  brain_server_db_attack_t *brain_server_db_attack = brain_server_client_options->brain_server_db_attack;
 
-      brain_server_db_hash->hb--;
+  if (brain_server_db_attack != NULL)
+  {
+    hc_thread_mutex_lock (brain_server_db_attack->mux_ag);
 
-      if (brain_server_db_hash->hb == 0)
+    for (i64 idx = 0; idx < brain_server_db_attack->short_cnt; idx++)
+    {
+      if (brain_server_db_attack->short_buf[idx].client_idx == client_idx)
       {
-        hc_thread_mutex_unlock (brain_server_db_hash->mux_hg);
+        brain_server_db_attack->short_buf[idx].offset     = 0;
+        brain_server_db_attack->short_buf[idx].length     = 0;
+        brain_server_db_attack->short_buf[idx].client_idx = 0;
       }
+    }
 
-      hc_thread_mutex_unlock (brain_server_db_hash->mux_hr);
+    hc_thread_mutex_unlock (brain_server_db_attack->mux_ag);
+  }
 
-      // check if they are in short term memory
+  // short free
 
-      if (temp_cnt > 0)
-      {
-        i64 temp_idx_new = 0;
+  hcfree (brain_server_client_options->brain_server_db_short.short_buf);
 
-        for (i64 temp_idx = 0; temp_idx < temp_cnt; temp_idx++)
-        {
-          brain_server_hash_unique_t *cur = &temp_buf[temp_idx];
+  brain_server_client_options->brain_server_db_short.short_buf = NULL;
+  brain_server_client_options->brain_server_db_short.short_cnt = 0;
 
-          const i64 r = brain_server_find_hash_short (cur->hash, brain_server_db_short->short_buf, brain_server_db_short->short_cnt);
+  hcfree (brain_server_client_options->recv_buf);
+  hcfree (brain_server_client_options->send_buf);
 
-          if (r != -1)
-          {
-            send_buf[cur->hash_idx] = 1;
-          }
-          else
-          {
-            brain_server_hash_unique_t *save = temp_buf + temp_idx_new;
+  brain_server_client_options->recv_buf = NULL;
+  brain_server_client_options->send_buf = NULL;
 
-            temp_idx_new++;
+  if (brain_server_client_options->connected == true)
+  {
+    brain_logging (stdout, client_idx, "Disconnected\n");
+  }
 
-            save->hash[0] = cur->hash[0];
-            save->hash[1] = cur->hash[1];
+  brain_server_client_options->connected              = false;
+  brain_server_client_options->passwords_max          = 0;
+  brain_server_client_options->brain_server_db_hash   = NULL;
+  brain_server_client_options->brain_server_db_attack = NULL;
 
-            save->hash_idx = cur->hash_idx; // we need this in a later stage
-          }
-        }
+  close (brain_server_client_options->client_fd);
 
-        temp_cnt = temp_idx_new;
-      }
+  brain_server_client_options->client_fd = -1;
 
-      // update remaining
+  brain_server_dbs->client_slots[client_idx] = 0;
+}
 
-      if (temp_cnt > 0)
-      {
-        if (brain_server_db_short->short_cnt == 0)
-        {
-          for (i64 idx = 0; idx < temp_cnt; idx++)
-          {
-            brain_server_db_short->short_buf[idx].hash[0] = temp_buf[idx].hash[0];
-            brain_server_db_short->short_buf[idx].hash[1] = temp_buf[idx].hash[1];
-          }
+bool brain_server_worker_realloc (brain_server_worker_t *brain_server_worker, const i64 passwords_max)
+{
+  if (passwords_max <= brain_server_worker->passwords_max) return true;
 
-          brain_server_db_short->short_cnt = temp_cnt;
-        }
-        else
-        {
-          const i64 cnt_total = brain_server_db_short->short_cnt + temp_cnt;
+  hcfree (brain_server_worker->temp_buf);
 
-          i64 short_left  = brain_server_db_short->short_cnt - 1;
-          i64 unique_left = temp_cnt - 1;
+  brain_server_worker->temp_buf = (brain_server_hash_unique_t *) hccalloc (passwords_max, sizeof (brain_server_hash_unique_t));
 
-          for (i64 idx = cnt_total - 1; idx >= 0; idx--)
-          {
-            const brain_server_hash_short_t  *short_entry  = brain_server_db_short->short_buf + short_left;
-            const brain_server_hash_unique_t *unique_entry = temp_buf + unique_left;
-
-            int rc = 0;
-
-            if ((short_left >= 0) && (unique_left >= 0))
-            {
-              rc = brain_server_sort_hash (short_entry->hash, unique_entry->hash);
-            }
-            else if (short_left >= 0)
-            {
-              rc = 1;
-            }
-            else if (unique_left >= 0)
-            {
-              rc = -1;
-            }
-            else
-            {
-              brain_logging (stderr, client_idx, "unexpected remaining buffers in compare: %" PRIi64 " - %" PRIi64 "\n", short_left, unique_left);
-            }
-
-            brain_server_hash_short_t *next = brain_server_db_short->short_buf + idx;
-
-            if (rc == -1)
-            {
-              next->hash[0] = unique_entry->hash[0];
-              next->hash[1] = unique_entry->hash[1];
-
-              unique_left--;
-            }
-            else if (rc == 1)
-            {
-              next->hash[0] = short_entry->hash[0];
-              next->hash[1] = short_entry->hash[1];
-
-              short_left--;
-            }
-            else
-            {
-              brain_logging (stderr, client_idx, "unexpected zero comparison in commit\n");
-            }
-          }
+  if (brain_server_worker->temp_buf == NULL)
+  {
+    brain_server_worker_free (brain_server_worker);
 
-          if ((short_left != -1) || (unique_left != -1))
-          {
-            brain_logging (stderr, client_idx, "unexpected remaining buffers in commit: %" PRIi64 " - %" PRIi64 "\n", short_left, unique_left);
-          }
+    return false;
+  }
 
-          brain_server_db_short->short_cnt = cnt_total;
-        }
-      }
+  brain_server_worker->passwords_max = passwords_max;
+
+  return true;
+}
 
-      // opportunity to set counters for stats
+void brain_server_worker_free (brain_server_worker_t *brain_server_worker)
+{
+  hcfree (brain_server_worker->temp_buf);
 
-      int local_lookup_new = 0;
+  brain_server_worker->temp_buf      = NULL;
+  brain_server_worker->passwords_max = 0;
+}
 
-      for (i64 hashes_idx = 0; hashes_idx < hashes_cnt; hashes_idx++)
-      {
-        if (send_buf[hashes_idx] == 0)
-        {
-          local_lookup_new++;
-        }
-      }
+HC_API_CALL void *brain_server_handle_client (void *p)
+{
+  brain_server_client_options_t *brain_server_client_options = (brain_server_client_options_t *) p;
 
-      // needs anti-flood fix
+  brain_server_worker_t brain_server_worker;
 
-      const double ms = hc_timer_get (timer_lookup);
+  memset (&brain_server_worker, 0, sizeof (brain_server_worker));
 
-      brain_logging (stdout, client_idx, "L | %8.2f ms | Long: %" PRIi64 ", Inc: %d, New: %d\n", ms, brain_server_db_hash->long_cnt, hashes_cnt, local_lookup_new);
+  // main loop
 
-      // send
+  while (keep_running == true)
+  {
+    // wait for client to send data, but not too long
 
-      int out_size = hashes_cnt;
+    const int rc_select = select_read_timeout (brain_server_client_options->client_fd, 1);
 
-      if (brain_send (client_fd, &out_size, sizeof (out_size), SEND_FLAGS, NULL, NULL) == false) break;
-      if (brain_send (client_fd, send_buf,           out_size, SEND_FLAGS, NULL, NULL) == false) break;
-    }
-    else
-    {
-      break;
-    }
+    if (rc_select == -1) break;
+
+    if (rc_select == 0) continue;
+
+    // there's data, the socket is blocking here so a reply is always sent in full
+
+    if (brain_server_client_serve (brain_server_client_options, &brain_server_worker) == BRAIN_SERVER_LINK_CLOSE) break;
   }
 
-  // client reservations
+  brain_server_worker_free (&brain_server_worker);
 
-  hc_thread_mutex_lock (brain_server_db_attack->mux_ag);
+  brain_server_client_close (brain_server_client_options);
 
-  for (i64 idx = 0; idx < brain_server_db_attack->short_cnt; idx++)
+  return NULL;
+}
+
+#if defined (__linux__)
+
+HC_API_CALL void *brain_server_handle_events (void *p)
+{
+  brain_server_worker_t *brain_server_worker = (brain_server_worker_t *) p;
+
+  brain_server_client_options_t *brain_server_client_options = brain_server_worker->brain_server_client_options;
+
+  // each client is armed with EPOLLONESHOT, so only one worker at a time serves it
+  // and its short-term memory and link state need no lock. no worker ever waits on a client,
+  // its socket is non-blocking and it is armed for EPOLLOUT instead while a reply is pending
+
+  while (keep_running == true)
   {
-    if (brain_server_db_attack->short_buf[idx].client_idx == client_idx)
+    struct epoll_event event;
+
+    const int rc_wait = epoll_wait (brain_server_worker->epoll_fd, &event, 1, 1000);
+
+    if (rc_wait == -1)
     {
-      brain_server_db_attack->short_buf[idx].offset     = 0;
-      brain_server_db_attack->short_buf[idx].length     = 0;
-      brain_server_db_attack->short_buf[idx].client_idx = 0;
-    }
-  }
+      if (errno == EINTR) continue;
 
-  hc_thread_mutex_unlock (brain_server_db_attack->mux_ag);
+      brain_logging (stderr, 0, "epoll_wait: %s\n", strerror (errno));
 
-  // short free
+      break;
+    }
 
-  hcfree (brain_server_db_short->short_buf);
-  hcfree (brain_server_db_short);
+    if (rc_wait == 0) continue;
 
-  // free local memory
+    brain_server_client_options_t *client = &brain_server_client_options[event.data.u32];
 
-  hcfree (send_buf);
-  hcfree (temp_buf);
-  hcfree (recv_buf);
+    const int rc_serve = brain_server_client_serve (client, brain_server_worker);
+
+    if (rc_serve != BRAIN_SERVER_LINK_CLOSE)
+    {
+      event.events = ((rc_serve == BRAIN_SERVER_LINK_WRITE) ? EPOLLOUT : EPOLLIN) | EPOLLONESHOT;
 
-  brain_logging (stdout, client_idx, "Disconnected\n");
+      if (epoll_ctl (brain_server_worker->epoll_fd, EPOLL_CTL_MOD, client->client_fd, &event) == 0) continue;
 
-  brain_server_dbs->client_slots[client_idx] = 0;
+      brain_logging (stderr, client->client_idx, "epoll_ctl: %s\n", strerror (errno));
+    }
 
-  close (client_fd);
+    brain_server_client_close (client);
+  }
 
   return NULL;
 }
 
+#endif
+
 int brain_server (const char *listen_host, const int listen_port, const char *brain_password, const char *brain_session_whitelist, const u32 brain_server_timer)
 {
   #if defined (_WIN)
@@ -3183,7 +4246,7 @@ int brain_server (const char *listen_host, const int listen_port, const char *br
     return -1;
   }
 
-  if (listen (server_fd, 5) == -1)
+  if (listen (server_fd, SOMAXCONN) == -1)
   {
     brain_logging (stderr, 0, "listen: %s\n", strerror (errno));
 
@@ -3313,8 +4376,59 @@ int brain_server (const char *listen_host, const int listen_port, const char *br
     brain_server_client_options[client_idx].brain_server_dbs      = brain_server_dbs;
     brain_server_client_options[client_idx].session_whitelist_buf = session_whitelist_buf;
     brain_server_client_options[client_idx].session_whitelist_cnt = session_whitelist_cnt;
+
+    brain_server_client_options[client_idx].client_fd             = -1;
+  }
+
+  #if defined (__linux__)
+
+  // every client link is a file descriptor
+
+  struct rlimit rl;
+
+  if (getrlimit (RLIMIT_NOFILE, &rl) == 0)
+  {
+    const rlim_t nofile_want = (rlim_t) BRAIN_SERVER_CLIENTS_MAX + 64;
+
+    if (rl.rlim_cur < nofile_want)
+    {
+      rl.rlim_cur = (rl.rlim_max == RLIM_INFINITY) ? nofile_want : MIN (rl.rlim_max, nofile_want);
+
+      setrlimit (RLIMIT_NOFILE, &rl);
+    }
+  }
+
+  // a few workers serve all clients, a client is handed to one of them as soon as it has sent data
+
+  const int epoll_fd = epoll_create1 (0);
+
+  if (epoll_fd == -1)
+  {
+    brain_logging (stderr, 0, "epoll_create1: %s\n", strerror (errno));
+
+    if (brain_password == NULL) hcfree (auth_password);
+
+    return -1;
+  }
+
+  const int workers_cnt = MAX (hc_get_processor_count (), BRAIN_SERVER_WORKERS_MIN);
+
+  brain_server_worker_t *brain_server_workers = (brain_server_worker_t *) hccalloc (workers_cnt, sizeof (brain_server_worker_t));
+
+  hc_thread_t *worker_thr = (hc_thread_t *) hccalloc (workers_cnt, sizeof (hc_thread_t));
+
+  for (int worker_idx = 0; worker_idx < workers_cnt; worker_idx++)
+  {
+    brain_server_workers[worker_idx].brain_server_client_options = brain_server_client_options;
+    brain_server_workers[worker_idx].epoll_fd                    = epoll_fd;
+
+    hc_thread_create (worker_thr[worker_idx], brain_server_handle_events, &brain_server_workers[worker_idx]);
   }
 
+  brain_logging (stdout, 0, "Serving up to %d clients with %d workers\n", BRAIN_SERVER_CLIENTS_MAX - 1, workers_cnt);
+
+  #endif
+
   // ready to serve
 
   brain_logging (stdout, 0, "Brain server started\n");
@@ -3362,6 +4476,13 @@ int brain_server (const char *listen_host, const int listen_port, const char *br
 
     const int client_fd = accept (server_fd, (struct sockaddr *) &ca, (socklen_t *) &calen);
 
+    if (client_fd == -1)
+    {
+      brain_logging (stderr, 0, "accept: %s\n", strerror (errno));
+
+      continue;
+    }
+
     brain_logging (stdout, 0, "Connection from %s:%d\n", inet_ntoa (ca.sin_addr), ntohs (ca.sin_port));
 
     const int client_idx = brain_server_get_client_idx (brain_server_dbs);
@@ -3375,7 +4496,45 @@ int brain_server (const char *listen_host, const int listen_port, const char *br
       continue;
     }
 
-    brain_server_client_options[client_idx].client_fd = client_fd;
+    brain_server_client_open (&brain_server_client_options[client_idx], client_fd);
+
+    #if defined (__linux__)
+
+    if (setsockopt (client_fd, SOL_TCP, TCP_NODELAY, &one, sizeof (one)) == -1)
+    {
+      brain_logging (stderr, client_idx, "setsockopt: %s\n", strerror (errno));
+
+      brain_server_client_close (&brain_server_client_options[client_idx]);
+
+      continue;
+    }
+
+    // a worker must never wait on a client, a slow or stalled client only holds its own link
+
+    if (fcntl (client_fd, F_SETFL, fcntl (client_fd, F_GETFL, 0) | O_NONBLOCK) == -1)
+    {
+      brain_logging (stderr, client_idx, "fcntl: %s\n", strerror (errno));
+
+      brain_server_client_close (&brain_server_client_options[client_idx]);
+
+      continue;
+    }
+
+    struct epoll_event event;
+
+    memset (&event, 0, sizeof (event));
+
+    event.events   = EPOLLIN | EPOLLONESHOT;
+    event.data.u32 = (u32) client_idx;
+
+    if (epoll_ctl (epoll_fd, EPOLL_CTL_ADD, client_fd, &event) == -1)
+    {
+      brain_logging (stderr, client_idx, "epoll_ctl: %s\n", strerror (errno));
+
+      brain_server_client_close (&brain_server_client_options[client_idx]);
+    }
+
+    #else
 
     hc_thread_t client_thr;
 
@@ -3391,13 +4550,38 @@ int brain_server (const char *listen_host, const int listen_port, const char *br
     }
 
     hc_thread_detach (client_thr);
+
+    #endif
   }
 
   brain_logging (stdout, 0, "Brain server stopping\n");
 
+  #if defined (__linux__)
+
+  hc_thread_wait (workers_cnt, worker_thr);
+
+  for (int client_idx = 1; client_idx < BRAIN_SERVER_CLIENTS_MAX; client_idx++)
+  {
+    if (brain_server_dbs->client_slots[client_idx] == 0) continue;
+
+    brain_server_client_close (&brain_server_client_options[client_idx]);
+  }
+
+  for (int worker_idx = 0; worker_idx < workers_cnt; worker_idx++)
+  {
+    brain_server_worker_free (&brain_server_workers[worker_idx]);
+  }
+
+  hcfree (brain_server_workers);
+  hcfree (worker_thr);
+
+  close (epoll_fd);
+
+  #endif
+
   hc_thread_wait (1, &dump_thr);
 
-  if (brain_server_write_hash_dumps (brain_server_dbs, ".") == false)
+  if (brain_server_write_hash_dumps (brain_server_dbs, ".", true) == false)
   {
     if (brain_password == NULL) hcfree (auth_password);
 
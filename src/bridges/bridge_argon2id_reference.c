@@ -8,6 +8,7 @@
 #include "bridges.h"
 #include "memory.h"
 #include "shared.h"
+#include "thread.h"
 #include "cpu_features.h"
 
 // argon2 reference
@@ -18,6 +19,7 @@
 #include "core.c"
 #include "blake2/blake2b.c"
 #include "opt.c"
+#include "thread.c"
 
 // good: we can use this multiplier do reduce copy overhead to increase the guessing speed,
 // bad: but we also increase the password candidate batch size.
@@ -64,10 +66,6 @@ typedef struct
   u64     workitem_count;
   size_t  workitem_size;
 
-  // implementation specific
-
-  void   *memory;
-
 } unit_t;
 
 typedef struct
@@ -75,6 +73,19 @@ typedef struct
   unit_t *units_buf;
   int     units_cnt;
 
+  // one memory slot per candidate computed at the same time. if the free host memory does not fit
+  // one slot per unit, the units share fewer slots and the threads of the waiting units go into
+  // the lanes of the candidates being computed (p > 1) instead
+
+  void  **slots_buf;
+  bool   *slots_busy;
+  int     slots_cnt;
+  int     slots_max;
+
+  u32     lanes_threads;
+
+  hc_thread_mutex_t mux_slots;
+
 } bridge_argon2id_t;
 
 static bool units_init (bridge_argon2id_t *bridge_argon2id)
@@ -94,7 +105,7 @@ static bool units_init (bridge_argon2id_t *bridge_argon2id)
   #endif
 
   // this works really good for me, I think is because of register pressure on SIMD enabled code
-  num_devices /= 2;
+  num_devices = MAX (num_devices / 2, 1);
 
   // this is just a wild guess, but memory bus will probably bottleneck if we
   // have too many cores using it. we set some upper limit which is not ideal, but good enough for now.
@@ -133,7 +144,7 @@ static void units_term (bridge_argon2id_t *bridge_argon2id)
   }
 }
 
-void *platform_init ()
+void *platform_init (user_options_t *user_options)
 {
   // Verify CPU features
 
@@ -141,7 +152,17 @@ void *platform_init ()
 
   // Allocate platform context
 
-  bridge_argon2id_t *bridge_argon2id = (bridge_argon2id_t *) hcmalloc (sizeof (bridge_argon2id_t));
+  bridge_argon2id_t *bridge_argon2id = (bridge_argon2id_t *) hccalloc (1, sizeof (bridge_argon2id_t));
+
+  // --bridge-parameter1 limits the number of candidates computed at the same time, for instance
+  // if memory bandwidth rather than memory size is the bottleneck for large m
+
+  if (user_options->bridge_parameter1 != NULL)
+  {
+    bridge_argon2id->slots_max = atoi (user_options->bridge_parameter1);
+  }
+
+  hc_thread_mutex_init (bridge_argon2id->mux_slots);
 
   if (units_init (bridge_argon2id) == false)
   {
@@ -159,6 +180,8 @@ void platform_term (void *platform_context)
 
   if (bridge_argon2id)
   {
+    hc_thread_mutex_delete (bridge_argon2id->mux_slots);
+
     units_term (bridge_argon2id);
 
     hcfree (bridge_argon2id);
@@ -211,13 +234,38 @@ bool salt_prepare (void *platform_context, MAYBE_UNUSED hashconfig_t *hashconfig
 
   bridge_argon2id_t *bridge_argon2id = platform_context;
 
-  for (int unit_idx = 0; unit_idx < bridge_argon2id->units_cnt; unit_idx++)
+  const u64 slot_size = largest_m * 1024;
+
+  int slots_cnt = bridge_argon2id->units_cnt;
+
+  if (bridge_argon2id->slots_max > 0) slots_cnt = MIN (slots_cnt, bridge_argon2id->slots_max);
+
+  u64 free_mem = 0;
+
+  if (get_free_memory (&free_mem) == true)
   {
-    unit_t *unit_buf = &bridge_argon2id->units_buf[unit_idx];
+    // leave a quarter to the system and to hashcat itself
+
+    const u64 slots_fit = (free_mem / 4 * 3) / slot_size;
 
-    unit_buf->memory = hcmalloc_bridge_aligned ((largest_m * 1024), 32); // because AVX2
+    slots_cnt = MIN (slots_cnt, (int) MAX (slots_fit, 1));
   }
 
+  bridge_argon2id->slots_buf  = (void **) hccalloc (slots_cnt, sizeof (void *));
+  bridge_argon2id->slots_busy = (bool *)  hccalloc (slots_cnt, sizeof (bool));
+  bridge_argon2id->slots_cnt  = slots_cnt;
+
+  for (int slot_idx = 0; slot_idx < slots_cnt; slot_idx++)
+  {
+    bridge_argon2id->slots_buf[slot_idx] = hcmalloc_bridge_aligned (slot_size, 64); // because AVX-512
+
+    if (bridge_argon2id->slots_buf[slot_idx] == NULL) return false;
+  }
+
+  // the unit count is tuned for one thread per unit, keep that thread budget
+
+  bridge_argon2id->lanes_threads = MAX (bridge_argon2id->units_cnt / slots_cnt, 1);
+
   return true;
 }
 
@@ -225,21 +273,54 @@ void salt_destroy (void *platform_context, MAYBE_UNUSED hashconfig_t *hashconfig
 {
   bridge_argon2id_t *bridge_argon2id = platform_context;
 
-  for (int unit_idx = 0; unit_idx < bridge_argon2id->units_cnt; unit_idx++)
+  for (int slot_idx = 0; slot_idx < bridge_argon2id->slots_cnt; slot_idx++)
+  {
+    hcfree_bridge_aligned (bridge_argon2id->slots_buf[slot_idx]);
+  }
+
+  hcfree (bridge_argon2id->slots_buf);
+  hcfree (bridge_argon2id->slots_busy);
+
+  bridge_argon2id->slots_buf  = NULL;
+  bridge_argon2id->slots_busy = NULL;
+  bridge_argon2id->slots_cnt  = 0;
+}
+
+static int slot_acquire (bridge_argon2id_t *bridge_argon2id)
+{
+  while (true)
   {
-    unit_t *unit_buf = &bridge_argon2id->units_buf[unit_idx];
+    hc_thread_mutex_lock (bridge_argon2id->mux_slots);
+
+    for (int slot_idx = 0; slot_idx < bridge_argon2id->slots_cnt; slot_idx++)
+    {
+      if (bridge_argon2id->slots_busy[slot_idx] == true) continue;
+
+      bridge_argon2id->slots_busy[slot_idx] = true;
+
+      hc_thread_mutex_unlock (bridge_argon2id->mux_slots);
+
+      return slot_idx;
+    }
 
-    hcfree_bridge_aligned (unit_buf->memory);
+    hc_thread_mutex_unlock (bridge_argon2id->mux_slots);
+
+    usleep (1000);
   }
 }
 
-bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_param_t *device_param, MAYBE_UNUSED hashconfig_t *hashconfig, MAYBE_UNUSED hashes_t *hashes, MAYBE_UNUSED const u32 salt_pos, MAYBE_UNUSED const u64 pws_cnt)
+static void slot_release (bridge_argon2id_t *bridge_argon2id, const int slot_idx)
 {
-  bridge_argon2id_t *bridge_argon2id = platform_context;
+  hc_thread_mutex_lock (bridge_argon2id->mux_slots);
 
-  const int unit_idx = device_param->bridge_link_device;
+  bridge_argon2id->slots_busy[slot_idx] = false;
 
-  unit_t *unit_buf = &bridge_argon2id->units_buf[unit_idx];
+  hc_thread_mutex_unlock (bridge_argon2id->mux_slots);
+}
+
+bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_param_t *device_param, MAYBE_UNUSED hashconfig_t *hashconfig, MAYBE_UNUSED hashes_t *hashes, MAYBE_UNUSED const u32 salt_pos, MAYBE_UNUSED const u64 pws_cnt)
+{
+  bridge_argon2id_t *bridge_argon2id = platform_context;
 
   argon2_t *esalts_buf = (argon2_t *) hashes->esalts_buf;
 
@@ -247,6 +328,8 @@ bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
 
   argon2_reference_tmp_t *argon2_reference_tmp = (argon2_reference_tmp_t *) device_param->h_tmps;
 
+  const int slot_idx = slot_acquire (bridge_argon2id);
+
   argon2_context context;
 
   context.out           = (uint8_t *) NULL;
@@ -262,12 +345,12 @@ bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
   context.t_cost        = argon2id->t;
   context.m_cost        = argon2id->m;
   context.lanes         = argon2id->p;
-  context.threads       = 1;
+  context.threads       = MIN (bridge_argon2id->lanes_threads, argon2id->p);
   context.allocate_cbk  = NULL;
   context.free_cbk      = NULL;
   context.flags         = ARGON2_DEFAULT_FLAGS;
   context.version       = ARGON2_VERSION_NUMBER;
-  context.memory        = unit_buf->memory;
+  context.memory        = bridge_argon2id->slots_buf[slot_idx];
 
   for (u64 i = 0; i < pws_cnt; i++)
   {
@@ -281,6 +364,8 @@ bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
     argon2_reference_tmp++;
   }
 
+  slot_release (bridge_argon2id, slot_idx);
+
   return true;
 }
 
@@ -27,6 +27,7 @@
 typedef void                (PYTHON_API_CALL *PY_INITIALIZE)                    ();
 typedef void                (PYTHON_API_CALL *PY_FINALIZE)                      ();
 typedef void                (PYTHON_API_CALL *PY_DECREF)                        (PyObject *);
+typedef void                (PYTHON_API_CALL *PY_INCREF)                        (PyObject *);
 typedef PyObject           *(PYTHON_API_CALL *PYBOOL_FROMLONG)                  (long);
 typedef PyObject           *(PYTHON_API_CALL *PYBYTES_FROMSTRINGANDSIZE)        (const char *, Py_ssize_t);
 typedef int                 (PYTHON_API_CALL *PYDICT_DELITEMSTRING)             (PyObject *, const char *);
@@ -42,6 +43,7 @@ typedef PyObject           *(PYTHON_API_CALL *PYLIST_NEW)
 typedef int                 (PYTHON_API_CALL *PYLIST_SETITEM)                   (PyObject *, Py_ssize_t, PyObject *);
 typedef Py_ssize_t          (PYTHON_API_CALL *PYLIST_SIZE)                      (PyObject *);
 typedef PyObject           *(PYTHON_API_CALL *PYLONG_FROMLONG)                  (long);
+typedef PyObject           *(PYTHON_API_CALL *PYMEMORYVIEW_FROMMEMORY)          (char *, Py_ssize_t, int);
 typedef PyObject           *(PYTHON_API_CALL *PYOBJECT_CALLOBJECT)              (PyObject *, PyObject *);
 typedef PyObject           *(PYTHON_API_CALL *PYOBJECT_GETATTRSTRING)           (PyObject *, const char *);
 typedef PyObject           *(PYTHON_API_CALL *PYTUPLE_NEW)                      (Py_ssize_t);
@@ -83,6 +85,7 @@ typedef struct hc_python_lib
   PY_INITIALIZE                     Py_Initialize;
   PY_FINALIZE                       Py_Finalize;
   PY_DECREF                         Py_DecRef;
+  PY_INCREF                         Py_IncRef;
   PYBOOL_FROMLONG                   PyBool_FromLong;
   PYBYTES_FROMSTRINGANDSIZE         PyBytes_FromStringAndSize;
   PYDICT_DELITEMSTRING              PyDict_DelItemString;
@@ -98,6 +101,7 @@ typedef struct hc_python_lib
   PYLIST_SETITEM                    PyList_SetItem;
   PYLIST_SIZE                       PyList_Size;
   PYLONG_FROMLONG                   PyLong_FromLong;
+  PYMEMORYVIEW_FROMMEMORY           PyMemoryView_FromMemory;
   PYOBJECT_CALLOBJECT               PyObject_CallObject;
   PYOBJECT_GETATTRSTRING            PyObject_GetAttrString;
   PYTUPLE_NEW                       PyTuple_New;
@@ -173,11 +177,13 @@ typedef struct
   PyGILState_STATE gstate;
 
   PyObject *pArgs;
+  PyObject *pArgs_buf;
   PyObject *pContext;
   PyObject *pGlobals;
   PyObject *pFunc_Init;
   PyObject *pFunc_Term;
   PyObject *pFunc_kernel_loop;
+  PyObject *pFunc_kernel_loop_buf;
 
 } unit_t;
 
@@ -192,6 +198,8 @@ typedef struct
 
   char *source_filename;
 
+  bool timings;
+
 } python_interpreter_t;
 
 #if defined (_WIN) || defined (__CYGWIN__) || defined (__APPLE__)
@@ -576,6 +584,7 @@ static bool init_python (hc_python_lib_t *python, user_options_t *user_options)
   HC_LOAD_FUNC_PYTHON (python, Py_Initialize,                     Py_Initialize,                      PY_INITIALIZE,                    PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, Py_Finalize,                       Py_Finalize,                        PY_FINALIZE,                      PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, Py_DecRef,                         Py_DecRef,                          PY_DECREF,                        PYTHON, 1);
+  HC_LOAD_FUNC_PYTHON (python, Py_IncRef,                         Py_IncRef,                          PY_INCREF,                        PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyBool_FromLong,                   PyBool_FromLong,                    PYBOOL_FROMLONG,                  PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyBytes_FromStringAndSize,         PyBytes_FromStringAndSize,          PYBYTES_FROMSTRINGANDSIZE,        PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyDict_DelItemString,              PyDict_DelItemString,               PYDICT_DELITEMSTRING,             PYTHON, 1);
@@ -591,6 +600,7 @@ static bool init_python (hc_python_lib_t *python, user_options_t *user_options)
   HC_LOAD_FUNC_PYTHON (python, PyList_SetItem,                    PyList_SetItem,                     PYLIST_SETITEM,                   PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyList_Size,                       PyList_Size,                        PYLIST_SIZE,                      PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyLong_FromLong,                   PyLong_FromLong,                    PYLONG_FROMLONG,                  PYTHON, 1);
+  HC_LOAD_FUNC_PYTHON (python, PyMemoryView_FromMemory,           PyMemoryView_FromMemory,            PYMEMORYVIEW_FROMMEMORY,          PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyObject_CallObject,               PyObject_CallObject,                PYOBJECT_CALLOBJECT,              PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyObject_GetAttrString,            PyObject_GetAttrString,             PYOBJECT_GETATTRSTRING,           PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyTuple_New,                       PyTuple_New,                        PYTUPLE_NEW,                      PYTHON, 1);
@@ -733,6 +743,10 @@ void *platform_init (user_options_t *user_options)
 
   python_interpreter->source_filename = (user_options->bridge_parameter1 == NULL) ? DEFAULT_SOURCE_FILENAME : user_options->bridge_parameter1;
 
+  // --bridge-parameter2=1 prints the per-batch timings of kernel_loop_buf ()
+
+  python_interpreter->timings = (user_options->bridge_parameter2 != NULL) && (strcmp (user_options->bridge_parameter2, "1") == 0);
+
   char *source = file_to_buffer (python_interpreter->source_filename);
 
   if (source == NULL)
@@ -795,6 +809,10 @@ void *platform_init (user_options_t *user_options)
     return false;
   }
 
+  // optional: takes the whole batch as one writable buffer of generic_io_tmp_t, see Python/hcmp.py
+
+  unit_buf->pFunc_kernel_loop_buf = python->PyDict_GetItemString (unit_buf->pGlobals, "kernel_loop_buf");
+
   // Initialize Context (which also means copy salts because they are part of the context)
 
   unit_buf->pContext = python->PyDict_New ();
@@ -821,6 +839,21 @@ void *platform_init (user_options_t *user_options)
   python->PyTuple_SetItem (unit_buf->pArgs, 2, python->PyLong_FromLong (0));
   python->PyTuple_SetItem (unit_buf->pArgs, 3, python->PyBool_FromLong (false));
 
+  unit_buf->pArgs_buf = python->PyTuple_New (5);
+
+  if (unit_buf->pArgs_buf == NULL)
+  {
+    python->PyErr_Print ();
+
+    return false;
+  }
+
+  // the tuple steals a reference, pArgs holds the other one
+
+  python->Py_IncRef (unit_buf->pContext);
+
+  python->PyTuple_SetItem (unit_buf->pArgs_buf, 0, unit_buf->pContext);
+
   python_interpreter->tstate = python->PyEval_SaveThread ();
 
   return python_interpreter;
@@ -836,6 +869,7 @@ void platform_term (void *platform_context)
 
   unit_buf->gstate = python->PyGILState_Ensure ();
 
+  python->Py_DecRef (unit_buf->pArgs_buf);
   python->Py_DecRef (unit_buf->pArgs);
   python->Py_DecRef (unit_buf->pContext);
   python->Py_DecRef (unit_buf->pFunc_kernel_loop);
@@ -870,6 +904,8 @@ bool thread_init (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
 
   rc |= python->PyDict_SetItemString (unit_buf->pContext, "module_name",    python->PyUnicode_FromString ((const char *) module_name));
   rc |= python->PyDict_SetItemString (unit_buf->pContext, "parallelism",    python->PyLong_FromLong (unit_buf->parallelism));
+  rc |= python->PyDict_SetItemString (unit_buf->pContext, "io_size",        python->PyLong_FromLong (sizeof (generic_io_tmp_t)));
+  rc |= python->PyDict_SetItemString (unit_buf->pContext, "timings",        python->PyBool_FromLong (python_interpreter->timings));
   rc |= python->PyDict_SetItemString (unit_buf->pContext, "salts_cnt",      python->PyLong_FromLong (hashes->salts_cnt));
   rc |= python->PyDict_SetItemString (unit_buf->pContext, "salts_size",     python->PyLong_FromLong (sizeof (salt_t)));
   rc |= python->PyDict_SetItemString (unit_buf->pContext, "salts_buf",      python->PyBytes_FromStringAndSize ((const char *) hashes->salts_buf, sizeof (salt_t) * hashes->salts_cnt));
@@ -997,6 +1033,44 @@ bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
 
   unit_buf->gstate = python->PyGILState_Ensure ();
 
+  if (unit_buf->pFunc_kernel_loop_buf != NULL)
+  {
+    // the batch goes to Python as one writable buffer of fixed-stride generic_io_tmp_t, the results are written into it in place
+
+    PyObject *io_buf = python->PyMemoryView_FromMemory ((char *) device_param->h_tmps, pws_cnt * sizeof (generic_io_tmp_t), PyBUF_WRITE);
+
+    if (io_buf == NULL)
+    {
+      python->PyErr_Print ();
+
+      python->PyGILState_Release (unit_buf->gstate);
+
+      return false;
+    }
+
+    python->PyTuple_SetItem (unit_buf->pArgs_buf, 1, io_buf);
+    python->PyTuple_SetItem (unit_buf->pArgs_buf, 2, python->PyLong_FromLong (pws_cnt));
+    python->PyTuple_SetItem (unit_buf->pArgs_buf, 3, python->PyLong_FromLong (salt_pos));
+    python->PyTuple_SetItem (unit_buf->pArgs_buf, 4, python->PyBool_FromLong (hashes->salts_buf == hashes->st_salts_buf));
+
+    PyObject *pReturn = python->PyObject_CallObject (unit_buf->pFunc_kernel_loop_buf, unit_buf->pArgs_buf);
+
+    if (pReturn == NULL)
+    {
+      python->PyErr_Print ();
+
+      python->PyGILState_Release (unit_buf->gstate);
+
+      return false;
+    }
+
+    python->Py_DecRef (pReturn);
+
+    python->PyGILState_Release (unit_buf->gstate);
+
+    return true;
+  }
+
   generic_io_tmp_t *generic_io_tmp = (generic_io_tmp_t *) device_param->h_tmps;
 
   PyObject *pws = python->PyList_New (pws_cnt);
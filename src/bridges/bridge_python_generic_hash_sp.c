@@ -27,12 +27,14 @@
 typedef void                (PYTHON_API_CALL *PY_INITIALIZE)                    ();
 typedef void                (PYTHON_API_CALL *PY_FINALIZE)                      ();
 typedef void                (PYTHON_API_CALL *PY_DECREF)                        (PyObject *);
+typedef void                (PYTHON_API_CALL *PY_INCREF)                        (PyObject *);
 typedef PyObject           *(PYTHON_API_CALL *PYBOOL_FROMLONG)                  (long);
 typedef PyObject           *(PYTHON_API_CALL *PYBYTES_FROMSTRINGANDSIZE)        (const char *, Py_ssize_t);
 typedef int                 (PYTHON_API_CALL *PYDICT_DELITEMSTRING)             (PyObject *, const char *);
 typedef PyObject           *(PYTHON_API_CALL *PYDICT_GETITEMSTRING)             (PyObject *, const char *);
 typedef PyObject           *(PYTHON_API_CALL *PYDICT_NEW)                       ();
 typedef int                 (PYTHON_API_CALL *PYDICT_SETITEMSTRING)             (PyObject *, const char *, PyObject *);
+typedef void                (PYTHON_API_CALL *PYERR_CLEAR)                      ();
 typedef void                (PYTHON_API_CALL *PYERR_PRINT)                      ();
 typedef PyObject           *(PYTHON_API_CALL *PYIMPORT_IMPORTMODULE)            (const char *);
 typedef PyObject           *(PYTHON_API_CALL *PYIMPORT_IMPORT)                  (PyObject *);
@@ -44,6 +46,7 @@ typedef Py_ssize_t          (PYTHON_API_CALL *PYLIST_SIZE)
 typedef PyObject           *(PYTHON_API_CALL *PYLONG_FROMLONG)                  (long);
 typedef PyObject           *(PYTHON_API_CALL *PYOBJECT_CALLOBJECT)              (PyObject *, PyObject *);
 typedef PyObject           *(PYTHON_API_CALL *PYOBJECT_GETATTRSTRING)           (PyObject *, const char *);
+typedef int                 (PYTHON_API_CALL *PYOBJECT_ISTRUE)                  (PyObject *);
 typedef PyObject           *(PYTHON_API_CALL *PYTUPLE_NEW)                      (Py_ssize_t);
 typedef int                 (PYTHON_API_CALL *PYTUPLE_SETITEM)                  (PyObject *, Py_ssize_t, PyObject *);
 typedef const char         *(PYTHON_API_CALL *PYUNICODE_ASUTF8)                 (PyObject *);
@@ -83,12 +86,14 @@ typedef struct hc_python_lib
   PY_INITIALIZE                     Py_Initialize;
   PY_FINALIZE                       Py_Finalize;
   PY_DECREF                         Py_DecRef;
+  PY_INCREF                         Py_IncRef;
   PYBOOL_FROMLONG                   PyBool_FromLong;
   PYBYTES_FROMSTRINGANDSIZE         PyBytes_FromStringAndSize;
   PYDICT_DELITEMSTRING              PyDict_DelItemString;
   PYDICT_GETITEMSTRING              PyDict_GetItemString;
   PYDICT_NEW                        PyDict_New;
   PYDICT_SETITEMSTRING              PyDict_SetItemString;
+  PYERR_CLEAR                       PyErr_Clear;
   PYERR_PRINT                       PyErr_Print;
   PYIMPORT_IMPORTMODULE             PyImport_ImportModule;
   PYIMPORT_IMPORT                   PyImport_Import;
@@ -100,6 +105,7 @@ typedef struct hc_python_lib
   PYLONG_FROMLONG                   PyLong_FromLong;
   PYOBJECT_CALLOBJECT               PyObject_CallObject;
   PYOBJECT_GETATTRSTRING            PyObject_GetAttrString;
+  PYOBJECT_ISTRUE                   PyObject_IsTrue;
   PYTUPLE_NEW                       PyTuple_New;
   PYTUPLE_SETITEM                   PyTuple_SetItem;
   PYUNICODE_ASUTF8                  PyUnicode_AsUTF8;
@@ -170,6 +176,8 @@ typedef struct
 
   PyThreadState *tstate;
 
+  PyGILState_STATE gstate;
+
   PyObject *pArgs;
   PyObject *pContext;
   PyObject *pGlobals;
@@ -190,6 +198,9 @@ typedef struct
 
   char *source_filename;
 
+  bool gil_enabled;
+  bool subinterpreters;
+
 } python_interpreter_t;
 
 static char *DEFAULT_SOURCE_FILENAME = "Python/generic_hash_sp.py";
@@ -221,34 +232,53 @@ const char *extract_module_name (const char *path)
   return module_name;
 }
 
+// free-threaded builds first, then regular builds which still run one interpreter per unit, each with its own GIL (PEP 684)
+
+static const char *PYTHON_ABIS[] = { "t", "" };
+
+#define PYTHON_ABIS_CNT (sizeof (PYTHON_ABIS) / sizeof (PYTHON_ABIS[0]))
+
+static bool python_abi_usable (const int maj, const int min, const char *abi)
+{
+  if (abi[0] == 't') return true;
+
+  if (maj > 3) return true;
+
+  return (maj == 3) && (min >= 13);
+}
+
 static char *expand_pyenv_libpath (const char *prefix, const int maj, const int min)
 {
-  char *out = NULL;
+  for (size_t abi_pos = 0; abi_pos < PYTHON_ABIS_CNT; abi_pos++)
+  {
+    const char *abi = PYTHON_ABIS[abi_pos];
 
-  #if defined (_WIN)
-  const int len = asprintf (&out, "%s/python%d%dt.dll",           prefix, maj, min); //untested
-  #elif defined (__MSYS__)
-  const int len = asprintf (&out, "%s/msys-python%d.%dt.dll",     prefix, maj, min); //untested could be wrong
-  #elif defined (__APPLE__)
-  const int len = asprintf (&out, "%s/lib/libpython%d.%dt.dylib", prefix, maj, min); //untested
-  #elif defined (__CYGWIN__)
-  const int len = asprintf (&out, "%s/lib/python%d%dt.dll",       prefix, maj, min); //untested
-  #else
-  const int len = asprintf (&out, "%s/lib/libpython%d.%dt.so",    prefix, maj, min);
-  #endif
+    if (python_abi_usable (maj, min, abi) == false) continue;
 
-  if (len == -1) return NULL;
+    char *out = NULL;
 
-  struct stat st;
+    #if defined (_WIN)
+    const int len = asprintf (&out, "%s/python%d%d%s.dll",           prefix, maj, min, abi); //untested
+    #elif defined (__MSYS__)
+    const int len = asprintf (&out, "%s/msys-python%d.%d%s.dll",     prefix, maj, min, abi); //untested could be wrong
+    #elif defined (__APPLE__)
+    const int len = asprintf (&out, "%s/lib/libpython%d.%d%s.dylib", prefix, maj, min, abi); //untested
+    #elif defined (__CYGWIN__)
+    const int len = asprintf (&out, "%s/lib/python%d%d%s.dll",       prefix, maj, min, abi); //untested
+    #else
+    const int len = asprintf (&out, "%s/lib/libpython%d.%d%s.so",    prefix, maj, min, abi);
+    #endif
 
-  if (stat (out, &st) != 0)
-  {
-    free (out);
+    if (len == -1) return NULL;
 
-    return NULL;
+    struct stat st;
+
+    if (stat (out, &st) == 0) return out;
+
+    free (out);
   }
 
-  return out;
+  return NULL;
 }
 
 static int resolve_pyenv_libpath (char *out_buf, const size_t out_sz)
@@ -365,156 +395,166 @@ static bool init_python (hc_python_lib_t *python, user_options_t *user_options)
   #define MIN_MIN 0
   #define MAX_MIN 50
 
-  for (int maj = MAX_MAJ; maj >= MIN_MAJ; --maj)
+  for (size_t abi_pos = 0; abi_pos < PYTHON_ABIS_CNT; abi_pos++)
   {
     if (python->lib != NULL) break;
 
-    for (int min = MAX_MIN; min >= MIN_MIN; --min)
+    const char *abi = PYTHON_ABIS[abi_pos];
+
+    for (int maj = MAX_MAJ; maj >= MIN_MAJ; --maj)
     {
-      #if defined (_WIN)
+      if (python->lib != NULL) break;
+
+      for (int min = MAX_MIN; min >= MIN_MIN; --min)
+      {
+        if (python_abi_usable (maj, min, abi) == false) continue;
 
-      // first try %LocalAppData% default path
-      char expandedPath[MAX_PATH - 1];
+        #if defined (_WIN)
 
-      char *libpython_namelocal = NULL;
+        // first try %LocalAppData% default path
+        char expandedPath[MAX_PATH - 1];
 
-      hc_asprintf (&libpython_namelocal, "%%LocalAppData%%\\Programs\\Python\\Python%d%d\\python%d%dt.dll", maj, min, maj, min);
+        char *libpython_namelocal = NULL;
 
-      DWORD len = ExpandEnvironmentStringsA (libpython_namelocal, expandedPath, sizeof (expandedPath));
+        hc_asprintf (&libpython_namelocal, "%%LocalAppData%%\\Programs\\Python\\Python%d%d\\python%d%d%s.dll", maj, min, maj, min, abi);
 
-      if (len)
-      {
-        python->lib = hc_dlopen (expandedPath);
+        DWORD len = ExpandEnvironmentStringsA (libpython_namelocal, expandedPath, sizeof (expandedPath));
+
+        if (len)
+        {
+          python->lib = hc_dlopen (expandedPath);
+
+          if (python->lib != NULL)
+          {
+            strncpy (pythondll_path, expandedPath, sizeof (pythondll_path) - 1);
+
+            hcfree (libpython_namelocal);
+
+            break;
+          }
+          else
+          {
+            hcfree (libpython_namelocal);
+          };
+        }
+
+        // use %PATH%
+        char *libpython_namepath = NULL;
+
+        hc_asprintf (&libpython_namepath, "python%d%d%s.dll", maj, min, abi);
+
+        python->lib = hc_dlopen (libpython_namepath);
 
         if (python->lib != NULL)
         {
-          strncpy (pythondll_path, expandedPath, sizeof (pythondll_path) - 1);
+          strncpy (pythondll_path, libpython_namepath, sizeof (pythondll_path) - 1);
 
-          hcfree (libpython_namelocal);
+          hcfree (libpython_namepath);
 
           break;
         }
         else
         {
-          hcfree (libpython_namelocal);
+          hcfree (libpython_namepath);
         };
-      }
 
-      // use %PATH%
-      char *libpython_namepath = NULL;
+        #elif defined (__MSYS__)
 
-      hc_asprintf (&libpython_namepath, "python%d%dt.dll", maj, min);
+        char *libpython_name = NULL;
 
-      python->lib = hc_dlopen (libpython_namepath);
+        hc_asprintf (&libpython_name, "msys-python%d.%d%s.dll", maj, min, abi);
 
-      if (python->lib != NULL)
-      {
-        strncpy (pythondll_path, libpython_namepath, sizeof (pythondll_path) - 1);
-
-        hcfree (libpython_namepath);
-
-        break;
-      }
-      else
-      {
-        hcfree (libpython_namepath);
-      };
-
-      #elif defined (__MSYS__)
-
-      char *libpython_name = NULL;
+        python->lib = dlopen (libpython_name, RTLD_NOW | RTLD_GLOBAL);
 
-      hc_asprintf (&libpython_name, "msys-python%d.%dt.dll", maj, min);
+        if (python->lib != NULL)
+        {
+          strncpy (pythondll_path, libpython_name, sizeof (pythondll_path) - 1);
 
-      python->lib = dlopen (libpython_name, RTLD_NOW | RTLD_GLOBAL);
+          hcfree (libpython_name);
 
-      if (python->lib != NULL)
-      {
-        strncpy (pythondll_path, libpython_name, sizeof (pythondll_path) - 1);
+          break;
+        }
+        else
+        {
+          hcfree (libpython_name);
+        };
 
-        hcfree (libpython_name);
+        #elif defined (__APPLE__)
 
-        break;
-      }
-      else
-      {
-        hcfree (libpython_name);
-      };
+        char *libpython_name = NULL;
 
-      #elif defined (__APPLE__)
+        hc_asprintf (&libpython_name, "libpython%d.%d%s.dylib", maj, min, abi);
 
-      char *libpython_name = NULL;
+        python->lib = dlopen (libpython_name, RTLD_NOW | RTLD_GLOBAL);
 
-      hc_asprintf (&libpython_name, "libpython%d.%dt.dylib", maj, min);
+        if (python->lib != NULL)
+        {
+          strncpy (pythondll_path, libpython_name, sizeof (pythondll_path) - 1);
 
-      python->lib = dlopen (libpython_name, RTLD_NOW | RTLD_GLOBAL);
+          hcfree (libpython_name);
 
-      if (python->lib != NULL)
-      {
-        strncpy (pythondll_path, libpython_name, sizeof (pythondll_path) - 1);
+          break;
+        }
+        else
+        {
+          hcfree (libpython_name);
+        };
 
-        hcfree (libpython_name);
+        #elif defined (__CYGWIN__)
 
-        break;
-      }
-      else
-      {
-        hcfree (libpython_name);
-      };
+        char *libpython_name = NULL;
 
-      #elif defined (__CYGWIN__)
+        hc_asprintf (&libpython_name, "python%d%d%s.dll", maj, min, abi);
 
-      char *libpython_name = NULL;
+        python->lib = hc_dlopen (libpython_name);
 
-      hc_asprintf (&libpython_name, "python%d%dt.dll", maj, min);
+        if (python->lib != NULL)
+        {
+          strncpy (pythondll_path, libpython_name, sizeof (pythondll_path) - 1);
 
-      python->lib = hc_dlopen (libpython_name);
+          hcfree (libpython_name);
 
-      if (python->lib != NULL)
-      {
-        strncpy (pythondll_path, libpython_name, sizeof (pythondll_path) - 1);
+          break;
+        }
+        else
+        {
+          hcfree (libpython_name);
+        };
 
-        hcfree (libpython_name);
+        #else
 
-        break;
-      }
-      else
-      {
-        hcfree (libpython_name);
-      };
+        char *libpython_name = NULL;
 
-      #else
+        hc_asprintf (&libpython_name, "libpython%d.%d%s.so", maj, min, abi);
 
-      char *libpython_name = NULL;
+        python->lib = dlopen (libpython_name, RTLD_NOW | RTLD_GLOBAL);
 
-      hc_asprintf (&libpython_name, "libpython%d.%dt.so", maj, min);
+        if (python->lib != NULL)
+        {
+          strncpy (pythondll_path, libpython_name, sizeof (pythondll_path) - 1);
 
-      python->lib = dlopen (libpython_name, RTLD_NOW | RTLD_GLOBAL);
+          hcfree (libpython_name);
 
-      if (python->lib != NULL)
-      {
-        strncpy (pythondll_path, libpython_name, sizeof (pythondll_path) - 1);
+          break;
+        }
+        else
+        {
+          hcfree (libpython_name);
+        };
 
-        hcfree (libpython_name);
+        #endif
 
-        break;
+        if (python->lib != NULL) break;
       }
-      else
-      {
-        hcfree (libpython_name);
-      };
-
-      #endif
 
       if (python->lib != NULL) break;
     }
-
-    if (python->lib != NULL) break;
   }
 
   if (python->lib == NULL)
   {
     fprintf (stderr, "Unable to find suitable Python library for -m 72000.\n\n");
+    fprintf (stderr, "It requires either a 'free-threaded' Python library or a regular Python library, version 3.13 or later.\n");
     fprintf (stderr, "Most users who encounter this error are just missing the so called 'free-threaded' library support.\n");
     fprintf (stderr, "* On Windows, during install, there's an option 'free-threaded' that you need to click, it's just disabled by default.\n");
     fprintf (stderr, "* On Linux and MacOS, use `pyenv` and select a version that ends with a `t` (for instance `3.13t`).\n");
@@ -534,23 +574,6 @@ static bool init_python (hc_python_lib_t *python, user_options_t *user_options)
     }
   }
 
-  #if defined (_WIN) || defined (__CYGWIN__) || defined (__APPLE__)
-
-  #else
-  if (user_options->quiet == false)
-  {
-    if (user_options->machine_readable == false)
-    {
-      fprintf (stderr, "Attention!!! The 'free-threaded' python library has some major downsides.\n");
-      fprintf (stderr, "  The main purpose of this module is to give Windows and macOS users a multithreading option.\n");
-      fprintf (stderr, "  It seems to be a lot slower, and relevant modules such as `cffi` are incompatibile.\n");
-      fprintf (stderr, "  Since your are on Linux we highly recommend to stick to multiprocessing module.\n");
-      fprintf (stderr, "  Maybe 'free-threaded' mode will become more mature in the future.\n");
-      fprintf (stderr, "  For now, we high recommend to stick to -m 73000 instead.\n\n");
-    }
-  }
-  #endif
-
   #define HC_LOAD_FUNC_PYTHON(ptr,name,pythonname,type,libname,noerr) \
     do { \
       ptr->name = (type) hc_dlsym ((ptr)->lib, #pythonname); \
@@ -592,12 +615,14 @@ static bool init_python (hc_python_lib_t *python, user_options_t *user_options)
   HC_LOAD_FUNC_PYTHON (python, Py_Initialize,                     Py_Initialize,                      PY_INITIALIZE,                    PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, Py_Finalize,                       Py_Finalize,                        PY_FINALIZE,                      PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, Py_DecRef,                         Py_DecRef,                          PY_DECREF,                        PYTHON, 1);
+  HC_LOAD_FUNC_PYTHON (python, Py_IncRef,                         Py_IncRef,                          PY_INCREF,                        PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyBool_FromLong,                   PyBool_FromLong,                    PYBOOL_FROMLONG,                  PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyBytes_FromStringAndSize,         PyBytes_FromStringAndSize,          PYBYTES_FROMSTRINGANDSIZE,        PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyDict_DelItemString,              PyDict_DelItemString,               PYDICT_DELITEMSTRING,             PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyDict_GetItemString,              PyDict_GetItemString,               PYDICT_GETITEMSTRING,             PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyDict_New,                        PyDict_New,                         PYDICT_NEW,                       PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyDict_SetItemString,              PyDict_SetItemString,               PYDICT_SETITEMSTRING,             PYTHON, 1);
+  HC_LOAD_FUNC_PYTHON (python, PyErr_Clear,                       PyErr_Clear,                        PYERR_CLEAR,                      PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyErr_Print,                       PyErr_Print,                        PYERR_PRINT,                      PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyImport_ImportModule,             PyImport_ImportModule,              PYIMPORT_IMPORTMODULE,            PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyImport_Import,                   PyImport_Import,                    PYIMPORT_IMPORT,                  PYTHON, 1);
@@ -609,6 +634,7 @@ static bool init_python (hc_python_lib_t *python, user_options_t *user_options)
   HC_LOAD_FUNC_PYTHON (python, PyLong_FromLong,                   PyLong_FromLong,                    PYLONG_FROMLONG,                  PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyObject_CallObject,               PyObject_CallObject,                PYOBJECT_CALLOBJECT,              PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyObject_GetAttrString,            PyObject_GetAttrString,             PYOBJECT_GETATTRSTRING,           PYTHON, 1);
+  HC_LOAD_FUNC_PYTHON (python, PyObject_IsTrue,                   PyObject_IsTrue,                    PYOBJECT_ISTRUE,                  PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyTuple_New,                       PyTuple_New,                        PYTUPLE_NEW,                      PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyTuple_SetItem,                   PyTuple_SetItem,                    PYTUPLE_SETITEM,                  PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyUnicode_AsUTF8,                  PyUnicode_AsUTF8,                   PYUNICODE_ASUTF8,                 PYTHON, 1);
@@ -694,12 +720,68 @@ static void units_term (python_interpreter_t *python_interpreter)
   }
 }
 
+static bool python_gil_enabled (hc_python_lib_t *python)
+{
+  // sys._is_gil_enabled () exists since 3.13, a free-threaded build can still turn the GIL back on at runtime
+
+  bool gil_enabled = true;
+
+  PyObject *sys = python->PyImport_ImportModule ("sys");
+
+  if (sys == NULL)
+  {
+    python->PyErr_Clear ();
+
+    return gil_enabled;
+  }
+
+  PyObject *is_gil_enabled = python->PyObject_GetAttrString (sys, "_is_gil_enabled");
+
+  if (is_gil_enabled == NULL)
+  {
+    python->PyErr_Clear ();
+  }
+  else
+  {
+    PyObject *result = python->PyObject_CallObject (is_gil_enabled, NULL);
+
+    if (result == NULL)
+    {
+      python->PyErr_Clear ();
+    }
+    else
+    {
+      gil_enabled = (python->PyObject_IsTrue (result) == 1);
+
+      python->Py_DecRef (result);
+    }
+
+    python->Py_DecRef (is_gil_enabled);
+  }
+
+  python->Py_DecRef (sys);
+
+  return gil_enabled;
+}
+
 void *platform_init (user_options_t *user_options)
 {
   // Verify CPU features
 
   if (cpu_chipset_test () == -1) return NULL;
 
+  // Verify the unit mode before python gets loaded
+
+  if (user_options->bridge_parameter2 != NULL)
+  {
+    if ((strcmp (user_options->bridge_parameter2, "subinterpreters") != 0) && (strcmp (user_options->bridge_parameter2, "shared") != 0))
+    {
+      fprintf (stderr, "Invalid --bridge-parameter2 '%s', must be 'subinterpreters' or 'shared'.\n", user_options->bridge_parameter2);
+
+      return NULL;
+    }
+  }
+
   // Allocate platform context
 
   python_interpreter_t *python_interpreter = (python_interpreter_t *) hcmalloc (sizeof (python_interpreter_t));
@@ -712,10 +794,39 @@ void *platform_init (user_options_t *user_options)
 
   python->Py_Initialize ();
 
+  python_interpreter->gil_enabled = python_gil_enabled (python);
+
   python_interpreter->thread_state = python->PyEval_SaveThread ();
 
   python_interpreter->source_filename = (user_options->bridge_parameter1 == NULL) ? DEFAULT_SOURCE_FILENAME : user_options->bridge_parameter1;
 
+  // units run in parallel either in one sub-interpreter each, with its own GIL, or without a GIL in the main interpreter
+  // --bridge-parameter2=subinterpreters or --bridge-parameter2=shared overrides the choice
+
+  python_interpreter->subinterpreters = python_interpreter->gil_enabled;
+
+  if (user_options->bridge_parameter2 != NULL)
+  {
+    python_interpreter->subinterpreters = (strcmp (user_options->bridge_parameter2, "subinterpreters") == 0);
+  }
+
+  #if defined (_WIN) || defined (__CYGWIN__) || defined (__APPLE__)
+
+  #else
+  if ((python_interpreter->gil_enabled == false) && (user_options->quiet == false))
+  {
+    if (user_options->machine_readable == false)
+    {
+      fprintf (stderr, "Attention!!! The 'free-threaded' python library has some major downsides.\n");
+      fprintf (stderr, "  The main purpose of this module is to give Windows and macOS users a multithreading option.\n");
+      fprintf (stderr, "  It seems to be a lot slower, and relevant modules such as `cffi` are incompatibile.\n");
+      fprintf (stderr, "  Since your are on Linux we highly recommend to stick to multiprocessing module.\n");
+      fprintf (stderr, "  Maybe 'free-threaded' mode will become more mature in the future.\n");
+      fprintf (stderr, "  For now, we high recommend to stick to -m 73000 instead.\n\n");
+    }
+  }
+  #endif
+
   if (units_init (python_interpreter) == false)
   {
     hcfree (python_interpreter);
@@ -755,26 +866,35 @@ bool thread_init (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
 
   hc_python_lib_t *python = python_interpreter->python;
 
-  PyInterpreterConfig config =
+  if (python_interpreter->subinterpreters == true)
   {
-    .use_main_obmalloc = 0,
-    .allow_fork = 1,
-    .allow_exec = 1,
-    .allow_threads = 1,
-    .allow_daemon_threads = 0,
-    .check_multi_interp_extensions = 1,
-    .gil = PyInterpreterConfig_OWN_GIL
-  };
+    PyInterpreterConfig config =
+    {
+      .use_main_obmalloc = 0,
+      .allow_fork = 1,
+      .allow_exec = 1,
+      .allow_threads = 1,
+      .allow_daemon_threads = 0,
+      .check_multi_interp_extensions = 1,
+      .gil = PyInterpreterConfig_OWN_GIL
+    };
+
+    unit_buf->tstate = NULL;
 
-  unit_buf->tstate = NULL;
+    PyStatus status = python->Py_NewInterpreterFromConfig (&unit_buf->tstate, &config);
 
-  PyStatus status = python->Py_NewInterpreterFromConfig (&unit_buf->tstate, &config);
+    if (status.exitcode)
+    {
+      python->PyErr_Print ();
 
-  if (status.exitcode)
+      return false;
+    }
+  }
+  else
   {
-    python->PyErr_Print ();
+    // no GIL, all units share the main interpreter with one thread state each
 
-    return false;
+    unit_buf->gstate = python->PyGILState_Ensure ();
   }
 
   PyObject *sys = python->PyImport_ImportModule ("sys");
@@ -887,6 +1007,8 @@ bool thread_init (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
     return false;
   }
 
+  python->Py_IncRef (unit_buf->pContext);
+
   python->PyTuple_SetItem (pArgs, 0, unit_buf->pContext);
 
   PyObject *pReturn = python->PyObject_CallObject (unit_buf->pFunc_Init, pArgs);
@@ -900,7 +1022,7 @@ bool thread_init (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
 
   python->Py_DecRef (pReturn);
 
-  //python->Py_DecRef (pArgs);
+  python->Py_DecRef (pArgs);
 
   // for later calls
 
@@ -913,10 +1035,16 @@ bool thread_init (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
     return false;
   }
 
+  python->Py_IncRef (unit_buf->pContext);
+
   python->PyTuple_SetItem (unit_buf->pArgs, 0, unit_buf->pContext);
   python->PyTuple_SetItem (unit_buf->pArgs, 2, python->PyLong_FromLong (0));
   python->PyTuple_SetItem (unit_buf->pArgs, 3, python->PyBool_FromLong (false));
 
+  // detach between calls, so a free-threaded runtime does not wait for this thread on stop-the-world pauses
+
+  unit_buf->tstate = python->PyEval_SaveThread ();
+
   return true;
 }
 
@@ -930,6 +1058,8 @@ void thread_term (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
 
   hc_python_lib_t *python = python_interpreter->python;
 
+  python->PyEval_RestoreThread (unit_buf->tstate);
+
   python->PyDict_DelItemString (unit_buf->pContext, "module_name");
   python->PyDict_DelItemString (unit_buf->pContext, "salts_cnt");
   python->PyDict_DelItemString (unit_buf->pContext, "salts_size");
@@ -953,20 +1083,37 @@ void thread_term (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
     return;
   }
 
+  python->Py_IncRef (unit_buf->pContext);
+
   python->PyTuple_SetItem (pArgs, 0, unit_buf->pContext);
 
-  python->PyObject_CallObject (unit_buf->pFunc_Term, pArgs);
+  PyObject *pReturn = python->PyObject_CallObject (unit_buf->pFunc_Term, pArgs);
+
+  if (pReturn == NULL)
+  {
+    python->PyErr_Print ();
+  }
+  else
+  {
+    python->Py_DecRef (pReturn);
+  }
 
   python->Py_DecRef (pArgs);
 
+  // the functions are borrowed from pGlobals
+
   python->Py_DecRef (unit_buf->pArgs);
   python->Py_DecRef (unit_buf->pContext);
-  python->Py_DecRef (unit_buf->pFunc_kernel_loop);
-  python->Py_DecRef (unit_buf->pFunc_Term);
-  python->Py_DecRef (unit_buf->pFunc_Init);
   python->Py_DecRef (unit_buf->pGlobals);
 
-  python->Py_EndInterpreter (unit_buf->tstate);
+  if (python_interpreter->subinterpreters == true)
+  {
+    python->Py_EndInterpreter (unit_buf->tstate);
+  }
+  else
+  {
+    python->PyGILState_Release (unit_buf->gstate);
+  }
 }
 
 int get_unit_count (void *platform_context)
@@ -996,16 +1143,8 @@ char *get_unit_info (void *platform_context, const int unit_idx)
   return unit_buf->unit_info_buf;
 }
 
-bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_param_t *device_param, MAYBE_UNUSED hashconfig_t *hashconfig, MAYBE_UNUSED hashes_t *hashes, MAYBE_UNUSED const u32 salt_pos, MAYBE_UNUSED const u64 pws_cnt)
+static bool call_kernel_loop (hc_python_lib_t *python, unit_t *unit_buf, hc_device_param_t *device_param, hashes_t *hashes, const u32 salt_pos, const u64 pws_cnt)
 {
-  python_interpreter_t *python_interpreter = platform_context;
-
-  const int unit_idx = device_param->bridge_link_device;
-
-  unit_t *unit_buf = &python_interpreter->units_buf[unit_idx];
-
-  hc_python_lib_t *python = python_interpreter->python;
-
   generic_io_tmp_t *generic_io_tmp = (generic_io_tmp_t *) device_param->h_tmps;
 
   PyObject *pws = python->PyList_New (pws_cnt);
@@ -1078,6 +1217,25 @@ bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
   return true;
 }
 
+bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_param_t *device_param, MAYBE_UNUSED hashconfig_t *hashconfig, MAYBE_UNUSED hashes_t *hashes, MAYBE_UNUSED const u32 salt_pos, MAYBE_UNUSED const u64 pws_cnt)
+{
+  python_interpreter_t *python_interpreter = platform_context;
+
+  const int unit_idx = device_param->bridge_link_device;
+
+  unit_t *unit_buf = &python_interpreter->units_buf[unit_idx];
+
+  hc_python_lib_t *python = python_interpreter->python;
+
+  python->PyEval_RestoreThread (unit_buf->tstate);
+
+  const bool rc = call_kernel_loop (python, unit_buf, device_param, hashes, salt_pos, pws_cnt);
+
+  unit_buf->tstate = python->PyEval_SaveThread ();
+
+  return rc;
+}
+
 const char *st_update_hash (MAYBE_UNUSED void *platform_context)
 {
   python_interpreter_t *python_interpreter = platform_context;
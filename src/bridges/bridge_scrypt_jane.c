@@ -9,6 +9,8 @@
 #include "memory.h"
 #include "shared.h"
 #include "cpu_features.h"
+#include "cpu_scrypt_mb.h"
+#include "timer.h"
 
 #include "code/scrypt-jane-portable.h"
 #include "code/scrypt-jane-hash.h"
@@ -40,6 +42,11 @@ typedef struct
 	//void *X;
 	void *Y;
 
+  // multi-buffer ROMix, V holds one region per lane
+
+  void   *XY;
+  int     lanes;
+
   // implementation specific
 
   char    unit_info_buf[1024];
@@ -55,8 +62,20 @@ typedef struct
   unit_t *units_buf;
   int     units_cnt;
 
+  int     lanes;
+  bool    timings;
+
 } bridge_scrypt_jane_t;
 
+static const char *lanes_info (const int lanes)
+{
+  if (lanes == 16) return "16x AVX-512F";
+  if (lanes ==  8) return "8x AVX2";
+  if (lanes ==  4) return "4x SSE2";
+
+  return "1x";
+}
+
 static bool units_init (bridge_scrypt_jane_t *bridge_scrypt_jane)
 {
   #if defined (_WIN)
@@ -82,12 +101,15 @@ static bool units_init (bridge_scrypt_jane_t *bridge_scrypt_jane)
     unit_t *unit_buf = &units_buf[i];
 
     unit_buf->unit_info_len = snprintf (unit_buf->unit_info_buf, sizeof (unit_buf->unit_info_buf) - 1,
-      "%s",
-      "Scrypt-Jane ROMix");
+      "%s (%s)",
+      "Scrypt-Jane ROMix",
+      lanes_info (bridge_scrypt_jane->lanes));
 
     unit_buf->unit_info_buf[unit_buf->unit_info_len] = 0;
 
-    unit_buf->workitem_count = N_ACCEL;
+    // keep the batch a multiple of the lanes, so the last multi-buffer ROMix is full
+
+    unit_buf->workitem_count = MAX (N_ACCEL, bridge_scrypt_jane->lanes);
 
     units_cnt++;
   }
@@ -106,7 +128,7 @@ static void units_term (bridge_scrypt_jane_t *bridge_scrypt_jane)
   }
 }
 
-void *platform_init ()
+void *platform_init (user_options_t *user_options)
 {
   // Verify CPU features
 
@@ -114,7 +136,23 @@ void *platform_init ()
 
   // Allocate platform context
 
-  bridge_scrypt_jane_t *bridge_scrypt_jane = (bridge_scrypt_jane_t *) hcmalloc (sizeof (bridge_scrypt_jane_t));
+  bridge_scrypt_jane_t *bridge_scrypt_jane = (bridge_scrypt_jane_t *) hccalloc (1, sizeof (bridge_scrypt_jane_t));
+
+  // --bridge-parameter1 sets the number of candidates running through ROMix in lockstep (1, 4, 8 or 16),
+  // default is the widest the CPU supports, 1 disables the multi-buffer ROMix
+
+  bridge_scrypt_jane->lanes = scrypt_mb_lanes_best ();
+
+  if (user_options->bridge_parameter1 != NULL)
+  {
+    const int lanes = atoi (user_options->bridge_parameter1);
+
+    bridge_scrypt_jane->lanes = (scrypt_mb_lanes_supported (lanes) == 1) ? lanes : 1;
+  }
+
+  // --bridge-parameter2=1 prints the H/s of each unit per launch, to size the units against the memory bandwidth
+
+  bridge_scrypt_jane->timings = (user_options->bridge_parameter2 != NULL) && (strcmp (user_options->bridge_parameter2, "1") == 0);
 
   if (units_init (bridge_scrypt_jane) == false)
   {
@@ -196,13 +234,36 @@ bool salt_prepare (void *platform_context, MAYBE_UNUSED hashconfig_t *hashconfig
 
   bridge_scrypt_jane_t *bridge_scrypt_jane = platform_context;
 
+  // every lane needs its own V, fall back to fewer lanes if they do not fit into the free host memory
+
+  int lanes = bridge_scrypt_jane->lanes;
+
+  u64 free_mem = 0;
+
+  if (get_free_memory (&free_mem) == true)
+  {
+    while ((lanes > 1) && ((u64) bridge_scrypt_jane->units_cnt * lanes * largest_V > free_mem / 4 * 3))
+    {
+      lanes = (lanes == 16) ? 8 : (lanes == 8) ? 4 : 1;
+
+      if ((lanes > 1) && (scrypt_mb_lanes_supported (lanes) == 0)) lanes = 1;
+    }
+  }
+
   for (int unit_idx = 0; unit_idx < bridge_scrypt_jane->units_cnt; unit_idx++)
   {
     unit_t *unit_buf = &bridge_scrypt_jane->units_buf[unit_idx];
 
-    unit_buf->V = hcmalloc_bridge_aligned (largest_V, 64);
+    unit_buf->lanes = lanes;
+
+    unit_buf->V = hcmalloc_bridge_aligned (largest_V * lanes, 64);
     //unit_buf->X = hcmalloc_bridge_aligned (largest_X, 64);
     unit_buf->Y = hcmalloc_bridge_aligned (largest_Y, 64);
+
+    if (lanes > 1)
+    {
+      unit_buf->XY = hcmalloc_bridge_aligned (largest_Y * 2 * lanes, 64);
+    }
   }
 
   return true;
@@ -219,6 +280,11 @@ void salt_destroy (void *platform_context, MAYBE_UNUSED hashconfig_t *hashconfig
     hcfree_bridge_aligned (unit_buf->V);
     //hcfree_bridge_aligned (unit_buf->X);
     hcfree_bridge_aligned (unit_buf->Y);
+
+    if (unit_buf->lanes > 1)
+    {
+      hcfree_bridge_aligned (unit_buf->XY);
+    }
   }
 }
 
@@ -246,18 +312,56 @@ bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
 
 	const size_t chunk_bytes = 64 * 2 * r;
 
+  hc_timer_t timer;
+
+  if (bridge_scrypt_jane->timings == true) hc_timer_set (&timer);
+
   // hashcat guarantees h_tmps[] is 64 byte aligned
 
-  for (u64 pw_cnt = 0; pw_cnt < pws_cnt; pw_cnt++)
+  if (unit_buf->lanes > 1)
   {
-    u8 *X = (u8 *) scrypt_tmp->P;
+    // each of the p chunks of a candidate is an independent ROMix, so all of them go into the lanes
+
+    const int lanes = unit_buf->lanes;
+
+    const u64 chunks_cnt = pws_cnt * p;
+
+    for (u64 chunk_idx = 0; chunk_idx < chunks_cnt; chunk_idx += lanes)
+    {
+      u32 *B[SCRYPT_MB_LANES_MAX];
+
+      for (int lane = 0; lane < lanes; lane++)
+      {
+        const u64 idx = chunk_idx + lane;
+
+        // unused lanes of the last round repeat the first chunk, they write back the same result
 
-    for (u32 i = 0; i < p; i++)
+        B[lane] = (idx < chunks_cnt) ? (u32 *) ((u8 *) scrypt_tmp[idx / p].P + (chunk_bytes * (idx % p))) : B[0];
+      }
+
+      scrypt_mb_romix (B, lanes, (u32 *) V, (u32 *) unit_buf->XY, N, r);
+    }
+  }
+  else
+  {
+    for (u64 pw_cnt = 0; pw_cnt < pws_cnt; pw_cnt++)
     {
-      scrypt_ROMix ((scrypt_mix_word_t *) (X + (chunk_bytes * i)), (scrypt_mix_word_t *) Y, (scrypt_mix_word_t *) V, N, r);
+      u8 *X = (u8 *) scrypt_tmp->P;
+
+      for (u32 i = 0; i < p; i++)
+      {
+        scrypt_ROMix ((scrypt_mix_word_t *) (X + (chunk_bytes * i)), (scrypt_mix_word_t *) Y, (scrypt_mix_word_t *) V, N, r);
+      }
+
+      scrypt_tmp++;
     }
+  }
+
+  if (bridge_scrypt_jane->timings == true)
+  {
+    const double ms = hc_timer_get (timer);
 
-    scrypt_tmp++;
+    fprintf (stderr, "scrypt-jane: unit %d, %d lanes, %" PRIu64 " pws, %.2f ms, %.2f H/s\n", unit_idx + 1, unit_buf->lanes, pws_cnt, ms, (ms > 0) ? (pws_cnt * 1000.0 / ms) : 0);
   }
 
   return true;
@@ -9,6 +9,8 @@
 #include "memory.h"
 #include "shared.h"
 #include "cpu_features.h"
+#include "cpu_scrypt_mb.h"
+#include "timer.h"
 
 #include "yescrypt.h"
 
@@ -42,6 +44,10 @@ typedef struct
   void *V;
 	void *XY;
 
+  // multi-buffer ROMix, V and XY hold one region per lane
+
+  int     lanes;
+
   // implementation specific
 
   char    unit_info_buf[1024];
@@ -57,8 +63,20 @@ typedef struct
   unit_t *units_buf;
   int     units_cnt;
 
+  int     lanes;
+  bool    timings;
+
 } bridge_scrypt_yescrypt_t;
 
+static const char *lanes_info (const int lanes)
+{
+  if (lanes == 16) return "16x AVX-512F";
+  if (lanes ==  8) return "8x AVX2";
+  if (lanes ==  4) return "4x SSE2";
+
+  return "1x";
+}
+
 static bool units_init (bridge_scrypt_yescrypt_t *bridge_scrypt_yescrypt)
 {
   #if defined (_WIN)
@@ -84,12 +102,15 @@ static bool units_init (bridge_scrypt_yescrypt_t *bridge_scrypt_yescrypt)
     unit_t *unit_buf = &units_buf[i];
 
     unit_buf->unit_info_len = snprintf (unit_buf->unit_info_buf, sizeof (unit_buf->unit_info_buf) - 1,
-      "%s",
-      "Scrypt-Yescrypt");
+      "%s (%s)",
+      "Scrypt-Yescrypt",
+      lanes_info (bridge_scrypt_yescrypt->lanes));
 
     unit_buf->unit_info_buf[unit_buf->unit_info_len] = 0;
 
-    unit_buf->workitem_count = N_ACCEL;
+    // keep the batch a multiple of the lanes, so the last multi-buffer ROMix is full
+
+    unit_buf->workitem_count = MAX (N_ACCEL, bridge_scrypt_yescrypt->lanes);
 
     units_cnt++;
   }
@@ -108,7 +129,7 @@ static void units_term (bridge_scrypt_yescrypt_t *bridge_scrypt_yescrypt)
   }
 }
 
-void *platform_init ()
+void *platform_init (user_options_t *user_options)
 {
   // Verify CPU features
 
@@ -116,7 +137,24 @@ void *platform_init ()
 
   // Allocate platform context
 
-  bridge_scrypt_yescrypt_t *bridge_scrypt_yescrypt = (bridge_scrypt_yescrypt_t *) hcmalloc (sizeof (bridge_scrypt_yescrypt_t));
+  bridge_scrypt_yescrypt_t *bridge_scrypt_yescrypt = (bridge_scrypt_yescrypt_t *) hccalloc (1, sizeof (bridge_scrypt_yescrypt_t));
+
+  // --bridge-parameter1 sets the number of candidates running through ROMix in lockstep (1, 4, 8 or 16),
+  // default is the widest the CPU supports, 1 disables the multi-buffer ROMix and uses smix () of yescrypt,
+  // which is faster than 4 lanes of SSE2
+
+  bridge_scrypt_yescrypt->lanes = (scrypt_mb_lanes_best () >= 8) ? scrypt_mb_lanes_best () : 1;
+
+  if (user_options->bridge_parameter1 != NULL)
+  {
+    const int lanes = atoi (user_options->bridge_parameter1);
+
+    bridge_scrypt_yescrypt->lanes = (scrypt_mb_lanes_supported (lanes) == 1) ? lanes : 1;
+  }
+
+  // --bridge-parameter2=1 prints the H/s of each unit per launch, to size the units against the memory bandwidth
+
+  bridge_scrypt_yescrypt->timings = (user_options->bridge_parameter2 != NULL) && (strcmp (user_options->bridge_parameter2, "1") == 0);
 
   if (units_init (bridge_scrypt_yescrypt) == false)
   {
@@ -191,12 +229,30 @@ bool salt_prepare (void *platform_context, MAYBE_UNUSED hashconfig_t *hashconfig
 
   bridge_scrypt_yescrypt_t *bridge_scrypt_yescrypt = platform_context;
 
+  // every lane needs its own V, fall back to fewer lanes if they do not fit into the free host memory
+
+  int lanes = bridge_scrypt_yescrypt->lanes;
+
+  u64 free_mem = 0;
+
+  if (get_free_memory (&free_mem) == true)
+  {
+    while ((lanes > 1) && ((u64) bridge_scrypt_yescrypt->units_cnt * lanes * largest_V > free_mem / 4 * 3))
+    {
+      lanes = (lanes == 16) ? 8 : 1;
+
+      if ((lanes > 1) && (scrypt_mb_lanes_supported (lanes) == 0)) lanes = 1;
+    }
+  }
+
   for (int unit_idx = 0; unit_idx < bridge_scrypt_yescrypt->units_cnt; unit_idx++)
   {
     unit_t *unit_buf = &bridge_scrypt_yescrypt->units_buf[unit_idx];
 
-    unit_buf->V  = hcmalloc_bridge_aligned (largest_V,  64);
-    unit_buf->XY = hcmalloc_bridge_aligned (largest_XY, 64);
+    unit_buf->lanes = lanes;
+
+    unit_buf->V  = hcmalloc_bridge_aligned (largest_V  * lanes, 64);
+    unit_buf->XY = hcmalloc_bridge_aligned (largest_XY * lanes, 64);
   }
 
   return true;
@@ -231,26 +287,68 @@ bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
 
   scrypt_tmp_t *scrypt_tmp = (scrypt_tmp_t *) device_param->h_tmps;
 
-  for (u64 pw_cnt = 0; pw_cnt < pws_cnt; pw_cnt++)
+  hc_timer_t timer;
+
+  if (bridge_scrypt_yescrypt->timings == true) hc_timer_set (&timer);
+
+  if (unit_buf->lanes > 1)
   {
-    u8 *B = (u8 *) scrypt_tmp->B;
+    // each of the p chunks of a candidate is an independent ROMix, so all of them go into the lanes
+
+    const int lanes = unit_buf->lanes;
+
+    const u32 p = salt_buf->scrypt_p;
+
+    const size_t chunk_bytes = 128 * salt_buf->scrypt_r;
+
+    const u64 chunks_cnt = pws_cnt * p;
+
+    for (u64 chunk_idx = 0; chunk_idx < chunks_cnt; chunk_idx += lanes)
+    {
+      u32 *B[SCRYPT_MB_LANES_MAX];
 
-    // We could use p-based parallelization from yescrypt instead,
-    // but since we're already multi-threading, there's no need to run OpenMP.
-    // With that in mind, we can optimize by using a constant p=1,
-    // allowing the compiler to eliminate branches in smix().
+      for (int lane = 0; lane < lanes; lane++)
+      {
+        const u64 idx = chunk_idx + lane;
 
-    for (u32 i = 0; i < salt_buf->scrypt_p; i++)
+        // unused lanes of the last round repeat the first chunk, they write back the same result
+
+        B[lane] = (idx < chunks_cnt) ? (u32 *) ((u8 *) scrypt_tmp[idx / p].B + (chunk_bytes * (idx % p))) : B[0];
+      }
+
+      scrypt_mb_romix (B, lanes, (u32 *) unit_buf->V, (u32 *) unit_buf->XY, salt_buf->scrypt_N, salt_buf->scrypt_r);
+    }
+  }
+  else
+  {
+    for (u64 pw_cnt = 0; pw_cnt < pws_cnt; pw_cnt++)
     {
-      // Same here: using constants allows the compiler to optimize away branches in smix(),
-      // so there's no need to call smix1()/smix2() directly and unnecessarily complicate the code.
+      u8 *B = (u8 *) scrypt_tmp->B;
+
+      // We could use p-based parallelization from yescrypt instead,
+      // but since we're already multi-threading, there's no need to run OpenMP.
+      // With that in mind, we can optimize by using a constant p=1,
+      // allowing the compiler to eliminate branches in smix().
 
-      smix (B, salt_buf->scrypt_r, salt_buf->scrypt_N, 1, 0, 0, unit_buf->V, 0, NULL, unit_buf->XY, NULL, NULL);
+      for (u32 i = 0; i < salt_buf->scrypt_p; i++)
+      {
+        // Same here: using constants allows the compiler to optimize away branches in smix(),
+        // so there's no need to call smix1()/smix2() directly and unnecessarily complicate the code.
 
-      B += 128 * salt_buf->scrypt_r;
+        smix (B, salt_buf->scrypt_r, salt_buf->scrypt_N, 1, 0, 0, unit_buf->V, 0, NULL, unit_buf->XY, NULL, NULL);
+
+        B += 128 * salt_buf->scrypt_r;
+      }
+
+      scrypt_tmp++;
     }
+  }
+
+  if (bridge_scrypt_yescrypt->timings == true)
+  {
+    const double ms = hc_timer_get (timer);
 
-    scrypt_tmp++;
+    fprintf (stderr, "scrypt-yescrypt: unit %d, %d lanes, %" PRIu64 " pws, %.2f ms, %.2f H/s\n", unit_idx + 1, unit_buf->lanes, pws_cnt, ms, (ms > 0) ? (pws_cnt * 1000.0 / ms) : 0);
   }
 
   return true;
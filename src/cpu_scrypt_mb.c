@@ -0,0 +1,199 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+#include "common.h"
+#include "types.h"
+#include "cpu_features.h"
+#include "cpu_scrypt_mb.h"
+
+// GCC does not keep 32 and 64 byte vectors on the Win64 stack aligned, so we stay with SSE2 there
+
+#if defined (__x86_64__) && !defined (_WIN)
+#define SCRYPT_MB_X86_AVX
+#endif
+
+#if defined (__x86_64__)
+
+#include <immintrin.h>
+
+// SSE2, 4 lanes
+
+typedef u32 mb_u32x4_t __attribute__ ((vector_size (16)));
+
+static inline void transpose_4x4 (mb_u32x4_t r[4])
+{
+  const __m128i t0 = _mm_unpacklo_epi32 ((__m128i) r[0], (__m128i) r[1]);
+  const __m128i t1 = _mm_unpacklo_epi32 ((__m128i) r[2], (__m128i) r[3]);
+  const __m128i t2 = _mm_unpackhi_epi32 ((__m128i) r[0], (__m128i) r[1]);
+  const __m128i t3 = _mm_unpackhi_epi32 ((__m128i) r[2], (__m128i) r[3]);
+
+  r[0] = (mb_u32x4_t) _mm_unpacklo_epi64 (t0, t1);
+  r[1] = (mb_u32x4_t) _mm_unpackhi_epi64 (t0, t1);
+  r[2] = (mb_u32x4_t) _mm_unpacklo_epi64 (t2, t3);
+  r[3] = (mb_u32x4_t) _mm_unpackhi_epi64 (t2, t3);
+}
+
+#define MB_LANES      4
+#define MB_VEC        mb_u32x4_t
+#define MB_TARGET     __attribute__ ((target ("sse2")))
+#define MB_TRANSPOSE  transpose_4x4
+#define MB_FN(name)   name ## _sse2
+
+#include "cpu_scrypt_mb_template.h"
+
+#undef MB_LANES
+#undef MB_VEC
+#undef MB_TARGET
+#undef MB_TRANSPOSE
+#undef MB_FN
+
+#endif // __x86_64__
+
+#if defined (SCRYPT_MB_X86_AVX)
+
+// AVX2, 8 lanes
+
+typedef u32 mb_u32x8_t __attribute__ ((vector_size (32)));
+
+static inline __attribute__ ((target ("avx2"))) void transpose_8x8 (mb_u32x8_t r[8])
+{
+  __m256i t[8];
+  __m256i u[8];
+
+  for (int k = 0; k < 8; k += 2)
+  {
+    t[k + 0] = _mm256_unpacklo_epi32 ((__m256i) r[k], (__m256i) r[k + 1]);
+    t[k + 1] = _mm256_unpackhi_epi32 ((__m256i) r[k], (__m256i) r[k + 1]);
+  }
+
+  for (int k = 0; k < 8; k += 4)
+  {
+    u[k + 0] = _mm256_unpacklo_epi64 (t[k + 0], t[k + 2]);
+    u[k + 1] = _mm256_unpackhi_epi64 (t[k + 0], t[k + 2]);
+    u[k + 2] = _mm256_unpacklo_epi64 (t[k + 1], t[k + 3]);
+    u[k + 3] = _mm256_unpackhi_epi64 (t[k + 1], t[k + 3]);
+  }
+
+  for (int m = 0; m < 4; m++)
+  {
+    r[m + 0] = (mb_u32x8_t) _mm256_permute2x128_si256 (u[m], u[m + 4], 0x20);
+    r[m + 4] = (mb_u32x8_t) _mm256_permute2x128_si256 (u[m], u[m + 4], 0x31);
+  }
+}
+
+#define MB_LANES      8
+#define MB_VEC        mb_u32x8_t
+#define MB_TARGET     __attribute__ ((target ("avx2")))
+#define MB_TRANSPOSE  transpose_8x8
+#define MB_FN(name)   name ## _avx2
+
+#include "cpu_scrypt_mb_template.h"
+
+#undef MB_LANES
+#undef MB_VEC
+#undef MB_TARGET
+#undef MB_TRANSPOSE
+#undef MB_FN
+
+// AVX-512F, 16 lanes
+
+typedef u32 mb_u32x16_t __attribute__ ((vector_size (64)));
+
+static inline __attribute__ ((target ("avx512f"))) void transpose_16x16 (mb_u32x16_t r[16])
+{
+  __m512i t[16];
+  __m512i u[16];
+  __m512i s[4];
+
+  for (int k = 0; k < 16; k += 2)
+  {
+    t[k + 0] = _mm512_unpacklo_epi32 ((__m512i) r[k], (__m512i) r[k + 1]);
+    t[k + 1] = _mm512_unpackhi_epi32 ((__m512i) r[k], (__m512i) r[k + 1]);
+  }
+
+  for (int k = 0; k < 16; k += 4)
+  {
+    u[k + 0] = _mm512_unpacklo_epi64 (t[k + 0], t[k + 2]);
+    u[k + 1] = _mm512_unpackhi_epi64 (t[k + 0], t[k + 2]);
+    u[k + 2] = _mm512_unpacklo_epi64 (t[k + 1], t[k + 3]);
+    u[k + 3] = _mm512_unpackhi_epi64 (t[k + 1], t[k + 3]);
+  }
+
+  // u[4k + m] holds word 4q + m of rows 4k .. 4k + 3 in its 128 bit lane q
+
+  for (int m = 0; m < 4; m++)
+  {
+    s[0] = _mm512_shuffle_i32x4 (u[m + 0], u[m +  4], 0x88);
+    s[1] = _mm512_shuffle_i32x4 (u[m + 0], u[m +  4], 0xdd);
+    s[2] = _mm512_shuffle_i32x4 (u[m + 8], u[m + 12], 0x88);
+    s[3] = _mm512_shuffle_i32x4 (u[m + 8], u[m + 12], 0xdd);
+
+    r[m +  0] = (mb_u32x16_t) _mm512_shuffle_i32x4 (s[0], s[2], 0x88);
+    r[m +  4] = (mb_u32x16_t) _mm512_shuffle_i32x4 (s[1], s[3], 0x88);
+    r[m +  8] = (mb_u32x16_t) _mm512_shuffle_i32x4 (s[0], s[2], 0xdd);
+    r[m + 12] = (mb_u32x16_t) _mm512_shuffle_i32x4 (s[1], s[3], 0xdd);
+  }
+}
+
+#define MB_LANES      16
+#define MB_VEC        mb_u32x16_t
+#define MB_TARGET     __attribute__ ((target ("avx512f")))
+#define MB_TRANSPOSE  transpose_16x16
+#define MB_FN(name)   name ## _avx512f
+
+#include "cpu_scrypt_mb_template.h"
+
+#undef MB_LANES
+#undef MB_VEC
+#undef MB_TARGET
+#undef MB_TRANSPOSE
+#undef MB_FN
+
+#endif // SCRYPT_MB_X86_AVX
+
+int scrypt_mb_lanes_supported (const int lanes)
+{
+  #if defined (__x86_64__)
+
+  if (lanes ==  4) return cpu_supports_sse2 ();
+
+  #endif
+
+  #if defined (SCRYPT_MB_X86_AVX)
+
+  if (lanes ==  8) return cpu_supports_avx2 ();
+  if (lanes == 16) return cpu_supports_avx512f ();
+
+  #endif
+
+  return 0;
+}
+
+// 1 means there is no multi-buffer support, the caller uses its regular ROMix
+
+int scrypt_mb_lanes_best (void)
+{
+  if (scrypt_mb_lanes_supported (16)) return 16;
+  if (scrypt_mb_lanes_supported  (8)) return 8;
+  if (scrypt_mb_lanes_supported  (4)) return 4;
+
+  return 1;
+}
+
+void scrypt_mb_romix (MAYBE_UNUSED u32 **B, MAYBE_UNUSED const int lanes, MAYBE_UNUSED u32 *V, MAYBE_UNUSED u32 *XY, MAYBE_UNUSED const u32 N, MAYBE_UNUSED const u32 r)
+{
+  #if defined (SCRYPT_MB_X86_AVX)
+
+  if (lanes == 16) romix_avx512f (B, V, (mb_u32x16_t *) XY, N, r);
+  if (lanes ==  8) romix_avx2    (B, V, (mb_u32x8_t  *) XY, N, r);
+
+  #endif
+
+  #if defined (__x86_64__)
+
+  if (lanes ==  4) romix_sse2    (B, V, (mb_u32x4_t  *) XY, N, r);
+
+  #endif
+}
@@ -10,6 +10,7 @@
 #include "event.h"
 #include "locking.h"
 #include "shared.h"
+#include "folder.h"
 #include "dictstat.h"
 
 int sort_by_dictstat (const void *s1, const void *s2)
@@ -75,6 +76,11 @@ int dictstat_init (hashcat_ctx_t *hashcat_ctx)
 
   hc_asprintf (&dictstat_ctx->filename, "%s/%s", folder_config->profile_dir, DICTSTAT_FILENAME);
 
+  hc_asprintf (&dictstat_ctx->idx_folder, "%s/%s", folder_config->profile_dir, DICTSTAT_IDX_FOLDER);
+
+  dictstat_ctx->idx     = NULL;
+  dictstat_ctx->idx_cnt = 0;
+
   return 0;
 }
 
@@ -84,6 +90,14 @@ void dictstat_destroy (hashcat_ctx_t *hashcat_ctx)
 
   if (dictstat_ctx->enabled == false) return;
 
+  for (u32 idx_pos = 0; idx_pos < dictstat_ctx->idx_cnt; idx_pos++)
+  {
+    hcfree (dictstat_ctx->idx[idx_pos].dictfile);
+    hcfree (dictstat_ctx->idx[idx_pos].chkpts);
+  }
+
+  hcfree (dictstat_ctx->idx);
+  hcfree (dictstat_ctx->idx_folder);
   hcfree (dictstat_ctx->filename);
   hcfree (dictstat_ctx->base);
 
@@ -276,3 +290,194 @@ void dictstat_append (hashcat_ctx_t *hashcat_ctx, dictstat_t *d)
 
   lsearch (d, dictstat_ctx->base, &dictstat_ctx->cnt, sizeof (dictstat_t), sort_by_dictstat);
 }
+
+static void dictstat_idx_filename (const dictstat_ctx_t *dictstat_ctx, const dictstat_t *d, char *buf, const size_t buf_sz)
+{
+  char hex[33];
+
+  for (int i = 0; i < 16; i++)
+  {
+    snprintf (hex + (i * 2), 3, "%02x", d->hash_filename[i]);
+  }
+
+  snprintf (buf, buf_sz, "%s/%s.idx", dictstat_ctx->idx_folder, hex);
+}
+
+static void dictstat_idx_store (dictstat_ctx_t *dictstat_ctx, const char *dictfile, const dictstat_t *d, dictstat_chkpt_t *chkpts, const u64 chkpts_cnt)
+{
+  // the same wordlist can be counted again, e.g. with a different rule or in another attack
+
+  for (u32 idx_pos = 0; idx_pos < dictstat_ctx->idx_cnt; idx_pos++)
+  {
+    dictstat_idx_t *idx = dictstat_ctx->idx + idx_pos;
+
+    if (strcmp (idx->dictfile, dictfile) != 0) continue;
+
+    hcfree (idx->chkpts);
+
+    memcpy (&idx->d, d, sizeof (dictstat_t));
+
+    idx->chkpts     = chkpts;
+    idx->chkpts_cnt = chkpts_cnt;
+
+    return;
+  }
+
+  dictstat_ctx->idx = (dictstat_idx_t *) hcrealloc (dictstat_ctx->idx, dictstat_ctx->idx_cnt * sizeof (dictstat_idx_t), sizeof (dictstat_idx_t));
+
+  dictstat_idx_t *idx = dictstat_ctx->idx + dictstat_ctx->idx_cnt;
+
+  idx->dictfile = hcstrdup (dictfile);
+
+  memcpy (&idx->d, d, sizeof (dictstat_t));
+
+  idx->chkpts     = chkpts;
+  idx->chkpts_cnt = chkpts_cnt;
+
+  dictstat_ctx->idx_cnt++;
+}
+
+void dictstat_idx_add (hashcat_ctx_t *hashcat_ctx, const char *dictfile, const dictstat_t *d, dictstat_chkpt_t *chkpts, const u64 chkpts_cnt)
+{
+  hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+  dictstat_ctx_t *dictstat_ctx = hashcat_ctx->dictstat_ctx;
+  user_options_t *user_options = hashcat_ctx->user_options;
+
+  if ((dictstat_ctx->enabled == false) || (chkpts_cnt == 0))
+  {
+    hcfree (chkpts);
+
+    return;
+  }
+
+  dictstat_idx_store (dictstat_ctx, dictfile, d, chkpts, chkpts_cnt);
+
+  // persist under the same conditions as the dictstat database itself
+
+  if (hashconfig->dictstat_disable == true) return;
+
+  if (user_options->rule_buf_l_chgd == true) return;
+  if (user_options->rule_buf_r_chgd == true) return;
+
+  hc_mkdir (dictstat_ctx->idx_folder, 0700);
+
+  char filename[HCBUFSIZ_TINY];
+
+  dictstat_idx_filename (dictstat_ctx, d, filename, sizeof (filename));
+
+  HCFILE fp;
+
+  if (hc_fopen (&fp, filename, "wb") == false)
+  {
+    event_log_warning (hashcat_ctx, "%s: %s", filename, strerror (errno));
+
+    return;
+  }
+
+  if (hc_lockfile (&fp) == -1)
+  {
+    hc_fclose (&fp);
+
+    event_log_warning (hashcat_ctx, "%s: %s", filename, strerror (errno));
+
+    return;
+  }
+
+  // header
+
+  u64 v = DICTSTAT_IDX_VERSION;
+  u64 z = chkpts_cnt;
+
+  v = byte_swap_64 (v);
+  z = byte_swap_64 (z);
+
+  hc_fwrite (&v, sizeof (u64), 1, &fp);
+  hc_fwrite (&z, sizeof (u64), 1, &fp);
+
+  hc_fwrite (d, sizeof (dictstat_t), 1, &fp);
+
+  // data
+
+  hc_fwrite (chkpts, sizeof (dictstat_chkpt_t), chkpts_cnt, &fp);
+
+  hc_unlockfile (&fp);
+
+  hc_fclose (&fp);
+}
+
+void dictstat_idx_load (hashcat_ctx_t *hashcat_ctx, const char *dictfile, const dictstat_t *d)
+{
+  hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+  dictstat_ctx_t *dictstat_ctx = hashcat_ctx->dictstat_ctx;
+
+  if (dictstat_ctx->enabled == false) return;
+
+  if (hashconfig->dictstat_disable == true) return;
+
+  char filename[HCBUFSIZ_TINY];
+
+  dictstat_idx_filename (dictstat_ctx, d, filename, sizeof (filename));
+
+  HCFILE fp;
+
+  if (hc_fopen (&fp, filename, "rb") == false) return;
+
+  u64 v = 0;
+  u64 z = 0;
+
+  dictstat_t d_idx;
+
+  const size_t nread1 = hc_fread (&v,     sizeof (u64),        1, &fp);
+  const size_t nread2 = hc_fread (&z,     sizeof (u64),        1, &fp);
+  const size_t nread3 = hc_fread (&d_idx, sizeof (dictstat_t), 1, &fp);
+
+  v = byte_swap_64 (v);
+  z = byte_swap_64 (z);
+
+  // silently ignore anything that does not belong to the wordlist as it is now, it gets rebuilt on the next full count
+
+  if ((nread1 != 1) || (nread2 != 1) || (nread3 != 1) || (v != DICTSTAT_IDX_VERSION) || (z == 0) || (z > (u64) d->stat.st_size))
+  {
+    hc_fclose (&fp);
+
+    return;
+  }
+
+  if ((sort_by_dictstat (&d_idx, d) != 0) || (d_idx.cnt != d->cnt))
+  {
+    hc_fclose (&fp);
+
+    return;
+  }
+
+  dictstat_chkpt_t *chkpts = (dictstat_chkpt_t *) hccalloc (z, sizeof (dictstat_chkpt_t));
+
+  const size_t nread4 = hc_fread (chkpts, sizeof (dictstat_chkpt_t), z, &fp);
+
+  hc_fclose (&fp);
+
+  if (nread4 != z)
+  {
+    hcfree (chkpts);
+
+    return;
+  }
+
+  dictstat_idx_store (dictstat_ctx, dictfile, &d_idx, chkpts, z);
+}
+
+const dictstat_idx_t *dictstat_idx_find (hashcat_ctx_t *hashcat_ctx, const char *dictfile)
+{
+  const dictstat_ctx_t *dictstat_ctx = hashcat_ctx->dictstat_ctx;
+
+  if (dictstat_ctx->enabled == false) return NULL;
+
+  for (u32 idx_pos = 0; idx_pos < dictstat_ctx->idx_cnt; idx_pos++)
+  {
+    const dictstat_idx_t *idx = dictstat_ctx->idx + idx_pos;
+
+    if (strcmp (idx->dictfile, dictfile) == 0) return idx;
+  }
+
+  return NULL;
+}
@@ -407,6 +407,49 @@ HC_API_CALL void *thread_calc_stdin (void *p)
   return NULL;
 }
 
+#ifdef WITH_BRAIN
+static int calc_brain_flush_pending (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 words_fin_pending)
+{
+  // with pipelined brain lookups a batch waits in pws until the lookup of the next one is in flight,
+  // it runs on the device meanwhile and is committed on the other link, the one it was looked up on
+
+  status_ctx_t *status_ctx = hashcat_ctx->status_ctx;
+
+  const u64 pws_cnt = device_param->pws_cnt;
+
+  if (run_copy    (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
+  if (run_cracker (hashcat_ctx, device_param, -1, pws_cnt) == -1) return -1;
+
+  if ((status_ctx->devices_status != STATUS_ABORTED)
+   && (status_ctx->devices_status != STATUS_ABORTED_RUNTIME)
+   && (status_ctx->devices_status != STATUS_QUIT)
+   && (status_ctx->devices_status != STATUS_BYPASS)
+   && (status_ctx->devices_status != STATUS_ERROR))
+  {
+    if (brain_client_commit_next (device_param, status_ctx) == false)
+    {
+      brain_client_disconnect (device_param);
+    }
+  }
+
+  memset (device_param->pws_comp,     0, device_param->size_pws_comp);
+  memset (device_param->pws_idx,      0, device_param->size_pws_idx);
+  if (device_param->pws_base_cnt) memset (device_param->pws_base_buf, 0, device_param->pws_base_cnt * sizeof (pw_pre_t));
+
+  device_param->pws_cnt      = 0;
+  device_param->pws_base_cnt = 0;
+
+  if ((device_param->speed_only_finish == false) && (status_ctx->run_thread_level2 == true))
+  {
+    device_param->words_done = MAX (device_param->words_done, words_fin_pending);
+
+    status_ctx->words_cur = get_highest_words_done (hashcat_ctx);
+  }
+
+  return 0;
+}
+#endif
+
 static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 {
   user_options_t       *user_options       = hashcat_ctx->user_options;
@@ -432,6 +475,10 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
     brain_client_disconnect (device_param);
 
+    // the hash lookups of the next batch overlap the device run of the current one
+
+    device_param->brain_link_async = ((user_options->brain_client == true) && (user_options->brain_client_features & BRAIN_CLIENT_FEATURE_HASHES)) ? true : false;
+
     if (user_options->brain_client == true)
     {
       const i64 passwords_max = device_param->hardware_power * device_param->kernel_accel;
@@ -496,13 +543,26 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
       u64 words_cur = 0;
 
+      bool pws_pending = false;
+
+      #ifdef WITH_BRAIN
+      u64 words_fin_pending = 0;
+      #endif
+
       while (status_ctx->run_thread_level1 == true)
       {
         u64 words_fin = 0;
 
-        memset (device_param->pws_comp,     0, device_param->size_pws_comp);
-        memset (device_param->pws_idx,      0, device_param->size_pws_idx);
-        memset (device_param->pws_base_buf, 0, device_param->size_pws_base);
+        #ifdef WITH_BRAIN
+        brain_client_swap (device_param);
+        #endif
+
+        if (pws_pending == false)
+        {
+          memset (device_param->pws_comp,     0, device_param->size_pws_comp);
+          memset (device_param->pws_idx,      0, device_param->size_pws_idx);
+          memset (device_param->pws_base_buf, 0, device_param->size_pws_base);
+        }
 
         u64 pre_rejects = -1;
 
@@ -612,9 +672,35 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
           {
             if (user_options->brain_client_features & BRAIN_CLIENT_FEATURE_HASHES)
             {
-              if (brain_client_lookup (device_param, status_ctx) == false)
+              if (pws_pending == true)
               {
-                brain_client_disconnect (device_param);
+                brain_client_lookup_start (device_param, status_ctx);
+
+                if (calc_brain_flush_pending (hashcat_ctx, device_param, words_fin_pending) == -1)
+                {
+                  brain_client_disconnect (device_param);
+
+                  hc_fclose (&extra_info_straight.fp);
+
+                  hcfree (hashcat_ctx_tmp->wl_data);
+                  hcfree (hashcat_ctx_tmp);
+
+                  return -1;
+                }
+
+                pws_pending = false;
+
+                if (brain_client_lookup_wait (device_param) == false)
+                {
+                  brain_client_disconnect (device_param);
+                }
+              }
+              else
+              {
+                if (brain_client_lookup (device_param, status_ctx) == false)
+                {
+                  brain_client_disconnect (device_param);
+                }
               }
             }
 
@@ -683,6 +769,19 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
         // flush
         //
 
+        #ifdef WITH_BRAIN
+        if ((device_param->brain_link_async == true) && (device_param->pws_cnt > 0) && (device_param->speed_only_finish == false) && (status_ctx->run_thread_level1 == true) && (words_fin > 0))
+        {
+          // goes to the device together with the first lookup of the next batch
+
+          pws_pending = true;
+
+          words_fin_pending = words_fin;
+
+          continue;
+        }
+        #endif
+
         const u64 pws_cnt = device_param->pws_cnt;
 
         if (pws_cnt)
@@ -742,6 +841,27 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
         if (words_fin == 0) break;
       }
 
+      #ifdef WITH_BRAIN
+      if (pws_pending == true)
+      {
+        // the loop was left before the next batch, it was looked up on the current link
+
+        brain_client_swap (device_param);
+
+        if (calc_brain_flush_pending (hashcat_ctx, device_param, words_fin_pending) == -1)
+        {
+          brain_client_disconnect (device_param);
+
+          hc_fclose (&extra_info_straight.fp);
+
+          hcfree (hashcat_ctx_tmp->wl_data);
+          hcfree (hashcat_ctx_tmp);
+
+          return -1;
+        }
+      }
+      #endif
+
       hc_fclose (&extra_info_straight.fp);
 
       wl_data_destroy (hashcat_ctx_tmp);
@@ -808,13 +928,26 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
       u64 words_cur = 0;
 
+      bool pws_pending = false;
+
+      #ifdef WITH_BRAIN
+      u64 words_fin_pending = 0;
+      #endif
+
       while (status_ctx->run_thread_level1 == true)
       {
         u64 words_fin = 0;
 
-        memset (device_param->pws_comp,     0, device_param->size_pws_comp);
-        memset (device_param->pws_idx,      0, device_param->size_pws_idx);
-        memset (device_param->pws_base_buf, 0, device_param->size_pws_base);
+        #ifdef WITH_BRAIN
+        brain_client_swap (device_param);
+        #endif
+
+        if (pws_pending == false)
+        {
+          memset (device_param->pws_comp,     0, device_param->size_pws_comp);
+          memset (device_param->pws_idx,      0, device_param->size_pws_idx);
+          memset (device_param->pws_base_buf, 0, device_param->size_pws_base);
+        }
 
         u64 pre_rejects = -1;
 
@@ -924,9 +1057,36 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
           {
             if (user_options->brain_client_features & BRAIN_CLIENT_FEATURE_HASHES)
             {
-              if (brain_client_lookup (device_param, status_ctx) == false)
+              if (pws_pending == true)
               {
-                brain_client_disconnect (device_param);
+                brain_client_lookup_start (device_param, status_ctx);
+
+                if (calc_brain_flush_pending (hashcat_ctx, device_param, words_fin_pending) == -1)
+                {
+                  brain_client_disconnect (device_param);
+
+                  hc_fclose (&extra_info_combi.base_fp);
+                  hc_fclose (&extra_info_combi.combs_fp);
+
+                  hcfree (hashcat_ctx_tmp->wl_data);
+                  hcfree (hashcat_ctx_tmp);
+
+                  return -1;
+                }
+
+                pws_pending = false;
+
+                if (brain_client_lookup_wait (device_param) == false)
+                {
+                  brain_client_disconnect (device_param);
+                }
+              }
+              else
+              {
+                if (brain_client_lookup (device_param, status_ctx) == false)
+                {
+                  brain_client_disconnect (device_param);
+                }
               }
             }
 
@@ -995,6 +1155,19 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
         // flush
         //
 
+        #ifdef WITH_BRAIN
+        if ((device_param->brain_link_async == true) && (device_param->pws_cnt > 0) && (device_param->speed_only_finish == false) && (status_ctx->run_thread_level1 == true) && (words_fin > 0))
+        {
+          // goes to the device together with the first lookup of the next batch
+
+          pws_pending = true;
+
+          words_fin_pending = words_fin;
+
+          continue;
+        }
+        #endif
+
         const u64 pws_cnt = device_param->pws_cnt;
 
         if (pws_cnt)
@@ -1056,6 +1229,28 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
         if (words_fin == 0) break;
       }
 
+      #ifdef WITH_BRAIN
+      if (pws_pending == true)
+      {
+        // the loop was left before the next batch, it was looked up on the current link
+
+        brain_client_swap (device_param);
+
+        if (calc_brain_flush_pending (hashcat_ctx, device_param, words_fin_pending) == -1)
+        {
+          brain_client_disconnect (device_param);
+
+          hc_fclose (&extra_info_combi.base_fp);
+          hc_fclose (&extra_info_combi.combs_fp);
+
+          hcfree (hashcat_ctx_tmp->wl_data);
+          hcfree (hashcat_ctx_tmp);
+
+          return -1;
+        }
+      }
+      #endif
+
       hc_fclose (&extra_info_combi.base_fp);
       hc_fclose (&extra_info_combi.combs_fp);
 
@@ -1074,12 +1269,25 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
       u64 words_cur = 0;
 
+      bool pws_pending = false;
+
+      #ifdef WITH_BRAIN
+      u64 words_fin_pending = 0;
+      #endif
+
       while (status_ctx->run_thread_level1 == true)
       {
         u64 words_fin = 0;
 
-        memset (device_param->pws_comp, 0, device_param->size_pws_comp);
-        memset (device_param->pws_idx,  0, device_param->size_pws_idx);
+        #ifdef WITH_BRAIN
+        brain_client_swap (device_param);
+        #endif
+
+        if (pws_pending == false)
+        {
+          memset (device_param->pws_comp, 0, device_param->size_pws_comp);
+          memset (device_param->pws_idx,  0, device_param->size_pws_idx);
+        }
 
         u64 pre_rejects = -1;
 
@@ -1179,9 +1387,30 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
           {
             if (user_options->brain_client_features & BRAIN_CLIENT_FEATURE_HASHES)
             {
-              if (brain_client_lookup (device_param, status_ctx) == false)
+              if (pws_pending == true)
               {
-                brain_client_disconnect (device_param);
+                brain_client_lookup_start (device_param, status_ctx);
+
+                if (calc_brain_flush_pending (hashcat_ctx, device_param, words_fin_pending) == -1)
+                {
+                  brain_client_disconnect (device_param);
+
+                  return -1;
+                }
+
+                pws_pending = false;
+
+                if (brain_client_lookup_wait (device_param) == false)
+                {
+                  brain_client_disconnect (device_param);
+                }
+              }
+              else
+              {
+                if (brain_client_lookup (device_param, status_ctx) == false)
+                {
+                  brain_client_disconnect (device_param);
+                }
               }
             }
 
@@ -1244,6 +1473,19 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
         // flush
         //
 
+        #ifdef WITH_BRAIN
+        if ((device_param->brain_link_async == true) && (device_param->pws_cnt > 0) && (device_param->speed_only_finish == false) && (status_ctx->run_thread_level1 == true) && (words_fin > 0))
+        {
+          // goes to the device together with the first lookup of the next batch
+
+          pws_pending = true;
+
+          words_fin_pending = words_fin;
+
+          continue;
+        }
+        #endif
+
         const u64 pws_cnt = device_param->pws_cnt;
 
         if (pws_cnt)
@@ -1284,6 +1526,22 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
         if (words_fin == 0) break;
       }
+
+      #ifdef WITH_BRAIN
+      if (pws_pending == true)
+      {
+        // the loop was left before the next batch, it was looked up on the current link
+
+        brain_client_swap (device_param);
+
+        if (calc_brain_flush_pending (hashcat_ctx, device_param, words_fin_pending) == -1)
+        {
+          brain_client_disconnect (device_param);
+
+          return -1;
+        }
+      }
+      #endif
     }
 
     #ifdef WITH_BRAIN
@@ -1431,7 +1689,7 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
           char rule_buf_out[RP_PASSWORD_SIZE];
 
-          for ( ; words_cur < words_off; words_cur++) get_next_word (hashcat_ctx_tmp, &fp, &line_buf, &line_len);
+          words_cur = skip_words (hashcat_ctx_tmp, &fp, dictfile, words_cur, words_off);
 
           for ( ; words_cur < words_fin; words_cur++)
           {
@@ -0,0 +1,61 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+#include "common.h"
+#include "types.h"
+#include "memory.h"
+#include "ext_lz4.h"
+
+#include "dynloader.h"
+
+int lz4_init (LZ4_PTR *lz4)
+{
+  memset (lz4, 0, sizeof (LZ4_PTR));
+
+  #if   defined (_WIN)
+  lz4->lib = hc_dlopen ("liblz4.dll");
+
+  if (lz4->lib == NULL) lz4->lib = hc_dlopen ("lz4.dll");
+  #elif defined (__APPLE__)
+  lz4->lib = hc_dlopen ("liblz4.dylib");
+
+  if (lz4->lib == NULL) lz4->lib = hc_dlopen ("liblz4.1.dylib");
+  #elif defined (__CYGWIN__)
+  lz4->lib = hc_dlopen ("cyglz4-1.dll");
+  #else
+  lz4->lib = hc_dlopen ("liblz4.so");
+
+  if (lz4->lib == NULL) lz4->lib = hc_dlopen ("liblz4.so.1");
+  #endif
+
+  if (lz4->lib == NULL) return -1;
+
+  lz4->LZ4F_createDecompressionContext = (HC_LZ4F_CREATEDECOMPRESSIONCONTEXT) hc_dlsym (lz4->lib, "LZ4F_createDecompressionContext");
+  lz4->LZ4F_freeDecompressionContext   = (HC_LZ4F_FREEDECOMPRESSIONCONTEXT)   hc_dlsym (lz4->lib, "LZ4F_freeDecompressionContext");
+  lz4->LZ4F_decompress                 = (HC_LZ4F_DECOMPRESS)                 hc_dlsym (lz4->lib, "LZ4F_decompress");
+  lz4->LZ4F_isError                    = (HC_LZ4F_ISERROR)                    hc_dlsym (lz4->lib, "LZ4F_isError");
+
+  if ((lz4->LZ4F_createDecompressionContext == NULL)
+   || (lz4->LZ4F_freeDecompressionContext   == NULL)
+   || (lz4->LZ4F_decompress                 == NULL)
+   || (lz4->LZ4F_isError                    == NULL))
+  {
+    lz4_close (lz4);
+
+    return -1;
+  }
+
+  return 0;
+}
+
+void lz4_close (LZ4_PTR *lz4)
+{
+  if (lz4->lib)
+  {
+    hc_dlclose (lz4->lib);
+  }
+
+  memset (lz4, 0, sizeof (LZ4_PTR));
+}
@@ -0,0 +1,69 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+#include "common.h"
+#include "types.h"
+#include "memory.h"
+#include "ext_zstd.h"
+
+#include "dynloader.h"
+
+int zstd_init (ZSTD_PTR *zstd)
+{
+  memset (zstd, 0, sizeof (ZSTD_PTR));
+
+  #if   defined (_WIN)
+  zstd->lib = hc_dlopen ("libzstd.dll");
+
+  if (zstd->lib == NULL) zstd->lib = hc_dlopen ("zstd.dll");
+  #elif defined (__APPLE__)
+  zstd->lib = hc_dlopen ("libzstd.dylib");
+
+  if (zstd->lib == NULL) zstd->lib = hc_dlopen ("libzstd.1.dylib");
+  #elif defined (__CYGWIN__)
+  zstd->lib = hc_dlopen ("cygzstd-1.dll");
+  #else
+  zstd->lib = hc_dlopen ("libzstd.so");
+
+  if (zstd->lib == NULL) zstd->lib = hc_dlopen ("libzstd.so.1");
+  #endif
+
+  if (zstd->lib == NULL) return -1;
+
+  zstd->ZSTD_createDStream    = (HC_ZSTD_CREATEDSTREAM)    hc_dlsym (zstd->lib, "ZSTD_createDStream");
+  zstd->ZSTD_freeDStream      = (HC_ZSTD_FREEDSTREAM)      hc_dlsym (zstd->lib, "ZSTD_freeDStream");
+  zstd->ZSTD_initDStream      = (HC_ZSTD_INITDSTREAM)      hc_dlsym (zstd->lib, "ZSTD_initDStream");
+  zstd->ZSTD_decompressStream = (HC_ZSTD_DECOMPRESSSTREAM) hc_dlsym (zstd->lib, "ZSTD_decompressStream");
+  zstd->ZSTD_decompress       = (HC_ZSTD_DECOMPRESS)       hc_dlsym (zstd->lib, "ZSTD_decompress");
+  zstd->ZSTD_DStreamInSize    = (HC_ZSTD_DSTREAMINSIZE)    hc_dlsym (zstd->lib, "ZSTD_DStreamInSize");
+  zstd->ZSTD_DStreamOutSize   = (HC_ZSTD_DSTREAMOUTSIZE)   hc_dlsym (zstd->lib, "ZSTD_DStreamOutSize");
+  zstd->ZSTD_isError          = (HC_ZSTD_ISERROR)          hc_dlsym (zstd->lib, "ZSTD_isError");
+
+  if ((zstd->ZSTD_createDStream    == NULL)
+   || (zstd->ZSTD_freeDStream      == NULL)
+   || (zstd->ZSTD_initDStream      == NULL)
+   || (zstd->ZSTD_decompressStream == NULL)
+   || (zstd->ZSTD_decompress       == NULL)
+   || (zstd->ZSTD_DStreamInSize    == NULL)
+   || (zstd->ZSTD_DStreamOutSize   == NULL)
+   || (zstd->ZSTD_isError          == NULL))
+  {
+    zstd_close (zstd);
+
+    return -1;
+  }
+
+  return 0;
+}
+
+void zstd_close (ZSTD_PTR *zstd)
+{
+  if (zstd->lib)
+  {
+    hc_dlclose (zstd->lib);
+  }
+
+  memset (zstd, 0, sizeof (ZSTD_PTR));
+}
@@ -8,6 +8,10 @@
 #include "limits.h"
 #include "memory.h"
 #include "shared.h"
+#include "thread.h"
+#include "dynloader.h"
+#include "ext_lz4.h"
+#include "ext_zstd.h"
 #include "filehandling.h"
 
 #include <Alloc.h>
@@ -16,6 +20,10 @@
 #include <Xz.h>
 #include <XzCrc64.h>
 
+#if defined (_POSIX)
+#include <sys/mman.h>
+#endif
+
 /* Maybe _LZMA_NO_SYSTEM_SIZE_T defined? */
 #if defined (__clang__) || defined (__GNUC__)
 #include <assert.h>
@@ -30,8 +38,18 @@ _Static_assert(sizeof (size_t) == sizeof (SizeT), "Check why sizeof(size_t) != s
 #define HCFILE_CHUNK_SIZE 4 * 1024 * 1024
 #endif
 
+#ifndef HCFILE_UNIT_SIZE_MAX
+#define HCFILE_UNIT_SIZE_MAX (256 * 1024 * 1024)
+#endif
+
 static bool xz_initialized = false;
 
+static int     zstd_initialized = 0; // 0 = not tried, 1 = loaded, -1 = not available
+static ZSTD_PTR zstd_lib;
+
+static int     lz4_initialized  = 0;
+static LZ4_PTR lz4_lib;
+
 static const ISzAlloc xz_alloc = { hc_lzma_alloc, hc_lzma_free };
 
 struct xzfile
@@ -50,6 +68,450 @@ struct xzfile
   CXzs               streams;
 };
 
+// read-ahead ring for compressed streams, the stream is decoded in units which are consumed in order
+// either a single thread reads the next block_size bytes from src, or, if the file consists of independent
+// units (xz blocks, BGZF members, seekable zstd frames), a pool of threads decodes them straight from the file into their ring slots
+// only the producers touch src and the slots they claimed, only the caller touches read_*, everything else is guarded by mux
+
+typedef struct hc_fra_unit
+{
+  u64             in_off;
+  u64             in_len;
+  u64             out_len;
+  CXzStreamFlags  xz_flags;
+
+} hc_fra_unit_t;
+
+struct hc_fra
+{
+  HCFILE             src;
+  char              *path;
+  bool               is_xz;
+  bool               is_zstd;
+  hc_fra_unit_t     *units;
+  u64                units_cnt;
+  u64                units_end;
+  char             **blocks;
+  size_t            *blocks_len;
+  size_t            *blocks_sz;
+  bool              *blocks_ready;
+  u32                blocks_cnt;
+  size_t             block_size;
+  u64                fill_unit;
+  u64                read_unit;
+  u32                read_slot;
+  size_t             read_pos;
+  size_t             read_len;
+  bool               read_hold;
+  bool               error;
+  bool               stop;
+  off_t              start;
+  u64                consumed;
+  hc_thread_t       *threads;
+  int                threads_cnt;
+  hc_thread_mutex_t  mux;
+};
+
+static size_t hc_fread_direct (void *ptr, size_t size, size_t nmemb, HCFILE *fp);
+
+// zstd and lz4 frames, both libraries are loaded on first use
+// frames lists the independent frames of a zstd file in the seekable format, so seeks only decode the frame they land in
+
+typedef struct zframe
+{
+  u64 in_off;
+  u64 in_len;
+  u64 out_off;
+  u64 out_len;
+
+} zframe_t;
+
+struct zfile
+{
+  FILE      *pfp;
+  bool       is_lz4;
+  void      *dctx;
+  u8        *in_buf;
+  size_t     in_sz;
+  size_t     in_len;
+  size_t     in_pos;
+  bool       in_eof;
+  u8        *out_buf;
+  size_t     out_sz;
+  size_t     out_len;
+  size_t     out_pos;
+  u64        out_base;
+  zframe_t  *frames;
+  u64        frames_cnt;
+};
+
+static void hc_zfile_close (zfile_t *zfp);
+
+static bool hc_zfile_reset (zfile_t *zfp)
+{
+  if (zfp->is_lz4 == true)
+  {
+    if (zfp->dctx != NULL) lz4_lib.LZ4F_freeDecompressionContext ((LZ4F_dctx *) zfp->dctx);
+
+    zfp->dctx = NULL;
+
+    LZ4F_dctx *dctx = NULL;
+
+    if (lz4_lib.LZ4F_isError (lz4_lib.LZ4F_createDecompressionContext (&dctx, LZ4F_VERSION))) return false;
+
+    zfp->dctx = dctx;
+  }
+  else
+  {
+    if (zfp->dctx == NULL) zfp->dctx = zstd_lib.ZSTD_createDStream ();
+
+    if (zfp->dctx == NULL) return false;
+
+    if (zstd_lib.ZSTD_isError (zstd_lib.ZSTD_initDStream ((ZSTD_DStream *) zfp->dctx))) return false;
+  }
+
+  zfp->in_len = 0;
+  zfp->in_pos = 0;
+  zfp->in_eof = false;
+
+  zfp->out_len = 0;
+  zfp->out_pos = 0;
+
+  return true;
+}
+
+// decode the next chunk into out_buf, returns the number of bytes available, 0 on end of stream, -1 on error
+
+static int hc_zfile_fill (zfile_t *zfp)
+{
+  zfp->out_base += zfp->out_len;
+
+  zfp->out_len = 0;
+  zfp->out_pos = 0;
+
+  while (zfp->out_len == 0)
+  {
+    if ((zfp->in_pos == zfp->in_len) && (zfp->in_eof == false))
+    {
+      zfp->in_len = fread (zfp->in_buf, 1, zfp->in_sz, zfp->pfp);
+      zfp->in_pos = 0;
+
+      if (zfp->in_len == 0)
+      {
+        if (ferror (zfp->pfp)) return -1;
+
+        zfp->in_eof = true;
+      }
+    }
+
+    // with the input drained the decoder may still hold output, so it's called once more
+
+    if (zfp->is_lz4 == true)
+    {
+      size_t dst_len = zfp->out_sz;
+      size_t src_len = zfp->in_len - zfp->in_pos;
+
+      const size_t rc = lz4_lib.LZ4F_decompress ((LZ4F_dctx *) zfp->dctx, zfp->out_buf, &dst_len, zfp->in_buf + zfp->in_pos, &src_len, NULL);
+
+      if (lz4_lib.LZ4F_isError (rc)) return -1;
+
+      zfp->in_pos  += src_len;
+      zfp->out_len  = dst_len;
+    }
+    else
+    {
+      ZSTD_inBuffer  in  = { zfp->in_buf,  zfp->in_len, zfp->in_pos };
+      ZSTD_outBuffer out = { zfp->out_buf, zfp->out_sz, 0 };
+
+      const size_t rc = zstd_lib.ZSTD_decompressStream ((ZSTD_DStream *) zfp->dctx, &out, &in);
+
+      if (zstd_lib.ZSTD_isError (rc)) return -1;
+
+      zfp->in_pos  = in.pos;
+      zfp->out_len = out.pos;
+    }
+
+    if ((zfp->out_len == 0) && (zfp->in_eof == true) && (zfp->in_pos == zfp->in_len)) return 0;
+  }
+
+  return (int) zfp->out_len;
+}
+
+static size_t hc_zfile_read (zfile_t *zfp, u8 *buf, const size_t len)
+{
+  size_t pos = 0;
+
+  while (pos < len)
+  {
+    if (zfp->out_pos == zfp->out_len)
+    {
+      const int rc = hc_zfile_fill (zfp);
+
+      if (rc == -1) return (size_t) -1;
+
+      if (rc ==  0) break;
+    }
+
+    const size_t chunk = MIN (zfp->out_len - zfp->out_pos, len - pos);
+
+    memcpy (buf + pos, zfp->out_buf + zfp->out_pos, chunk);
+
+    zfp->out_pos += chunk;
+
+    pos += chunk;
+  }
+
+  return pos;
+}
+
+static int hc_zfile_seek (zfile_t *zfp, const u64 offset)
+{
+  const u64 cur = zfp->out_base + zfp->out_pos;
+
+  // restart at the last frame starting at or before the target, unless reading on from here is closer
+
+  u64 in_off  = 0;
+  u64 out_off = 0;
+
+  if (zfp->frames_cnt > 0)
+  {
+    u64 lo = 0;
+    u64 hi = zfp->frames_cnt;
+
+    while (lo < hi)
+    {
+      const u64 mid = lo + ((hi - lo) / 2);
+
+      if (zfp->frames[mid].out_off <= offset)
+      {
+        lo = mid + 1;
+      }
+      else
+      {
+        hi = mid;
+      }
+    }
+
+    if (lo > 0)
+    {
+      in_off  = zfp->frames[lo - 1].in_off;
+      out_off = zfp->frames[lo - 1].out_off;
+    }
+  }
+
+  if ((offset < zfp->out_base) || (cur < out_off))
+  {
+    if (fseeko (zfp->pfp, (off_t) in_off, SEEK_SET) != 0) return -1;
+
+    if (hc_zfile_reset (zfp) == false) return -1;
+
+    zfp->out_base = out_off;
+  }
+  else if (offset < cur)
+  {
+    // still in the current chunk
+
+    zfp->out_pos = (size_t) (offset - zfp->out_base);
+
+    return 0;
+  }
+
+  while ((zfp->out_base + zfp->out_pos) < offset)
+  {
+    if (zfp->out_pos == zfp->out_len)
+    {
+      if (hc_zfile_fill (zfp) <= 0) return -1;
+    }
+
+    const u64 left = offset - (zfp->out_base + zfp->out_pos);
+
+    zfp->out_pos += (size_t) MIN ((u64) (zfp->out_len - zfp->out_pos), left);
+  }
+
+  return 0;
+}
+
+static u64 hc_zfile_size (const zfile_t *zfp)
+{
+  if (zfp->frames_cnt == 0) return 0;
+
+  const zframe_t *last = zfp->frames + zfp->frames_cnt - 1;
+
+  return last->out_off + last->out_len;
+}
+
+static u32 hc_zfile_le32 (const u8 *buf)
+{
+  return ((u32) buf[0]) | ((u32) buf[1] << 8) | ((u32) buf[2] << 16) | ((u32) buf[3] << 24);
+}
+
+static void hc_zfile_seek_table (zfile_t *zfp, const u64 file_size)
+{
+  u8 footer[ZSTD_SEEKABLE_FOOTER_SIZE];
+
+  if (file_size < (8 + ZSTD_SEEKABLE_FOOTER_SIZE)) return;
+
+  if (fseeko (zfp->pfp, (off_t) (file_size - ZSTD_SEEKABLE_FOOTER_SIZE), SEEK_SET) != 0) return;
+
+  if (fread (footer, 1, sizeof (footer), zfp->pfp) != sizeof (footer)) return;
+
+  if (hc_zfile_le32 (footer + 5) != ZSTD_SEEKABLE_MAGICNUMBER) return;
+
+  const u64 frames_cnt = hc_zfile_le32 (footer);
+  const u8  descriptor = footer[4];
+
+  if (descriptor & 0x7c) return;
+
+  const u64 entry_size = (descriptor & 0x80) ? 12 : 8;
+  const u64 table_size = (frames_cnt * entry_size) + ZSTD_SEEKABLE_FOOTER_SIZE;
+
+  if ((table_size + 8) > file_size) return;
+
+  const u64 table_off = file_size - (table_size + 8);
+
+  u8 *table = (u8 *) hcmalloc (table_size + 8);
+
+  if ((fseeko (zfp->pfp, (off_t) table_off, SEEK_SET) == 0) && (fread (table, 1, table_size + 8, zfp->pfp) == (table_size + 8)))
+  {
+    if ((hc_zfile_le32 (table) == ZSTD_SEEKABLE_SKIPPABLE) && (hc_zfile_le32 (table + 4) == table_size))
+    {
+      zframe_t *frames = (zframe_t *) hccalloc (frames_cnt + 1, sizeof (zframe_t));
+
+      u64 in_off  = 0;
+      u64 out_off = 0;
+
+      for (u64 i = 0; i < frames_cnt; i++)
+      {
+        const u8 *entry = table + 8 + (i * entry_size);
+
+        frames[i].in_off  = in_off;
+        frames[i].in_len  = hc_zfile_le32 (entry + 0);
+        frames[i].out_off = out_off;
+        frames[i].out_len = hc_zfile_le32 (entry + 4);
+
+        in_off  += frames[i].in_len;
+        out_off += frames[i].out_len;
+      }
+
+      // the frames have to add up to the seek table, or it doesn't belong to this file
+
+      if ((frames_cnt > 0) && (in_off == table_off))
+      {
+        zfp->frames     = frames;
+        zfp->frames_cnt = frames_cnt;
+      }
+      else
+      {
+        hcfree (frames);
+      }
+    }
+  }
+
+  hcfree (table);
+}
+
+static bool hc_zfile_open (HCFILE *fp, const bool is_lz4)
+{
+  /* same as the xz tables, the first open is expected to come from the main thread */
+  if (is_lz4 == true)
+  {
+    if (lz4_initialized == 0) lz4_initialized = (lz4_init (&lz4_lib) == 0) ? 1 : -1;
+
+    if (lz4_initialized == -1)
+    {
+      close (fp->fd);
+
+      fp->fd = -1;
+
+      errno = ENOTSUP;
+
+      return false;
+    }
+  }
+  else
+  {
+    if (zstd_initialized == 0) zstd_initialized = (zstd_init (&zstd_lib) == 0) ? 1 : -1;
+
+    if (zstd_initialized == -1)
+    {
+      close (fp->fd);
+
+      fp->fd = -1;
+
+      errno = ENOTSUP;
+
+      return false;
+    }
+  }
+
+  struct stat st;
+
+  if (fstat (fp->fd, &st) == -1)
+  {
+    close (fp->fd);
+
+    fp->fd = -1;
+
+    return false;
+  }
+
+  zfile_t *zfp = (zfile_t *) hccalloc (1, sizeof (zfile_t));
+
+  if ((zfp->pfp = fdopen (fp->fd, "rb")) == NULL)
+  {
+    hcfree (zfp);
+
+    close (fp->fd);
+
+    fp->fd = -1;
+
+    return false;
+  }
+
+  zfp->is_lz4  = is_lz4;
+  zfp->in_sz   = (is_lz4 == true) ? HCFILE_BUFFER_SIZE : zstd_lib.ZSTD_DStreamInSize ();
+  zfp->out_sz  = (is_lz4 == true) ? HCFILE_BUFFER_SIZE : zstd_lib.ZSTD_DStreamOutSize ();
+  zfp->in_buf  = (u8 *) hcmalloc (zfp->in_sz);
+  zfp->out_buf = (u8 *) hcmalloc (zfp->out_sz);
+
+  if ((is_lz4 == false) && (S_ISREG (st.st_mode))) hc_zfile_seek_table (zfp, (u64) st.st_size);
+
+  if ((fseeko (zfp->pfp, 0, SEEK_SET) != 0) || (hc_zfile_reset (zfp) == false))
+  {
+    hc_zfile_close (zfp);
+
+    fp->fd = -1;
+
+    return false;
+  }
+
+  fp->zfp = zfp;
+
+  return true;
+}
+
+static void hc_zfile_close (zfile_t *zfp)
+{
+  if (zfp->dctx != NULL)
+  {
+    if (zfp->is_lz4 == true)
+    {
+      lz4_lib.LZ4F_freeDecompressionContext ((LZ4F_dctx *) zfp->dctx);
+    }
+    else
+    {
+      zstd_lib.ZSTD_freeDStream ((ZSTD_DStream *) zfp->dctx);
+    }
+  }
+
+  fclose (zfp->pfp);
+
+  hcfree (zfp->frames);
+  hcfree (zfp->in_buf);
+  hcfree (zfp->out_buf);
+  hcfree (zfp);
+}
+
 #if defined (__CYGWIN__)
 // workaround for zlib with cygwin build
 int _wopen (const char *path, int oflag, ...)
@@ -72,6 +534,12 @@ bool hc_fopen (HCFILE *fp, const char *path, const char *mode)
   fp->gfp      = NULL;
   fp->ufp      = NULL;
   fp->xfp      = NULL;
+  fp->zfp      = NULL;
+  fp->rfp      = NULL;
+  fp->mfp      = NULL;
+  fp->mfp_len  = 0;
+  fp->mfp_pos  = 0;
+  fp->mfp_rel  = 0;
   fp->bom_size = 0;
   fp->path     = NULL;
   fp->mode     = NULL;
@@ -118,6 +586,8 @@ bool hc_fopen (HCFILE *fp, const char *path, const char *mode)
   bool is_gzip = false;
   bool is_zip  = false;
   bool is_xz   = false;
+  bool is_zstd = false;
+  bool is_lz4  = false;
   bool is_fifo = hc_path_is_fifo (path);
 
   if (is_fifo == false)
@@ -133,10 +603,12 @@ bool hc_fopen (HCFILE *fp, const char *path, const char *mode)
         if (check[0] == 0x1f && check[1] == 0x8b && check[2] == 0x08)                     is_gzip = true;
         if (check[0] == 0x50 && check[1] == 0x4b && check[2] == 0x03 && check[3] == 0x04) is_zip  = true;
         if (memcmp (check, XZ_SIG, XZ_SIG_SIZE) == 0)                                     is_xz   = true;
+        if (check[0] == 0x28 && check[1] == 0xb5 && check[2] == 0x2f && check[3] == 0xfd) is_zstd = true;
+        if (check[0] == 0x04 && check[1] == 0x22 && check[2] == 0x4d && check[3] == 0x18) is_lz4  = true;
 
         // compressed files with BOM will be undetected!
 
-        if (is_gzip == false && is_zip == false && is_xz == false)
+        if (is_gzip == false && is_zip == false && is_xz == false && is_zstd == false && is_lz4 == false)
         {
           fp->bom_size = hc_string_bom_size (check);
         }
@@ -157,6 +629,19 @@ bool hc_fopen (HCFILE *fp, const char *path, const char *mode)
 
   if (fp->fd == -1) return false;
 
+  if ((is_zstd || is_lz4) && (strncmp (mode, "r", 1) != 0))
+  {
+    // there's no encoder, appending plain text would corrupt the file
+
+    close (fp->fd);
+
+    fp->fd = -1;
+
+    errno = ENOTSUP;
+
+    return false;
+  }
+
   if (is_gzip)
   {
     if ((fp->gfp = gzdopen (fp->fd, mode)) == NULL) return false;
@@ -273,6 +758,10 @@ bool hc_fopen (HCFILE *fp, const char *path, const char *mode)
     xfp->inProcessed = inLen;
     fp->xfp = xfp;
   }
+  else if (is_zstd || is_lz4)
+  {
+    if (hc_zfile_open (fp, is_lz4) == false) return false;
+  }
   else
   {
     if ((fp->pfp = fdopen (fp->fd, mode)) == NULL) return false;
@@ -303,6 +792,12 @@ bool hc_fopen_raw (HCFILE *fp, const char *path, const char *mode)
   fp->gfp      = NULL;
   fp->ufp      = NULL;
   fp->xfp      = NULL;
+  fp->zfp      = NULL;
+  fp->rfp      = NULL;
+  fp->mfp      = NULL;
+  fp->mfp_len  = 0;
+  fp->mfp_pos  = 0;
+  fp->mfp_rel  = 0;
   fp->bom_size = 0;
   fp->path     = NULL;
   fp->mode     = NULL;
@@ -361,34 +856,666 @@ bool hc_fopen_raw (HCFILE *fp, const char *path, const char *mode)
   return true;
 }
 
-size_t hc_fread (void *ptr, size_t size, size_t nmemb, HCFILE *fp)
+static HC_API_CALL void *hc_fread_ahead_thread (void *p)
 {
-  size_t n = (size_t) -1;
+  hc_fra_t *rfp = (hc_fra_t *) p;
 
-  if (ptr == NULL || fp == NULL) return n;
+  while (true)
+  {
+    hc_thread_mutex_lock (rfp->mux);
 
-  if (size == 0 || nmemb == 0) return 0;
+    const bool stop      = rfp->stop;
+    const u64  read_unit = rfp->read_unit;
 
-  if (fp->pfp)
-  {
-    #ifdef _WIN
-    u64 len = (u64) size * nmemb;
+    hc_thread_mutex_unlock (rfp->mux);
 
-    #ifndef _WIN64
-    /* check 2 GB limit with 32 bit build */
-    if (len >= INT32_MAX) return n;
-    #endif
+    if (stop == true) break;
 
-    if (len <= HCFILE_CHUNK_SIZE)
+    if (rfp->fill_unit == (read_unit + rfp->blocks_cnt))
     {
-      n = fread (ptr, size, nmemb, fp->pfp);
+      usleep (100);
+
+      continue;
     }
-    else
-    {
-      size_t left = (size_t) len;
-      size_t pos = 0;
 
-      /* assume success */
+    const u32 slot = (u32) (rfp->fill_unit % rfp->blocks_cnt);
+
+    const size_t len = hc_fread_direct (rfp->blocks[slot], 1, rfp->block_size, &rfp->src);
+
+    if (len == (size_t) -1)
+    {
+      hc_thread_mutex_lock (rfp->mux);
+
+      rfp->error = true;
+
+      hc_thread_mutex_unlock (rfp->mux);
+
+      break;
+    }
+
+    if (len == 0) break;
+
+    rfp->blocks_len[slot] = len;
+
+    hc_thread_mutex_lock (rfp->mux);
+
+    rfp->blocks_ready[slot] = true;
+
+    rfp->fill_unit++;
+
+    hc_thread_mutex_unlock (rfp->mux);
+
+    // all decompressors only return short reads at the end of the stream
+
+    if (len < rfp->block_size) break;
+  }
+
+  hc_thread_mutex_lock (rfp->mux);
+
+  rfp->units_end = rfp->fill_unit;
+
+  hc_thread_mutex_unlock (rfp->mux);
+
+  return NULL;
+}
+
+static bool hc_fread_ahead_unit_xz (const hc_fra_unit_t *unit, const Byte *in_buf, Byte *out_buf)
+{
+  CAlignOffsetAlloc alloc;
+
+  AlignOffsetAlloc_CreateVTable (&alloc);
+
+  alloc.numAlignBits = 7;
+  alloc.baseAlloc    = &xz_alloc;
+
+  CXzUnpacker state;
+
+  XzUnpacker_Construct (&state, &alloc.vt);
+  XzUnpacker_Init (&state);
+
+  state.streamFlags = unit->xz_flags;
+
+  XzUnpacker_PrepareToRandomBlockDecoding (&state);
+
+  SizeT in_len  = (SizeT) unit->in_len;
+  SizeT out_len = (SizeT) unit->out_len;
+
+  ECoderStatus status;
+
+  const SRes res = XzUnpacker_Code (&state, out_buf, &out_len, in_buf, &in_len, true, CODER_FINISH_END, &status);
+
+  const bool ok = (res == SZ_OK) && (out_len == (SizeT) unit->out_len) && (XzUnpacker_IsBlockFinished (&state) != 0);
+
+  XzUnpacker_Free (&state);
+
+  return ok;
+}
+
+static bool hc_fread_ahead_unit_gz (const hc_fra_unit_t *unit, Bytef *in_buf, Bytef *out_buf)
+{
+  z_stream zs;
+
+  memset (&zs, 0, sizeof (zs));
+
+  if (inflateInit2 (&zs, 16 + MAX_WBITS) != Z_OK) return false;
+
+  // one spare byte in the output, so a member larger than its ISIZE is noticed
+
+  zs.next_in   = in_buf;
+  zs.avail_in  = (uInt) unit->in_len;
+  zs.next_out  = out_buf;
+  zs.avail_out = (uInt) unit->out_len + 1;
+
+  int rc = Z_OK;
+
+  while (zs.avail_in > 0)
+  {
+    rc = inflate (&zs, Z_NO_FLUSH);
+
+    if (rc != Z_STREAM_END) break;
+
+    // a unit holds several complete members
+
+    if (inflateReset (&zs) != Z_OK) break;
+  }
+
+  inflateEnd (&zs);
+
+  return (rc == Z_STREAM_END) && ((u64) (zs.next_out - out_buf) == unit->out_len);
+}
+
+static HC_API_CALL void *hc_fread_ahead_thread_units (void *p)
+{
+  hc_fra_t *rfp = (hc_fra_t *) p;
+
+  FILE *pfp = fopen (rfp->path, "rb");
+
+  if (pfp == NULL)
+  {
+    hc_thread_mutex_lock (rfp->mux);
+
+    rfp->error = true;
+
+    hc_thread_mutex_unlock (rfp->mux);
+
+    return NULL;
+  }
+
+  u8    *in_buf = NULL;
+  size_t in_sz  = 0;
+
+  while (true)
+  {
+    hc_thread_mutex_lock (rfp->mux);
+
+    const bool stop  = (rfp->stop == true) || (rfp->error == true);
+    const u64  unit  = rfp->fill_unit;
+    const bool claim = (stop == false) && (unit < rfp->units_cnt) && (unit < (rfp->read_unit + rfp->blocks_cnt));
+
+    if (claim == true) rfp->fill_unit++;
+
+    hc_thread_mutex_unlock (rfp->mux);
+
+    if (stop == true) break;
+
+    if (unit >= rfp->units_cnt) break;
+
+    if (claim == false)
+    {
+      usleep (100);
+
+      continue;
+    }
+
+    const hc_fra_unit_t *u = rfp->units + unit;
+
+    const u32 slot = (u32) (unit % rfp->blocks_cnt);
+
+    if (rfp->blocks_sz[slot] < (u->out_len + 1))
+    {
+      hcfree (rfp->blocks[slot]);
+
+      rfp->blocks_sz[slot] = (size_t) u->out_len + 1;
+      rfp->blocks[slot]    = (char *) hcmalloc (rfp->blocks_sz[slot]);
+    }
+
+    if (in_sz < u->in_len)
+    {
+      hcfree (in_buf);
+
+      in_sz  = (size_t) u->in_len;
+      in_buf = (u8 *) hcmalloc (in_sz);
+    }
+
+    bool ok = (fseeko (pfp, (off_t) u->in_off, SEEK_SET) == 0) && (fread (in_buf, 1, (size_t) u->in_len, pfp) == (size_t) u->in_len);
+
+    if (ok == true)
+    {
+      if (rfp->is_xz == true)
+      {
+        ok = hc_fread_ahead_unit_xz (u, (const Byte *) in_buf, (Byte *) rfp->blocks[slot]);
+      }
+      else if (rfp->is_zstd == true)
+      {
+        // a unit is a run of complete frames, the one-shot decoder handles them back to back
+
+        const size_t rc = zstd_lib.ZSTD_decompress (rfp->blocks[slot], rfp->blocks_sz[slot], in_buf, (size_t) u->in_len);
+
+        ok = (zstd_lib.ZSTD_isError (rc) == 0) && (rc == u->out_len);
+      }
+      else
+      {
+        ok = hc_fread_ahead_unit_gz (u, (Bytef *) in_buf, (Bytef *) rfp->blocks[slot]);
+      }
+    }
+
+    hc_thread_mutex_lock (rfp->mux);
+
+    if (ok == true)
+    {
+      rfp->blocks_len[slot]   = (size_t) u->out_len;
+      rfp->blocks_ready[slot] = true;
+    }
+    else
+    {
+      rfp->error = true;
+    }
+
+    hc_thread_mutex_unlock (rfp->mux);
+  }
+
+  hcfree (in_buf);
+
+  fclose (pfp);
+
+  return NULL;
+}
+
+// xz files written by multi-threaded encoders consist of independent blocks, their offsets and sizes are in the index we read on open
+
+static void hc_fread_ahead_units_xz (hc_fra_t *rfp, const xzfile_t *xfp)
+{
+  const CXzs *streams = &xfp->streams;
+
+  const u64 units_cnt = Xzs_GetNumBlocks (streams);
+
+  if (units_cnt < 2) return;
+
+  hc_fra_unit_t *units = (hc_fra_unit_t *) hccalloc (units_cnt, sizeof (hc_fra_unit_t));
+
+  u64 unit = 0;
+
+  // Xzs_ReadBackward () stores the last stream first
+
+  for (size_t i = streams->num; i > 0; i--)
+  {
+    const CXzStream *stream = streams->streams + i - 1;
+
+    u64 in_off = stream->startOffset + XZ_STREAM_HEADER_SIZE;
+
+    for (size_t j = 0; j < stream->numBlocks; j++)
+    {
+      const CXzBlockSizes *block = stream->blocks + j;
+
+      const u64 in_len = (block->totalSize + 3) & ~(u64) 3;
+
+      if ((block->unpackSize > HCFILE_UNIT_SIZE_MAX) || (in_len > HCFILE_UNIT_SIZE_MAX))
+      {
+        hcfree (units);
+
+        return;
+      }
+
+      units[unit].in_off   = in_off;
+      units[unit].in_len   = in_len;
+      units[unit].out_len  = block->unpackSize;
+      units[unit].xz_flags = stream->flags;
+
+      in_off += in_len;
+
+      unit++;
+    }
+  }
+
+  rfp->units     = units;
+  rfp->units_cnt = units_cnt;
+  rfp->is_xz     = true;
+}
+
+// BGZF (bgzip) files are a series of small gzip members which record their compressed size in an extra field
+// and their uncompressed size in the trailer, so they can be split without inflating anything
+
+static void hc_fread_ahead_units_gz (hc_fra_t *rfp, const size_t block_size)
+{
+  FILE *pfp = fopen (rfp->path, "rb");
+
+  if (pfp == NULL) return;
+
+  hc_fra_unit_t *units     = NULL;
+  u64            units_cnt = 0;
+
+  u64 in_off = 0;
+
+  bool ok = true;
+
+  while (true)
+  {
+    u8 hdr[18];
+
+    if (fseeko (pfp, (off_t) in_off, SEEK_SET) != 0) { ok = false; break; }
+
+    const size_t hdr_len = fread (hdr, 1, sizeof (hdr), pfp);
+
+    if (hdr_len == 0) break;
+
+    if (hdr_len != sizeof (hdr)) { ok = false; break; }
+
+    if ((hdr[0] != 0x1f) || (hdr[1] != 0x8b) || (hdr[2] != 0x08) || ((hdr[3] & 0x04) == 0)) { ok = false; break; }
+
+    if ((hdr[10] != 6) || (hdr[11] != 0) || (hdr[12] != 'B') || (hdr[13] != 'C') || (hdr[14] != 2) || (hdr[15] != 0)) { ok = false; break; }
+
+    const u64 in_len = (u64) (hdr[16] | (hdr[17] << 8)) + 1;
+
+    u8 isize[4];
+
+    if (fseeko (pfp, (off_t) (in_off + in_len - 4), SEEK_SET) != 0) { ok = false; break; }
+
+    if (fread (isize, 1, sizeof (isize), pfp) != sizeof (isize)) { ok = false; break; }
+
+    const u64 out_len = (u64) isize[0] | ((u64) isize[1] << 8) | ((u64) isize[2] << 16) | ((u64) isize[3] << 24);
+
+    // members are grouped until a unit reaches the block size
+
+    hc_fra_unit_t *last = (units_cnt > 0) ? units + units_cnt - 1 : NULL;
+
+    if ((last != NULL) && ((last->out_len + out_len) <= block_size))
+    {
+      last->in_len  += in_len;
+      last->out_len += out_len;
+    }
+    else
+    {
+      units = (hc_fra_unit_t *) hcrealloc (units, units_cnt * sizeof (hc_fra_unit_t), sizeof (hc_fra_unit_t));
+
+      units[units_cnt].in_off  = in_off;
+      units[units_cnt].in_len  = in_len;
+      units[units_cnt].out_len = out_len;
+
+      units_cnt++;
+    }
+
+    in_off += in_len;
+  }
+
+  fclose (pfp);
+
+  if ((ok == false) || (units_cnt < 2))
+  {
+    hcfree (units);
+
+    return;
+  }
+
+  rfp->units     = units;
+  rfp->units_cnt = units_cnt;
+}
+
+// seekable zstd files are a series of independent frames listed in the seek table we read on open,
+// small frames are grouped into units of up to the block size
+
+static void hc_fread_ahead_units_zstd (hc_fra_t *rfp, const zfile_t *zfp, const size_t block_size)
+{
+  if (zfp->is_lz4 == true) return;
+
+  if (zfp->frames_cnt < 2) return;
+
+  hc_fra_unit_t *units     = NULL;
+  u64            units_cnt = 0;
+
+  for (u64 i = 0; i < zfp->frames_cnt; i++)
+  {
+    const zframe_t *frame = zfp->frames + i;
+
+    // frames are grouped until a unit reaches the block size
+
+    hc_fra_unit_t *last = (units_cnt > 0) ? units + units_cnt - 1 : NULL;
+
+    if ((last != NULL) && ((last->out_len + frame->out_len) <= block_size))
+    {
+      last->in_len  += frame->in_len;
+      last->out_len += frame->out_len;
+    }
+    else
+    {
+      if (frame->out_len > HCFILE_UNIT_SIZE_MAX)
+      {
+        hcfree (units);
+
+        return;
+      }
+
+      units = (hc_fra_unit_t *) hcrealloc (units, units_cnt * sizeof (hc_fra_unit_t), sizeof (hc_fra_unit_t));
+
+      units[units_cnt].in_off  = frame->in_off;
+      units[units_cnt].in_len  = frame->in_len;
+      units[units_cnt].out_len = frame->out_len;
+
+      units_cnt++;
+    }
+  }
+
+  if (units_cnt < 2)
+  {
+    hcfree (units);
+
+    return;
+  }
+
+  rfp->units     = units;
+  rfp->units_cnt = units_cnt;
+  rfp->is_zstd   = true;
+}
+
+// make sure the current block has unread bytes, false on end of stream or error
+
+static bool hc_fread_ahead_wait (hc_fra_t *rfp)
+{
+  while (rfp->read_pos == rfp->read_len)
+  {
+    hc_thread_mutex_lock (rfp->mux);
+
+    if (rfp->read_hold == true)
+    {
+      rfp->blocks_ready[rfp->read_slot] = false;
+
+      rfp->read_unit++;
+
+      rfp->read_hold = false;
+    }
+
+    const u32  slot  = (u32) (rfp->read_unit % rfp->blocks_cnt);
+    const bool ready = rfp->blocks_ready[slot];
+    const bool end   = (rfp->read_unit >= rfp->units_end) || (rfp->error == true);
+
+    hc_thread_mutex_unlock (rfp->mux);
+
+    if (ready == true)
+    {
+      rfp->read_slot = slot;
+      rfp->read_pos  = 0;
+      rfp->read_len  = rfp->blocks_len[slot];
+      rfp->read_hold = true;
+
+      continue;
+    }
+
+    if (end == true) return false;
+
+    usleep (100);
+  }
+
+  return true;
+}
+
+static void hc_fread_ahead_stop (HCFILE *fp)
+{
+  hc_fra_t *rfp = fp->rfp;
+
+  if (rfp == NULL) return;
+
+  hc_thread_mutex_lock (rfp->mux);
+
+  rfp->stop = true;
+
+  hc_thread_mutex_unlock (rfp->mux);
+
+  hc_thread_wait (rfp->threads_cnt, rfp->threads);
+
+  hc_thread_mutex_delete (rfp->mux);
+
+  for (u32 i = 0; i < rfp->blocks_cnt; i++) hcfree (rfp->blocks[i]);
+
+  hcfree (rfp->blocks);
+  hcfree (rfp->blocks_len);
+  hcfree (rfp->blocks_sz);
+  hcfree (rfp->blocks_ready);
+  hcfree (rfp->units);
+  hcfree (rfp->threads);
+  hcfree (rfp->path);
+  hcfree (rfp);
+
+  fp->rfp = NULL;
+}
+
+bool hc_fread_ahead (HCFILE *fp, const u32 blocks_cnt, const size_t block_size)
+{
+  if (fp == NULL) return false;
+
+  if (fp->rfp) return true;
+
+  if (blocks_cnt == 0 || block_size == 0) return false;
+
+  if (fp->mode == NULL || fp->mode[0] != 'r') return false;
+
+  // plain files are either mapped or served from the stdio buffer, there is nothing to overlap
+
+  if (fp->gfp == NULL && fp->ufp == NULL && fp->xfp == NULL && fp->zfp == NULL) return false;
+
+  const off_t start = hc_ftell (fp);
+
+  if (start < 0) return false;
+
+  hc_fra_t *rfp = (hc_fra_t *) hccalloc (1, sizeof (hc_fra_t));
+
+  memcpy (&rfp->src, fp, sizeof (HCFILE));
+
+  rfp->blocks       = (char **)  hccalloc (blocks_cnt, sizeof (char *));
+  rfp->blocks_len   = (size_t *) hccalloc (blocks_cnt, sizeof (size_t));
+  rfp->blocks_sz    = (size_t *) hccalloc (blocks_cnt, sizeof (size_t));
+  rfp->blocks_ready = (bool *)   hccalloc (blocks_cnt, sizeof (bool));
+  rfp->blocks_cnt   = blocks_cnt;
+  rfp->block_size   = block_size;
+  rfp->units_end    = (u64) -1;
+  rfp->start        = start;
+
+  // independent units can only be used when reading from the start, after a seek we fall back to a single thread
+
+  const int processor_count = hc_get_processor_count ();
+
+  if ((start == 0) && (processor_count > 1) && (blocks_cnt > 1) && (fp->path != NULL))
+  {
+    rfp->path = hcstrdup (fp->path);
+
+    if (fp->xfp) hc_fread_ahead_units_xz (rfp, fp->xfp);
+    if (fp->gfp) hc_fread_ahead_units_gz (rfp, block_size);
+    if (fp->zfp) hc_fread_ahead_units_zstd (rfp, fp->zfp, block_size);
+  }
+
+  hc_thread_mutex_init (rfp->mux);
+
+  fp->rfp = rfp;
+
+  if (rfp->units != NULL)
+  {
+    rfp->units_end   = rfp->units_cnt;
+    rfp->threads_cnt = (int) MIN ((u64) MIN ((u32) processor_count, blocks_cnt), rfp->units_cnt);
+    rfp->threads     = (hc_thread_t *) hccalloc (rfp->threads_cnt, sizeof (hc_thread_t));
+
+    for (int i = 0; i < rfp->threads_cnt; i++)
+    {
+      hc_thread_create (rfp->threads[i], hc_fread_ahead_thread_units, rfp);
+    }
+  }
+  else
+  {
+    for (u32 i = 0; i < blocks_cnt; i++)
+    {
+      rfp->blocks[i]    = (char *) hcmalloc (block_size);
+      rfp->blocks_sz[i] = block_size;
+    }
+
+    rfp->threads_cnt = 1;
+    rfp->threads     = (hc_thread_t *) hccalloc (1, sizeof (hc_thread_t));
+
+    hc_thread_create (rfp->threads[0], hc_fread_ahead_thread, rfp);
+  }
+
+  return true;
+}
+
+static size_t hc_fread_ahead_read (void *ptr, size_t size, size_t nmemb, HCFILE *fp)
+{
+  hc_fra_t *rfp = fp->rfp;
+
+  const size_t len = size * nmemb;
+
+  size_t pos = 0;
+
+  while (pos < len)
+  {
+    if (hc_fread_ahead_wait (rfp) == false) break;
+
+    const size_t left  = rfp->read_len - rfp->read_pos;
+    const size_t chunk = MIN (left, len - pos);
+
+    memcpy ((char *) ptr + pos, rfp->blocks[rfp->read_slot] + rfp->read_pos, chunk);
+
+    rfp->read_pos += chunk;
+
+    pos += chunk;
+  }
+
+  if (pos == 0)
+  {
+    hc_thread_mutex_lock (rfp->mux);
+
+    const bool error = rfp->error;
+
+    hc_thread_mutex_unlock (rfp->mux);
+
+    if (error == true) return (size_t) -1;
+  }
+
+  rfp->consumed += pos;
+
+  if (fp->gfp) fp->uncompressed_size += pos;
+
+  return pos / size;
+}
+
+size_t hc_fread (void *ptr, size_t size, size_t nmemb, HCFILE *fp)
+{
+  if (ptr == NULL || fp == NULL) return (size_t) -1;
+
+  if (size == 0 || nmemb == 0) return 0;
+
+  if (fp->rfp) return hc_fread_ahead_read (ptr, size, nmemb, fp);
+
+  return hc_fread_direct (ptr, size, nmemb, fp);
+}
+
+static size_t hc_fread_direct (void *ptr, size_t size, size_t nmemb, HCFILE *fp)
+{
+  size_t n = (size_t) -1;
+
+  if (ptr == NULL || fp == NULL) return n;
+
+  if (size == 0 || nmemb == 0) return 0;
+
+  if (fp->mfp)
+  {
+    const u64 left = fp->mfp_len - fp->mfp_pos;
+
+    u64 len = (u64) size * nmemb;
+
+    if (len > left) len = left - (left % size);
+
+    memcpy (ptr, fp->mfp + fp->mfp_pos, (size_t) len);
+
+    fp->mfp_pos += len;
+
+    n = (size_t) (len / size);
+  }
+  else if (fp->pfp)
+  {
+    #ifdef _WIN
+    u64 len = (u64) size * nmemb;
+
+    #ifndef _WIN64
+    /* check 2 GB limit with 32 bit build */
+    if (len >= INT32_MAX) return n;
+    #endif
+
+    if (len <= HCFILE_CHUNK_SIZE)
+    {
+      n = fread (ptr, size, nmemb, fp->pfp);
+    }
+    else
+    {
+      size_t left = (size_t) len;
+      size_t pos = 0;
+
+      /* assume success */
       n = nmemb;
 
       do
@@ -499,6 +1626,14 @@ size_t hc_fread (void *ptr, size_t size, size_t nmemb, HCFILE *fp)
       xfp->outProcessed += outLeft;
     } while (outPos < outLen);
   }
+  else if (fp->zfp)
+  {
+    const size_t len = hc_zfile_read (fp->zfp, (u8 *) ptr, size * nmemb);
+
+    if (len == (size_t) -1) return n;
+
+    n = len / size;
+  }
 
   return n;
 }
@@ -561,9 +1696,50 @@ int hc_fseek (HCFILE *fp, off_t offset, int whence)
 {
   int r = -1;
 
-  if (fp == NULL) return r;
+  if (fp == NULL) return r;
+
+  if (fp->rfp)
+  {
+    // the thread is ahead of the caller, so seek from the logical position and start over behind the target
+
+    const u32    blocks_cnt = fp->rfp->blocks_cnt;
+    const size_t block_size = fp->rfp->block_size;
+
+    if (whence == SEEK_END) return r;
+
+    if (whence == SEEK_CUR) offset += hc_ftell (fp);
+
+    if (fp->ufp) return r;
+
+    if (fp->xfp && offset != 0) return r;
+
+    hc_fread_ahead_stop (fp);
+
+    r = hc_fseek (fp, offset, SEEK_SET);
+
+    hc_fread_ahead (fp, blocks_cnt, block_size);
+
+    return r;
+  }
+
+  if (fp->mfp)
+  {
+    off_t base = 0;
+
+    if (whence == SEEK_CUR) base = (off_t) fp->mfp_pos;
+    if (whence == SEEK_END) base = (off_t) fp->mfp_len;
+
+    const off_t pos = base + offset;
+
+    if (pos >= 0 && (u64) pos <= fp->mfp_len)
+    {
+      fp->mfp_pos = (u64) pos;
+      fp->mfp_rel = 0;
 
-  if (fp->pfp)
+      r = 0;
+    }
+  }
+  else if (fp->pfp)
   {
     r = fseeko (fp->pfp, offset, whence);
   }
@@ -607,15 +1783,68 @@ int hc_fseek (HCFILE *fp, off_t offset, int whence)
       r = -1;
     }
   }
+  else if (fp->zfp)
+  {
+    zfile_t *zfp = fp->zfp;
+
+    off_t base = 0;
+
+    if (whence == SEEK_CUR) base = (off_t) (zfp->out_base + zfp->out_pos);
+
+    if (whence == SEEK_END)
+    {
+      /* the uncompressed size is only known from a seek table */
+      if (zfp->frames_cnt == 0) return r;
+
+      base = (off_t) hc_zfile_size (zfp);
+    }
+
+    const off_t pos = base + offset;
+
+    if (pos >= 0) r = hc_zfile_seek (zfp, (u64) pos);
+  }
 
   return r;
 }
 
+bool hc_fseekable (const HCFILE *fp)
+{
+  // compressed streams can only seek by decompressing up to the target, except for zstd files with a seek table
+
+  if (fp == NULL) return false;
+
+  if (fp->mfp != NULL) return true;
+  if (fp->pfp != NULL) return true;
+
+  if ((fp->zfp != NULL) && (fp->zfp->frames_cnt > 1)) return true;
+
+  return false;
+}
+
 void hc_rewind (HCFILE *fp)
 {
   if (fp == NULL) return;
 
-  if (fp->pfp)
+  if (fp->rfp)
+  {
+    const u32    blocks_cnt = fp->rfp->blocks_cnt;
+    const size_t block_size = fp->rfp->block_size;
+
+    hc_fread_ahead_stop (fp);
+
+    hc_rewind (fp);
+
+    hc_fread_ahead (fp, blocks_cnt, block_size);
+
+    return;
+  }
+
+  if (fp->mfp)
+  {
+    fp->mfp_pos = 0;
+    fp->mfp_rel = 0;
+  }
+  else if (fp->pfp)
   {
     rewind (fp->pfp);
   }
@@ -660,6 +1889,10 @@ void hc_rewind (HCFILE *fp)
     xfp->inPos = inLen;
     xfp->inProcessed = inLen;
   }
+  else if (fp->zfp)
+  {
+    hc_zfile_seek (fp->zfp, 0);
+  }
 }
 
 int hc_fstat (HCFILE *fp, struct stat *buf)
@@ -697,6 +1930,15 @@ int hc_fstat (HCFILE *fp, struct stat *buf)
       buf->st_size = (off_t) xfp->outSize;
     }
   }
+  else if (fp->zfp)
+  {
+    const zfile_t *zfp = fp->zfp;
+
+    if (zfp->frames_cnt > 0)
+    {
+      buf->st_size = (off_t) hc_zfile_size (zfp);
+    }
+  }
 
   return r;
 }
@@ -707,7 +1949,15 @@ off_t hc_ftell (HCFILE *fp)
 
   if (fp == NULL) return -1;
 
-  if (fp->pfp)
+  if (fp->rfp)
+  {
+    n = fp->rfp->start + (off_t) fp->rfp->consumed;
+  }
+  else if (fp->mfp)
+  {
+    n = (off_t) fp->mfp_pos;
+  }
+  else if (fp->pfp)
   {
     n = ftello (fp->pfp);
   }
@@ -725,6 +1975,12 @@ off_t hc_ftell (HCFILE *fp)
     const xzfile_t *xfp = fp->xfp;
     n = (off_t) xfp->outProcessed;
   }
+  else if (fp->zfp)
+  {
+    const zfile_t *zfp = fp->zfp;
+
+    n = (off_t) (zfp->out_base + zfp->out_pos);
+  }
 
   return n;
 }
@@ -753,7 +2009,22 @@ int hc_fgetc (HCFILE *fp)
 
   if (fp == NULL) return r;
 
-  if (fp->pfp)
+  if (fp->rfp)
+  {
+    hc_fra_t *rfp = fp->rfp;
+
+    if (hc_fread_ahead_wait (rfp) == true)
+    {
+      r = (int) (unsigned char) rfp->blocks[rfp->read_slot][rfp->read_pos++];
+
+      rfp->consumed++;
+    }
+  }
+  else if (fp->mfp)
+  {
+    if (fp->mfp_pos < fp->mfp_len) r = (int) (unsigned char) fp->mfp[fp->mfp_pos++];
+  }
+  else if (fp->pfp)
   {
     r = fgetc (fp->pfp);
   }
@@ -794,6 +2065,15 @@ int hc_fgetc (HCFILE *fp)
     xfp->outProcessed++;
     r = (int) out;
   }
+  else if (fp->zfp)
+  {
+    zfile_t *zfp = fp->zfp;
+
+    if ((zfp->out_pos < zfp->out_len) || (hc_zfile_fill (zfp) > 0))
+    {
+      r = (int) zfp->out_buf[zfp->out_pos++];
+    }
+  }
 
   return r;
 }
@@ -804,7 +2084,43 @@ char *hc_fgets (char *buf, int len, HCFILE *fp)
 
   if (fp == NULL || buf == NULL || len <= 0) return r;
 
-  if (fp->pfp)
+  if (fp->rfp)
+  {
+    int pos = 0;
+
+    while (pos < len - 1)
+    {
+      const int c = hc_fgetc (fp);
+
+      if (c == EOF) break;
+
+      buf[pos++] = (char) c;
+
+      if (c == '\n') break;
+    }
+
+    buf[pos] = 0;
+
+    if (pos > 0) r = buf;
+  }
+  else if (fp->mfp)
+  {
+    int pos = 0;
+
+    while ((pos < len - 1) && (fp->mfp_pos < fp->mfp_len))
+    {
+      const char c = fp->mfp[fp->mfp_pos++];
+
+      buf[pos++] = c;
+
+      if (c == '\n') break;
+    }
+
+    buf[pos] = 0;
+
+    if (pos > 0) r = buf;
+  }
+  else if (fp->pfp)
   {
     r = fgets (buf, len, fp->pfp);
   }
@@ -857,6 +2173,37 @@ char *hc_fgets (char *buf, int len, HCFILE *fp)
     /* always NULL terminate */
     *outBuf = 0;
   }
+  else if (fp->zfp)
+  {
+    zfile_t *zfp = fp->zfp;
+
+    int pos = 0;
+
+    while (pos < (len - 1))
+    {
+      if ((zfp->out_pos == zfp->out_len) && (hc_zfile_fill (zfp) <= 0)) break;
+
+      const u8 *src = zfp->out_buf + zfp->out_pos;
+
+      size_t chunk = MIN (zfp->out_len - zfp->out_pos, (size_t) (len - 1 - pos));
+
+      const u8 *nl = (const u8 *) memchr (src, '\n', chunk);
+
+      if (nl != NULL) chunk = (size_t) (nl - src) + 1;
+
+      memcpy (buf + pos, src, chunk);
+
+      zfp->out_pos += chunk;
+
+      pos += (int) chunk;
+
+      if (nl != NULL) break;
+    }
+
+    buf[pos] = 0;
+
+    if (pos > 0) r = buf;
+  }
 
   return r;
 }
@@ -927,7 +2274,15 @@ int hc_feof (HCFILE *fp)
 
   if (fp == NULL) return r;
 
-  if (fp->pfp)
+  if (fp->rfp)
+  {
+    r = (hc_fread_ahead_wait (fp->rfp) == false);
+  }
+  else if (fp->mfp)
+  {
+    r = (fp->mfp_pos >= fp->mfp_len);
+  }
+  else if (fp->pfp)
   {
     r = feof (fp->pfp);
   }
@@ -944,6 +2299,12 @@ int hc_feof (HCFILE *fp)
     const xzfile_t *xfp = fp->xfp;
     r = (xfp->inEof && xfp->inPos == xfp->inLen);
   }
+  else if (fp->zfp)
+  {
+    zfile_t *zfp = fp->zfp;
+
+    r = ((zfp->out_pos == zfp->out_len) && (hc_zfile_fill (zfp) <= 0));
+  }
 
   return r;
 }
@@ -982,6 +2343,15 @@ void hc_fclose (HCFILE *fp)
 {
   if (fp == NULL) return;
 
+  hc_fread_ahead_stop (fp);
+
+  #if defined (_POSIX)
+  if (fp->mfp)
+  {
+    munmap (fp->mfp, (size_t) fp->mfp_len);
+  }
+  #endif
+
   if (fp->pfp)
   {
     fclose (fp->pfp);
@@ -1009,17 +2379,151 @@ void hc_fclose (HCFILE *fp)
     hcfree (xfp);
     close (fp->fd);
   }
+  else if (fp->zfp)
+  {
+    hc_zfile_close (fp->zfp);
+  }
 
   fp->fd = -1;
   fp->pfp = NULL;
   fp->gfp = NULL;
   fp->ufp = NULL;
   fp->xfp = NULL;
+  fp->zfp = NULL;
+  fp->mfp = NULL;
+
+  fp->mfp_len = 0;
+  fp->mfp_pos = 0;
+  fp->mfp_rel = 0;
 
   fp->path = NULL;
   fp->mode = NULL;
 }
 
+bool hc_fmap (HCFILE *fp)
+{
+  if (fp == NULL) return false;
+
+  if (fp->mfp) return true;
+
+  #if defined (_POSIX)
+
+  // only uncompressed regular files opened for reading, everything else stays on the stream path
+
+  if (fp->pfp == NULL) return false;
+
+  if (fp->mode == NULL || fp->mode[0] != 'r') return false;
+
+  struct stat st;
+
+  if (fstat (fp->fd, &st) == -1) return false;
+
+  if (S_ISREG (st.st_mode) == 0) return false;
+
+  if (st.st_size <= 0) return false;
+
+  if ((u64) st.st_size > (u64) (SIZE_MAX / 2)) return false;
+
+  const off_t pos = ftello (fp->pfp);
+
+  if (pos < 0 || pos > st.st_size) return false;
+
+  // the wordlist parsers modify lines in-place (hex decode, LM upper case), so use a private writable mapping
+
+  void *map = mmap (NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fp->fd, 0);
+
+  if (map == MAP_FAILED) return false;
+
+  madvise (map, (size_t) st.st_size, MADV_SEQUENTIAL);
+
+  fp->mfp     = (char *) map;
+  fp->mfp_len = (u64) st.st_size;
+  fp->mfp_pos = (u64) pos;
+  fp->mfp_rel = 0;
+
+  return true;
+
+  #else
+
+  return false;
+
+  #endif
+}
+
+char *hc_fmap_window (HCFILE *fp, const size_t max_len, size_t *len)
+{
+  if (fp == NULL || fp->mfp == NULL) return NULL;
+
+  #if defined (_POSIX)
+
+  const u64 left = fp->mfp_len - fp->mfp_pos;
+
+  // the final window is left to hc_fread() so the caller can terminate the last line and parsers never read past the mapping
+
+  if (left <= (u64) max_len) return NULL;
+
+  char *buf = fp->mfp + fp->mfp_pos;
+
+  u64 cnt = max_len;
+
+  while (cnt > 0 && buf[cnt - 1] != '\n') cnt--;
+
+  // a single line longer than the window, let the caller deal with it
+
+  if (cnt == 0) return NULL;
+
+  const u64 page_size = (u64) sysconf (_SC_PAGESIZE);
+
+  // everything before the new window has been consumed, drop it (including private copies of modified pages)
+
+  const u64 rel = fp->mfp_pos & ~(page_size - 1);
+
+  if (rel > fp->mfp_rel)
+  {
+    madvise (fp->mfp + fp->mfp_rel, (size_t) (rel - fp->mfp_rel), MADV_DONTNEED);
+
+    fp->mfp_rel = rel;
+  }
+
+  fp->mfp_pos += cnt;
+
+  // read-ahead the next window while the current one is being parsed
+
+  const u64 next = fp->mfp_pos & ~(page_size - 1);
+
+  const u64 ahead = MIN ((u64) max_len + page_size, fp->mfp_len - next);
+
+  madvise (fp->mfp + next, (size_t) ahead, MADV_WILLNEED);
+
+  *len = (size_t) cnt;
+
+  return buf;
+
+  #else
+
+  return NULL;
+
+  #endif
+}
+
+void hc_fmap_drop (const HCFILE *fp, const u64 offset, const u64 len)
+{
+  if (fp == NULL || fp->mfp == NULL) return;
+
+  #if defined (_POSIX)
+
+  // only whole pages inside the range, neighbouring ranges can be in use by other threads
+
+  const u64 page_size = (u64) sysconf (_SC_PAGESIZE);
+
+  const u64 beg = (offset + page_size - 1) & ~(page_size - 1);
+  const u64 end = (offset + len)           & ~(page_size - 1);
+
+  if (end > beg) madvise (fp->mfp + beg, (size_t) (end - beg), MADV_DONTNEED);
+
+  #endif
+}
+
 size_t fgetl (HCFILE *fp, char *line_buf, const size_t line_sz)
 {
   int c;
@@ -1061,10 +2565,158 @@ size_t fgetl (HCFILE *fp, char *line_buf, const size_t line_sz)
   return line_len;
 }
 
+// block-buffered replacement for the fgetl () loops, the lines are returned as slices of the buffer
+// they are NUL-terminated and can be modified in place, but only until the next call
+
+void hc_line_reader_init (hc_line_reader_t *lr, HCFILE *fp, const size_t line_sz)
+{
+  lr->fp = fp;
+
+  lr->buf     = (char *) hcmalloc (line_sz + 1);
+  lr->buf_sz  = line_sz;
+  lr->buf_len = 0;
+  lr->buf_pos = 0;
+
+  lr->eof = false;
+}
+
+bool hc_line_reader_next (hc_line_reader_t *lr, char **line_buf, size_t *line_len)
+{
+  while (true)
+  {
+    char *line = lr->buf + lr->buf_pos;
+
+    const size_t left = lr->buf_len - lr->buf_pos;
+
+    char *nl = (char *) memchr (line, '\n', left);
+
+    size_t len = 0;
+
+    size_t line_truncated = 0;
+
+    if (nl != NULL)
+    {
+      len = (size_t) (nl - line);
+
+      lr->buf_pos += len + 1;
+    }
+    else if (lr->eof == true)
+    {
+      if (left == 0) return false;
+
+      len = left;
+
+      lr->buf_pos = lr->buf_len;
+    }
+    else if ((lr->buf_pos == 0) && (lr->buf_len == lr->buf_sz))
+    {
+      // the line does not fit into the buffer, skip the rest of it
+
+      int c;
+
+      while ((c = hc_fgetc (lr->fp)) != EOF)
+      {
+        if (c == '\n') break;
+
+        line_truncated++;
+      }
+
+      if (c == EOF) lr->eof = true;
+
+      len = left;
+
+      lr->buf_pos = lr->buf_len;
+    }
+    else
+    {
+      if (lr->buf_pos > 0)
+      {
+        memmove (lr->buf, line, left);
+
+        lr->buf_len = left;
+        lr->buf_pos = 0;
+      }
+
+      const size_t nread = hc_fread (lr->buf + lr->buf_len, 1, lr->buf_sz - lr->buf_len, lr->fp);
+
+      if ((nread == 0) || (nread == (size_t) -1))
+      {
+        lr->eof = true;
+      }
+      else
+      {
+        lr->buf_len += nread;
+      }
+
+      continue;
+    }
+
+    // same as fgetl ()
+
+    if (line_truncated > 0)
+    {
+      fprintf (stderr, "\nOversized line detected! Truncated %" PRIu64 " bytes\n", (u64) line_truncated);
+    }
+    else
+    {
+      while (len > 0 && line[len - 1] == '\r')
+      {
+        len--;
+      }
+    }
+
+    line[len] = 0;
+
+    *line_buf = line;
+    *line_len = len;
+
+    return true;
+  }
+}
+
+// position of the next line, the file itself is already further ahead
+
+off_t hc_line_reader_tell (hc_line_reader_t *lr)
+{
+  return hc_ftell (lr->fp) - (off_t) (lr->buf_len - lr->buf_pos);
+}
+
+void hc_line_reader_destroy (hc_line_reader_t *lr)
+{
+  hcfree (lr->buf);
+
+  lr->buf = NULL;
+}
+
 u64 count_lines (HCFILE *fp)
 {
   u64 cnt = 0;
 
+  if (fp->mfp)
+  {
+    // same result as below: every byte following a newline starts a new line
+
+    const char *pos = fp->mfp + fp->mfp_pos;
+    const char *end = fp->mfp + fp->mfp_len;
+
+    if (pos < end) cnt++;
+
+    while (pos < end)
+    {
+      const char *nl = (const char *) memchr (pos, '\n', (size_t) (end - pos));
+
+      if (nl == NULL) break;
+
+      pos = nl + 1;
+
+      if (pos < end) cnt++;
+    }
+
+    fp->mfp_pos = fp->mfp_len;
+
+    return cnt;
+  }
+
   char *buf = (char *) hcmalloc (HCBUFSIZ_LARGE + 1);
 
   char prev = '\n';
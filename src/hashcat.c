@@ -751,6 +751,12 @@ static int outer_loop (hashcat_ctx_t *hashcat_ctx)
 
   if (hashes_init_benchmark (hashcat_ctx) == -1) return -1;
 
+  /**
+   * load hashes, bucket index for the digest lookup
+   */
+
+  if (hashes_init_digests_idx (hashcat_ctx) == -1) return -1;
+
   /**
    * Done loading hashes, log results
    */
@@ -2050,6 +2056,8 @@ int hashcat_get_status (hashcat_ctx_t *hashcat_ctx, hashcat_status_t *hashcat_st
   hashcat_status->progress_ignore             = status_get_progress_ignore            (hashcat_ctx);
   hashcat_status->progress_rejected           = status_get_progress_rejected          (hashcat_ctx);
   hashcat_status->progress_rejected_percent   = status_get_progress_rejected_percent  (hashcat_ctx);
+  hashcat_status->bitmap_fp                   = status_get_bitmap_fp                  (hashcat_ctx);
+  hashcat_status->bitmap_fp_percent           = status_get_bitmap_fp_percent          (hashcat_ctx);
   hashcat_status->progress_restored           = status_get_progress_restored          (hashcat_ctx);
   hashcat_status->progress_skip               = status_get_progress_skip              (hashcat_ctx);
   hashcat_status->restore_point               = status_get_restore_point              (hashcat_ctx);
@@ -2064,6 +2072,7 @@ int hashcat_get_status (hashcat_ctx_t *hashcat_ctx, hashcat_status_t *hashcat_st
   hashcat_status->brain_attack                = status_get_brain_attack               (hashcat_ctx);
   hashcat_status->brain_rx_all                = status_get_brain_rx_all               (hashcat_ctx);
   hashcat_status->brain_tx_all                = status_get_brain_tx_all               (hashcat_ctx);
+  hashcat_status->brain_wait_all              = status_get_brain_wait_all             (hashcat_ctx);
   #endif
   hashcat_status->status_string               = status_get_status_string              (hashcat_ctx);
   hashcat_status->status_number               = status_get_status_number              (hashcat_ctx);
@@ -21,6 +21,7 @@
 #include "shared.h"
 #include "thread.h"
 #include "locking.h"
+#include "bitmap.h"
 #include "hashes.h"
 
 #ifdef WITH_BRAIN
@@ -117,6 +118,167 @@ int sort_by_hash_no_salt (const void *v1, const void *v2, void *v3)
   return sort_by_digest_p0p1 (d1, d2, v3);
 }
 
+static HC_API_CALL void *hashes_sort_radix_thread (void *p)
+{
+  hash_sort_thread_param_t *param = (hash_sort_thread_param_t *) p;
+
+  const u64 beg = (param->cnt * (u64) (param->tid + 0)) / (u64) param->tsz;
+  const u64 end = (param->cnt * (u64) (param->tid + 1)) / (u64) param->tsz;
+
+  const u32 word  = param->pass / 4;
+  const u32 shift = (param->pass % 4) * 8;
+
+  u64 *hist = param->hist + (param->tid * 256);
+
+  if (param->scatter == false)
+  {
+    for (u64 i = beg; i < end; i++)
+    {
+      hist[(param->src[i].key[word] >> shift) & 0xff]++;
+    }
+  }
+  else
+  {
+    for (u64 i = beg; i < end; i++)
+    {
+      const u32 digit = (param->src[i].key[word] >> shift) & 0xff;
+
+      param->dst[hist[digit]++] = param->src[i];
+    }
+  }
+
+  return NULL;
+}
+
+// same order as sort_by_hash_no_salt (), but the digests are copied into fixed-width records which are
+// sorted with a LSD radix sort, one byte per pass, each pass split across all CPU cores
+// the radix sort is stable, so duplicate hashes stay in hashfile order
+
+static bool hashes_sort_radix (const hashconfig_t *hashconfig, hash_t *hashes_buf, const u32 hashes_cnt)
+{
+  if (hashconfig->is_salted == true) return false;
+
+  if (hashes_cnt < HASHLIST_RADIX_MIN) return false;
+
+  // sort_by_digest_p0p1 () would read past a digest smaller than 4 words, keep that behaviour with hc_qsort_r ()
+
+  const u32 dgst_pos_max = MAX (MAX (hashconfig->dgst_pos0, hashconfig->dgst_pos1), MAX (hashconfig->dgst_pos2, hashconfig->dgst_pos3));
+
+  if (((dgst_pos_max + 1) * sizeof (u32)) > hashconfig->dgst_size) return false;
+
+  hash_sort_rec_t *recs = (hash_sort_rec_t *) hcmalloc ((size_t) hashes_cnt * sizeof (hash_sort_rec_t));
+  hash_sort_rec_t *tmps = (hash_sort_rec_t *) hcmalloc ((size_t) hashes_cnt * sizeof (hash_sort_rec_t));
+
+  for (u32 hashes_pos = 0; hashes_pos < hashes_cnt; hashes_pos++)
+  {
+    const u32 *digest = (const u32 *) hashes_buf[hashes_pos].digest;
+
+    hash_sort_rec_t *rec = recs + hashes_pos;
+
+    rec->key[0]   = digest[hashconfig->dgst_pos0];
+    rec->key[1]   = digest[hashconfig->dgst_pos1];
+    rec->key[2]   = digest[hashconfig->dgst_pos2];
+    rec->key[3]   = digest[hashconfig->dgst_pos3];
+    rec->hash_pos = hashes_pos;
+  }
+
+  const int processor_count = hc_get_processor_count ();
+
+  const int tsz = (int) MAX (1, MIN ((u64) processor_count, hashes_cnt / HASHLIST_RADIX_MIN));
+
+  hash_sort_thread_param_t *threads_param = (hash_sort_thread_param_t *) hccalloc (tsz, sizeof (hash_sort_thread_param_t));
+  hc_thread_t              *c_threads     = (hc_thread_t *)              hccalloc (tsz, sizeof (hc_thread_t));
+
+  u64 *hist = (u64 *) hccalloc ((size_t) tsz * 256, sizeof (u64));
+
+  for (u32 pass = 0; pass < 16; pass++)
+  {
+    memset (hist, 0, (size_t) tsz * 256 * sizeof (u64));
+
+    for (int i = 0; i < tsz; i++)
+    {
+      hash_sort_thread_param_t *param = threads_param + i;
+
+      param->tid     = i;
+      param->tsz     = tsz;
+      param->src     = recs;
+      param->dst     = tmps;
+      param->cnt     = hashes_cnt;
+      param->pass    = pass;
+      param->scatter = false;
+      param->hist    = hist;
+
+      hc_thread_create (c_threads[i], hashes_sort_radix_thread, param);
+    }
+
+    hc_thread_wait (tsz, c_threads);
+
+    // turn the counts into offsets, digit by digit and within a digit thread by thread to keep the sort stable
+    // a pass where all hashes have the same digit would not move anything
+
+    bool skip = false;
+
+    u64 off = 0;
+
+    for (u32 digit = 0; digit < 256; digit++)
+    {
+      u64 digit_cnt = 0;
+
+      for (int i = 0; i < tsz; i++)
+      {
+        const u64 cnt = hist[(i * 256) + digit];
+
+        hist[(i * 256) + digit] = off;
+
+        off += cnt;
+
+        digit_cnt += cnt;
+      }
+
+      if (digit_cnt == hashes_cnt) skip = true;
+    }
+
+    if (skip == true) continue;
+
+    for (int i = 0; i < tsz; i++)
+    {
+      threads_param[i].scatter = true;
+
+      hc_thread_create (c_threads[i], hashes_sort_radix_thread, &threads_param[i]);
+    }
+
+    hc_thread_wait (tsz, c_threads);
+
+    hash_sort_rec_t *swap = recs;
+
+    recs = tmps;
+    tmps = swap;
+  }
+
+  hcfree (hist);
+  hcfree (c_threads);
+  hcfree (threads_param);
+
+  hcfree (tmps);
+
+  // apply the new order, the hash_t only point to their digest, salt and esalt buffers
+
+  hash_t *hashes_buf_sorted = (hash_t *) hcmalloc ((size_t) hashes_cnt * sizeof (hash_t));
+
+  for (u32 hashes_pos = 0; hashes_pos < hashes_cnt; hashes_pos++)
+  {
+    hashes_buf_sorted[hashes_pos] = hashes_buf[recs[hashes_pos].hash_pos];
+  }
+
+  memcpy (hashes_buf, hashes_buf_sorted, (size_t) hashes_cnt * sizeof (hash_t));
+
+  hcfree (hashes_buf_sorted);
+
+  hcfree (recs);
+
+  return true;
+}
+
 int hash_encode (const hashconfig_t *hashconfig, const hashes_t *hashes, const module_ctx_t *module_ctx, char *out_buf, const int out_size, const u32 salt_pos, const u32 digest_pos)
 {
   if (module_ctx->module_hash_encode == MODULE_DEFAULT)
@@ -572,6 +734,35 @@ int check_hash (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, pla
   return 0;
 }
 
+static int check_cracked_reset (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  if (device_param->is_cuda == true)
+  {
+    if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_result, device_param->size_results) == -1) return -1;
+  }
+
+  if (device_param->is_hip == true)
+  {
+    if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_result, device_param->size_results) == -1) return -1;
+  }
+
+  #if defined (__APPLE__)
+  if (device_param->is_metal == true)
+  {
+    if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_result, device_param->size_results) == -1) return -1;
+  }
+  #endif
+
+  if (device_param->is_opencl == true)
+  {
+    if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_result, device_param->size_results) == -1) return -1;
+
+    if (hc_clFlush (hashcat_ctx, device_param->opencl_command_queue) == -1) return -1;
+  }
+
+  return 0;
+}
+
 //int check_cracked (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u32 salt_pos)
 int check_cracked (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 {
@@ -581,20 +772,20 @@ int check_cracked (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
   status_ctx_t   *status_ctx   = hashcat_ctx->status_ctx;
   user_options_t *user_options = hashcat_ctx->user_options;
 
-  u32 num_cracked = 0;
+  u32 results[2] = { 0 };
 
   int rc = -1;
 
   if (device_param->is_cuda == true)
   {
-    if (hc_cuMemcpyDtoH (hashcat_ctx, &num_cracked, device_param->cuda_d_result, sizeof (u32)) == -1) return -1;
+    if (hc_cuMemcpyDtoH (hashcat_ctx, results, device_param->cuda_d_result, sizeof (results)) == -1) return -1;
 
     if (hc_cuStreamSynchronize (hashcat_ctx, device_param->cuda_stream) == -1) return -1;
   }
 
   if (device_param->is_hip == true)
   {
-    if (hc_hipMemcpyDtoH (hashcat_ctx, &num_cracked, device_param->hip_d_result, sizeof (u32)) == -1) return -1;
+    if (hc_hipMemcpyDtoH (hashcat_ctx, results, device_param->hip_d_result, sizeof (results)) == -1) return -1;
 
     if (hc_hipStreamSynchronize (hashcat_ctx, device_param->hip_stream) == -1) return -1;
   }
@@ -602,21 +793,29 @@ int check_cracked (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
   #if defined (__APPLE__)
   if (device_param->is_metal == true)
   {
-    if (hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, &num_cracked, device_param->metal_d_result, 0, sizeof (u32)) == -1) return -1;
+    if (hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, results, device_param->metal_d_result, 0, sizeof (results)) == -1) return -1;
   }
   #endif
 
   if (device_param->is_opencl == true)
   {
     /* blocking */
-    if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_result, CL_TRUE, 0, sizeof (u32), &num_cracked, 0, NULL, NULL) == -1) return -1;
+    if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_result, CL_TRUE, 0, sizeof (results), results, 0, NULL, NULL) == -1) return -1;
   }
 
+  const u32 num_cracked = results[0];
+
+  // bitmap false positives (--bitmap-fp-count), the counter is reset together with num_cracked
+
+  device_param->bitmap_fp += results[1];
+
   if (num_cracked == 0 || user_options->speed_only == true)
   {
     // we want to get the num_cracked in benchmark mode because it has an influence in performance
     // however if the benchmark cracks the artificial hash used for benchmarks we don't want to see that!
 
+    if (results[1] > 0) return check_cracked_reset (hashcat_ctx, device_param);
+
     return 0;
   }
 
@@ -776,6 +975,10 @@ int check_cracked (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
     }
   }
 
+  // with most of the digests cracked, rebuild the bitmaps from the remaining ones
+
+  if (cpt_cracked > 0) bitmap_ctx_update (hashcat_ctx);
+
   hc_thread_mutex_unlock (status_ctx->mux_display);
 
   hcfree (cracked);
@@ -801,31 +1004,7 @@ int check_cracked (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
     hc_thread_mutex_unlock (status_ctx->mux_display);
   }
 
-  if (device_param->is_cuda == true)
-  {
-    if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_result, sizeof (u32)) == -1) return -1;
-  }
-
-  if (device_param->is_hip == true)
-  {
-    if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_result, sizeof (u32)) == -1) return -1;
-  }
-
-  #if defined (__APPLE__)
-  if (device_param->is_metal == true)
-  {
-    if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_result, sizeof (u32)) == -1) return -1;
-  }
-  #endif
-
-  if (device_param->is_opencl == true)
-  {
-    if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_result, sizeof (u32)) == -1) return -1;
-
-    if (hc_clFlush (hashcat_ctx, device_param->opencl_command_queue) == -1) return -1;
-  }
-
-  return 0;
+  return check_cracked_reset (hashcat_ctx, device_param);
 }
 
 int hashes_init_filename (hashcat_ctx_t *hashcat_ctx)
@@ -887,561 +1066,798 @@ int hashes_init_filename (hashcat_ctx_t *hashcat_ctx)
   return 0;
 }
 
-int hashes_init_stage1 (hashcat_ctx_t *hashcat_ctx)
+// decodes a single hashfile line into hashes_buf, split hashes (LM) take two hash_t
+// returns the number of hashes decoded, or -1 if the hashlist format did not match the line
+
+static int hashes_parse_line (hashcat_ctx_t *hashcat_ctx, const u32 hashlist_format, char *line_buf, const size_t line_len, const u32 line_num, hash_t *hashes_buf, int *parser_status)
 {
-  hashconfig_t          *hashconfig         = hashcat_ctx->hashconfig;
-  hashes_t              *hashes             = hashcat_ctx->hashes;
-  module_ctx_t          *module_ctx         = hashcat_ctx->module_ctx;
-  user_options_t        *user_options       = hashcat_ctx->user_options;
-  user_options_extra_t  *user_options_extra = hashcat_ctx->user_options_extra;
+  const hashconfig_t         *hashconfig         = hashcat_ctx->hashconfig;
+  const module_ctx_t         *module_ctx         = hashcat_ctx->module_ctx;
+  const user_options_t       *user_options       = hashcat_ctx->user_options;
+  const user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
 
-  /**
-   * load hashes, part I: find input mode, count hashes
-   */
+  *parser_status = PARSER_OK;
 
-  const char *hashfile      = hashes->hashfile;
-  const u32   hashlist_mode = hashes->hashlist_mode;
+  char *hash_buf = NULL;
+  int   hash_len = 0;
 
-  u32 hashlist_format = HLFMT_HASHCAT;
+  hlfmt_hash (hashcat_ctx, hashlist_format, line_buf, line_len, &hash_buf, &hash_len);
 
-  u64 hashes_avail = 0;
+  if (hash_len < 1)     return -1;
+  if (hash_buf == NULL) return -1;
 
-  if ((user_options->benchmark == false) && (user_options->stdout_flag == false) && (user_options->keyspace == false))
+  // the following conditions should be true if (hashlist_format == HLFMT_PWDUMP)
+
+  const bool is_split = ((hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT) && (hash_len == 32));
+
+  const int hashes_per_line = (is_split == true) ? 2 : 1;
+
+  if (user_options->username == true)
   {
-    if (hashlist_mode == HL_MODE_ARG)
-    {
-      hashes_avail = 1;
-    }
-    else if (hashlist_mode == HL_MODE_FILE_PLAIN)
+    char *user_buf = NULL;
+    int   user_len = 0;
+
+    hlfmt_user (hashcat_ctx, hashlist_format, line_buf, line_len, &user_buf, &user_len);
+
+    // special case:
+    // both hash_t need to have the username info if the pwdump format is used (i.e. we have 2 hashes for 3000, both with same user)
+
+    for (int i = 0; i < hashes_per_line; i++)
     {
-      HCFILE fp;
+      user_t **user = &hashes_buf[i].hash_info->user;
 
-      if (hc_fopen (&fp, hashfile, "rb") == false)
-      {
-        event_log_error (hashcat_ctx, "%s: %s", hashfile, strerror (errno));
+      *user = (user_t *) hcmalloc (sizeof (user_t));
 
-        return -1;
+      user_t *user_ptr = *user;
+
+      if (user_buf != NULL)
+      {
+        user_ptr->user_name = hcstrdup (user_buf);
+      }
+      else
+      {
+        user_ptr->user_name = hcstrdup ("");
       }
 
-      EVENT_DATA (EVENT_HASHLIST_COUNT_LINES_PRE, hashfile, strlen (hashfile));
+      user_ptr->user_len = (u32) user_len;
+    }
+  }
 
-      hashes_avail = count_lines (&fp);
+  if (hashconfig->opts_type & OPTS_TYPE_HASH_COPY)
+  {
+    hashinfo_t *hash_info_tmp = hashes_buf[0].hash_info;
 
-      EVENT_DATA (EVENT_HASHLIST_COUNT_LINES_POST, hashfile, strlen (hashfile));
+    hash_info_tmp->orighash = hcstrdup (hash_buf);
+  }
 
-      hc_rewind (&fp);
+  if (hashconfig->is_salted == true)
+  {
+    const u32 orig_pos = hashes_buf[0].salt->orig_pos;
 
-      if (hashes_avail == 0)
-      {
-        event_log_error (hashcat_ctx, "hashfile is empty or corrupt.");
+    memset (hashes_buf[0].salt, 0, sizeof (salt_t));
 
-        hc_fclose (&fp);
+    hashes_buf[0].salt->orig_pos = orig_pos;
+  }
 
-        return -1;
-      }
+  if (hashconfig->esalt_size > 0)
+  {
+    memset (hashes_buf[0].esalt, 0, hashconfig->esalt_size);
+  }
 
-      hashlist_format = hlfmt_detect (hashcat_ctx, &fp, 100); // 100 = max numbers to "scan". could be hashes_avail, too
+  if (hashconfig->hook_salt_size > 0)
+  {
+    memset (hashes_buf[0].hook_salt, 0, hashconfig->hook_salt_size);
+  }
 
-      hc_fclose (&fp);
+  for (int i = 0; i < hashes_per_line; i++)
+  {
+    hash_t *hash = &hashes_buf[i];
 
-      if ((user_options->remove == true) && (hashlist_format != HLFMT_HASHCAT))
-      {
-        event_log_error (hashcat_ctx, "Use of --remove is not supported in native hashfile-format mode.");
+    char *split_buf = (is_split == true) ? hash_buf + (i * 16) : hash_buf;
+    int   split_len = (is_split == true) ?              16     : hash_len;
 
-        return -1;
-      }
+    *parser_status = module_ctx->module_hash_decode (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, split_buf, split_len);
+
+    if (*parser_status < PARSER_GLOBAL_ZERO) return i;
+
+    if (module_ctx->module_hash_decode_postprocess != MODULE_DEFAULT)
+    {
+      *parser_status = module_ctx->module_hash_decode_postprocess (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, user_options, user_options_extra);
+
+      if (*parser_status < PARSER_GLOBAL_ZERO) return i;
     }
-    else if (hashlist_mode == HL_MODE_FILE_BINARY)
+
+    if (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT)
     {
-      struct stat st;
+      split_t *split = hash->hash_info->split;
 
-      if (stat (hashes->hashfile, &st) == -1)
-      {
-        event_log_error (hashcat_ctx, "%s: %s", hashes->hashfile, strerror (errno));
+      split->split_group  = line_num;
+      split->split_origin = (is_split == false) ? SPLIT_ORIGIN_NONE : (i == 0) ? SPLIT_ORIGIN_LEFT : SPLIT_ORIGIN_RIGHT;
+    }
+  }
 
-        return -1;
-      }
+  return hashes_per_line;
+}
 
-      if (module_ctx->module_hash_binary_count != MODULE_DEFAULT)
-      {
-        const int binary_count = module_ctx->module_hash_binary_count (hashes);
+static char *hashes_parse_error_line (const char *line_buf)
+{
+  char *tmp_line_buf;
 
-        if (binary_count > 0)
-        {
-          hashes_avail = binary_count;
-        }
-        else if (binary_count == 0)
-        {
-          event_log_error (hashcat_ctx, "No hashes loaded.");
+  hc_asprintf (&tmp_line_buf, "%s", line_buf);
 
-          return -1;
-        }
-        else if (binary_count == PARSER_HAVE_ERRNO)
-        {
-          event_log_error (hashcat_ctx, "%s: %s", hashes->hashfile, strerror (errno));
+  compress_terminal_line_length (tmp_line_buf, 38, 32);
 
-          return -1;
-        }
-        else
-        {
-          event_log_error (hashcat_ctx, "%s: %s", hashes->hashfile, strerror (binary_count));
+  return tmp_line_buf;
+}
 
-          return -1;
-        }
-      }
-      else
-      {
-        hashes_avail = 1;
-      }
-    }
+static void hashes_parse_error (hashcat_ctx_t *hashcat_ctx, const char *tmp_line_buf, const u32 line_num, const int parser_status)
+{
+  const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+        hashes_t       *hashes       = hashcat_ctx->hashes;
+  const user_options_t *user_options = hashcat_ctx->user_options;
+
+  if (user_options->machine_readable == true)
+  {
+    event_log_warning (hashcat_ctx, "%s:%u:%s:%s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
   }
   else
   {
-    hashes_avail = 1;
+    event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u (%s): %s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
   }
 
-  if (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT) hashes_avail *= 2;
+  if ((hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT) == 0)
+  {
+    if (parser_status == PARSER_TOKEN_LENGTH)
+    {
+      hashes->parser_token_length_cnt++;
+    }
+  }
+}
 
-  hashes->hashlist_format = hashlist_format;
+// moves a decoded hash into an earlier slot, the slots keep their digest, salt and esalt buffers
 
-  /**
-   * load hashes, part II: allocate required memory, set pointers
-   */
+static void hashes_move (const hashconfig_t *hashconfig, hash_t *dst, hash_t *src)
+{
+  memcpy (dst->digest, src->digest, hashconfig->dgst_size);
 
-  hash_t *hashes_buf     = (hash_t *) hccalloc (hashes_avail, sizeof (hash_t));
-  void   *digests_buf    =            hccalloc (hashes_avail, hashconfig->dgst_size);
-  salt_t *salts_buf      = NULL;
-  void   *esalts_buf     = NULL;
-  void   *hook_salts_buf = NULL;
+  if (hashconfig->is_salted == true)
+  {
+    const u32 orig_pos = dst->salt->orig_pos;
 
-  if ((user_options->dynamic_x == true) || (user_options->username == true) || (hashconfig->opts_type & OPTS_TYPE_HASH_COPY) || (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT))
+    memcpy (dst->salt, src->salt, sizeof (salt_t));
+
+    dst->salt->orig_pos = orig_pos;
+  }
+
+  if (hashconfig->esalt_size > 0)
   {
-    u64 hash_pos;
+    memcpy (dst->esalt, src->esalt, hashconfig->esalt_size);
+  }
 
-    for (hash_pos = 0; hash_pos < hashes_avail; hash_pos++)
+  if (hashconfig->hook_salt_size > 0)
+  {
+    memcpy (dst->hook_salt, src->hook_salt, hashconfig->hook_salt_size);
+  }
+
+  hashinfo_t *hash_info = dst->hash_info;
+
+  dst->hash_info = src->hash_info;
+  src->hash_info = hash_info;
+}
+
+static HC_API_CALL void *hashes_parse_thread (void *p)
+{
+  hashlist_thread_param_t *param = (hashlist_thread_param_t *) p;
+
+  hashcat_ctx_t *hashcat_ctx = param->hashcat_ctx;
+
+  hash_t *hashes_buf = hashcat_ctx->hashes->hashes_buf;
+
+  char *line_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
+
+  for (u64 chunk = param->tid; chunk < param->chunks_cnt; chunk += param->tsz)
+  {
+    hashlist_parse_error_t *errors       = NULL;
+    u64                     errors_cnt   = 0;
+    u64                     errors_avail = 0;
+
+    const char *pos = param->map + param->chunks_off[chunk];
+    const char *end = param->map + param->chunks_off[chunk + 1];
+
+    for (u64 line = param->chunks_line[chunk]; pos < end; line++)
     {
-      hashinfo_t *hash_info = (hashinfo_t *) hcmalloc (sizeof (hashinfo_t));
+      const char *nl = (const char *) memchr (pos, '\n', end - pos);
 
-      hashes_buf[hash_pos].hash_info = hash_info;
+      const char *eol = (nl == NULL) ? end : nl;
 
-      if (user_options->dynamic_x == true)
-      {
-        hash_info->dynamicx = (dynamicx_t *) hcmalloc (sizeof (dynamicx_t));
-      }
+      // same as fgetl ()
 
-      if (user_options->username == true)
+      size_t line_len = eol - pos;
+
+      if (line_len >= HCBUFSIZ_LARGE)
       {
-        hash_info->user = (user_t *) hcmalloc (sizeof (user_t));
-      }
+        fprintf (stderr, "\nOversized line detected! Truncated %" PRIu64 " bytes\n", (u64) (line_len - (HCBUFSIZ_LARGE - 1)));
 
-      if (hashconfig->opts_type & OPTS_TYPE_HASH_COPY)
+        line_len = HCBUFSIZ_LARGE - 1;
+      }
+      else
       {
-        if (user_options->benchmark == false)
+        while (line_len > 0 && pos[line_len - 1] == '\r')
         {
-          hash_info->orighash = (char *) hcmalloc (256);
+          line_len--;
         }
       }
 
-      if (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT)
-      {
-        hash_info->split = (split_t *) hcmalloc (sizeof (split_t));
-      }
-    }
-  }
+      memcpy (line_buf, pos, line_len);
 
-  if (hashconfig->is_salted == true)
-  {
-    salts_buf = (salt_t *) hccalloc (hashes_avail, sizeof (salt_t));
+      line_buf[line_len] = 0;
 
-    if (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
-    {
-      // this disables:
-      // - sorting by salt value
-      // - grouping by salt value
-      // - keep the salt in position relative to hashfile (not equal because of some hashes maybe failed to load)
+      pos = eol + 1;
 
-      u64 hash_pos;
+      if (line_len == 0) continue;
 
-      for (hash_pos = 0; hash_pos < hashes_avail; hash_pos++)
+      // every line owns the slots of its line number, the main thread compacts them afterwards
+
+      const u32 line_num = (u32) (line + 1);
+
+      int parser_status = PARSER_OK;
+
+      const int parsed = hashes_parse_line (hashcat_ctx, param->hashlist_format, line_buf, line_len, line_num, &hashes_buf[line * param->slots_per_line], &parser_status);
+
+      if (parsed > 0) param->lines_parsed[line] = (u8) parsed;
+
+      if ((parsed == -1) || (parser_status < PARSER_GLOBAL_ZERO))
       {
-        salt_t *salt = &salts_buf[hash_pos];
+        if (errors_cnt == errors_avail)
+        {
+          errors = (hashlist_parse_error_t *) hcrealloc (errors, errors_avail * sizeof (hashlist_parse_error_t), INCR_HASHLIST_ERRORS * sizeof (hashlist_parse_error_t));
 
-        salt->orig_pos = hash_pos;
+          errors_avail += INCR_HASHLIST_ERRORS;
+        }
+
+        hashlist_parse_error_t *error = errors + errors_cnt;
+
+        error->line_num      = line_num;
+        error->parser_status = parser_status;
+        error->fmt_error     = (parsed == -1);
+        error->line_buf      = (parsed == -1) ? NULL : hashes_parse_error_line (line_buf);
+
+        errors_cnt++;
       }
     }
 
-    if (hashconfig->esalt_size > 0)
-    {
-      esalts_buf = hccalloc (hashes_avail, hashconfig->esalt_size);
-    }
+    hc_thread_mutex_lock (*param->mux_done);
 
-    if (hashconfig->hook_salt_size > 0)
-    {
-      hook_salts_buf = hccalloc (hashes_avail, hashconfig->hook_salt_size);
-    }
-  }
-  else
-  {
-    salts_buf = (salt_t *) hccalloc (1, sizeof (salt_t));
+    param->chunks_errors[chunk]     = errors;
+    param->chunks_errors_cnt[chunk] = errors_cnt;
+    param->chunks_done[chunk]       = true;
+
+    hc_thread_mutex_unlock (*param->mux_done);
   }
 
-  for (u64 hash_pos = 0; hash_pos < hashes_avail; hash_pos++)
+  hcfree (line_buf);
+
+  return NULL;
+}
+
+// large hashlists are memory-mapped and split into chunks which are decoded by a pool of threads
+// the warnings are printed and the hashes are compacted here in hashfile order, so the result is the same as with the serial loop
+
+static int hashes_parse_parallel (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const u32 hashlist_format, const u64 hashes_avail, u32 *hashes_cnt)
+{
+  const hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
+  const hashes_t     *hashes     = hashcat_ctx->hashes;
+
+  const int processor_count = hc_get_processor_count ();
+
+  if (processor_count < 2) return 0;
+
+  if (hc_fmap (fp) == false) return 0;
+
+  if (fp->mfp_pos != 0) return 0;
+
+  if (fp->mfp_len < (2 * HASHLIST_CHUNK_SIZE)) return 0;
+
+  // the line numbers of each chunk are needed upfront, they tell the threads which slots to use
+
+  const u64 chunks_max = (fp->mfp_len / HASHLIST_CHUNK_SIZE) + 2;
+
+  u64 *chunks_off  = (u64 *) hccalloc (chunks_max, sizeof (u64));
+  u64 *chunks_line = (u64 *) hccalloc (chunks_max, sizeof (u64));
+
+  u64 chunks_cnt = 0;
+  u64 lines_cnt  = 0;
+
+  u64 pos = 0;
+
+  while (pos < fp->mfp_len)
   {
-    /**
-     * Initialize some values for later use
-     */
+    chunks_off[chunks_cnt]  = pos;
+    chunks_line[chunks_cnt] = lines_cnt;
 
-    hashes_buf[hash_pos].orig_line_pos = hash_pos;
+    chunks_cnt++;
 
-    hashes_buf[hash_pos].digest = ((char *) digests_buf) + (hash_pos * hashconfig->dgst_size);
+    u64 next = fp->mfp_len;
 
-    if (hashconfig->is_salted == true)
+    if ((pos + HASHLIST_CHUNK_SIZE) < fp->mfp_len)
     {
-      hashes_buf[hash_pos].salt = &salts_buf[hash_pos];
+      const u64 from = pos + HASHLIST_CHUNK_SIZE - 1;
 
-      if (hashconfig->esalt_size > 0)
-      {
-        hashes_buf[hash_pos].esalt = ((char *) esalts_buf) + (hash_pos * hashconfig->esalt_size);
-      }
+      const char *nl = (const char *) memchr (fp->mfp + from, '\n', (size_t) (fp->mfp_len - from));
 
-      if (hashconfig->hook_salt_size > 0)
-      {
-        hashes_buf[hash_pos].hook_salt = ((char *) hook_salts_buf) + (hash_pos * hashconfig->hook_salt_size);
-      }
+      if (nl != NULL) next = (u64) (nl - fp->mfp) + 1;
     }
-    else
+
+    const char *line = fp->mfp + pos;
+    const char *end  = fp->mfp + next;
+
+    while (line < end)
     {
-      hashes_buf[hash_pos].salt = &salts_buf[0];
+      const char *nl = (const char *) memchr (line, '\n', (size_t) (end - line));
+
+      lines_cnt++;
+
+      if (nl == NULL) break;
+
+      line = nl + 1;
     }
+
+    pos = next;
   }
 
-  hashes->hashes_buf     = hashes_buf;
-  hashes->digests_buf    = digests_buf;
-  hashes->salts_buf      = salts_buf;
-  hashes->esalts_buf     = esalts_buf;
-  hashes->hook_salts_buf = hook_salts_buf;
+  chunks_off[chunks_cnt]  = pos;
+  chunks_line[chunks_cnt] = lines_cnt;
 
-  /**
-   * load hashes, part III: parse hashes
-   */
+  const u64 slots_per_line = (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT) ? 2 : 1;
 
-  u32 hashes_cnt = 0;
+  // the file changed after it was counted, the serial loop knows how to deal with that
 
-  if (user_options->benchmark == true)
+  if ((lines_cnt * slots_per_line) > hashes_avail)
   {
-    hashes->hashfile = "-";
+    hcfree (chunks_line);
+    hcfree (chunks_off);
 
-    hashes_cnt = 1;
-  }
-  else if (user_options->hash_info > 0)
-  {
-  }
-  else if (user_options->keyspace == true)
-  {
-  }
-  else if (user_options->stdout_flag == true)
-  {
+    return 0;
   }
-  else if (user_options->backend_info > 0)
+
+  const int tsz = (int) MIN ((u64) processor_count, chunks_cnt);
+
+  hashlist_thread_param_t *threads_param = (hashlist_thread_param_t *) hccalloc (tsz, sizeof (hashlist_thread_param_t));
+  hc_thread_t             *c_threads     = (hc_thread_t *)             hccalloc (tsz, sizeof (hc_thread_t));
+
+  u8                      *lines_parsed      = (u8 *)                       hccalloc (lines_cnt,  sizeof (u8));
+  hashlist_parse_error_t **chunks_errors     = (hashlist_parse_error_t **) hccalloc (chunks_cnt, sizeof (hashlist_parse_error_t *));
+  u64                     *chunks_errors_cnt = (u64 *)                     hccalloc (chunks_cnt, sizeof (u64));
+  bool                    *chunks_done       = (bool *)                    hccalloc (chunks_cnt, sizeof (bool));
+
+  hc_thread_mutex_t mux_done;
+
+  hc_thread_mutex_init (mux_done);
+
+  for (int i = 0; i < tsz; i++)
   {
+    hashlist_thread_param_t *param = threads_param + i;
+
+    param->tid               = i;
+    param->tsz               = tsz;
+    param->hashcat_ctx       = hashcat_ctx;
+    param->hashlist_format   = hashlist_format;
+    param->map               = fp->mfp;
+    param->chunks_off        = chunks_off;
+    param->chunks_line       = chunks_line;
+    param->chunks_cnt        = chunks_cnt;
+    param->slots_per_line    = slots_per_line;
+    param->lines_parsed      = lines_parsed;
+    param->chunks_errors     = chunks_errors;
+    param->chunks_errors_cnt = chunks_errors_cnt;
+    param->chunks_done       = chunks_done;
+    param->mux_done          = &mux_done;
+
+    hc_thread_create (c_threads[i], hashes_parse_thread, param);
   }
-  else
+
+  hash_t *hashes_buf = hashes->hashes_buf;
+
+  time_t prev = 0;
+  time_t now  = 0;
+
+  for (u64 chunk = 0; chunk < chunks_cnt; chunk++)
   {
-    if (hashlist_mode == HL_MODE_ARG)
+    while (true)
     {
-      char *input_buf = user_options_extra->hc_hash;
+      hc_thread_mutex_lock (mux_done);
 
-      size_t input_len = strlen (input_buf);
+      const bool done = chunks_done[chunk];
 
-      char  *hash_buf = NULL;
-      int    hash_len = 0;
+      hc_thread_mutex_unlock (mux_done);
 
-      hlfmt_hash (hashcat_ctx, hashlist_format, input_buf, input_len, &hash_buf, &hash_len);
+      if (done == true) break;
 
-      bool hash_fmt_error = false;
+      usleep (1000);
 
-      if (hash_len < 1)     hash_fmt_error = true;
-      if (hash_buf == NULL) hash_fmt_error = true;
+      time (&now);
 
-      if (hash_fmt_error)
+      if ((now - prev) == 0) continue;
+
+      time (&prev);
+
+      hashlist_parse_t hashlist_parse;
+
+      hashlist_parse.hashes_cnt   = *hashes_cnt;
+      hashlist_parse.hashes_avail = hashes_avail;
+
+      EVENT_DATA (EVENT_HASHLIST_PARSE_HASH, &hashlist_parse, sizeof (hashlist_parse_t));
+    }
+
+    hashlist_parse_error_t *errors = chunks_errors[chunk];
+
+    for (u64 errors_pos = 0; errors_pos < chunks_errors_cnt[chunk]; errors_pos++)
+    {
+      hashlist_parse_error_t *error = errors + errors_pos;
+
+      if (error->fmt_error == true)
       {
         event_log_warning (hashcat_ctx, "Failed to parse hashes using the '%s' format.", strhlfmt (hashlist_format));
       }
       else
       {
-        if (hashconfig->opts_type & OPTS_TYPE_HASH_COPY)
-        {
-          hashinfo_t *hash_info_tmp = hashes_buf[hashes_cnt].hash_info;
+        hashes_parse_error (hashcat_ctx, error->line_buf, error->line_num, error->parser_status);
 
-          hash_info_tmp->orighash = hcstrdup (hash_buf);
-        }
+        hcfree (error->line_buf);
+      }
+    }
 
-        if (hashconfig->is_salted == true)
-        {
-          memset (hashes_buf[0].salt, 0, sizeof (salt_t));
-        }
+    hcfree (errors);
 
-        if (hashconfig->esalt_size > 0)
-        {
-          memset (hashes_buf[0].esalt, 0, hashconfig->esalt_size);
-        }
+    // the slots of this and all previous chunks are no longer used by the threads
 
-        if (hashconfig->hook_salt_size > 0)
-        {
-          memset (hashes_buf[0].hook_salt, 0, hashconfig->hook_salt_size);
-        }
+    for (u64 line = chunks_line[chunk]; line < chunks_line[chunk + 1]; line++)
+    {
+      for (u64 i = 0; i < lines_parsed[line]; i++)
+      {
+        const u64 slot = (line * slots_per_line) + i;
 
-        int parser_status = PARSER_OK;
+        if (slot != *hashes_cnt) hashes_move (hashconfig, &hashes_buf[*hashes_cnt], &hashes_buf[slot]);
 
-        if (user_options->username == true)
-        {
-          char *user_buf = NULL;
-          int   user_len = 0;
+        *hashes_cnt = *hashes_cnt + 1;
+      }
+    }
+  }
 
-          hlfmt_user (hashcat_ctx, hashlist_format, input_buf, input_len, &user_buf, &user_len);
+  hc_thread_wait (tsz, c_threads);
 
-          // special case:
-          // both hash_t need to have the username info if the pwdump format is used (i.e. we have 2 hashes for 3000, both with same user)
+  hc_thread_mutex_delete (mux_done);
 
-          u32 hashes_per_user = 1;
+  hcfree (chunks_done);
+  hcfree (chunks_errors_cnt);
+  hcfree (chunks_errors);
+  hcfree (lines_parsed);
+  hcfree (chunks_line);
+  hcfree (chunks_off);
+  hcfree (c_threads);
+  hcfree (threads_param);
 
-          if (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT)
-          {
-            // the following conditions should be true if (hashlist_format == HLFMT_PWDUMP)
+  // everything has been read, leave nothing for the serial loop
 
-            if (hash_len == 32)
-            {
-              hashes_per_user = 2;
-            }
-          }
+  hc_fseek (fp, 0, SEEK_END);
 
-          for (u32 i = 0; i < hashes_per_user; i++)
-          {
-            user_t **user = &hashes_buf[hashes_cnt + i].hash_info->user;
+  return 0;
+}
 
-            *user = (user_t *) hcmalloc (sizeof (user_t));
+int hashes_init_stage1 (hashcat_ctx_t *hashcat_ctx)
+{
+  hashconfig_t          *hashconfig         = hashcat_ctx->hashconfig;
+  hashes_t              *hashes             = hashcat_ctx->hashes;
+  module_ctx_t          *module_ctx         = hashcat_ctx->module_ctx;
+  user_options_t        *user_options       = hashcat_ctx->user_options;
+  user_options_extra_t  *user_options_extra = hashcat_ctx->user_options_extra;
 
-            user_t *user_ptr = *user;
+  /**
+   * load hashes, part I: find input mode, count hashes
+   */
 
-            if (user_buf != NULL)
-            {
-              user_ptr->user_name = hcstrdup (user_buf);
-            }
-            else
-            {
-              user_ptr->user_name = hcstrdup ("");
-            }
+  const char *hashfile      = hashes->hashfile;
+  const u32   hashlist_mode = hashes->hashlist_mode;
 
-            user_ptr->user_len = (u32) user_len;
-          }
-        }
+  u32 hashlist_format = HLFMT_HASHCAT;
 
-        if (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT)
-        {
-          if (hash_len == 32)
-          {
-            hash_t *hash;
+  u64 hashes_avail = 0;
 
-            hash = &hashes_buf[hashes_cnt];
+  if ((user_options->benchmark == false) && (user_options->stdout_flag == false) && (user_options->keyspace == false))
+  {
+    if (hashlist_mode == HL_MODE_ARG)
+    {
+      hashes_avail = 1;
+    }
+    else if (hashlist_mode == HL_MODE_FILE_PLAIN)
+    {
+      HCFILE fp;
 
-            parser_status = module_ctx->module_hash_decode (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, hash_buf +  0, 16);
+      if (hc_fopen (&fp, hashfile, "rb") == false)
+      {
+        event_log_error (hashcat_ctx, "%s: %s", hashfile, strerror (errno));
 
-            if (parser_status == PARSER_OK)
-            {
-              if (module_ctx->module_hash_decode_postprocess != MODULE_DEFAULT)
-              {
-                parser_status = module_ctx->module_hash_decode_postprocess (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, user_options, user_options_extra);
+        return -1;
+      }
 
-                if (parser_status == PARSER_OK)
-                {
-                  // nothing to do
-                }
-                else
-                {
-                  event_log_warning (hashcat_ctx, "Hash '%s': %s", input_buf, strparser (parser_status));
-                }
-              }
+      EVENT_DATA (EVENT_HASHLIST_COUNT_LINES_PRE, hashfile, strlen (hashfile));
 
-              hashes_buf[hashes_cnt].hash_info->split->split_group  = 0;
-              hashes_buf[hashes_cnt].hash_info->split->split_origin = SPLIT_ORIGIN_LEFT;
+      hc_fmap (&fp);
 
-              hashes_cnt++;
-            }
-            else
-            {
-              event_log_warning (hashcat_ctx, "Hash '%s': %s", input_buf, strparser (parser_status));
-            }
+      hashes_avail = count_lines (&fp);
 
-            if (parser_status == PARSER_TOKEN_LENGTH)
-            {
-              hashes->parser_token_length_cnt++;
-            }
+      EVENT_DATA (EVENT_HASHLIST_COUNT_LINES_POST, hashfile, strlen (hashfile));
 
-            hash = &hashes_buf[hashes_cnt];
+      hc_rewind (&fp);
 
-            parser_status = module_ctx->module_hash_decode (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, hash_buf + 16, 16);
+      if (hashes_avail == 0)
+      {
+        event_log_error (hashcat_ctx, "hashfile is empty or corrupt.");
 
-            if (parser_status == PARSER_OK)
-            {
-              if (module_ctx->module_hash_decode_postprocess != MODULE_DEFAULT)
-              {
-                parser_status = module_ctx->module_hash_decode_postprocess (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, user_options, user_options_extra);
+        hc_fclose (&fp);
 
-                if (parser_status == PARSER_OK)
-                {
-                  // nothing to do
-                }
-                else
-                {
-                  event_log_warning (hashcat_ctx, "Hash '%s': %s", input_buf, strparser (parser_status));
-                }
-              }
+        return -1;
+      }
 
-              hashes_buf[hashes_cnt].hash_info->split->split_group  = 0;
-              hashes_buf[hashes_cnt].hash_info->split->split_origin = SPLIT_ORIGIN_RIGHT;
+      hashlist_format = hlfmt_detect (hashcat_ctx, &fp, 100); // 100 = max numbers to "scan". could be hashes_avail, too
 
-              hashes_cnt++;
-            }
-            else
-            {
-              event_log_warning (hashcat_ctx, "Hash '%s': %s", input_buf, strparser (parser_status));
-            }
+      hc_fclose (&fp);
 
-            if (parser_status == PARSER_TOKEN_LENGTH)
-            {
-              hashes->parser_token_length_cnt++;
-            }
-          }
-          else
-          {
-            hash_t *hash = &hashes_buf[hashes_cnt];
+      if ((user_options->remove == true) && (hashlist_format != HLFMT_HASHCAT))
+      {
+        event_log_error (hashcat_ctx, "Use of --remove is not supported in native hashfile-format mode.");
 
-            parser_status = module_ctx->module_hash_decode (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, hash_buf, hash_len);
+        return -1;
+      }
+    }
+    else if (hashlist_mode == HL_MODE_FILE_BINARY)
+    {
+      struct stat st;
+
+      if (stat (hashes->hashfile, &st) == -1)
+      {
+        event_log_error (hashcat_ctx, "%s: %s", hashes->hashfile, strerror (errno));
+
+        return -1;
+      }
+
+      if (module_ctx->module_hash_binary_count != MODULE_DEFAULT)
+      {
+        const int binary_count = module_ctx->module_hash_binary_count (hashes);
+
+        if (binary_count > 0)
+        {
+          hashes_avail = binary_count;
+        }
+        else if (binary_count == 0)
+        {
+          event_log_error (hashcat_ctx, "No hashes loaded.");
+
+          return -1;
+        }
+        else if (binary_count == PARSER_HAVE_ERRNO)
+        {
+          event_log_error (hashcat_ctx, "%s: %s", hashes->hashfile, strerror (errno));
+
+          return -1;
+        }
+        else
+        {
+          event_log_error (hashcat_ctx, "%s: %s", hashes->hashfile, strerror (binary_count));
+
+          return -1;
+        }
+      }
+      else
+      {
+        hashes_avail = 1;
+      }
+    }
+  }
+  else
+  {
+    hashes_avail = 1;
+  }
+
+  if (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT) hashes_avail *= 2;
+
+  hashes->hashlist_format = hashlist_format;
+
+  /**
+   * load hashes, part II: allocate required memory, set pointers
+   */
+
+  hash_t *hashes_buf     = (hash_t *) hccalloc (hashes_avail, sizeof (hash_t));
+  void   *digests_buf    =            hccalloc (hashes_avail, hashconfig->dgst_size);
+  salt_t *salts_buf      = NULL;
+  void   *esalts_buf     = NULL;
+  void   *hook_salts_buf = NULL;
+
+  if ((user_options->dynamic_x == true) || (user_options->username == true) || (hashconfig->opts_type & OPTS_TYPE_HASH_COPY) || (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT))
+  {
+    u64 hash_pos;
 
-            if (parser_status == PARSER_OK)
-            {
-              if (module_ctx->module_hash_decode_postprocess != MODULE_DEFAULT)
-              {
-                parser_status = module_ctx->module_hash_decode_postprocess (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, user_options, user_options_extra);
+    for (hash_pos = 0; hash_pos < hashes_avail; hash_pos++)
+    {
+      hashinfo_t *hash_info = (hashinfo_t *) hcmalloc (sizeof (hashinfo_t));
 
-                if (parser_status == PARSER_OK)
-                {
-                  // nothing to do
-                }
-                else
-                {
-                  event_log_warning (hashcat_ctx, "Hash '%s': %s", input_buf, strparser (parser_status));
-                }
-              }
+      hashes_buf[hash_pos].hash_info = hash_info;
 
-              hashes_buf[hashes_cnt].hash_info->split->split_group  = 0;
-              hashes_buf[hashes_cnt].hash_info->split->split_origin = SPLIT_ORIGIN_NONE;
+      if (user_options->dynamic_x == true)
+      {
+        hash_info->dynamicx = (dynamicx_t *) hcmalloc (sizeof (dynamicx_t));
+      }
 
-              hashes_cnt++;
-            }
-            else
-            {
-              event_log_warning (hashcat_ctx, "Hash '%s': %s", input_buf, strparser (parser_status));
-            }
+      if (user_options->username == true)
+      {
+        hash_info->user = (user_t *) hcmalloc (sizeof (user_t));
+      }
 
-            if (parser_status == PARSER_TOKEN_LENGTH)
-            {
-              hashes->parser_token_length_cnt++;
-            }
-          }
-        }
-        else
+      if (hashconfig->opts_type & OPTS_TYPE_HASH_COPY)
+      {
+        if (user_options->benchmark == false)
         {
-          hash_t *hash = &hashes_buf[hashes_cnt];
+          hash_info->orighash = (char *) hcmalloc (256);
+        }
+      }
 
-          parser_status = module_ctx->module_hash_decode (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, hash_buf, hash_len);
+      if (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT)
+      {
+        hash_info->split = (split_t *) hcmalloc (sizeof (split_t));
+      }
+    }
+  }
 
-          if (parser_status == PARSER_OK)
-          {
-            if (module_ctx->module_hash_decode_postprocess != MODULE_DEFAULT)
-            {
-              parser_status = module_ctx->module_hash_decode_postprocess (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, user_options, user_options_extra);
+  if (hashconfig->is_salted == true)
+  {
+    salts_buf = (salt_t *) hccalloc (hashes_avail, sizeof (salt_t));
 
-              if (parser_status == PARSER_OK)
-              {
-                // nothing to do
-              }
-              else
-              {
-                event_log_warning (hashcat_ctx, "Hash '%s': %s", input_buf, strparser (parser_status));
-              }
-            }
+    if (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
+    {
+      // this disables:
+      // - sorting by salt value
+      // - grouping by salt value
+      // - keep the salt in position relative to hashfile (not equal because of some hashes maybe failed to load)
 
-            hashes_cnt++;
-          }
-          else
-          {
-            event_log_warning (hashcat_ctx, "Hash '%s': %s", input_buf, strparser (parser_status));
-          }
+      u64 hash_pos;
 
-          if (parser_status == PARSER_TOKEN_LENGTH)
-          {
-            hashes->parser_token_length_cnt++;
-          }
-        }
+      for (hash_pos = 0; hash_pos < hashes_avail; hash_pos++)
+      {
+        salt_t *salt = &salts_buf[hash_pos];
+
+        salt->orig_pos = hash_pos;
       }
     }
-    else if (hashlist_mode == HL_MODE_FILE_PLAIN)
+
+    if (hashconfig->esalt_size > 0)
     {
-      HCFILE fp;
+      esalts_buf = hccalloc (hashes_avail, hashconfig->esalt_size);
+    }
 
-      if (hc_fopen (&fp, hashfile, "rb") == false)
+    if (hashconfig->hook_salt_size > 0)
+    {
+      hook_salts_buf = hccalloc (hashes_avail, hashconfig->hook_salt_size);
+    }
+  }
+  else
+  {
+    salts_buf = (salt_t *) hccalloc (1, sizeof (salt_t));
+  }
+
+  for (u64 hash_pos = 0; hash_pos < hashes_avail; hash_pos++)
+  {
+    /**
+     * Initialize some values for later use
+     */
+
+    hashes_buf[hash_pos].orig_line_pos = hash_pos;
+
+    hashes_buf[hash_pos].digest = ((char *) digests_buf) + (hash_pos * hashconfig->dgst_size);
+
+    if (hashconfig->is_salted == true)
+    {
+      hashes_buf[hash_pos].salt = &salts_buf[hash_pos];
+
+      if (hashconfig->esalt_size > 0)
       {
-        event_log_error (hashcat_ctx, "%s: %s", hashfile, strerror (errno));
+        hashes_buf[hash_pos].esalt = ((char *) esalts_buf) + (hash_pos * hashconfig->esalt_size);
+      }
 
-        return -1;
+      if (hashconfig->hook_salt_size > 0)
+      {
+        hashes_buf[hash_pos].hook_salt = ((char *) hook_salts_buf) + (hash_pos * hashconfig->hook_salt_size);
       }
+    }
+    else
+    {
+      hashes_buf[hash_pos].salt = &salts_buf[0];
+    }
+  }
 
-      u32 line_num = 0;
+  hashes->hashes_buf     = hashes_buf;
+  hashes->digests_buf    = digests_buf;
+  hashes->salts_buf      = salts_buf;
+  hashes->esalts_buf     = esalts_buf;
+  hashes->hook_salts_buf = hook_salts_buf;
 
-      char *line_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
+  /**
+   * load hashes, part III: parse hashes
+   */
 
-      time_t prev = 0;
-      time_t now  = 0;
+  u32 hashes_cnt = 0;
 
-      while (!hc_feof (&fp))
-      {
-        line_num++;
+  if (user_options->benchmark == true)
+  {
+    hashes->hashfile = "-";
+
+    hashes_cnt = 1;
+  }
+  else if (user_options->hash_info > 0)
+  {
+  }
+  else if (user_options->keyspace == true)
+  {
+  }
+  else if (user_options->stdout_flag == true)
+  {
+  }
+  else if (user_options->backend_info > 0)
+  {
+  }
+  else
+  {
+    if (hashlist_mode == HL_MODE_ARG)
+    {
+      char *input_buf = user_options_extra->hc_hash;
 
-        const size_t line_len = fgetl (&fp, line_buf, HCBUFSIZ_LARGE);
+      size_t input_len = strlen (input_buf);
 
-        if (line_len == 0) continue;
+      char  *hash_buf = NULL;
+      int    hash_len = 0;
 
-        if (hashes_avail == hashes_cnt)
-        {
-          event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u: File changed during runtime. Skipping new data.", hashes->hashfile, line_num);
+      hlfmt_hash (hashcat_ctx, hashlist_format, input_buf, input_len, &hash_buf, &hash_len);
 
-          break;
-        }
+      bool hash_fmt_error = false;
 
-        char *hash_buf = NULL;
-        int   hash_len = 0;
+      if (hash_len < 1)     hash_fmt_error = true;
+      if (hash_buf == NULL) hash_fmt_error = true;
 
-        hlfmt_hash (hashcat_ctx, hashlist_format, line_buf, line_len, &hash_buf, &hash_len);
+      if (hash_fmt_error)
+      {
+        event_log_warning (hashcat_ctx, "Failed to parse hashes using the '%s' format.", strhlfmt (hashlist_format));
+      }
+      else
+      {
+        if (hashconfig->opts_type & OPTS_TYPE_HASH_COPY)
+        {
+          hashinfo_t *hash_info_tmp = hashes_buf[hashes_cnt].hash_info;
 
-        bool hash_fmt_error = false;
+          hash_info_tmp->orighash = hcstrdup (hash_buf);
+        }
 
-        if (hash_len < 1)     hash_fmt_error = true;
-        if (hash_buf == NULL) hash_fmt_error = true;
+        if (hashconfig->is_salted == true)
+        {
+          memset (hashes_buf[0].salt, 0, sizeof (salt_t));
+        }
 
-        if (hash_fmt_error)
+        if (hashconfig->esalt_size > 0)
         {
-          event_log_warning (hashcat_ctx, "Failed to parse hashes using the '%s' format.", strhlfmt (hashlist_format));
+          memset (hashes_buf[0].esalt, 0, hashconfig->esalt_size);
+        }
 
-          continue;
+        if (hashconfig->hook_salt_size > 0)
+        {
+          memset (hashes_buf[0].hook_salt, 0, hashconfig->hook_salt_size);
         }
 
+        int parser_status = PARSER_OK;
+
         if (user_options->username == true)
         {
           char *user_buf = NULL;
           int   user_len = 0;
 
-          hlfmt_user (hashcat_ctx, hashlist_format, line_buf, line_len, &user_buf, &user_len);
+          hlfmt_user (hashcat_ctx, hashlist_format, input_buf, input_len, &user_buf, &user_len);
 
           // special case:
           // both hash_t need to have the username info if the pwdump format is used (i.e. we have 2 hashes for 3000, both with same user)
@@ -1479,282 +1895,219 @@ int hashes_init_stage1 (hashcat_ctx_t *hashcat_ctx)
           }
         }
 
-        if (hashconfig->opts_type & OPTS_TYPE_HASH_COPY)
-        {
-          hashinfo_t *hash_info_tmp = hashes_buf[hashes_cnt].hash_info;
-
-          hash_info_tmp->orighash = hcstrdup (hash_buf);
-        }
-
-        if (hashconfig->is_salted == true)
-        {
-          const u32 orig_pos = hashes_buf[hashes_cnt].salt->orig_pos;
-
-          memset (hashes_buf[hashes_cnt].salt, 0, sizeof (salt_t));
-
-          hashes_buf[hashes_cnt].salt->orig_pos = orig_pos;
-        }
-
-        if (hashconfig->esalt_size > 0)
-        {
-          memset (hashes_buf[hashes_cnt].esalt, 0, hashconfig->esalt_size);
-        }
-
-        if (hashconfig->hook_salt_size > 0)
-        {
-          memset (hashes_buf[hashes_cnt].hook_salt, 0, hashconfig->hook_salt_size);
-        }
-
-        if (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT)
-        {
-          if (hash_len == 32)
-          {
-            hash_t *hash;
-
-            hash = &hashes_buf[hashes_cnt];
-
-            int parser_status = module_ctx->module_hash_decode (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, hash_buf +  0, 16);
-
-            if (parser_status < PARSER_GLOBAL_ZERO)
-            {
-              char *tmp_line_buf;
-
-              hc_asprintf (&tmp_line_buf, "%s", line_buf);
-
-              compress_terminal_line_length (tmp_line_buf, 38, 32);
-
-              if (user_options->machine_readable == true)
-              {
-                event_log_warning (hashcat_ctx, "%s:%u:%s:%s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
-              }
-              else
-              {
-                event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u (%s): %s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
-              }
-
-              hcfree (tmp_line_buf);
+        if (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT)
+        {
+          if (hash_len == 32)
+          {
+            hash_t *hash;
 
-              continue;
-            }
+            hash = &hashes_buf[hashes_cnt];
 
-            if (module_ctx->module_hash_decode_postprocess != MODULE_DEFAULT)
-            {
-              int parser_status_postprocess = module_ctx->module_hash_decode_postprocess (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, user_options, user_options_extra);
+            parser_status = module_ctx->module_hash_decode (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, hash_buf +  0, 16);
 
-              if (parser_status_postprocess < PARSER_GLOBAL_ZERO)
+            if (parser_status == PARSER_OK)
+            {
+              if (module_ctx->module_hash_decode_postprocess != MODULE_DEFAULT)
               {
-                char *tmp_line_buf;
-
-                hc_asprintf (&tmp_line_buf, "%s", line_buf);
-
-                compress_terminal_line_length (tmp_line_buf, 38, 32);
+                parser_status = module_ctx->module_hash_decode_postprocess (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, user_options, user_options_extra);
 
-                if (user_options->machine_readable == true)
+                if (parser_status == PARSER_OK)
                 {
-                  event_log_warning (hashcat_ctx, "%s:%u:%s:%s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status_postprocess));
+                  // nothing to do
                 }
                 else
                 {
-                  event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u (%s): %s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status_postprocess));
+                  event_log_warning (hashcat_ctx, "Hash '%s': %s", input_buf, strparser (parser_status));
                 }
+              }
 
-                hcfree (tmp_line_buf);
+              hashes_buf[hashes_cnt].hash_info->split->split_group  = 0;
+              hashes_buf[hashes_cnt].hash_info->split->split_origin = SPLIT_ORIGIN_LEFT;
 
-                continue;
-              }
+              hashes_cnt++;
+            }
+            else
+            {
+              event_log_warning (hashcat_ctx, "Hash '%s': %s", input_buf, strparser (parser_status));
             }
 
-            hashes_buf[hashes_cnt].hash_info->split->split_group  = line_num;
-            hashes_buf[hashes_cnt].hash_info->split->split_origin = SPLIT_ORIGIN_LEFT;
-
-            hashes_cnt++;
+            if (parser_status == PARSER_TOKEN_LENGTH)
+            {
+              hashes->parser_token_length_cnt++;
+            }
 
             hash = &hashes_buf[hashes_cnt];
 
             parser_status = module_ctx->module_hash_decode (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, hash_buf + 16, 16);
 
-            if (parser_status < PARSER_GLOBAL_ZERO)
+            if (parser_status == PARSER_OK)
             {
-              char *tmp_line_buf;
-
-              hc_asprintf (&tmp_line_buf, "%s", line_buf);
-
-              compress_terminal_line_length (tmp_line_buf, 38, 32);
-
-              if (user_options->machine_readable == true)
-              {
-                event_log_warning (hashcat_ctx, "%s:%u:%s:%s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
-              }
-              else
+              if (module_ctx->module_hash_decode_postprocess != MODULE_DEFAULT)
               {
-                event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u (%s): %s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
+                parser_status = module_ctx->module_hash_decode_postprocess (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, user_options, user_options_extra);
+
+                if (parser_status == PARSER_OK)
+                {
+                  // nothing to do
+                }
+                else
+                {
+                  event_log_warning (hashcat_ctx, "Hash '%s': %s", input_buf, strparser (parser_status));
+                }
               }
 
-              hcfree (tmp_line_buf);
+              hashes_buf[hashes_cnt].hash_info->split->split_group  = 0;
+              hashes_buf[hashes_cnt].hash_info->split->split_origin = SPLIT_ORIGIN_RIGHT;
 
-              continue;
+              hashes_cnt++;
             }
-
-            if (module_ctx->module_hash_decode_postprocess != MODULE_DEFAULT)
+            else
             {
-              int parser_status_postprocess = module_ctx->module_hash_decode_postprocess (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, user_options, user_options_extra);
+              event_log_warning (hashcat_ctx, "Hash '%s': %s", input_buf, strparser (parser_status));
+            }
 
-              if (parser_status_postprocess < PARSER_GLOBAL_ZERO)
-              {
-                char *tmp_line_buf;
+            if (parser_status == PARSER_TOKEN_LENGTH)
+            {
+              hashes->parser_token_length_cnt++;
+            }
+          }
+          else
+          {
+            hash_t *hash = &hashes_buf[hashes_cnt];
 
-                hc_asprintf (&tmp_line_buf, "%s", line_buf);
+            parser_status = module_ctx->module_hash_decode (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, hash_buf, hash_len);
 
-                compress_terminal_line_length (tmp_line_buf, 38, 32);
+            if (parser_status == PARSER_OK)
+            {
+              if (module_ctx->module_hash_decode_postprocess != MODULE_DEFAULT)
+              {
+                parser_status = module_ctx->module_hash_decode_postprocess (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, user_options, user_options_extra);
 
-                if (user_options->machine_readable == true)
+                if (parser_status == PARSER_OK)
                 {
-                  event_log_warning (hashcat_ctx, "%s:%u:%s:%s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status_postprocess));
+                  // nothing to do
                 }
                 else
                 {
-                  event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u (%s): %s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status_postprocess));
+                  event_log_warning (hashcat_ctx, "Hash '%s': %s", input_buf, strparser (parser_status));
                 }
+              }
 
-                hcfree (tmp_line_buf);
+              hashes_buf[hashes_cnt].hash_info->split->split_group  = 0;
+              hashes_buf[hashes_cnt].hash_info->split->split_origin = SPLIT_ORIGIN_NONE;
 
-                continue;
-              }
+              hashes_cnt++;
+            }
+            else
+            {
+              event_log_warning (hashcat_ctx, "Hash '%s': %s", input_buf, strparser (parser_status));
             }
 
-            hashes_buf[hashes_cnt].hash_info->split->split_group  = line_num;
-            hashes_buf[hashes_cnt].hash_info->split->split_origin = SPLIT_ORIGIN_RIGHT;
-
-            hashes_cnt++;
+            if (parser_status == PARSER_TOKEN_LENGTH)
+            {
+              hashes->parser_token_length_cnt++;
+            }
           }
-          else
-          {
-            hash_t *hash = &hashes_buf[hashes_cnt];
+        }
+        else
+        {
+          hash_t *hash = &hashes_buf[hashes_cnt];
 
-            int parser_status = module_ctx->module_hash_decode (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, hash_buf, hash_len);
+          parser_status = module_ctx->module_hash_decode (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, hash_buf, hash_len);
 
-            if (parser_status < PARSER_GLOBAL_ZERO)
+          if (parser_status == PARSER_OK)
+          {
+            if (module_ctx->module_hash_decode_postprocess != MODULE_DEFAULT)
             {
-              char *tmp_line_buf;
-
-              hc_asprintf (&tmp_line_buf, "%s", line_buf);
-
-              compress_terminal_line_length (tmp_line_buf, 38, 32);
+              parser_status = module_ctx->module_hash_decode_postprocess (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, user_options, user_options_extra);
 
-              if (user_options->machine_readable == true)
+              if (parser_status == PARSER_OK)
               {
-                event_log_warning (hashcat_ctx, "%s:%u:%s:%s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
+                // nothing to do
               }
               else
               {
-                event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u (%s): %s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
+                event_log_warning (hashcat_ctx, "Hash '%s': %s", input_buf, strparser (parser_status));
               }
-
-              hcfree (tmp_line_buf);
-
-              continue;
             }
 
-            if (module_ctx->module_hash_decode_postprocess != MODULE_DEFAULT)
-            {
-              int parser_status_postprocess = module_ctx->module_hash_decode_postprocess (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, user_options, user_options_extra);
-
-              if (parser_status_postprocess < PARSER_GLOBAL_ZERO)
-              {
-                char *tmp_line_buf;
-
-                hc_asprintf (&tmp_line_buf, "%s", line_buf);
+            hashes_cnt++;
+          }
+          else
+          {
+            event_log_warning (hashcat_ctx, "Hash '%s': %s", input_buf, strparser (parser_status));
+          }
 
-                compress_terminal_line_length (tmp_line_buf, 38, 32);
+          if (parser_status == PARSER_TOKEN_LENGTH)
+          {
+            hashes->parser_token_length_cnt++;
+          }
+        }
+      }
+    }
+    else if (hashlist_mode == HL_MODE_FILE_PLAIN)
+    {
+      HCFILE fp;
 
-                if (user_options->machine_readable == true)
-                {
-                  event_log_warning (hashcat_ctx, "%s:%u:%s:%s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status_postprocess));
-                }
-                else
-                {
-                  event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u (%s): %s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status_postprocess));
-                }
+      if (hc_fopen (&fp, hashfile, "rb") == false)
+      {
+        event_log_error (hashcat_ctx, "%s: %s", hashfile, strerror (errno));
 
-                hcfree (tmp_line_buf);
+        return -1;
+      }
 
-                continue;
-              }
-            }
+      u32 line_num = 0;
 
-            hashes_buf[hashes_cnt].hash_info->split->split_group  = line_num;
-            hashes_buf[hashes_cnt].hash_info->split->split_origin = SPLIT_ORIGIN_NONE;
+      time_t prev = 0;
+      time_t now  = 0;
 
-            hashes_cnt++;
-          }
-        }
-        else
-        {
-          hash_t *hash = &hashes_buf[hashes_cnt];
+      // large hashlists are decoded by a pool of threads, which leaves nothing to do for the loop below
 
-          int parser_status = module_ctx->module_hash_decode (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, hash_buf, hash_len);
+      hashes_parse_parallel (hashcat_ctx, &fp, hashlist_format, hashes_avail, &hashes_cnt);
 
-          if (parser_status < PARSER_GLOBAL_ZERO)
-          {
-            char *tmp_line_buf;
+      hc_line_reader_t lr;
 
-            hc_asprintf (&tmp_line_buf, "%s", line_buf);
+      hc_line_reader_init (&lr, &fp, HCBUFSIZ_LARGE);
 
-            compress_terminal_line_length (tmp_line_buf, 38, 32);
+      char  *line_buf = NULL;
+      size_t line_len = 0;
 
-            if (user_options->machine_readable == true)
-            {
-              event_log_warning (hashcat_ctx, "%s:%u:%s:%s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
-            }
-            else
-            {
-              event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u (%s): %s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
-            }
+      while (hc_line_reader_next (&lr, &line_buf, &line_len) == true)
+      {
+        line_num++;
 
-            hcfree (tmp_line_buf);
+        if (line_len == 0) continue;
 
-            if (parser_status == PARSER_TOKEN_LENGTH)
-            {
-              hashes->parser_token_length_cnt++;
-            }
+        if (hashes_avail == hashes_cnt)
+        {
+          event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u: File changed during runtime. Skipping new data.", hashes->hashfile, line_num);
 
-            continue;
-          }
+          break;
+        }
 
-          if (module_ctx->module_hash_decode_postprocess != MODULE_DEFAULT)
-          {
-            int parser_status_postprocess = module_ctx->module_hash_decode_postprocess (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, user_options, user_options_extra);
+        int parser_status = PARSER_OK;
 
-            if (parser_status_postprocess < PARSER_GLOBAL_ZERO)
-            {
-              char *tmp_line_buf;
+        const int parsed = hashes_parse_line (hashcat_ctx, hashlist_format, line_buf, line_len, line_num, &hashes_buf[hashes_cnt], &parser_status);
 
-              hc_asprintf (&tmp_line_buf, "%s", line_buf);
+        if (parsed == -1)
+        {
+          event_log_warning (hashcat_ctx, "Failed to parse hashes using the '%s' format.", strhlfmt (hashlist_format));
 
-              compress_terminal_line_length (tmp_line_buf, 38, 32);
+          continue;
+        }
 
-              if (user_options->machine_readable == true)
-              {
-                event_log_warning (hashcat_ctx, "%s:%u:%s:%s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status_postprocess));
-              }
-              else
-              {
-                event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u (%s): %s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status_postprocess));
-              }
+        if (parser_status < PARSER_GLOBAL_ZERO)
+        {
+          char *tmp_line_buf = hashes_parse_error_line (line_buf);
 
-              hcfree (tmp_line_buf);
+          hashes_parse_error (hashcat_ctx, tmp_line_buf, line_num, parser_status);
 
-              if (parser_status_postprocess == PARSER_TOKEN_LENGTH)
-              {
-                hashes->parser_token_length_cnt++;
-              }
+          hcfree (tmp_line_buf);
+        }
 
-              continue;
-            }
-          }
+        hashes_cnt += parsed;
 
-          hashes_cnt++;
-        }
+        if (parsed == 0) continue;
 
         time (&now);
 
@@ -1777,7 +2130,7 @@ int hashes_init_stage1 (hashcat_ctx_t *hashcat_ctx)
 
       EVENT_DATA (EVENT_HASHLIST_PARSE_HASH, &hashlist_parse, sizeof (hashlist_parse_t));
 
-      hcfree (line_buf);
+      hc_line_reader_destroy (&lr);
 
       hc_fclose (&fp);
     }
@@ -1877,7 +2230,7 @@ int hashes_init_stage1 (hashcat_ctx_t *hashcat_ctx)
     {
       hc_qsort_r (hashes_buf, hashes_cnt, sizeof (hash_t), sort_by_hash, (void *) hashconfig);
     }
-    else
+    else if (hashes_sort_radix (hashconfig, hashes_buf, hashes_cnt) == false)
     {
       hc_qsort_r (hashes_buf, hashes_cnt, sizeof (hash_t), sort_by_hash_no_salt, (void *) hashconfig);
     }
@@ -1889,6 +2242,36 @@ int hashes_init_stage1 (hashcat_ctx_t *hashcat_ctx)
   {
     // update split split_neighbor after sorting
     // see https://github.com/hashcat/hashcat/issues/1034 for good examples for testing
+    // split_group is the line number, so we can index the RIGHT halves by it instead of searching for them
+
+    int split_group_max = 0;
+
+    for (u32 i = 0; i < hashes_cnt; i++)
+    {
+      const split_t *split = hashes_buf[i].hash_info->split;
+
+      split_group_max = MAX (split_group_max, split->split_group);
+    }
+
+    u32 *split_right = (u32 *) hcmalloc (((size_t) split_group_max + 1) * sizeof (u32));
+
+    for (int split_group = 0; split_group <= split_group_max; split_group++)
+    {
+      split_right[split_group] = (u32) -1;
+    }
+
+    // keep the first RIGHT half of each group, just like a front to back search would find it
+
+    for (u32 j = 0; j < hashes_cnt; j++)
+    {
+      const split_t *split2 = hashes_buf[j].hash_info->split;
+
+      if (split2->split_origin != SPLIT_ORIGIN_RIGHT) continue;
+
+      if (split_right[split2->split_group] != (u32) -1) continue;
+
+      split_right[split2->split_group] = j;
+    }
 
     for (u32 i = 0; i < hashes_cnt; i++)
     {
@@ -1896,20 +2279,17 @@ int hashes_init_stage1 (hashcat_ctx_t *hashcat_ctx)
 
       if (split1->split_origin != SPLIT_ORIGIN_LEFT) continue;
 
-      for (u32 j = 0; j < hashes_cnt; j++)
-      {
-        split_t *split2 = hashes_buf[j].hash_info->split;
-
-        if (split2->split_origin != SPLIT_ORIGIN_RIGHT) continue;
+      const u32 j = split_right[split1->split_group];
 
-        if (split1->split_group != split2->split_group) continue;
+      if (j == (u32) -1) continue;
 
-        split1->split_neighbor = j;
-        split2->split_neighbor = i;
+      split_t *split2 = hashes_buf[j].hash_info->split;
 
-        break;
-      }
+      split1->split_neighbor = j;
+      split2->split_neighbor = i;
     }
+
+    hcfree (split_right);
   }
 
   if (hashes->parser_token_length_cnt > 0)
@@ -2625,6 +3005,80 @@ int hashes_init_benchmark (hashcat_ctx_t *hashcat_ctx)
   return 0;
 }
 
+// below DIGESTS_IDX_MIN the binary search stays in cache, DIGESTS_IDX_BITS_MAX limits the index to 64 MB
+
+#define DIGESTS_IDX_MIN      (1U << 12)
+#define DIGESTS_IDX_BITS_MAX 24
+
+int hashes_init_digests_idx (hashcat_ctx_t *hashcat_ctx)
+{
+  const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+        hashes_t       *hashes       = hashcat_ctx->hashes;
+  const user_options_t *user_options = hashcat_ctx->user_options;
+
+  hashes->digests_idx      = NULL;
+  hashes->digests_idx_bits = 0;
+
+  if (user_options->digests_index == false) return 0;
+
+  if (user_options->attack_mode == ATTACK_MODE_ASSOCIATION) return 0;
+
+  // the kernels search the digests of a salt at DIGESTS_OFFSET_HOST, the index is only valid for a single salt
+
+  if (hashes->salts_cnt != 1) return 0;
+
+  const u32 digests_cnt = hashes->digests_cnt;
+
+  if (digests_cnt < DIGESTS_IDX_MIN) return 0;
+
+  // about one to two digests per bucket, so a bitmap hit costs one or two dependent loads instead of log2 (digests_cnt)
+
+  u32 digests_idx_bits = 0;
+
+  while (((digests_cnt >> digests_idx_bits) > 1) && (digests_idx_bits < DIGESTS_IDX_BITS_MAX)) digests_idx_bits++;
+
+  const u32 buckets_cnt = 1U << digests_idx_bits;
+
+  const u32 dgst_size = hashconfig->dgst_size;
+  const u32 dgst_pos3 = hashconfig->dgst_pos3;
+
+  const u32 shift = 32 - digests_idx_bits;
+
+  const char *digests_buf_ptr = (const char *) hashes->digests_buf;
+
+  // entry k holds the position of the first digest with a bucket >= k, entry buckets_cnt holds digests_cnt
+  // the digests are sorted by DGST_R3 first (sort_by_digest_p0p1 ()), so the buckets are consecutive ranges
+
+  u32 *digests_idx = (u32 *) hcmalloc ((buckets_cnt + 1) * sizeof (u32));
+
+  u32 bucket = 0;
+
+  for (u32 digests_pos = 0; digests_pos < digests_cnt; digests_pos++)
+  {
+    const u32 *digest_ptr = (const u32 *) (digests_buf_ptr + ((u64) digests_pos * dgst_size));
+
+    const u32 k = digest_ptr[dgst_pos3] >> shift;
+
+    if (k + 1 < bucket)
+    {
+      // not sorted by DGST_R3, fall back to the binary search
+
+      hcfree (digests_idx);
+
+      return 0;
+    }
+
+    while (bucket <= k) digests_idx[bucket++] = digests_pos;
+  }
+
+  while (bucket <= buckets_cnt) digests_idx[bucket++] = digests_cnt;
+
+  hashes->digests_idx      = digests_idx;
+  hashes->digests_idx_bits = digests_idx_bits;
+
+  return 0;
+}
+
 int hashes_init_zerohash (hashcat_ctx_t *hashcat_ctx)
 {
   const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
@@ -2749,6 +3203,7 @@ void hashes_destroy (hashcat_ctx_t *hashcat_ctx)
 
   hcfree (hashes->digests_buf);
   hcfree (hashes->digests_shown);
+  hcfree (hashes->digests_idx);
 
   hcfree (hashes->salts_buf);
   hcfree (hashes->salts_shown);
@@ -533,7 +533,15 @@ static void main_outerloop_mainscreen (MAYBE_UNUSED hashcat_ctx_t *hashcat_ctx,
   if (user_options->quiet == true) return;
 
   event_log_info (hashcat_ctx, "Hashes: %u digests; %u unique digests, %u unique salts", hashes->hashes_cnt_orig, hashes->digests_cnt, hashes->salts_cnt);
-  event_log_info (hashcat_ctx, "Bitmaps: %u bits, %u entries, 0x%08x mask, %u bytes, %u/%u rotates", bitmap_ctx->bitmap_bits, bitmap_ctx->bitmap_nums, bitmap_ctx->bitmap_mask, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_shift1, bitmap_ctx->bitmap_shift2);
+
+  if (bitmap_ctx->bitmap_mode == 1)
+  {
+    event_log_info (hashcat_ctx, "Bitmaps: bloom filter, 8 x %u blocks, 0x%08x mask, %" PRIu64 " bytes, %.2e false positive rate", bitmap_ctx->bitmap_mask + 1, bitmap_ctx->bitmap_mask, (u64) bitmap_ctx->bitmap_size * 8, bitmap_ctx->bitmap_fpr);
+  }
+  else
+  {
+    event_log_info (hashcat_ctx, "Bitmaps: %u bits, %u entries, 0x%08x mask, %u bytes, %u/%u rotates", bitmap_ctx->bitmap_bits, bitmap_ctx->bitmap_nums, bitmap_ctx->bitmap_mask, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_shift1, bitmap_ctx->bitmap_shift2);
+  }
 
   if ((user_options->attack_mode == ATTACK_MODE_STRAIGHT) || (user_options->attack_mode == ATTACK_MODE_ASSOCIATION))
   {
@@ -714,6 +722,7 @@ static void main_bitmap_final_overflow (MAYBE_UNUSED hashcat_ctx_t *hashcat_ctx,
   event_log_advice (hashcat_ctx, "You can increase the bitmap table size with --bitmap-max, but");
   event_log_advice (hashcat_ctx, "this creates a trade-off between L2-cache and bitmap efficiency.");
   event_log_advice (hashcat_ctx, "It is therefore not guaranteed to restore full performance.");
+  event_log_advice (hashcat_ctx, "For large hashlists, try the bloom filter with --bitmap-bloom instead.");
   event_log_advice (hashcat_ctx, NULL);
 }
 
@@ -224,6 +224,26 @@ u32 module_deep_comp_kernel (MAYBE_UNUSED const hashes_t *hashes, MAYBE_UNUSED c
   return KERN_RUN_AUX1;
 }
 
+u64 module_potfile_custom_key (MAYBE_UNUSED const hashconfig_t *hashconfig, MAYBE_UNUSED const hash_t *hash)
+{
+  // module_potfile_custom_check () only accepts entries with the same ESSID, so that's what we bucket by
+
+  const wpa_pmkid_t *wpa_pmkid = (const wpa_pmkid_t *) hash->esalt;
+
+  const u8 *essid = (const u8 *) wpa_pmkid->essid_buf;
+
+  u64 key = wpa_pmkid->essid_len;
+
+  for (size_t i = 0; i < sizeof (wpa_pmkid->essid_buf); i++)
+  {
+    if (essid[i] == 0) break;
+
+    key = (key ^ essid[i]) * 0x100000001b3;
+  }
+
+  return key;
+}
+
 bool module_potfile_custom_check (MAYBE_UNUSED const hashconfig_t *hashconfig, MAYBE_UNUSED const hash_t *db, MAYBE_UNUSED const hash_t *entry_hash, MAYBE_UNUSED const void *entry_tmps)
 {
   const wpa_pmkid_t *wpa_pmkid_entry = (const wpa_pmkid_t *) entry_hash->esalt;
@@ -575,6 +595,7 @@ void module_init (module_ctx_t *module_ctx)
   module_ctx->module_outfile_check_disable    = MODULE_DEFAULT;
   module_ctx->module_outfile_check_nocomp     = MODULE_DEFAULT;
   module_ctx->module_potfile_custom_check     = module_potfile_custom_check;
+  module_ctx->module_potfile_custom_key       = module_potfile_custom_key;
   module_ctx->module_potfile_disable          = MODULE_DEFAULT;
   module_ctx->module_potfile_keep_all_hashes  = MODULE_DEFAULT;
   module_ctx->module_pwdump_column            = MODULE_DEFAULT;
@@ -511,6 +511,26 @@ u32 module_deep_comp_kernel (MAYBE_UNUSED const hashes_t *hashes, MAYBE_UNUSED c
   return 0;
 }
 
+u64 module_potfile_custom_key (MAYBE_UNUSED const hashconfig_t *hashconfig, MAYBE_UNUSED const hash_t *hash)
+{
+  // module_potfile_custom_check () only accepts entries with the same ESSID, so that's what we bucket by
+
+  const wpa_t *wpa = (const wpa_t *) hash->esalt;
+
+  const u8 *essid = (const u8 *) wpa->essid_buf;
+
+  u64 key = wpa->essid_len;
+
+  for (size_t i = 0; i < sizeof (wpa->essid_buf); i++)
+  {
+    if (essid[i] == 0) break;
+
+    key = (key ^ essid[i]) * 0x100000001b3;
+  }
+
+  return key;
+}
+
 bool module_potfile_custom_check (MAYBE_UNUSED const hashconfig_t *hashconfig, MAYBE_UNUSED const hash_t *db, MAYBE_UNUSED const hash_t *entry_hash, MAYBE_UNUSED const void *entry_tmps)
 {
   const wpa_t *wpa_entry = (const wpa_t *) entry_hash->esalt;
@@ -1395,6 +1415,7 @@ void module_init (module_ctx_t *module_ctx)
   module_ctx->module_outfile_check_disable    = MODULE_DEFAULT;
   module_ctx->module_outfile_check_nocomp     = MODULE_DEFAULT;
   module_ctx->module_potfile_custom_check     = module_potfile_custom_check;
+  module_ctx->module_potfile_custom_key       = module_potfile_custom_key;
   module_ctx->module_potfile_disable          = MODULE_DEFAULT;
   module_ctx->module_potfile_keep_all_hashes  = MODULE_DEFAULT;
   module_ctx->module_pwdump_column            = MODULE_DEFAULT;
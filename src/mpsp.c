@@ -1569,12 +1569,15 @@ int mask_ctx_init (hashcat_ctx_t *hashcat_ctx)
                 return -1;
               }
 
-              char *line_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
+              hc_line_reader_t lr;
 
-              while (!hc_feof (&mask_fp))
-              {
-                const size_t line_len = fgetl (&mask_fp, line_buf, HCBUFSIZ_LARGE);
+              hc_line_reader_init (&lr, &mask_fp, HCBUFSIZ_LARGE);
+
+              char  *line_buf = NULL;
+              size_t line_len = 0;
 
+              while (hc_line_reader_next (&lr, &line_buf, &line_len) == true)
+              {
                 if (line_len == 0) continue;
 
                 if (line_buf[0] == '#') continue;
@@ -1594,13 +1597,15 @@ int mask_ctx_init (hashcat_ctx_t *hashcat_ctx)
 
                 if (mask_append (hashcat_ctx, mask_buf, prepend_buf) == -1)
                 {
+                  hc_line_reader_destroy (&lr);
+
                   hc_fclose (&mask_fp);
 
                   return -1;
                 }
               }
 
-              hcfree (line_buf);
+              hc_line_reader_destroy (&lr);
 
               hc_fclose (&mask_fp);
             }
@@ -1654,12 +1659,15 @@ int mask_ctx_init (hashcat_ctx_t *hashcat_ctx)
           return -1;
         }
 
-        char *line_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
+        hc_line_reader_t lr;
 
-        while (!hc_feof (&mask_fp))
-        {
-          const size_t line_len = fgetl (&mask_fp, line_buf, HCBUFSIZ_LARGE);
+        hc_line_reader_init (&lr, &mask_fp, HCBUFSIZ_LARGE);
+
+        char  *line_buf = NULL;
+        size_t line_len = 0;
 
+        while (hc_line_reader_next (&lr, &line_buf, &line_len) == true)
+        {
           if (line_len == 0) continue;
 
           if (line_buf[0] == '#') continue;
@@ -1679,13 +1687,15 @@ int mask_ctx_init (hashcat_ctx_t *hashcat_ctx)
 
           if (mask_append (hashcat_ctx, mask_buf, prepend_buf) == -1)
           {
+            hc_line_reader_destroy (&lr);
+
             hc_fclose (&mask_fp);
 
             return -1;
           }
         }
 
-        hcfree (line_buf);
+        hc_line_reader_destroy (&lr);
 
         hc_fclose (&mask_fp);
       }
@@ -1724,12 +1734,15 @@ int mask_ctx_init (hashcat_ctx_t *hashcat_ctx)
           return -1;
         }
 
-        char *line_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
+        hc_line_reader_t lr;
 
-        while (!hc_feof (&mask_fp))
-        {
-          const size_t line_len = fgetl (&mask_fp, line_buf, HCBUFSIZ_LARGE);
+        hc_line_reader_init (&lr, &mask_fp, HCBUFSIZ_LARGE);
 
+        char  *line_buf = NULL;
+        size_t line_len = 0;
+
+        while (hc_line_reader_next (&lr, &line_buf, &line_len) == true)
+        {
           if (line_len == 0) continue;
 
           if (line_buf[0] == '#') continue;
@@ -1749,13 +1762,15 @@ int mask_ctx_init (hashcat_ctx_t *hashcat_ctx)
 
           if (mask_append (hashcat_ctx, mask_buf, prepend_buf) == -1)
           {
+            hc_line_reader_destroy (&lr);
+
             hc_fclose (&mask_fp);
 
             return -1;
           }
         }
 
-        hcfree (line_buf);
+        hc_line_reader_destroy (&lr);
 
         hc_fclose (&mask_fp);
       }
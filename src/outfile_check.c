@@ -178,23 +178,32 @@ static int outfile_remove (hashcat_ctx_t *hashcat_ctx)
 
       hc_fseek (&fp, out_info[j].seek, SEEK_SET);
 
-      char *line_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
+      hc_line_reader_t lr;
+
+      hc_line_reader_init (&lr, &fp, HCBUFSIZ_LARGE);
+
+      char *line_buf = (char *) hcmalloc (HCBUFSIZ_LARGE + 2); // line, fake separator and NUL
+
+      char  *lr_buf = NULL;
+      size_t line_len = 0;
 
       // large portion of the following code is the same as in potfile_remove_parse
       // maybe subject of a future optimization
 
-      while (!hc_feof (&fp))
+      while (hc_line_reader_next (&lr, &lr_buf, &line_len) == true)
       {
-        size_t line_len = fgetl (&fp, line_buf, HCBUFSIZ_LARGE);
-
         if (line_len == 0) continue;
 
         // this fake separator is used to enable loading outfiles without password
 
+        memcpy (line_buf, lr_buf, line_len);
+
         line_buf[line_len] = separator;
 
         line_len++;
 
+        line_buf[line_len] = 0;
+
         for (int tries = 0; tries < PW_MAX; tries++)
         {
           char *last_separator = strrchr (line_buf, separator);
@@ -292,7 +301,9 @@ static int outfile_remove (hashcat_ctx_t *hashcat_ctx)
 
       hcfree (line_buf);
 
-      out_info[j].seek = hc_ftell (&fp);
+      out_info[j].seek = hc_line_reader_tell (&lr);
+
+      hc_line_reader_destroy (&lr);
 
       //hc_thread_mutex_unlock (status_ctx->mux_display);
 
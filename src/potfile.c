@@ -14,6 +14,7 @@
 #include "outfile.h"
 #include "locking.h"
 #include "shared.h"
+#include "thread.h"
 #include "potfile.h"
 
 static const char MASKED_PLAIN[] = "[notfound]";
@@ -58,50 +59,131 @@ static int sort_by_hash_t_salt (const void *v1, const void *v2)
 }
 */
 
-// this function is special and only used whenever --username or --dynamic-x and --show are used together:
-// it will sort all tree entries according to the settings stored in hashconfig
+// the key of the potfile hash index is the same as the one compared by sort_by_hash (): digest at dgst_pos0...dgst_pos3 and the salt
+// salt->orig_pos is part of the comparison but not of the key, that is fine as equal keys only need equal hash values
 
-int sort_pot_tree_by_hash (const void *v1, const void *v2)
+static u64 pot_hash_mix (u64 h, const u64 v)
 {
-  const pot_tree_entry_t *t1 = (const pot_tree_entry_t *) v1;
-  const pot_tree_entry_t *t2 = (const pot_tree_entry_t *) v2;
+  h ^= v;
+  h *= 0x9e3779b97f4a7c15ULL;
+  h ^= h >> 29;
 
-  const hash_t *h1 = (const hash_t *) t1->nodes->hash_buf;
-  const hash_t *h2 = (const hash_t *) t2->nodes->hash_buf;
+  return h;
+}
 
-  hashconfig_t *hc = t1->hashconfig; // is same as t2->hashconfig
+static u64 pot_hash_key (const hashconfig_t *hashconfig, const hash_t *hash)
+{
+  const u32 *digest = (const u32 *) hash->digest;
 
-  return sort_by_hash (h1, h2, hc);
-}
+  u64 h = 0;
 
-// this function is used to reproduce the hash ordering based on the original input hash file
+  h = pot_hash_mix (h, ((u64) digest[hashconfig->dgst_pos0] << 32) | digest[hashconfig->dgst_pos1]);
+  h = pot_hash_mix (h, ((u64) digest[hashconfig->dgst_pos2] << 32) | digest[hashconfig->dgst_pos3]);
 
-int sort_pot_orig_line (const void *v1, const void *v2)
+  if (hashconfig->is_salted == true)
+  {
+    const salt_t *salt = hash->salt;
+
+    h = pot_hash_mix (h, ((u64) salt->salt_len << 32) | salt->salt_iter);
+
+    for (int n = 0; n < 16; n += 2)
+    {
+      h = pot_hash_mix (h, ((u64) salt->salt_buf[n] << 32) | salt->salt_buf[n + 1]);
+    }
+  }
+
+  return h;
+}
+
+void pot_hash_index_init (pot_hash_index_t *index, hash_t *hashes_buf, const u32 hashes_cnt, const hashconfig_t *hashconfig)
 {
-  const pot_orig_line_entry_t *t1 = (const pot_orig_line_entry_t *) v1;
-  const pot_orig_line_entry_t *t2 = (const pot_orig_line_entry_t *) v2;
+  // keep the load factor at or below 50% to keep the probe sequences short
 
-  if (t1->line_pos > t2->line_pos) return 1;
-  if (t1->line_pos < t2->line_pos) return -1;
+  u64 slots_cnt = 16;
 
-  return 0;
+  while (slots_cnt < ((u64) hashes_cnt * 2)) slots_cnt *= 2;
+
+  index->slots      = (u32 *) hccalloc (slots_cnt,      sizeof (u32));
+  index->next       = (u32 *) hccalloc (hashes_cnt + 1, sizeof (u32));
+  index->mask       = slots_cnt - 1;
+  index->hashes_buf = hashes_buf;
+  index->hashconfig = hashconfig;
+
+  for (u32 hash_pos = 0; hash_pos < hashes_cnt; hash_pos++)
+  {
+    const hash_t *hash = &hashes_buf[hash_pos];
+
+    u64 slot = pot_hash_key (hashconfig, hash) & index->mask;
+
+    while (index->slots[slot] != 0)
+    {
+      const u32 head = index->slots[slot] - 1;
+
+      if (sort_by_hash (hash, &hashes_buf[head], (void *) hashconfig) == 0) break;
+
+      slot = (slot + 1) & index->mask;
+    }
+
+    // we always insert the new hash at the very beginning of the chain
+
+    index->next[hash_pos] = index->slots[slot];
+
+    index->slots[slot] = hash_pos + 1;
+  }
 }
 
-// the problem with the GNU tdestroy () function is that it doesn't work with mingw etc
-// there are 2 alternatives:
-// 1. recursively delete the entries with entry->left and entry->right
-// 2. use tdelete () <- this is what we currently use, but this could be slower!
+void pot_hash_index_destroy (pot_hash_index_t *index)
+{
+  hcfree (index->slots);
+  hcfree (index->next);
+
+  index->slots = NULL;
+  index->next  = NULL;
+}
 
-void pot_tree_destroy (pot_tree_entry_t *tree)
+hash_t *pot_hash_index_find (const pot_hash_index_t *index, const hash_t *hash_buf)
 {
-  pot_tree_entry_t *entry = tree;
+  u64 slot = pot_hash_key (index->hashconfig, hash_buf) & index->mask;
 
-  while (tree != NULL)
+  while (index->slots[slot] != 0)
   {
-    entry = *(pot_tree_entry_t **) tree;
+    const hash_t *head = &index->hashes_buf[index->slots[slot] - 1];
+
+    if (sort_by_hash (hash_buf, head, (void *) index->hashconfig) == 0) return (hash_t *) head;
 
-    tdelete (entry, (void **) &tree, sort_pot_tree_by_hash);
+    slot = (slot + 1) & index->mask;
   }
+
+  return NULL;
+}
+
+// this function keeps hashes with the same module_potfile_custom_key () together, in hashes_buf order
+
+int sort_pot_custom_key (const void *v1, const void *v2)
+{
+  const pot_custom_key_t *k1 = (const pot_custom_key_t *) v1;
+  const pot_custom_key_t *k2 = (const pot_custom_key_t *) v2;
+
+  if (k1->key > k2->key) return 1;
+  if (k1->key < k2->key) return -1;
+
+  if (k1->hash_pos > k2->hash_pos) return 1;
+  if (k1->hash_pos < k2->hash_pos) return -1;
+
+  return 0;
+}
+
+// this function is used to reproduce the hash ordering based on the original input hash file
+
+int sort_pot_orig_line (const void *v1, const void *v2)
+{
+  const pot_orig_line_entry_t *t1 = (const pot_orig_line_entry_t *) v1;
+  const pot_orig_line_entry_t *t2 = (const pot_orig_line_entry_t *) v2;
+
+  if (t1->line_pos > t2->line_pos) return 1;
+  if (t1->line_pos < t2->line_pos) return -1;
+
+  return 0;
 }
 
 int potfile_init (hashcat_ctx_t *hashcat_ctx)
@@ -342,170 +424,392 @@ void potfile_update_hash (hashcat_ctx_t *hashcat_ctx, hash_t *found, char *line_
   }
 }
 
-void potfile_update_hashes (hashcat_ctx_t *hashcat_ctx, hash_t *hash_buf, char *line_pw_buf, int line_pw_len, pot_tree_entry_t *tree)
+static void potfile_update_chain (hashcat_ctx_t *hashcat_ctx, hash_t *found, char *line_pw_buf, int line_pw_len, const pot_hash_index_t *index, const bool all)
 {
-  hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
+  // without --username or --dynamic-x there is only one hash per key, update just the head of the chain
 
-  // the linked list node:
+  if (all == false)
+  {
+    potfile_update_hash (hashcat_ctx, found, line_pw_buf, line_pw_len);
 
-  pot_hash_node_t search_node;
+    return;
+  }
 
-  search_node.hash_buf = hash_buf;
-  search_node.next     = NULL;
+  for (u32 hash_pos = (u32) (found - index->hashes_buf) + 1; hash_pos != 0; hash_pos = index->next[hash_pos - 1])
+  {
+    potfile_update_hash (hashcat_ctx, (hash_t *) &index->hashes_buf[hash_pos - 1], line_pw_buf, line_pw_len);
+  }
+}
 
-  // the search entry:
+void potfile_update_hashes (hashcat_ctx_t *hashcat_ctx, hash_t *hash_buf, char *line_pw_buf, int line_pw_len, const pot_hash_index_t *index, const bool all)
+{
+  hash_t *found = pot_hash_index_find (index, hash_buf);
 
-  pot_tree_entry_t search_entry;
+  if (found == NULL) return;
 
-  search_entry.nodes      = &search_node;
-  search_entry.hashconfig = hashconfig;
+  potfile_update_chain (hashcat_ctx, found, line_pw_buf, line_pw_len, index, all);
+}
 
-  // the main search function is this:
+static void potfile_hash_buf_init (const hashconfig_t *hashconfig, hash_t *hash_buf)
+{
+  hash_buf->digest    = hcmalloc (hashconfig->dgst_size);
+  hash_buf->salt      = NULL;
+  hash_buf->esalt     = NULL;
+  hash_buf->hook_salt = NULL;
+  hash_buf->cracked   = 0;
+  hash_buf->hash_info = NULL;
+  hash_buf->pw_buf    = NULL;
+  hash_buf->pw_len    = 0;
 
-  void **found = (void **) tfind (&search_entry, (void **) &tree, sort_pot_tree_by_hash);
+  if (hashconfig->is_salted == true)
+  {
+    hash_buf->salt = (salt_t *) hcmalloc (sizeof (salt_t));
+  }
 
-  if (found)
+  if (hashconfig->esalt_size > 0)
   {
-    pot_tree_entry_t *found_entry = (pot_tree_entry_t *) *found;
+    hash_buf->esalt = hcmalloc (hashconfig->esalt_size);
+  }
 
-    pot_hash_node_t *node = found_entry->nodes;
+  if (hashconfig->hook_salt_size > 0)
+  {
+    hash_buf->hook_salt = hcmalloc (hashconfig->hook_salt_size);
+  }
+}
 
-    while (node)
-    {
-      potfile_update_hash (hashcat_ctx, node->hash_buf, line_pw_buf, line_pw_len);
+static void potfile_hash_buf_reset (const hashconfig_t *hashconfig, hash_t *hash_buf)
+{
+  if (hash_buf->salt)
+  {
+    memset (hash_buf->salt, 0, sizeof (salt_t));
+  }
 
-      node = node->next;
-    }
+  if (hash_buf->esalt)
+  {
+    memset (hash_buf->esalt, 0, hashconfig->esalt_size);
+  }
+
+  if (hash_buf->hook_salt)
+  {
+    memset (hash_buf->hook_salt, 0, hashconfig->hook_salt_size);
   }
 }
 
-int potfile_remove_parse (hashcat_ctx_t *hashcat_ctx)
+static void potfile_hash_buf_destroy (const hashconfig_t *hashconfig, hash_t *hash_buf)
 {
-  const hashconfig_t  *hashconfig   = hashcat_ctx->hashconfig;
-  const hashes_t      *hashes       = hashcat_ctx->hashes;
-  const module_ctx_t  *module_ctx   = hashcat_ctx->module_ctx;
-        potfile_ctx_t *potfile_ctx  = hashcat_ctx->potfile_ctx;
+  if (hashconfig->esalt_size > 0)
+  {
+    hcfree (hash_buf->esalt);
+  }
 
-  if (potfile_ctx->enabled == false) return 0;
+  if (hashconfig->hook_salt_size > 0)
+  {
+    hcfree (hash_buf->hook_salt);
+  }
 
-  if (hashconfig->potfile_disable == true) return 0;
+  if (hashconfig->is_salted == true)
+  {
+    hcfree (hash_buf->salt);
+  }
 
-  if (hashconfig->opts_type & OPTS_TYPE_PT_NEVERCRACK) return 0;
+  hcfree (hash_buf->digest);
+}
 
-  // if no potfile exists yet we don't need to do anything here
+// splits a potfile line at the last separator, the hash part gets zero-terminated in-place
 
-  if (hc_path_exist (potfile_ctx->filename) == false) return 0;
+static bool potfile_split_line (const hashconfig_t *hashconfig, char *line_buf, const size_t line_len, int *line_hash_len, char **line_pw_buf, size_t *line_pw_len)
+{
+  if (line_len == 0) return false;
 
-  hash_t *hashes_buf = hashes->hashes_buf;
-  u32     hashes_cnt = hashes->hashes_cnt;
+  char *last_separator = strrchr (line_buf, hashconfig->separator);
 
-  // no solution for these special hash types (for instance because they use hashfile in output etc)
+  if (last_separator == NULL) return false; // ??
+
+  *line_pw_buf = last_separator + 1;
+
+  *line_pw_len = line_buf + line_len - *line_pw_buf;
+
+  *line_hash_len = last_separator - line_buf;
+
+  line_buf[*line_hash_len] = 0;
+
+  if (*line_hash_len == 0) return false;
+
+  return true;
+}
+
+static HC_API_CALL void *potfile_remove_parse_thread (void *p)
+{
+  pot_thread_param_t *param = (pot_thread_param_t *) p;
+
+  hashcat_ctx_t *hashcat_ctx = param->hashcat_ctx;
+
+  const hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
+  const module_ctx_t *module_ctx = hashcat_ctx->module_ctx;
 
   hash_t hash_buf;
 
-  hash_buf.digest    = hcmalloc (hashconfig->dgst_size);
-  hash_buf.salt      = NULL;
-  hash_buf.esalt     = NULL;
-  hash_buf.hook_salt = NULL;
-  hash_buf.cracked   = 0;
-  hash_buf.hash_info = NULL;
-  hash_buf.pw_buf    = NULL;
-  hash_buf.pw_len    = 0;
+  potfile_hash_buf_init (hashconfig, &hash_buf);
 
-  if (hashconfig->is_salted == true)
+  char *line_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
+
+  for (u64 chunk = param->tid; chunk < param->chunks_cnt; chunk += param->tsz)
   {
-    hash_buf.salt = (salt_t *) hcmalloc (sizeof (salt_t));
+    pot_match_t *matches       = NULL;
+    u64          matches_cnt   = 0;
+    u64          matches_avail = 0;
+
+    const char *pos = param->map + param->chunks_off[chunk];
+    const char *end = param->map + param->chunks_off[chunk + 1];
+
+    while (pos < end)
+    {
+      const char *line = pos;
+
+      const char *nl = (const char *) memchr (pos, '\n', end - pos);
+
+      const char *eol = (nl == NULL) ? end : nl;
+
+      pos = eol + 1;
+
+      // same as fgetl ()
+
+      size_t line_len = eol - line;
+
+      if (line_len >= HCBUFSIZ_LARGE)
+      {
+        fprintf (stderr, "\nOversized line detected! Truncated %" PRIu64 " bytes\n", (u64) (line_len - (HCBUFSIZ_LARGE - 1)));
+
+        line_len = HCBUFSIZ_LARGE - 1;
+      }
+      else
+      {
+        while (line_len > 0 && line[line_len - 1] == '\r')
+        {
+          line_len--;
+        }
+      }
+
+      memcpy (line_buf, line, line_len);
+
+      line_buf[line_len] = 0;
+
+      int    line_hash_len = 0;
+      char  *line_pw_buf   = NULL;
+      size_t line_pw_len   = 0;
+
+      if (potfile_split_line (hashconfig, line_buf, line_len, &line_hash_len, &line_pw_buf, &line_pw_len) == false) continue;
+
+      potfile_hash_buf_reset (hashconfig, &hash_buf);
+
+      const int parser_status = module_ctx->module_hash_decode (hashconfig, hash_buf.digest, hash_buf.salt, hash_buf.esalt, hash_buf.hook_salt, hash_buf.hash_info, line_buf, line_hash_len);
+
+      if (parser_status != PARSER_OK) continue;
+
+      const hash_t *found = pot_hash_index_find (param->index, &hash_buf);
+
+      if (found == NULL) continue;
+
+      if (matches_cnt == matches_avail)
+      {
+        matches = (pot_match_t *) hcrealloc (matches, matches_avail * sizeof (pot_match_t), INCR_POT * sizeof (pot_match_t));
+
+        matches_avail += INCR_POT;
+      }
+
+      // the password is not modified by the copy into line_buf, so it can be referenced in the mapping
+
+      matches[matches_cnt].hash_pos = (u32) (found - param->index->hashes_buf);
+      matches[matches_cnt].pw_len   = (u32) line_pw_len;
+      matches[matches_cnt].pw_off   = (u64) (line - param->map) + (u64) (line_pw_buf - line_buf);
+
+      matches_cnt++;
+    }
+
+    hc_thread_mutex_lock (*param->mux_done);
+
+    param->chunks_matches[chunk]     = matches;
+    param->chunks_matches_cnt[chunk] = matches_cnt;
+    param->chunks_done[chunk]        = true;
+
+    hc_thread_mutex_unlock (*param->mux_done);
   }
 
-  if (hashconfig->esalt_size > 0)
+  hcfree (line_buf);
+
+  potfile_hash_buf_destroy (hashconfig, &hash_buf);
+
+  return NULL;
+}
+
+// large potfiles are memory-mapped and split into chunks which are decoded by a pool of threads
+// the matches are applied here in potfile order, so the result is the same as with the serial loop
+
+static int potfile_remove_parse_parallel (hashcat_ctx_t *hashcat_ctx, const pot_hash_index_t *index)
+{
+  const hashconfig_t  *hashconfig  = hashcat_ctx->hashconfig;
+        potfile_ctx_t *potfile_ctx = hashcat_ctx->potfile_ctx;
+
+  HCFILE *fp = &potfile_ctx->fp;
+
+  const int processor_count = hc_get_processor_count ();
+
+  if (processor_count < 2) return 0;
+
+  if (hc_fmap (fp) == false) return 0;
+
+  const u64 start = fp->mfp_pos;
+
+  if ((fp->mfp_len - start) < (2 * POTFILE_CHUNK_SIZE)) return 0;
+
+  u64 *chunks_off = (u64 *) hccalloc (((fp->mfp_len - start) / POTFILE_CHUNK_SIZE) + 2, sizeof (u64));
+
+  u64 chunks_cnt = 0;
+
+  u64 pos = start;
+
+  while (pos < fp->mfp_len)
   {
-    hash_buf.esalt = hcmalloc (hashconfig->esalt_size);
+    chunks_off[chunks_cnt] = pos;
+
+    chunks_cnt++;
+
+    if ((pos + POTFILE_CHUNK_SIZE) >= fp->mfp_len)
+    {
+      pos = fp->mfp_len;
+
+      break;
+    }
+
+    const u64 from = pos + POTFILE_CHUNK_SIZE - 1;
+
+    const char *nl = (const char *) memchr (fp->mfp + from, '\n', (size_t) (fp->mfp_len - from));
+
+    pos = (nl == NULL) ? fp->mfp_len : (u64) (nl - fp->mfp) + 1;
   }
 
-  if (hashconfig->hook_salt_size > 0)
+  chunks_off[chunks_cnt] = pos;
+
+  const int tsz = (int) MIN ((u64) processor_count, chunks_cnt);
+
+  pot_thread_param_t *threads_param = (pot_thread_param_t *) hccalloc (tsz, sizeof (pot_thread_param_t));
+  hc_thread_t        *c_threads     = (hc_thread_t *)        hccalloc (tsz, sizeof (hc_thread_t));
+
+  pot_match_t **chunks_matches     = (pot_match_t **) hccalloc (chunks_cnt, sizeof (pot_match_t *));
+  u64          *chunks_matches_cnt = (u64 *)          hccalloc (chunks_cnt, sizeof (u64));
+  bool         *chunks_done        = (bool *)         hccalloc (chunks_cnt, sizeof (bool));
+
+  hc_thread_mutex_t mux_done;
+
+  hc_thread_mutex_init (mux_done);
+
+  for (int i = 0; i < tsz; i++)
   {
-    hash_buf.hook_salt = hcmalloc (hashconfig->hook_salt_size);
+    pot_thread_param_t *param = threads_param + i;
+
+    param->tid                = i;
+    param->tsz                = tsz;
+    param->hashcat_ctx        = hashcat_ctx;
+    param->index              = index;
+    param->map                = fp->mfp;
+    param->chunks_off         = chunks_off;
+    param->chunks_cnt         = chunks_cnt;
+    param->chunks_matches     = chunks_matches;
+    param->chunks_matches_cnt = chunks_matches_cnt;
+    param->chunks_done        = chunks_done;
+    param->mux_done           = &mux_done;
+
+    hc_thread_create (c_threads[i], potfile_remove_parse_thread, param);
   }
 
-  // we only need this variable in a very specific situation:
-  // whenever we use --username or --dynamic-x and --show together we want to keep all hashes sorted within a nice structure
+  for (u64 chunk = 0; chunk < chunks_cnt; chunk++)
+  {
+    while (true)
+    {
+      hc_thread_mutex_lock (mux_done);
 
-  pot_tree_entry_t *all_hashes_tree  = NULL;
-  pot_tree_entry_t *tree_entry_cache = NULL;
-  pot_hash_node_t  *tree_nodes_cache = NULL;
+      const bool done = chunks_done[chunk];
 
-  if (hashconfig->potfile_keep_all_hashes == true)
-  {
-    // we need *at most* one entry for every hash
-    // (if there are no hashes with the same keys (hash + salt), a counter example would be: same hash but different user name)
-    tree_entry_cache = (pot_tree_entry_t *) hccalloc (hashes_cnt, sizeof (pot_tree_entry_t));
+      hc_thread_mutex_unlock (mux_done);
+
+      if (done == true) break;
+
+      usleep (1000);
+    }
 
-    // we need *always exactly* one linked list for every hash
-    tree_nodes_cache = (pot_hash_node_t  *) hccalloc (hashes_cnt, sizeof (pot_hash_node_t));
+    pot_match_t *matches = chunks_matches[chunk];
 
-    for (u32 hash_pos = 0; hash_pos < hashes_cnt; hash_pos++)
+    for (u64 matches_pos = 0; matches_pos < chunks_matches_cnt[chunk]; matches_pos++)
     {
-      // initialize the linked list node:
-      // we always need to create a new one and add it, because we want to keep and later update all hashes:
+      const pot_match_t *match = matches + matches_pos;
 
-      pot_hash_node_t *new_node = &tree_nodes_cache[hash_pos];
+      potfile_update_chain (hashcat_ctx, (hash_t *) &index->hashes_buf[match->hash_pos], fp->mfp + match->pw_off, (int) match->pw_len, index, hashconfig->potfile_keep_all_hashes);
+    }
 
-      new_node->hash_buf = &hashes_buf[hash_pos];
-      new_node->next     = NULL;
+    hcfree (matches);
+  }
 
-      // initialize the entry:
+  hc_thread_wait (tsz, c_threads);
 
-      pot_tree_entry_t *new_entry = &tree_entry_cache[hash_pos];
+  hc_thread_mutex_delete (mux_done);
 
-      // note: the "key" (hash + salt) is indirectly accessible via the first nodes "hash_buf"
+  hcfree (chunks_done);
+  hcfree (chunks_matches_cnt);
+  hcfree (chunks_matches);
+  hcfree (chunks_off);
+  hcfree (c_threads);
+  hcfree (threads_param);
 
-      new_entry->nodes      = new_node;
-      // the hashconfig is needed here because we need to be able to check within the sort function if we also need
-      // to sort by salt and we also need to have the correct order of dgst_pos0...dgst_pos3:
-      new_entry->hashconfig = (hashconfig_t *) hashconfig; // "const hashconfig_t" gives a warning
+  // everything has been read, leave nothing for the serial loop
 
-      // the following function searches if the "key" is already present and if not inserts the new entry:
+  hc_fseek (fp, 0, SEEK_END);
 
-      void **found = (void **) tsearch (new_entry, (void **) &all_hashes_tree, sort_pot_tree_by_hash);
+  return 0;
+}
+
+int potfile_remove_parse (hashcat_ctx_t *hashcat_ctx)
+{
+  const hashconfig_t  *hashconfig   = hashcat_ctx->hashconfig;
+  const hashes_t      *hashes       = hashcat_ctx->hashes;
+  const module_ctx_t  *module_ctx   = hashcat_ctx->module_ctx;
+        potfile_ctx_t *potfile_ctx  = hashcat_ctx->potfile_ctx;
 
-      pot_tree_entry_t *found_entry = (pot_tree_entry_t *) *found;
+  if (potfile_ctx->enabled == false) return 0;
 
-      // we now need to check these cases; tsearch () could return:
-      // 1. NULL : if we have a memory allocation problem (not enough memory for the tree structure)
-      // 2. found_entry == new_entry: if we successfully insert a new key (which was not present yet)
-      // 3. found_entry != new_entry: if the key was already present
+  if (hashconfig->potfile_disable == true) return 0;
 
-      // case 1: memory allocation error
+  if (hashconfig->opts_type & OPTS_TYPE_PT_NEVERCRACK) return 0;
 
-      if (found_entry == NULL)
-      {
-        fprintf (stderr, "Error while allocating memory for the potfile search: %s\n", MSG_ENOMEM);
+  // if no potfile exists yet we don't need to do anything here
 
-        return -1;
-      }
+  if (hc_path_exist (potfile_ctx->filename) == false) return 0;
 
-      // case 2: this means it was a new insert (and the insert was successful)
+  hash_t *hashes_buf = hashes->hashes_buf;
+  u32     hashes_cnt = hashes->hashes_cnt;
 
-      if (found_entry == new_entry)
-      {
-        // no updates to the linked list required (since it is the first one!)
-      }
-      // case 3: if we have found an already existing entry
-      else
-      {
-        new_node->next = found_entry->nodes;
-      }
+  // no solution for these special hash types (for instance because they use hashfile in output etc)
 
-      // we always insert the new node at the very beginning
-      // (or in other words: the head of the linked list always points to *this* new inserted node)
+  hash_t hash_buf;
 
-      found_entry->nodes = new_node;
-    }
-  }
+  potfile_hash_buf_init (hashconfig, &hash_buf);
+
+  // all hashes are indexed by hash + salt, whenever we use --username or --dynamic-x and --show together
+  // the hashes with the same key are kept in a chain so that we can update all of them
+
+  pot_hash_index_t index;
+
+  pot_hash_index_init (&index, hashes_buf, hashes_cnt, hashconfig);
 
   const int rc = potfile_read_open (hashcat_ctx);
 
-  if (rc == -1) return -1;
+  if (rc == -1)
+  {
+    pot_hash_index_destroy (&index);
+
+    potfile_hash_buf_destroy (hashconfig, &hash_buf);
+
+    return -1;
+  }
 
   void *tmps = NULL;
 
@@ -514,44 +818,48 @@ int potfile_remove_parse (hashcat_ctx_t *hashcat_ctx)
     tmps = hcmalloc (hashconfig->tmp_size);
   }
 
-  char *line_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
+  // the potfile custom check can't use the index, but modules can tell us which hashes are worth checking
 
-  while (!hc_feof (&potfile_ctx->fp))
-  {
-    size_t line_len = fgetl (&potfile_ctx->fp, line_buf, HCBUFSIZ_LARGE);
+  pot_custom_key_t *custom_keys = NULL;
 
-    if (line_len == 0) continue;
+  if ((module_ctx->module_potfile_custom_check != MODULE_DEFAULT) && (module_ctx->module_potfile_custom_key != MODULE_DEFAULT))
+  {
+    custom_keys = (pot_custom_key_t *) hccalloc (hashes_cnt, sizeof (pot_custom_key_t));
 
-    char *last_separator = strrchr (line_buf, hashconfig->separator);
+    for (u32 hashes_pos = 0; hashes_pos < hashes_cnt; hashes_pos++)
+    {
+      custom_keys[hashes_pos].key      = module_ctx->module_potfile_custom_key (hashconfig, &hashes_buf[hashes_pos]);
+      custom_keys[hashes_pos].hash_pos = hashes_pos;
+    }
 
-    if (last_separator == NULL) continue; // ??
+    qsort (custom_keys, hashes_cnt, sizeof (pot_custom_key_t), sort_pot_custom_key);
+  }
 
-    char *line_pw_buf = last_separator + 1;
+  // the potfile custom check stays serial
 
-    size_t line_pw_len = line_buf + line_len - line_pw_buf;
+  if (module_ctx->module_hash_decode_potfile == MODULE_DEFAULT)
+  {
+    potfile_remove_parse_parallel (hashcat_ctx, &index);
+  }
 
-    char *line_hash_buf = line_buf;
+  hc_line_reader_t lr;
 
-    int line_hash_len = last_separator - line_buf;
+  hc_line_reader_init (&lr, &potfile_ctx->fp, HCBUFSIZ_LARGE);
 
-    line_hash_buf[line_hash_len] = 0;
+  char  *line_buf = NULL;
+  size_t line_len = 0;
 
-    if (line_hash_len == 0) continue;
+  while (hc_line_reader_next (&lr, &line_buf, &line_len) == true)
+  {
+    int    line_hash_len = 0;
+    char  *line_pw_buf   = NULL;
+    size_t line_pw_len   = 0;
 
-    if (hash_buf.salt)
-    {
-      memset (hash_buf.salt, 0, sizeof (salt_t));
-    }
+    if (potfile_split_line (hashconfig, line_buf, line_len, &line_hash_len, &line_pw_buf, &line_pw_len) == false) continue;
 
-    if (hash_buf.esalt)
-    {
-      memset (hash_buf.esalt, 0, hashconfig->esalt_size);
-    }
+    char *line_hash_buf = line_buf;
 
-    if (hash_buf.hook_salt)
-    {
-      memset (hash_buf.hook_salt, 0, hashconfig->hook_salt_size);
-    }
+    potfile_hash_buf_reset (hashconfig, &hash_buf);
 
     if (module_ctx->module_hash_decode_potfile != MODULE_DEFAULT)
     {
@@ -561,8 +869,37 @@ int potfile_remove_parse (hashcat_ctx_t *hashcat_ctx)
 
         if (parser_status != PARSER_OK) continue;
 
-        for (u32 hashes_pos = 0; hashes_pos < hashes_cnt; hashes_pos++)
+        u32 keys_pos = 0;
+        u32 keys_end = hashes_cnt;
+
+        if (custom_keys != NULL)
+        {
+          // only the hashes with the same key can match, they are next to each other
+
+          const u64 key = module_ctx->module_potfile_custom_key (hashconfig, &hash_buf);
+
+          u32 lo = 0;
+          u32 hi = hashes_cnt;
+
+          while (lo < hi)
+          {
+            const u32 mid = lo + ((hi - lo) / 2);
+
+            if (custom_keys[mid].key < key) lo = mid + 1; else hi = mid;
+          }
+
+          keys_pos = lo;
+
+          for (keys_end = keys_pos; keys_end < hashes_cnt; keys_end++)
+          {
+            if (custom_keys[keys_end].key != key) break;
+          }
+        }
+
+        for (; keys_pos < keys_end; keys_pos++)
         {
+          const u32 hashes_pos = (custom_keys != NULL) ? custom_keys[keys_pos].hash_pos : keys_pos;
+
           const bool cracked = module_ctx->module_potfile_custom_check (hashconfig, &hashes_buf[hashes_pos], &hash_buf, tmps);
 
           if (cracked == true)
@@ -584,20 +921,11 @@ int potfile_remove_parse (hashcat_ctx_t *hashcat_ctx)
 
       if (parser_status != PARSER_OK) continue;
 
-      if (hashconfig->potfile_keep_all_hashes == true)
-      {
-        potfile_update_hashes (hashcat_ctx, &hash_buf, line_pw_buf, (u32) line_pw_len, all_hashes_tree);
-
-        continue;
-      }
-
-      hash_t *found = (hash_t *) hc_bsearch_r (&hash_buf, hashes_buf, hashes_cnt, sizeof (hash_t), sort_by_hash, (void *) hashconfig);
-
-      potfile_update_hash (hashcat_ctx, found, line_pw_buf, (u32) line_pw_len);
+      potfile_update_hashes (hashcat_ctx, &hash_buf, line_pw_buf, (u32) line_pw_len, &index, hashconfig->potfile_keep_all_hashes);
     }
   }
 
-  hcfree (line_buf);
+  hc_line_reader_destroy (&lr);
 
   if (hashconfig->tmp_size > 0)
   {
@@ -606,30 +934,11 @@ int potfile_remove_parse (hashcat_ctx_t *hashcat_ctx)
 
   potfile_read_close (hashcat_ctx);
 
-  if (hashconfig->potfile_keep_all_hashes == true)
-  {
-    pot_tree_destroy (all_hashes_tree); // this could be slow (should we just skip it?)
-
-    hcfree (tree_nodes_cache);
-    hcfree (tree_entry_cache);
-  }
-
-  if (hashconfig->esalt_size > 0)
-  {
-    hcfree (hash_buf.esalt);
-  }
-
-  if (hashconfig->hook_salt_size > 0)
-  {
-    hcfree (hash_buf.hook_salt);
-  }
+  pot_hash_index_destroy (&index);
 
-  if (hashconfig->is_salted == true)
-  {
-    hcfree (hash_buf.salt);
-  }
+  hcfree (custom_keys);
 
-  hcfree (hash_buf.digest);
+  potfile_hash_buf_destroy (hashconfig, &hash_buf);
 
   return 0;
 }
@@ -844,10 +844,6 @@ int kernel_rules_load (hashcat_ctx_t *hashcat_ctx, kernel_rule_t **out_buf, u32
     all_kernel_rules_buf = (kernel_rule_t **) hccalloc (user_options->rp_files_cnt, sizeof (kernel_rule_t *));
   }
 
-  char *rule_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
-
-  u32 rule_len = 0;
-
   for (u32 i = 0; i < user_options->rp_files_cnt; i++)
   {
     u32 kernel_rules_avail = 0;
@@ -869,15 +865,18 @@ int kernel_rules_load (hashcat_ctx_t *hashcat_ctx, kernel_rule_t **out_buf, u32
       hcfree (all_kernel_rules_cnt);
       hcfree (all_kernel_rules_buf);
 
-      hcfree (rule_buf);
-
       return -1;
     }
 
-    while (!hc_feof (&fp))
-    {
-      rule_len = (u32) fgetl (&fp, rule_buf, HCBUFSIZ_LARGE);
+    hc_line_reader_t lr;
 
+    hc_line_reader_init (&lr, &fp, HCBUFSIZ_LARGE);
+
+    char  *rule_buf = NULL;
+    size_t rule_len = 0;
+
+    while (hc_line_reader_next (&lr, &rule_buf, &rule_len) == true)
+    {
       if (rule_line == (u32) -1)
       {
         event_log_error (hashcat_ctx, "Unsupported number of lines in rule file %s.", rp_file);
@@ -885,7 +884,9 @@ int kernel_rules_load (hashcat_ctx_t *hashcat_ctx, kernel_rule_t **out_buf, u32
         hcfree (all_kernel_rules_cnt);
         hcfree (all_kernel_rules_buf);
 
-        hcfree (rule_buf);
+        hc_line_reader_destroy (&lr);
+
+        hc_fclose (&fp);
 
         return -1;
       }
@@ -911,7 +912,9 @@ int kernel_rules_load (hashcat_ctx_t *hashcat_ctx, kernel_rule_t **out_buf, u32
           hcfree (all_kernel_rules_cnt);
           hcfree (all_kernel_rules_buf);
 
-          hcfree (rule_buf);
+          hc_line_reader_destroy (&lr);
+
+          hc_fclose (&fp);
 
           return -1;
         }
@@ -952,7 +955,9 @@ int kernel_rules_load (hashcat_ctx_t *hashcat_ctx, kernel_rule_t **out_buf, u32
         hcfree (all_kernel_rules_cnt);
         hcfree (all_kernel_rules_buf);
 
-        hcfree (rule_buf);
+        hc_line_reader_destroy (&lr);
+
+        hc_fclose (&fp);
 
         return -1;
       }
@@ -960,14 +965,14 @@ int kernel_rules_load (hashcat_ctx_t *hashcat_ctx, kernel_rule_t **out_buf, u32
       kernel_rules_cnt++;
     }
 
+    hc_line_reader_destroy (&lr);
+
     hc_fclose (&fp);
 
     all_kernel_rules_cnt[i] = kernel_rules_cnt;
     all_kernel_rules_buf[i] = kernel_rules_buf;
   }
 
-  hcfree (rule_buf);
-
   /**
    * merge rules
    */
@@ -993,7 +998,6 @@ int kernel_rules_load (hashcat_ctx_t *hashcat_ctx, kernel_rule_t **out_buf, u32
         hcfree (all_kernel_rules_cnt);
         hcfree (all_kernel_rules_buf);
 
-        hcfree (rule_buf);
         hcfree (repeats);
 
         return -1;
@@ -54,6 +54,7 @@ static int selftest_init (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_
 
   device_param->kernel_param.digests_cnt = 1;
   device_param->kernel_param.digests_offset_host = 0;
+  device_param->kernel_param.digests_idx_bits = 0; // the bucket index belongs to digests_buf, not to st_digests_buf
 
   // password : move the known password into a fake buffer
 
@@ -953,6 +954,7 @@ static int selftest_run_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *d
 
 static int selftest_cleanup (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, u32 *num_cracked)
 {
+  hashes_t             *hashes             = hashcat_ctx->hashes;
   user_options_t       *user_options       = hashcat_ctx->user_options;
   user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
 
@@ -996,6 +998,7 @@ static int selftest_cleanup (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *devi
   device_param->kernel_param.il_cnt               = 0;
   device_param->kernel_param.digests_cnt          = 0;
   device_param->kernel_param.digests_offset_host  = 0;
+  device_param->kernel_param.digests_idx_bits     = hashes->digests_idx_bits;
   device_param->kernel_param.combs_mode           = 0;
   device_param->kernel_param.salt_repeat          = 0;
 
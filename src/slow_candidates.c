@@ -28,7 +28,21 @@ void slow_candidates_seek (hashcat_ctx_t *hashcat_ctx, void *extra_info, const u
   {
     extra_info_straight_t *extra_info_straight = (extra_info_straight_t *) extra_info;
 
-    for (u64 i = cur; i < end; i++)
+    // the base words of the whole gap except the last one are not needed, jump over them
+
+    const u64 words_cur = CEILDIV (cur, straight_ctx->kernel_rules_cnt);
+    const u64 words_end = CEILDIV (end, straight_ctx->kernel_rules_cnt);
+
+    u64 i = cur;
+
+    if (words_end > (words_cur + 1))
+    {
+      skip_words (hashcat_ctx, &extra_info_straight->fp, straight_ctx->dict, words_cur, words_end - 1);
+
+      i = (words_end - 1) * straight_ctx->kernel_rules_cnt;
+    }
+
+    for ( ; i < end; i++)
     {
       if ((i % straight_ctx->kernel_rules_cnt) == 0)
       {
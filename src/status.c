@@ -1310,6 +1310,39 @@ double status_get_progress_rejected_percent (const hashcat_ctx_t *hashcat_ctx)
   return percent_rejected;
 }
 
+u64 status_get_bitmap_fp (const hashcat_ctx_t *hashcat_ctx)
+{
+  const backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
+
+  u64 bitmap_fp = 0;
+
+  for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
+  {
+    const hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_idx];
+
+    if (device_param->skipped == true) continue;
+
+    bitmap_fp += device_param->bitmap_fp;
+  }
+
+  return bitmap_fp;
+}
+
+double status_get_bitmap_fp_percent (const hashcat_ctx_t *hashcat_ctx)
+{
+  const u64 progress_done = status_get_progress_done (hashcat_ctx);
+  const u64 bitmap_fp     = status_get_bitmap_fp     (hashcat_ctx);
+
+  double percent_fp = 0;
+
+  if (progress_done)
+  {
+    percent_fp = ((double) (bitmap_fp) / (double) progress_done) * 100;
+  }
+
+  return percent_fp;
+}
+
 u64 status_get_progress_restored (const hashcat_ctx_t *hashcat_ctx)
 {
   const hashes_t     *hashes     = hashcat_ctx->hashes;
@@ -2037,6 +2070,25 @@ char *status_get_brain_tx_all (const hashcat_ctx_t *hashcat_ctx)
 
 }
 
+double status_get_brain_wait_all (const hashcat_ctx_t *hashcat_ctx)
+{
+  const backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
+
+  double brain_wait_all = 0;
+
+  for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
+  {
+    hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_idx];
+
+    if ((device_param->skipped == false) && (device_param->skipped_warning == false))
+    {
+      brain_wait_all += device_param->brain_link_wait_ms;
+    }
+  }
+
+  return brain_wait_all / 1000;
+}
+
 char *status_get_brain_link_recv_bytes_sec_dev (const hashcat_ctx_t *hashcat_ctx, const int backend_devices_idx)
 {
   const backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
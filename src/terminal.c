@@ -3484,6 +3484,14 @@ void status_display (hashcat_ctx_t *hashcat_ctx)
       break;
   }
 
+  if (user_options->bitmap_fp_count == true)
+  {
+    event_log_info (hashcat_ctx,
+      "Bitmap.FP........: %" PRIu64 " (%.04f%%)",
+      hashcat_status->bitmap_fp,
+      hashcat_status->bitmap_fp_percent);
+  }
+
   #ifdef WITH_BRAIN
   if (user_options->brain_client == true)
   {
@@ -3492,6 +3500,10 @@ void status_display (hashcat_ctx_t *hashcat_ctx)
       hashcat_status->brain_rx_all,
       hashcat_status->brain_tx_all);
 
+    event_log_info (hashcat_ctx,
+      "Brain.Link.Wait..: %.2f s",
+      hashcat_status->brain_wait_all);
+
     if (bridge_ctx->enabled == true)
     {
       if (hashcat_status->device_info_cnt == 1)
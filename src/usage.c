@@ -92,8 +92,14 @@ static const char *const USAGE_BIG_PRE_HASHMODES[] =
   "     --speed-only               |      | Return expected speed of the attack, then quit       |",
   "     --progress-only            |      | Return ideal progress step size and time to process  |",
   " -c, --segment-size             | Num  | Sets size in MB to cache from the wordfile to X      | -c 32",
+  "     --wordlist-read-ahead      | Num  | Sets compressed wordlist blocks to read ahead to X   | --wordlist-read-ahead=16",
+  "     --wordlist-read-ahead-size | Num  | Sets size in MB of a wordlist read-ahead block to X  | --wordlist-read-ahead-size=1",
   "     --bitmap-min               | Num  | Sets minimum bits allowed for bitmaps to X           | --bitmap-min=24",
   "     --bitmap-max               | Num  | Sets maximum bits allowed for bitmaps to X           | --bitmap-max=24",
+  "     --bitmap-bloom             |      | Use a blocked bloom filter instead of the bitmaps    |",
+  "     --bitmap-bloom-fpr         | Num  | Sets bloom filter false positive rate to 1/2^X       | --bitmap-bloom-fpr=20",
+  "     --bitmap-fp-count          |      | Count and show candidates passing the bitmaps/filter |",
+  "     --digests-index-disable    |      | Disable bucket index of large unsalted hashlists     |",
   "     --bridge-parameter1        | Str  | Sets the generic parameter 1 for a Bridge            |",
   "     --bridge-parameter2        | Str  | Sets the generic parameter 2 for a Bridge            |",
   "     --bridge-parameter3        | Str  | Sets the generic parameter 3 for a Bridge            |",
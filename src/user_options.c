@@ -50,6 +50,9 @@ static const struct option long_options[] =
   {"benchmark-max",             required_argument, NULL, IDX_BENCHMARK_MAX},
   {"benchmark-min",             required_argument, NULL, IDX_BENCHMARK_MIN},
   {"benchmark",                 no_argument,       NULL, IDX_BENCHMARK},
+  {"bitmap-bloom",              no_argument,       NULL, IDX_BITMAP_BLOOM},
+  {"bitmap-bloom-fpr",          required_argument, NULL, IDX_BITMAP_BLOOM_FPR},
+  {"bitmap-fp-count",           no_argument,       NULL, IDX_BITMAP_FP_COUNT},
   {"bitmap-max",                required_argument, NULL, IDX_BITMAP_MAX},
   {"bitmap-min",                required_argument, NULL, IDX_BITMAP_MIN},
   {"bridge-parameter1",         required_argument, NULL, IDX_BRIDGE_PARAMETER1},
@@ -68,6 +71,7 @@ static const struct option long_options[] =
   {"debug-file",                required_argument, NULL, IDX_DEBUG_FILE},
   {"debug-mode",                required_argument, NULL, IDX_DEBUG_MODE},
   {"deprecated-check-disable",  no_argument,       NULL, IDX_DEPRECATED_CHECK_DISABLE},
+  {"digests-index-disable",     no_argument,       NULL, IDX_DIGESTS_INDEX_DISABLE},
   {"dynamic-x",                 no_argument,       NULL, IDX_DYNAMIC_X},
   {"encoding-from",             required_argument, NULL, IDX_ENCODING_FROM},
   {"encoding-to",               required_argument, NULL, IDX_ENCODING_TO},
@@ -158,6 +162,8 @@ static const struct option long_options[] =
   {"veracrypt-pim-stop",        required_argument, NULL, IDX_VERACRYPT_PIM_STOP},
   {"version",                   no_argument,       NULL, IDX_VERSION},
   {"wordlist-autohex-disable",  no_argument,       NULL, IDX_WORDLIST_AUTOHEX_DISABLE},
+  {"wordlist-read-ahead",       required_argument, NULL, IDX_WORDLIST_READ_AHEAD},
+  {"wordlist-read-ahead-size",  required_argument, NULL, IDX_WORDLIST_READ_AHEAD_SIZE},
   {"workload-profile",          required_argument, NULL, IDX_WORKLOAD_PROFILE},
   #ifdef WITH_BRAIN
   {"brain-client",              no_argument,       NULL, IDX_BRAIN_CLIENT},
@@ -207,6 +213,9 @@ int user_options_init (hashcat_ctx_t *hashcat_ctx)
   user_options->benchmark_max             = BENCHMARK_MAX;
   user_options->benchmark_min             = BENCHMARK_MIN;
   user_options->benchmark                 = BENCHMARK;
+  user_options->bitmap_bloom              = BITMAP_BLOOM;
+  user_options->bitmap_bloom_fpr          = BITMAP_BLOOM_FPR;
+  user_options->bitmap_fp_count           = BITMAP_FP_COUNT;
   user_options->bitmap_max                = BITMAP_MAX;
   user_options->bitmap_min                = BITMAP_MIN;
   #ifdef WITH_BRAIN
@@ -236,6 +245,7 @@ int user_options_init (hashcat_ctx_t *hashcat_ctx)
   user_options->debug_file                = NULL;
   user_options->debug_mode                = DEBUG_MODE;
   user_options->deprecated_check          = DEPRECATED_CHECK;
+  user_options->digests_index             = DIGESTS_INDEX;
   user_options->dynamic_x                 = DYNAMIC_X;
   user_options->encoding_from             = ENCODING_FROM;
   user_options->encoding_to               = ENCODING_TO;
@@ -323,6 +333,8 @@ int user_options_init (hashcat_ctx_t *hashcat_ctx)
   user_options->veracrypt_pim_stop        = VERACRYPT_PIM_STOP;
   user_options->version                   = VERSION;
   user_options->wordlist_autohex          = WORDLIST_AUTOHEX;
+  user_options->wordlist_read_ahead       = WORDLIST_READ_AHEAD;
+  user_options->wordlist_read_ahead_size  = WORDLIST_READ_AHEAD_SIZE;
   user_options->workload_profile          = WORKLOAD_PROFILE;
   user_options->rp_files_cnt              = 0;
   user_options->rp_files                  = (char **) hccalloc (256, sizeof (char *));
@@ -394,9 +406,12 @@ int user_options_getopt (hashcat_ctx_t *hashcat_ctx, int argc, char **argv)
       case IDX_VERACRYPT_PIM_START:
       case IDX_VERACRYPT_PIM_STOP:
       case IDX_SEGMENT_SIZE:
+      case IDX_WORDLIST_READ_AHEAD:
+      case IDX_WORDLIST_READ_AHEAD_SIZE:
       case IDX_SCRYPT_TMTO:
       case IDX_BITMAP_MIN:
       case IDX_BITMAP_MAX:
+      case IDX_BITMAP_BLOOM_FPR:
       case IDX_INCREMENT_MIN:
       case IDX_INCREMENT_MAX:
       case IDX_HOOK_THREADS:
@@ -442,6 +457,7 @@ int user_options_getopt (hashcat_ctx_t *hashcat_ctx, int argc, char **argv)
       case IDX_QUIET:                     user_options->quiet                     = true;                            break;
       case IDX_SHOW:                      user_options->show                      = true;                            break;
       case IDX_DEPRECATED_CHECK_DISABLE:  user_options->deprecated_check          = false;                           break;
+      case IDX_DIGESTS_INDEX_DISABLE:     user_options->digests_index             = false;                           break;
       case IDX_LEFT:                      user_options->left                      = true;                            break;
       case IDX_ADVICE_DISABLE:            user_options->advice                    = false;                           break;
       case IDX_USERNAME:                  user_options->username                  = true;                            break;
@@ -518,6 +534,8 @@ int user_options_getopt (hashcat_ctx_t *hashcat_ctx, int argc, char **argv)
       case IDX_OUTFILE_AUTOHEX_DISABLE:   user_options->outfile_autohex           = false;                           break;
       case IDX_OUTFILE_CHECK_TIMER:       user_options->outfile_check_timer       = hc_strtoul (optarg, NULL, 10);   break;
       case IDX_WORDLIST_AUTOHEX_DISABLE:  user_options->wordlist_autohex          = false;                           break;
+      case IDX_WORDLIST_READ_AHEAD:       user_options->wordlist_read_ahead       = hc_strtoul (optarg, NULL, 10);   break;
+      case IDX_WORDLIST_READ_AHEAD_SIZE:  user_options->wordlist_read_ahead_size  = hc_strtoul (optarg, NULL, 10);   break;
       case IDX_HEX_CHARSET:               user_options->hex_charset               = true;                            break;
       case IDX_HEX_SALT:                  user_options->hex_salt                  = true;                            break;
       case IDX_HEX_WORDLIST:              user_options->hex_wordlist              = true;                            break;
@@ -578,6 +596,9 @@ int user_options_getopt (hashcat_ctx_t *hashcat_ctx, int argc, char **argv)
                                           user_options->separator_chgd            = true;                            break;
       case IDX_BITMAP_MIN:                user_options->bitmap_min                = hc_strtoul (optarg, NULL, 10);   break;
       case IDX_BITMAP_MAX:                user_options->bitmap_max                = hc_strtoul (optarg, NULL, 10);   break;
+      case IDX_BITMAP_BLOOM:              user_options->bitmap_bloom              = true;                            break;
+      case IDX_BITMAP_BLOOM_FPR:          user_options->bitmap_bloom_fpr          = hc_strtoul (optarg, NULL, 10);   break;
+      case IDX_BITMAP_FP_COUNT:           user_options->bitmap_fp_count           = true;                            break;
       case IDX_HOOK_THREADS:              user_options->hook_threads              = hc_strtoul (optarg, NULL, 10);   break;
       case IDX_INCREMENT:                 user_options->increment++;                                                 break;
       case IDX_INCREMENT_INVERSE:         user_options->increment                 = INCREMENT_INVERSED;              break;
@@ -1036,6 +1057,27 @@ int user_options_sanity (hashcat_ctx_t *hashcat_ctx)
     return -1;
   }
 
+  if ((user_options->bitmap_bloom_fpr == 0) || (user_options->bitmap_bloom_fpr > 24))
+  {
+    event_log_error (hashcat_ctx, "Invalid --bitmap-bloom-fpr value specified - must be between 1 and 24.");
+
+    return -1;
+  }
+
+  if (user_options->wordlist_read_ahead > 256)
+  {
+    event_log_error (hashcat_ctx, "Invalid --wordlist-read-ahead value specified - must be <= 256.");
+
+    return -1;
+  }
+
+  if ((user_options->wordlist_read_ahead_size == 0) || (user_options->wordlist_read_ahead_size > 1024))
+  {
+    event_log_error (hashcat_ctx, "Invalid --wordlist-read-ahead-size value specified - must be between 1 and 1024.");
+
+    return -1;
+  }
+
   if (user_options->rp_gen_func_min > user_options->rp_gen_func_max)
   {
     event_log_error (hashcat_ctx, "Invalid --rp-gen-func-min value specified.");
@@ -3552,9 +3594,13 @@ void user_options_logger (hashcat_ctx_t *hashcat_ctx)
   logfile_top_uint   (user_options->benchmark_all);
   logfile_top_uint   (user_options->benchmark_max);
   logfile_top_uint   (user_options->benchmark_min);
+  logfile_top_uint   (user_options->bitmap_bloom);
+  logfile_top_uint   (user_options->bitmap_bloom_fpr);
+  logfile_top_uint   (user_options->bitmap_fp_count);
   logfile_top_uint   (user_options->bitmap_max);
   logfile_top_uint   (user_options->bitmap_min);
   logfile_top_uint   (user_options->debug_mode);
+  logfile_top_uint   (user_options->digests_index);
   logfile_top_uint   (user_options->dynamic_x);
   logfile_top_uint   (user_options->hash_info);
   logfile_top_uint   (user_options->force);
@@ -3593,6 +3639,8 @@ void user_options_logger (hashcat_ctx_t *hashcat_ctx)
   logfile_top_uint   (user_options->outfile_format);
   logfile_top_uint   (user_options->outfile_json);
   logfile_top_uint   (user_options->wordlist_autohex);
+  logfile_top_uint   (user_options->wordlist_read_ahead);
+  logfile_top_uint   (user_options->wordlist_read_ahead_size);
   logfile_top_uint   (user_options->potfile);
   logfile_top_uint   (user_options->progress_only);
   logfile_top_uint   (user_options->quiet);
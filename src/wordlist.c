@@ -9,12 +9,24 @@
 #include "event.h"
 #include "convert.h"
 #include "dictstat.h"
+#include "filehandling.h"
 #include "rp.h"
 #include "rp_cpu.h"
 #include "shared.h"
 #include "wordlist.h"
 #include "bitops.h"
 #include "emu_inc_hash_sha1.h"
+#include "thread.h"
+
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#elif defined (__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined (__x86_64__) && (defined (__GNUC__) || defined (__clang__))
+#include <immintrin.h>
+#endif
 
 size_t convert_from_hex (hashcat_ctx_t *hashcat_ctx, char *line_buf, const size_t line_len)
 {
@@ -52,12 +64,41 @@ size_t convert_from_hex (hashcat_ctx_t *hashcat_ctx, char *line_buf, const size_
 
 int load_segment (hashcat_ctx_t *hashcat_ctx, HCFILE *fp)
 {
-  wl_data_t *wl_data = hashcat_ctx->wl_data;
+  user_options_t *user_options = hashcat_ctx->user_options;
+  wl_data_t      *wl_data      = hashcat_ctx->wl_data;
 
   // NOTE: use (never changing) ->incr here instead of ->avail otherwise the buffer gets bigger and bigger
 
   wl_data->pos = 0;
 
+  wl_data->words_cnt = 0;
+  wl_data->words_pos = 0;
+
+  // uncompressed wordlists are memory-mapped, hand out complete lines straight from the mapping
+
+  if (hc_fmap (fp) == true)
+  {
+    size_t map_cnt = 0;
+
+    char *map_buf = hc_fmap_window (fp, wl_data->incr - 1000, &map_cnt);
+
+    if (map_buf != NULL)
+    {
+      wl_data->seg = map_buf;
+      wl_data->cnt = map_cnt;
+
+      return 0;
+    }
+  }
+
+  // compressed wordlists are decompressed on a background thread while the previous segment is processed
+
+  hc_fread_ahead (fp, user_options->wordlist_read_ahead, (size_t) user_options->wordlist_read_ahead_size * 1024 * 1024);
+
+  // otherwise (and for the last window of a mapping) copy the segment into our own buffer
+
+  wl_data->seg = wl_data->buf;
+
   wl_data->cnt = hc_fread (wl_data->buf, 1, wl_data->incr - 1000, fp);
 
   if (wl_data->cnt == (size_t) -1)
@@ -77,6 +118,8 @@ int load_segment (hashcat_ctx_t *hashcat_ctx, HCFILE *fp)
     {
       wl_data->buf = (char *) hcrealloc (wl_data->buf, wl_data->avail, wl_data->incr);
 
+      wl_data->seg = wl_data->buf;
+
       wl_data->avail += wl_data->incr;
     }
 
@@ -103,26 +146,331 @@ int load_segment (hashcat_ctx_t *hashcat_ctx, HCFILE *fp)
   return 0;
 }
 
-void get_next_word_lm_gen (char *buf, u64 sz, u64 *len, u64 *off, u64 cutlen)
+/**
+ * line splitting primitives
+ * SSE2 and NEON are part of the x86_64 and aarch64 baseline, AVX2 is selected at runtime in wl_data_init()
+ */
+
+static inline void wl_word_emit (const char *buf, wl_word_t *words, u64 *words_cnt, u64 *start, const u64 nl)
+{
+  u64 len = nl - *start;
+
+  if ((len > 0) && (buf[nl - 1] == '\r')) len--;
+
+  words[*words_cnt].off = *start;
+  words[*words_cnt].len = len;
+
+  *words_cnt += 1;
+
+  *start = nl + 1;
+}
+
+static inline u64 wl_split_nl_tail (char *buf, u64 *pos, const u64 sz, wl_word_t *words, const u64 words_max, u64 words_cnt, u64 start, u64 i)
 {
-  char *ptr = buf;
+  for (; i < sz; i++)
+  {
+    if (buf[i] != '\n') continue;
+
+    wl_word_emit (buf, words, &words_cnt, &start, i);
+
+    if (words_cnt == words_max) break;
+  }
+
+  // last line without a newline
 
-  for (u64 i = 0; i < sz; i++, ptr++)
+  if ((start < sz) && (words_cnt < words_max) && (i >= sz))
   {
-    if (*ptr >= 'a' && *ptr <= 'z') *ptr -= 0x20;
+    words[words_cnt].off = start;
+    words[words_cnt].len = sz - start;
 
-    if (i == cutlen)
+    words_cnt++;
+
+    start = sz;
+  }
+
+  *pos = start;
+
+  return words_cnt;
+}
+
+static u64 wl_split_nl_scalar (char *buf, u64 *pos, const u64 sz, wl_word_t *words, const u64 words_max)
+{
+  return wl_split_nl_tail (buf, pos, sz, words, words_max, 0, *pos, *pos);
+}
+
+static void wl_upper_scalar (char *buf, const u64 len)
+{
+  for (u64 i = 0; i < len; i++)
+  {
+    if (buf[i] >= 'a' && buf[i] <= 'z') buf[i] -= 0x20;
+  }
+}
+
+#if defined (__SSE2__)
+
+static u64 wl_split_nl_sse2 (char *buf, u64 *pos, const u64 sz, wl_word_t *words, const u64 words_max)
+{
+  const __m128i nl = _mm_set1_epi8 ('\n');
+
+  u64 words_cnt = 0;
+
+  u64 start = *pos;
+
+  u64 i = start;
+
+  for (; i + 16 <= sz; i += 16)
+  {
+    u32 mask = (u32) _mm_movemask_epi8 (_mm_cmpeq_epi8 (_mm_loadu_si128 ((const __m128i *) (buf + i)), nl));
+
+    while (mask)
     {
-      if (cutlen == 20) buf[i - 1]= ']'; // add ] in $HEX[] format
+      wl_word_emit (buf, words, &words_cnt, &start, i + __builtin_ctz (mask));
+
+      mask &= mask - 1;
 
-      *len = i;
+      if (words_cnt == words_max)
+      {
+        *pos = start;
 
-      // but continue a loop to skip rest of the line
+        return words_cnt;
+      }
     }
+  }
+
+  return wl_split_nl_tail (buf, pos, sz, words, words_max, words_cnt, start, i);
+}
+
+static void wl_upper_sse2 (char *buf, const u64 len)
+{
+  const __m128i bias  = _mm_set1_epi8 ((char) (0x80 - 'a'));
+  const __m128i limit = _mm_set1_epi8 ((char) (-0x80 + 26));
+  const __m128i flip  = _mm_set1_epi8 (0x20);
+
+  u64 i = 0;
+
+  for (; i + 16 <= len; i += 16)
+  {
+    const __m128i v = _mm_loadu_si128 ((const __m128i *) (buf + i));
+
+    const __m128i lower = _mm_cmplt_epi8 (_mm_add_epi8 (v, bias), limit);
+
+    _mm_storeu_si128 ((__m128i *) (buf + i), _mm_sub_epi8 (v, _mm_and_si128 (lower, flip)));
+  }
+
+  wl_upper_scalar (buf + i, len - i);
+}
+
+static inline u64 wl_find_nl (const char *buf, const u64 sz)
+{
+  const __m128i nl = _mm_set1_epi8 ('\n');
+
+  u64 i = 0;
+
+  for (; i + 16 <= sz; i += 16)
+  {
+    const u32 mask = (u32) _mm_movemask_epi8 (_mm_cmpeq_epi8 (_mm_loadu_si128 ((const __m128i *) (buf + i)), nl));
+
+    if (mask) return i + __builtin_ctz (mask);
+  }
+
+  for (; i < sz; i++)
+  {
+    if (buf[i] == '\n') return i;
+  }
+
+  return sz;
+}
 
-    if (*ptr != '\n') continue;
+#define wl_upper_default wl_upper_sse2
+
+#elif defined (__ARM_NEON)
+
+static inline u64 wl_neon_mask (const uint8x16_t cmp)
+{
+  // narrow the 128 bit compare result into a 64 bit mask, 4 bits per byte
+
+  return vget_lane_u64 (vreinterpret_u64_u8 (vshrn_n_u16 (vreinterpretq_u16_u8 (cmp), 4)), 0);
+}
+
+static u64 wl_split_nl_neon (char *buf, u64 *pos, const u64 sz, wl_word_t *words, const u64 words_max)
+{
+  const uint8x16_t nl = vdupq_n_u8 ('\n');
+
+  u64 words_cnt = 0;
+
+  u64 start = *pos;
+
+  u64 i = start;
+
+  for (; i + 16 <= sz; i += 16)
+  {
+    u64 mask = wl_neon_mask (vceqq_u8 (vld1q_u8 ((const u8 *) (buf + i)), nl)) & 0x8888888888888888ULL;
+
+    while (mask)
+    {
+      wl_word_emit (buf, words, &words_cnt, &start, i + (__builtin_ctzll (mask) >> 2));
+
+      mask &= mask - 1;
+
+      if (words_cnt == words_max)
+      {
+        *pos = start;
+
+        return words_cnt;
+      }
+    }
+  }
+
+  return wl_split_nl_tail (buf, pos, sz, words, words_max, words_cnt, start, i);
+}
+
+static void wl_upper_neon (char *buf, const u64 len)
+{
+  const uint8x16_t lo   = vdupq_n_u8 ('a');
+  const uint8x16_t hi   = vdupq_n_u8 ('z');
+  const uint8x16_t flip = vdupq_n_u8 (0x20);
+
+  u64 i = 0;
+
+  for (; i + 16 <= len; i += 16)
+  {
+    const uint8x16_t v = vld1q_u8 ((const u8 *) (buf + i));
 
-    *off = i + 1;
+    const uint8x16_t lower = vandq_u8 (vcgeq_u8 (v, lo), vcleq_u8 (v, hi));
+
+    vst1q_u8 ((u8 *) (buf + i), vsubq_u8 (v, vandq_u8 (lower, flip)));
+  }
+
+  wl_upper_scalar (buf + i, len - i);
+}
+
+static inline u64 wl_find_nl (const char *buf, const u64 sz)
+{
+  const uint8x16_t nl = vdupq_n_u8 ('\n');
+
+  u64 i = 0;
+
+  for (; i + 16 <= sz; i += 16)
+  {
+    const u64 mask = wl_neon_mask (vceqq_u8 (vld1q_u8 ((const u8 *) (buf + i)), nl));
+
+    if (mask) return i + (__builtin_ctzll (mask) >> 2);
+  }
+
+  for (; i < sz; i++)
+  {
+    if (buf[i] == '\n') return i;
+  }
+
+  return sz;
+}
+
+#define wl_upper_default wl_upper_neon
+
+#else
+
+static inline u64 wl_find_nl (const char *buf, const u64 sz)
+{
+  const char *nl = (const char *) memchr (buf, '\n', sz);
+
+  return (nl == NULL) ? sz : (u64) (nl - buf);
+}
+
+#define wl_upper_default wl_upper_scalar
+
+#endif
+
+#if defined (__x86_64__) && (defined (__GNUC__) || defined (__clang__))
+
+#define WL_HAVE_AVX2
+
+// cpu_features.c is only linked into the bridges, the builtin also checks that the OS saves the YMM state
+
+static int wl_cpu_supports_avx2 ()
+{
+  __builtin_cpu_init ();
+
+  return __builtin_cpu_supports ("avx2");
+}
+
+__attribute__ ((target ("avx2")))
+static u64 wl_split_nl_avx2 (char *buf, u64 *pos, const u64 sz, wl_word_t *words, const u64 words_max)
+{
+  const __m256i nl = _mm256_set1_epi8 ('\n');
+
+  u64 words_cnt = 0;
+
+  u64 start = *pos;
+
+  u64 i = start;
+
+  for (; i + 32 <= sz; i += 32)
+  {
+    u32 mask = (u32) _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (_mm256_loadu_si256 ((const __m256i *) (buf + i)), nl));
+
+    while (mask)
+    {
+      wl_word_emit (buf, words, &words_cnt, &start, i + __builtin_ctz (mask));
+
+      mask &= mask - 1;
+
+      if (words_cnt == words_max)
+      {
+        *pos = start;
+
+        return words_cnt;
+      }
+    }
+  }
+
+  return wl_split_nl_tail (buf, pos, sz, words, words_max, words_cnt, start, i);
+}
+
+__attribute__ ((target ("avx2")))
+static void wl_upper_avx2 (char *buf, const u64 len)
+{
+  const __m256i bias  = _mm256_set1_epi8 ((char) (0x80 - 'a'));
+  const __m256i limit = _mm256_set1_epi8 ((char) (-0x80 + 26));
+  const __m256i flip  = _mm256_set1_epi8 (0x20);
+
+  u64 i = 0;
+
+  for (; i + 32 <= len; i += 32)
+  {
+    const __m256i v = _mm256_loadu_si256 ((const __m256i *) (buf + i));
+
+    const __m256i lower = _mm256_cmpgt_epi8 (limit, _mm256_add_epi8 (v, bias));
+
+    _mm256_storeu_si256 ((__m256i *) (buf + i), _mm256_sub_epi8 (v, _mm256_and_si256 (lower, flip)));
+  }
+
+  wl_upper_scalar (buf + i, len - i);
+}
+
+#endif
+
+void get_next_word_lm_gen (char *buf, u64 sz, u64 *len, u64 *off, u64 cutlen)
+{
+  const u64 nl = wl_find_nl (buf, sz);
+
+  // only the first cutlen characters can end up in the candidate
+
+  wl_upper_default (buf, MIN (nl, cutlen));
+
+  if ((nl > cutlen) || ((nl == cutlen) && (nl < sz)))
+  {
+    if (cutlen == 20) buf[cutlen - 1] = ']'; // add ] in $HEX[] format
+
+    *len = cutlen;
+
+    // but continue to skip rest of the line
+  }
+
+  if (nl < sz)
+  {
+    *off = nl + 1;
+
+    u64 i = nl;
 
     if ((i > 0) && (buf[i - 1] == '\r')) i--;
 
@@ -133,7 +481,7 @@ void get_next_word_lm_gen (char *buf, u64 sz, u64 *len, u64 *off, u64 cutlen)
 
   *off = sz;
 
-  if (sz < cutlen) *len = sz;
+  if (sz <= cutlen) *len = sz;
 }
 
 void get_next_word_lm_hex (char *buf, u64 sz, u64 *len, u64 *off)
@@ -232,214 +580,584 @@ void get_next_word_lm_text (char *buf, u64 sz, u64 *len, u64 *off)
 
 void get_next_word_uc (char *buf, u64 sz, u64 *len, u64 *off)
 {
-  char *ptr = buf;
+  const u64 nl = wl_find_nl (buf, sz);
+
+  wl_upper_default (buf, nl);
+
+  if (nl < sz)
+  {
+    *off = nl + 1;
+
+    u64 i = nl;
+
+    if ((i > 0) && (buf[i - 1] == '\r')) i--;
+
+    *len = i;
+
+    return;
+  }
+
+  *off = sz;
+  *len = sz;
+}
+
+void get_next_word_std (char *buf, u64 sz, u64 *len, u64 *off)
+{
+  const u64 nl = wl_find_nl (buf, sz);
+
+  if (nl < sz)
+  {
+    *off = nl + 1;
+
+    u64 i = nl;
+
+    if ((i > 0) && (buf[i - 1] == '\r')) i--;
+
+    *len = i;
+
+    return;
+  }
+
+  *off = sz;
+  *len = sz;
+}
+
+u64 wl_split_func (const wl_data_t *wl_data, char *buf, u64 *pos, const u64 sz, wl_word_t *words, const u64 words_max)
+{
+  // generic splitter for parsers which need to look at each line, e.g. LM
+
+  u64 words_cnt = 0;
+
+  u64 i = *pos;
+
+  while ((i < sz) && (words_cnt < words_max))
+  {
+    u64 len = 0;
+    u64 off = 0;
+
+    wl_data->func (buf + i, sz - i, &len, &off);
+
+    words[words_cnt].off = i;
+    words[words_cnt].len = len;
+
+    words_cnt++;
+
+    i += off;
+  }
+
+  *pos = i;
+
+  return words_cnt;
+}
+
+u64 wl_split_std (const wl_data_t *wl_data, char *buf, u64 *pos, const u64 sz, wl_word_t *words, const u64 words_max)
+{
+  return wl_data->split_nl (buf, pos, sz, words, words_max);
+}
+
+u64 wl_split_uc (const wl_data_t *wl_data, char *buf, u64 *pos, const u64 sz, wl_word_t *words, const u64 words_max)
+{
+  const u64 start = *pos;
+
+  const u64 words_cnt = wl_data->split_nl (buf, pos, sz, words, words_max);
+
+  // line boundaries are not affected by upper casing, so do the whole batch in one go
+
+  wl_data->upper (buf + start, *pos - start);
+
+  return words_cnt;
+}
+
+void get_next_word (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, char **out_buf, u32 *out_len)
+{
+  user_options_t       *user_options       = hashcat_ctx->user_options;
+  user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
+  wl_data_t            *wl_data            = hashcat_ctx->wl_data;
+
+  while (true)
+  {
+    while (wl_data->words_pos < wl_data->words_cnt)
+    {
+      const wl_word_t *word = wl_data->words + wl_data->words_pos;
+
+      wl_data->words_pos++;
+
+      char *ptr = wl_data->seg + word->off;
+
+      u64 len = word->len;
+
+      // do the on-the-fly hex decode using original buffer
+      // this is safe as length only decreases in size
+
+      len = (u32) convert_from_hex (hashcat_ctx, ptr, len);
+
+      // do the on-the-fly encoding
+      // needs to write into new buffer because size case both decrease and increase
+
+      if (wl_data->iconv_enabled == true)
+      {
+        char  *iconv_ptr = wl_data->iconv_tmp;
+        size_t iconv_sz  = HCBUFSIZ_TINY;
+
+        size_t ptr_len = len;
+
+        const size_t iconv_rc = iconv (wl_data->iconv_ctx, &ptr, &ptr_len, &iconv_ptr, &iconv_sz);
+
+        if (iconv_rc == (size_t) -1) continue;
+
+        ptr = wl_data->iconv_tmp;
+        len = HCBUFSIZ_TINY - iconv_sz;
+      }
+
+      // this is only a test for length, not writing into output buffer
+
+      if (run_rule_engine (user_options_extra->rule_len_l, user_options->rule_buf_l))
+      {
+        if (len >= RP_PASSWORD_SIZE) continue;
+
+        char rule_buf_out[RP_PASSWORD_SIZE];
+
+        memset (rule_buf_out, 0, sizeof (rule_buf_out));
+
+        const int rule_len_out = _old_apply_rule (user_options->rule_buf_l, user_options_extra->rule_len_l, ptr, (u32) len, rule_buf_out);
+
+        if (rule_len_out < 0) continue;
+      }
+
+      if (len > PW_MAX) continue;
+
+      *out_buf = ptr;
+      *out_len = (u32) len;
+
+      return;
+    }
+
+    if (wl_data->pos < wl_data->cnt)
+    {
+      wl_data->words_cnt = wl_data->split (wl_data, wl_data->seg, &wl_data->pos, wl_data->cnt, wl_data->words, WL_WORDS_MAX);
+      wl_data->words_pos = 0;
+
+      continue;
+    }
+
+    if (hc_feof (fp))
+    {
+      fprintf (stderr, "BUG feof()!!\n");
+
+      return;
+    }
+
+    if (load_segment (hashcat_ctx, fp) == -1)
+    {
+      event_log_error (hashcat_ctx, "Error reading file!\n");
+
+      return;
+    }
+  }
+}
+
+void pw_pre_add (hc_device_param_t *device_param, const u8 *pw_buf, const int pw_len, const u8 *base_buf, const int base_len, const int rule_idx)
+{
+  if (device_param->pws_pre_cnt < device_param->kernel_power)
+  {
+    pw_pre_t *pw_pre = device_param->pws_pre_buf + device_param->pws_pre_cnt;
+
+    memcpy (pw_pre->pw_buf, pw_buf, pw_len);
+
+    pw_pre->pw_len = pw_len;
+
+    if (base_buf != NULL)
+    {
+      memcpy (pw_pre->base_buf, base_buf, base_len);
+
+      pw_pre->base_len = base_len;
+    }
+
+    pw_pre->rule_idx = rule_idx;
+
+    device_param->pws_pre_cnt++;
+  }
+  else
+  {
+    fprintf (stdout, "BUG pw_pre_add()!!\n");
+
+    return;
+  }
+}
+
+void pw_base_add (hc_device_param_t *device_param, pw_pre_t *pw_pre)
+{
+  if (device_param->pws_base_cnt < device_param->kernel_power)
+  {
+    memcpy (device_param->pws_base_buf + device_param->pws_base_cnt, pw_pre, sizeof (pw_pre_t));
+
+    device_param->pws_base_cnt++;
+  }
+  else
+  {
+    fprintf (stderr, "BUG pw_base_add()!!\n");
+
+    return;
+  }
+}
+
+void pw_add (hc_device_param_t *device_param, const u8 *pw_buf, const int pw_len)
+{
+  if (device_param->pws_cnt < device_param->kernel_power)
+  {
+    pw_idx_t *pw_idx = device_param->pws_idx + device_param->pws_cnt;
+
+    const u32 pw_len4 = (pw_len + 3) & ~3; // round up to multiple of 4
+
+    const u32 pw_len4_cnt = pw_len4 / 4;
+
+    pw_idx->cnt = pw_len4_cnt;
+    pw_idx->len = pw_len;
+
+    u8 *dst = (u8 *) (device_param->pws_comp + pw_idx->off);
+
+    memcpy (dst, pw_buf, pw_len);
+
+    memset (dst + pw_len, 0, pw_len4 - pw_len);
+
+    // prepare next element
+
+    pw_idx_t *pw_idx_next = pw_idx + 1;
+
+    pw_idx_next->off = pw_idx->off + pw_idx->cnt;
+
+    device_param->pws_cnt++;
+  }
+  else
+  {
+    fprintf (stderr, "BUG pw_add()!!\n");
+
+    return;
+  }
+}
+
+static int count_words_keyspace (hashcat_ctx_t *hashcat_ctx, const u64 words, u64 *keyspace)
+{
+  combinator_ctx_t     *combinator_ctx     = hashcat_ctx->combinator_ctx;
+  hashconfig_t         *hashconfig         = hashcat_ctx->hashconfig;
+  straight_ctx_t       *straight_ctx       = hashcat_ctx->straight_ctx;
+  mask_ctx_t           *mask_ctx           = hashcat_ctx->mask_ctx;
+  user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
+  user_options_t       *user_options       = hashcat_ctx->user_options;
+
+  u64 cnt = words;
+
+  if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
+  {
+    if (overflow_check_u64_mul (cnt, straight_ctx->kernel_rules_cnt) == false) return -1;
+
+    cnt *= straight_ctx->kernel_rules_cnt;
+  }
+  else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
+  {
+    if (((hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL) == 0) && (user_options->attack_mode == ATTACK_MODE_HYBRID2))
+    {
+      if (overflow_check_u64_mul (cnt, mask_ctx->bfs_cnt) == false) return -1;
+
+      cnt *= mask_ctx->bfs_cnt;
+    }
+    else
+    {
+      if (overflow_check_u64_mul (cnt, combinator_ctx->combs_cnt) == false) return -1;
+
+      cnt *= combinator_ctx->combs_cnt;
+    }
+  }
+
+  *keyspace = cnt;
+
+  return 0;
+}
+
+static void count_words_segment (hashcat_ctx_t *hashcat_ctx, char *seg, u64 pos, const u64 sz, u64 *words, u64 *words2)
+{
+  user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
+  user_options_t       *user_options       = hashcat_ctx->user_options;
+  wl_data_t            *wl_data            = hashcat_ctx->wl_data;
+
+  u64 cnt  = 0;
+  u64 cnt2 = 0;
+
+  while (pos < sz)
+  {
+    const u64 words_cnt = wl_data->split (wl_data, seg, &pos, sz, wl_data->words, WL_WORDS_MAX);
+
+    for (u64 words_idx = 0; words_idx < words_cnt; words_idx++)
+    {
+      char *ptr = seg + wl_data->words[words_idx].off;
+
+      u64 len = wl_data->words[words_idx].len;
+
+      // do the on-the-fly hex decode using original buffer
+      // this is safe as length only decreases in size
+
+      len = (u32) convert_from_hex (hashcat_ctx, ptr, len);
+
+      // do the on-the-fly encoding
+
+      if (wl_data->iconv_enabled == true)
+      {
+        char  *iconv_ptr = wl_data->iconv_tmp;
+        size_t iconv_sz  = HCBUFSIZ_TINY;
+
+        size_t ptr_len = len;
+
+        const size_t iconv_rc = iconv (wl_data->iconv_ctx, &ptr, &ptr_len, &iconv_ptr, &iconv_sz);
+
+        if (iconv_rc == (size_t) -1) continue;
+
+        ptr = wl_data->iconv_tmp;
+        len = HCBUFSIZ_TINY - iconv_sz;
+      }
+
+      if (run_rule_engine (user_options_extra->rule_len_l, user_options->rule_buf_l))
+      {
+        if (len >= RP_PASSWORD_SIZE) continue;
 
-  for (u64 i = 0; i < sz; i++, ptr++)
-  {
-    if (*ptr >= 'a' && *ptr <= 'z') *ptr -= 0x20;
+        char rule_buf_out[RP_PASSWORD_SIZE];
 
-    if (*ptr != '\n') continue;
+        memset (rule_buf_out, 0, sizeof (rule_buf_out));
 
-    *off = i + 1;
+        const int rule_len_out = _old_apply_rule (user_options->rule_buf_l, user_options_extra->rule_len_l, ptr, (u32) len, rule_buf_out);
 
-    if ((i > 0) && (buf[i - 1] == '\r')) i--;
+        if (rule_len_out < 0) continue;
+      }
 
-    *len = i;
+      cnt2++;
 
-    return;
+      if (len > PW_MAX) continue;
+
+      cnt++;
+    }
   }
 
-  *off = sz;
-  *len = sz;
+  *words  = cnt;
+  *words2 = cnt2;
 }
 
-void get_next_word_std (char *buf, u64 sz, u64 *len, u64 *off)
+static HC_API_CALL void *count_words_thread (void *p)
 {
-  char *ptr = buf;
+  wl_count_thread_param_t *param = (wl_count_thread_param_t *) p;
 
-  for (u64 i = 0; i < sz; i++, ptr++)
+  for (u64 chunk = param->tid; chunk < param->chunks_cnt; chunk += param->tsz)
   {
-    if (*ptr != '\n') continue;
+    const u64 beg = param->chunks_off[chunk];
+    const u64 end = param->chunks_off[chunk + 1];
 
-    *off = i + 1;
+    count_words_segment (&param->hashcat_ctx, param->fp->mfp, beg, end, param->chunks_words + chunk, param->chunks_words2 + chunk);
 
-    if ((i > 0) && (buf[i - 1] == '\r')) i--;
+    // the parsers modify the private mapping, don't let the copies pile up
 
-    *len = i;
+    hc_fmap_drop (param->fp, beg, end - beg);
 
-    return;
+    param->comp += end - beg;
   }
 
-  *off = sz;
-  *len = sz;
+  param->done = true;
+
+  return NULL;
 }
 
-void get_next_word (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, char **out_buf, u32 *out_len)
+static int count_words_parallel (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, const u64 dict_size, u64 *words, u64 *words2, u64 *comp, dictstat_chkpt_t **chkpts, u64 *chkpts_cnt)
 {
-  user_options_t       *user_options       = hashcat_ctx->user_options;
-  user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
-  wl_data_t            *wl_data            = hashcat_ctx->wl_data;
-
-  while (wl_data->pos < wl_data->cnt)
-  {
-    u64 off;
-    u64 len;
+  user_options_t *user_options = hashcat_ctx->user_options;
+  wl_data_t      *wl_data      = hashcat_ctx->wl_data;
 
-    char *ptr = wl_data->buf + wl_data->pos;
+  const int processor_count = hc_get_processor_count ();
 
-    wl_data->func (ptr, wl_data->cnt - wl_data->pos, &len, &off);
+  if (processor_count < 2) return 0;
 
-    wl_data->pos += off;
+  if (hc_fmap (fp) == false) return 0;
 
-    // do the on-the-fly hex decode using original buffer
-    // this is safe as length only decreases in size
+  // split the mapping into chunks of about one segment, each ending with a newline
+  // whatever follows the last newline is left to the serial loop in count_words ()
 
-    len = (u32) convert_from_hex (hashcat_ctx, ptr, len);
+  const u64 chunk_size = wl_data->incr - 1000;
 
-    // do the on-the-fly encoding
-    // needs to write into new buffer because size case both decrease and increase
+  const u64 start = fp->mfp_pos;
 
-    if (wl_data->iconv_enabled == true)
-    {
-      char  *iconv_ptr = wl_data->iconv_tmp;
-      size_t iconv_sz  = HCBUFSIZ_TINY;
+  u64 *chunks_off = (u64 *) hccalloc (((fp->mfp_len - start) / chunk_size) + 2, sizeof (u64));
 
-      size_t ptr_len = len;
+  u64 chunks_cnt = 0;
 
-      const size_t iconv_rc = iconv (wl_data->iconv_ctx, &ptr, &ptr_len, &iconv_ptr, &iconv_sz);
+  u64 pos = start;
 
-      if (iconv_rc == (size_t) -1) continue;
+  while ((pos + chunk_size) < fp->mfp_len)
+  {
+    const u64 from = pos + chunk_size - 1;
 
-      ptr = wl_data->iconv_tmp;
-      len = HCBUFSIZ_TINY - iconv_sz;
-    }
+    const char *nl = (const char *) memchr (fp->mfp + from, '\n', (size_t) (fp->mfp_len - from));
 
-    // this is only a test for length, not writing into output buffer
+    if (nl == NULL) break;
 
-    if (run_rule_engine (user_options_extra->rule_len_l, user_options->rule_buf_l))
-    {
-      if (len >= RP_PASSWORD_SIZE) continue;
+    chunks_off[chunks_cnt] = pos;
 
-      char rule_buf_out[RP_PASSWORD_SIZE];
+    chunks_cnt++;
 
-      memset (rule_buf_out, 0, sizeof (rule_buf_out));
+    pos = (u64) (nl - fp->mfp) + 1;
+  }
 
-      const int rule_len_out = _old_apply_rule (user_options->rule_buf_l, user_options_extra->rule_len_l, ptr, (u32) len, rule_buf_out);
+  chunks_off[chunks_cnt] = pos;
 
-      if (rule_len_out < 0) continue;
-    }
+  if (chunks_cnt < 2)
+  {
+    hcfree (chunks_off);
 
-    if (len > PW_MAX) continue;
+    return 0;
+  }
 
-    *out_buf = ptr;
-    *out_len = (u32) len;
+  const int tsz = (int) MIN ((u64) processor_count, chunks_cnt);
 
-    return;
-  }
+  wl_count_thread_param_t *threads_param = (wl_count_thread_param_t *) hccalloc (tsz, sizeof (wl_count_thread_param_t));
+  hc_thread_t             *c_threads     = (hc_thread_t *)             hccalloc (tsz, sizeof (hc_thread_t));
 
-  if (hc_feof (fp))
-  {
-    fprintf (stderr, "BUG feof()!!\n");
+  u64 *chunks_words  = (u64 *) hccalloc (chunks_cnt, sizeof (u64));
+  u64 *chunks_words2 = (u64 *) hccalloc (chunks_cnt, sizeof (u64));
 
-    return;
-  }
+  int rc = 0;
 
-  if (load_segment (hashcat_ctx, fp) == -1)
+  for (int i = 0; i < tsz; i++)
   {
-    event_log_error (hashcat_ctx, "Error reading file!\n");
+    wl_count_thread_param_t *param = threads_param + i;
 
-    return;
-  }
+    param->tid = i;
+    param->tsz = tsz;
 
-  get_next_word (hashcat_ctx, fp, out_buf, out_len);
-}
+    // each thread gets its own splitter state and iconv context, everything else is shared read-only
 
-void pw_pre_add (hc_device_param_t *device_param, const u8 *pw_buf, const int pw_len, const u8 *base_buf, const int base_len, const int rule_idx)
-{
-  if (device_param->pws_pre_cnt < device_param->kernel_power)
-  {
-    pw_pre_t *pw_pre = device_param->pws_pre_buf + device_param->pws_pre_cnt;
+    memcpy (&param->hashcat_ctx, hashcat_ctx, sizeof (hashcat_ctx_t));
+    memcpy (&param->wl_data,     wl_data,     sizeof (wl_data_t));
 
-    memcpy (pw_pre->pw_buf, pw_buf, pw_len);
+    param->hashcat_ctx.wl_data = &param->wl_data;
 
-    pw_pre->pw_len = pw_len;
+    param->wl_data.words = (wl_word_t *) hccalloc (WL_WORDS_MAX, sizeof (wl_word_t));
 
-    if (base_buf != NULL)
+    if (wl_data->iconv_enabled == true)
     {
-      memcpy (pw_pre->base_buf, base_buf, base_len);
+      param->wl_data.iconv_ctx = iconv_open (user_options->encoding_to, user_options->encoding_from);
 
-      pw_pre->base_len = base_len;
+      if (param->wl_data.iconv_ctx == (iconv_t) -1) rc = -1;
+
+      param->wl_data.iconv_tmp = (char *) hcmalloc (HCBUFSIZ_TINY);
     }
 
-    pw_pre->rule_idx = rule_idx;
+    param->fp = fp;
 
-    device_param->pws_pre_cnt++;
+    param->chunks_off    = chunks_off;
+    param->chunks_words  = chunks_words;
+    param->chunks_words2 = chunks_words2;
+    param->chunks_cnt    = chunks_cnt;
   }
-  else
+
+  if (rc == 0)
   {
-    fprintf (stdout, "BUG pw_pre_add()!!\n");
+    for (int i = 0; i < tsz; i++)
+    {
+      hc_thread_create (c_threads[i], count_words_thread, threads_param + i);
+    }
 
-    return;
-  }
-}
+    time_t prev;
 
-void pw_base_add (hc_device_param_t *device_param, pw_pre_t *pw_pre)
-{
-  if (device_param->pws_base_cnt < device_param->kernel_power)
-  {
-    memcpy (device_param->pws_base_buf + device_param->pws_base_cnt, pw_pre, sizeof (pw_pre_t));
+    time (&prev);
 
-    device_param->pws_base_cnt++;
-  }
-  else
-  {
-    fprintf (stderr, "BUG pw_base_add()!!\n");
+    while (true)
+    {
+      int done_cnt = 0;
 
-    return;
-  }
-}
+      u64 comp_cur = 0;
 
-void pw_add (hc_device_param_t *device_param, const u8 *pw_buf, const int pw_len)
-{
-  if (device_param->pws_cnt < device_param->kernel_power)
-  {
-    pw_idx_t *pw_idx = device_param->pws_idx + device_param->pws_cnt;
+      for (int i = 0; i < tsz; i++)
+      {
+        if (threads_param[i].done == true) done_cnt++;
 
-    const u32 pw_len4 = (pw_len + 3) & ~3; // round up to multiple of 4
+        comp_cur += threads_param[i].comp;
+      }
 
-    const u32 pw_len4_cnt = pw_len4 / 4;
+      if (done_cnt == tsz) break;
 
-    pw_idx->cnt = pw_len4_cnt;
-    pw_idx->len = pw_len;
+      usleep (100000);
 
-    u8 *dst = (u8 *) (device_param->pws_comp + pw_idx->off);
+      time_t now;
 
-    memcpy (dst, pw_buf, pw_len);
+      time (&now);
 
-    memset (dst + pw_len, 0, pw_len4 - pw_len);
+      if ((now - prev) == 0) continue;
 
-    // prepare next element
+      time (&prev);
 
-    pw_idx_t *pw_idx_next = pw_idx + 1;
+      cache_generate_t cache_generate;
 
-    pw_idx_next->off = pw_idx->off + pw_idx->cnt;
+      memset (&cache_generate, 0, sizeof (cache_generate));
 
-    device_param->pws_cnt++;
+      cache_generate.dictfile = dictfile;
+      cache_generate.comp     = comp_cur;
+      cache_generate.percent  = ((double) comp_cur / (double) dict_size) * 100;
+
+      if (cache_generate.percent < 100)
+      {
+        EVENT_DATA (EVENT_WORDLIST_CACHE_GENERATE, &cache_generate, sizeof (cache_generate));
+      }
+    }
+
+    hc_thread_wait (tsz, c_threads);
+
+    // one checkpoint per chunk
+
+    dictstat_chkpt_t *chunks_chkpts = (dictstat_chkpt_t *) hccalloc (chunks_cnt, sizeof (dictstat_chkpt_t));
+
+    u64 cnt  = 0;
+    u64 cnt2 = 0;
+
+    for (u64 chunk = 0; chunk < chunks_cnt; chunk++)
+    {
+      chunks_chkpts[chunk].offset = chunks_off[chunk];
+      chunks_chkpts[chunk].words  = cnt;
+
+      cnt  += chunks_words[chunk];
+      cnt2 += chunks_words2[chunk];
+    }
+
+    *words      = cnt;
+    *words2     = cnt2;
+    *comp       = chunks_off[chunks_cnt] - start;
+    *chkpts     = chunks_chkpts;
+    *chkpts_cnt = chunks_cnt;
+
+    // continue with the remainder
+
+    hc_fseek (fp, (off_t) chunks_off[chunks_cnt], SEEK_SET);
   }
-  else
+
+  for (int i = 0; i < tsz; i++)
   {
-    fprintf (stderr, "BUG pw_add()!!\n");
+    wl_count_thread_param_t *param = threads_param + i;
 
-    return;
+    hcfree (param->wl_data.words);
+
+    if (wl_data->iconv_enabled == true)
+    {
+      if (param->wl_data.iconv_ctx != (iconv_t) -1) iconv_close (param->wl_data.iconv_ctx);
+
+      hcfree (param->wl_data.iconv_tmp);
+    }
   }
+
+  hcfree (chunks_words);
+  hcfree (chunks_words2);
+  hcfree (chunks_off);
+  hcfree (c_threads);
+  hcfree (threads_param);
+
+  return rc;
 }
 
 int count_words (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, u64 *result)
 {
-  combinator_ctx_t     *combinator_ctx     = hashcat_ctx->combinator_ctx;
-  hashconfig_t         *hashconfig         = hashcat_ctx->hashconfig;
-  straight_ctx_t       *straight_ctx       = hashcat_ctx->straight_ctx;
-  mask_ctx_t           *mask_ctx           = hashcat_ctx->mask_ctx;
   user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
   user_options_t       *user_options       = hashcat_ctx->user_options;
   wl_data_t            *wl_data            = hashcat_ctx->wl_data;
@@ -518,29 +1236,15 @@ int count_words (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, u
   {
     if (cached_cnt)
     {
-      u64 keyspace = cached_cnt;
+      u64 keyspace = 0;
 
-      if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
-      {
-        if (overflow_check_u64_mul (keyspace, straight_ctx->kernel_rules_cnt) == false) return -1;
+      if (count_words_keyspace (hashcat_ctx, cached_cnt, &keyspace) == -1) return -1;
 
-        keyspace *= straight_ctx->kernel_rules_cnt;
-      }
-      else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
-      {
-        if (((hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL) == 0) && (user_options->attack_mode == ATTACK_MODE_HYBRID2))
-        {
-          if (overflow_check_u64_mul (keyspace, mask_ctx->bfs_cnt) == false) return -1;
+      // pick up the checkpoints recorded when the cache entry was built
 
-          keyspace *= mask_ctx->bfs_cnt;
-        }
-        else
-        {
-          if (overflow_check_u64_mul (keyspace, combinator_ctx->combs_cnt) == false) return -1;
+      d.cnt = cached_cnt;
 
-          keyspace *= combinator_ctx->combs_cnt;
-        }
-      }
+      dictstat_idx_load (hashcat_ctx, dictfile, &d);
 
       cache_hit_t cache_hit;
 
@@ -568,91 +1272,53 @@ int count_words (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, u
   u64 cnt  = 0;
   u64 cnt2 = 0;
 
-  while (!hc_feof (fp))
-  {   
-    if (load_segment (hashcat_ctx, fp) == -1)
-    {
-      return -2;
-    }
-    
-    comp += wl_data->cnt;
-
-    u64 i = 0;
-
-    while (i < wl_data->cnt)
-    {
-      u64 len;
-      u64 off;
-
-      char *ptr = wl_data->buf + i;
-
-      wl_data->func (ptr, wl_data->cnt - i, &len, &off);
-
-      i += off;
-
-      // do the on-the-fly hex decode using original buffer
-      // this is safe as length only decreases in size
-
-      len = (u32) convert_from_hex (hashcat_ctx, ptr, len);
-
-      // do the on-the-fly encoding
+  dictstat_chkpt_t *chkpts     = NULL;
+  u64               chkpts_cnt = 0;
 
-      if (wl_data->iconv_enabled == true)
-      {
-        char  *iconv_ptr = wl_data->iconv_tmp;
-        size_t iconv_sz  = HCBUFSIZ_TINY;
+  // large uncompressed wordlists are counted in parallel, the serial loop below only sees what is left
 
-        size_t ptr_len = len;
+  if (count_words_parallel (hashcat_ctx, fp, dictfile, (u64) d.stat.st_size, &d.cnt, &cnt2, &comp, &chkpts, &chkpts_cnt) == -1)
+  {
+    return -2;
+  }
 
-        const size_t iconv_rc = iconv (wl_data->iconv_ctx, &ptr, &ptr_len, &iconv_ptr, &iconv_sz);
+  const bool seekable = hc_fseekable (fp);
 
-        if (iconv_rc == (size_t) -1) continue;
+  while (!hc_feof (fp))
+  {
+    // every segment starts on a line boundary, remember where so --skip and restore can seek there later
 
-        ptr = wl_data->iconv_tmp;
-        len = HCBUFSIZ_TINY - iconv_sz;
-      }
+    if ((seekable == true) && (d.cnt > 0))
+    {
+      const off_t seg_off = hc_ftell (fp);
 
-      if (run_rule_engine (user_options_extra->rule_len_l, user_options->rule_buf_l))
+      if ((seg_off > 0) && ((chkpts_cnt == 0) || (chkpts[chkpts_cnt - 1].offset < (u64) seg_off)))
       {
-        if (len >= RP_PASSWORD_SIZE) continue;
-
-        char rule_buf_out[RP_PASSWORD_SIZE];
+        chkpts = (dictstat_chkpt_t *) hcrealloc (chkpts, chkpts_cnt * sizeof (dictstat_chkpt_t), sizeof (dictstat_chkpt_t));
 
-        memset (rule_buf_out, 0, sizeof (rule_buf_out));
-
-        const int rule_len_out = _old_apply_rule (user_options->rule_buf_l, user_options_extra->rule_len_l, ptr, (u32) len, rule_buf_out);
+        chkpts[chkpts_cnt].offset = (u64) seg_off;
+        chkpts[chkpts_cnt].words  = d.cnt;
 
-        if (rule_len_out < 0) continue;
+        chkpts_cnt++;
       }
+    }
 
-      cnt2++;
-
-      if (len > PW_MAX) continue;
+    if (load_segment (hashcat_ctx, fp) == -1)
+    {
+      hcfree (chkpts);
 
-      d.cnt++;
+      return -2;
+    }
 
-      if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
-      {
-        if (overflow_check_u64_add (cnt, straight_ctx->kernel_rules_cnt) == false) return -1;
+    comp += wl_data->cnt;
 
-        cnt += straight_ctx->kernel_rules_cnt;
-      }
-      else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
-      {
-        if (((hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL) == 0) && (user_options->attack_mode == ATTACK_MODE_HYBRID2))
-        {
-          if (overflow_check_u64_add (cnt, mask_ctx->bfs_cnt) == false) return -1;
+    u64 words  = 0;
+    u64 words2 = 0;
 
-          cnt += mask_ctx->bfs_cnt;
-        }
-        else
-        {
-          if (overflow_check_u64_add (cnt, combinator_ctx->combs_cnt) == false) return -1;
+    count_words_segment (hashcat_ctx, wl_data->seg, 0, wl_data->cnt, &words, &words2);
 
-          cnt += combinator_ctx->combs_cnt;
-        }
-      }
-    }
+    d.cnt += words;
+    cnt2  += words2;
 
     time (&now);
 
@@ -664,6 +1330,13 @@ int count_words (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, u
 
     if (percent < 100)
     {
+      if (count_words_keyspace (hashcat_ctx, d.cnt, &cnt) == -1)
+      {
+        hcfree (chkpts);
+
+        return -1;
+      }
+
       cache_generate_t cache_generate;
 
       cache_generate.dictfile    = dictfile;
@@ -676,6 +1349,13 @@ int count_words (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, u
     }
   }
 
+  if (count_words_keyspace (hashcat_ctx, d.cnt, &cnt) == -1)
+  {
+    hcfree (chkpts);
+
+    return -1;
+  }
+
   time_t rt_stop;
 
   time (&rt_stop);
@@ -693,6 +1373,8 @@ int count_words (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, u
 
   dictstat_append (hashcat_ctx, &d);
 
+  dictstat_idx_add (hashcat_ctx, dictfile, &d, chkpts, chkpts_cnt);
+
   //hc_signal (sigHandler_default);
 
   *result = cnt;
@@ -700,6 +1382,63 @@ int count_words (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, u
   return 0;
 }
 
+u64 skip_words (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, u64 words_cur, const u64 words_off)
+{
+  wl_data_t *wl_data = hashcat_ctx->wl_data;
+
+  const dictstat_idx_t *idx = dictstat_idx_find (hashcat_ctx, dictfile);
+
+  if ((idx != NULL) && (hc_fseekable (fp) == true))
+  {
+    // find the last checkpoint at or before words_off
+
+    u64 lo = 0;
+    u64 hi = idx->chkpts_cnt;
+
+    while (lo < hi)
+    {
+      const u64 mid = lo + ((hi - lo) / 2);
+
+      if (idx->chkpts[mid].words <= words_off)
+      {
+        lo = mid + 1;
+      }
+      else
+      {
+        hi = mid;
+      }
+    }
+
+    if (lo > 0)
+    {
+      const dictstat_chkpt_t *chkpt = idx->chkpts + lo - 1;
+
+      // only seek if it saves reading, never go backwards
+
+      if (chkpt->words > words_cur)
+      {
+        if (hc_fseek (fp, (off_t) chkpt->offset, SEEK_SET) == 0)
+        {
+          wl_data->pos = 0;
+          wl_data->cnt = 0;
+
+          wl_data->words_cnt = 0;
+          wl_data->words_pos = 0;
+
+          words_cur = chkpt->words;
+        }
+      }
+    }
+  }
+
+  char *line_buf;
+  u32   line_len;
+
+  for ( ; words_cur < words_off; words_cur++) get_next_word (hashcat_ctx, fp, &line_buf, &line_len);
+
+  return words_cur;
+}
+
 int wl_data_init (hashcat_ctx_t *hashcat_ctx)
 {
   wl_data_t      *wl_data      = hashcat_ctx->wl_data;
@@ -719,20 +1458,48 @@ int wl_data_init (hashcat_ctx_t *hashcat_ctx)
   wl_data->enabled = true;
 
   wl_data->buf     = (char *) hcmalloc (user_options->segment_size);
+  wl_data->seg     = wl_data->buf;
   wl_data->avail   = user_options->segment_size;
   wl_data->incr    = user_options->segment_size;
   wl_data->cnt     = 0;
   wl_data->pos     = 0;
 
+  wl_data->words     = (wl_word_t *) hccalloc (WL_WORDS_MAX, sizeof (wl_word_t));
+  wl_data->words_cnt = 0;
+  wl_data->words_pos = 0;
+
+  /**
+   * choose line splitter
+   */
+
+  wl_data->split_nl = wl_split_nl_scalar;
+  wl_data->upper    = wl_upper_default;
+
+  #if defined (__SSE2__)
+  wl_data->split_nl = wl_split_nl_sse2;
+  #elif defined (__ARM_NEON)
+  wl_data->split_nl = wl_split_nl_neon;
+  #endif
+
+  #if defined (WL_HAVE_AVX2)
+  if (wl_cpu_supports_avx2 ())
+  {
+    wl_data->split_nl = wl_split_nl_avx2;
+    wl_data->upper    = wl_upper_avx2;
+  }
+  #endif
+
   /**
    * choose dictionary parser
    */
 
-  wl_data->func = get_next_word_std;
+  wl_data->func  = get_next_word_std;
+  wl_data->split = wl_split_std;
 
   if (hashconfig->opts_type & OPTS_TYPE_PT_UPPER)
   {
-    wl_data->func = get_next_word_uc;
+    wl_data->func  = get_next_word_uc;
+    wl_data->split = wl_split_uc;
   }
 
   if (hashconfig->opts_type & OPTS_TYPE_PT_LM)
@@ -752,6 +1519,8 @@ int wl_data_init (hashcat_ctx_t *hashcat_ctx)
         wl_data->func = get_next_word_lm_text;        // treat as normal text
       }
     }
+
+    wl_data->split = wl_split_func;
   }
 
   /**
@@ -779,6 +1548,7 @@ void wl_data_destroy (hashcat_ctx_t *hashcat_ctx)
   if (wl_data->enabled == false) return;
 
   hcfree (wl_data->buf);
+  hcfree (wl_data->words);
 
   if (wl_data->iconv_enabled == true)
   {
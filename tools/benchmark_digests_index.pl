@@ -0,0 +1,35 @@
+#!/usr/bin/env perl
+
+##
+## Author......: See docs/credits.txt
+## License.....: MIT
+##
+
+## Generates an unsalted MD5 hashlist (-m 0) of random digests to benchmark the digest lookup of the kernels.
+## Compare the speed with and without the bucket index, for example at 1K, 1M and 100M digests.
+## Use --bitmap-max=18 to keep enough candidates passing the bitmaps so the lookup cost is visible.
+##
+## Usage: perl tools/benchmark_digests_index.pl [digests] [outfile]
+##        : > empty.pot && ./hashcat -m 0 -a 3 -w 3 --potfile-path empty.pot --bitmap-max=18 --runtime=60 outfile ?a?a?a?a?a?a?a?a
+##        : > empty.pot && ./hashcat -m 0 -a 3 -w 3 --potfile-path empty.pot --bitmap-max=18 --runtime=60 outfile ?a?a?a?a?a?a?a?a --digests-index-disable
+
+use strict;
+use warnings;
+
+my $digests = shift // 1000000;
+my $outfile = shift // "digests_index_bench.txt";
+
+die "usage: $0 [digests] [outfile]\n" unless $digests =~ m/^[0-9]+$/;
+
+srand (1034);
+
+open (my $fh, ">", $outfile) or die "Unable to open '$outfile': $!\n";
+
+for (my $i = 0; $i < $digests; $i++)
+{
+  printf $fh ("%08x%08x%08x%08x\n", int (rand (2 ** 32)), int (rand (2 ** 32)), int (rand (2 ** 32)), int (rand (2 ** 32)));
+}
+
+close ($fh);
+
+print "$outfile: $digests digests\n";
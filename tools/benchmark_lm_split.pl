@@ -0,0 +1,45 @@
+#!/usr/bin/env perl
+
+##
+## Author......: See docs/credits.txt
+## License.....: MIT
+##
+
+## Generates a LM hashlist in user:hash format to benchmark the loading of split hashes (-m 3000).
+## Every line turns into a LEFT and a RIGHT half, so the default of 5M lines is 10M halves.
+##
+## Usage: perl tools/benchmark_lm_split.pl [lines] [outfile]
+##        : > empty.pot && time ./hashcat -m 3000 --username --potfile-path empty.pot --left outfile > /dev/null
+
+use strict;
+use warnings;
+
+my $lines   = shift // 5000000;
+my $outfile = shift // "lm_split_bench.txt";
+
+die "usage: $0 [lines] [outfile]\n" unless $lines =~ m/^[0-9]+$/;
+
+# the second half of a LM hash for passwords shorter than 8 characters
+
+my $lm_empty = "aad3b435b51404ee";
+
+srand (1034);
+
+open (my $fh, ">", $outfile) or die "Unable to open '$outfile': $!\n";
+
+for (my $i = 0; $i < $lines; $i++)
+{
+  my $left  = random_half ();
+  my $right = (($i % 4) == 0) ? $lm_empty : random_half ();
+
+  printf $fh ("user%u:%s%s\n", $i, $left, $right);
+}
+
+close ($fh);
+
+print "$outfile: $lines lines, " . ($lines * 2) . " LM halves\n";
+
+sub random_half
+{
+  return sprintf ("%08x%08x", int (rand (2 ** 32)), int (rand (2 ** 32)));
+}
@@ -0,0 +1,514 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+// Simulates many brain clients over loopback to benchmark the brain server.
+// Each client does what a hashcat device thread does: lookup a batch of candidate hashes, then commit.
+// A part of each batch is drawn from a space shared by all clients so the server also rejects candidates.
+//
+// Build: cc -O2 -pthread -Ideps/xxHash -o brain_load tools/brain_load.c
+// Usage: ./hashcat --brain-server --brain-password=test &
+//        ./brain_load --password=test --clients=1000 --threads=8 --batch=16384 --seconds=30
+
+#define XXH_INLINE_ALL
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+
+#include "xxhash.h"
+
+typedef uint8_t  u8;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int64_t  i64;
+
+// keep in sync with include/brain.h
+
+#define BRAIN_LINK_VERSION          1
+#define BRAIN_OPERATION_COMMIT      1
+#define BRAIN_OPERATION_HASH_LOOKUP 2
+
+#define SHARED_SPACE (1 << 20)
+
+typedef struct options
+{
+  const char *host;
+  int         port;
+  const char *password;
+  u32         session;
+  int         clients;
+  int         threads;
+  int         batch;
+  int         seconds;
+  int         shared;
+
+} options_t;
+
+typedef struct client
+{
+  int fd;
+
+  u64 *hash_buf;
+  u8  *reply_buf;
+
+} client_t;
+
+typedef struct worker
+{
+  const options_t *options;
+
+  client_t *clients;
+  int       clients_cnt;
+
+  u64 rng;
+
+  u64 rounds;
+  u64 hashes;
+  u64 rejects;
+  double latency_sum;
+  double latency_max;
+
+  bool failed;
+
+} worker_t;
+
+static volatile bool start_flag = false;
+static volatile bool stop_flag  = false;
+
+static double now (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+
+  return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+static u64 xorshift64 (u64 *state)
+{
+  u64 x = *state;
+
+  x ^= x << 13;
+  x ^= x >>  7;
+  x ^= x << 17;
+
+  return *state = x;
+}
+
+static bool send_all (const int fd, const void *buf, const size_t len)
+{
+  const u8 *ptr = (const u8 *) buf;
+
+  for (size_t pos = 0; pos < len;)
+  {
+    const ssize_t n = send (fd, ptr + pos, len - pos, MSG_NOSIGNAL);
+
+    if (n <= 0) return false;
+
+    pos += n;
+  }
+
+  return true;
+}
+
+static bool recv_all (const int fd, void *buf, const size_t len)
+{
+  u8 *ptr = (u8 *) buf;
+
+  for (size_t pos = 0; pos < len;)
+  {
+    const ssize_t n = recv (fd, ptr + pos, len - pos, 0);
+
+    if (n <= 0) return false;
+
+    pos += n;
+  }
+
+  return true;
+}
+
+static u64 auth_hash (const u32 challenge, const char *pw_buf, const int pw_len)
+{
+  u64 response = XXH64 (pw_buf, pw_len, challenge);
+
+  for (int i = 0; i < 100000; i++)
+  {
+    response = XXH64 (&response, 8, 0);
+  }
+
+  return response;
+}
+
+static int client_connect (const options_t *options, const struct sockaddr_in *sa, const int client_idx)
+{
+  const int fd = socket (AF_INET, SOCK_STREAM, 0);
+
+  if (fd == -1)
+  {
+    fprintf (stderr, "socket: %s\n", strerror (errno));
+
+    return -1;
+  }
+
+  const int one = 1;
+
+  setsockopt (fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof (one));
+
+  if (connect (fd, (const struct sockaddr *) sa, sizeof (*sa)) == -1)
+  {
+    fprintf (stderr, "connect: %s\n", strerror (errno));
+
+    close (fd);
+
+    return -1;
+  }
+
+  u32 version     = BRAIN_LINK_VERSION;
+  u32 version_ok  = 0;
+  u32 challenge   = 0;
+  u32 password_ok = 0;
+
+  if (send_all (fd, &version,    sizeof (version))    == false) goto fail;
+  if (recv_all (fd, &version_ok, sizeof (version_ok)) == false) goto fail;
+
+  if (version_ok == 0)
+  {
+    fprintf (stderr, "client %d: version rejected\n", client_idx);
+
+    goto fail;
+  }
+
+  if (recv_all (fd, &challenge, sizeof (challenge)) == false) goto fail;
+
+  u64 response = auth_hash (challenge, options->password, (int) strlen (options->password));
+
+  if (send_all (fd, &response,    sizeof (response))    == false) goto fail;
+  if (recv_all (fd, &password_ok, sizeof (password_ok)) == false) goto fail;
+
+  if (password_ok == 0)
+  {
+    fprintf (stderr, "client %d: invalid password\n", client_idx);
+
+    goto fail;
+  }
+
+  // every client runs its own attack, they share the session
+
+  u32 session       = options->session;
+  u32 attack        = (u32) client_idx;
+  i64 passwords_max = options->batch;
+  u64 highest       = 0;
+
+  if (send_all (fd, &session,       sizeof (session))       == false) goto fail;
+  if (send_all (fd, &attack,        sizeof (attack))        == false) goto fail;
+  if (send_all (fd, &passwords_max, sizeof (passwords_max)) == false) goto fail;
+  if (recv_all (fd, &highest,       sizeof (highest))       == false) goto fail;
+
+  return fd;
+
+  fail:
+
+  fprintf (stderr, "client %d: handshake failed\n", client_idx);
+
+  close (fd);
+
+  return -1;
+}
+
+static void *worker_run (void *p)
+{
+  worker_t *worker = (worker_t *) p;
+
+  const options_t *options = worker->options;
+
+  const int batch = options->batch;
+
+  while (start_flag == false) usleep (1000);
+
+  while (stop_flag == false)
+  {
+    const double t_start = now ();
+
+    // all lookups of this thread are in flight at the same time
+
+    for (int idx = 0; idx < worker->clients_cnt; idx++)
+    {
+      client_t *client = &worker->clients[idx];
+
+      for (int hash_idx = 0; hash_idx < batch; hash_idx++)
+      {
+        const u64 r = xorshift64 (&worker->rng);
+
+        if ((int) (r % 100) < options->shared)
+        {
+          client->hash_buf[hash_idx] = XXH64 (&r, 4, 0) % SHARED_SPACE;
+        }
+        else
+        {
+          client->hash_buf[hash_idx] = xorshift64 (&worker->rng);
+        }
+      }
+
+      const u8  operation = BRAIN_OPERATION_HASH_LOOKUP;
+      const int in_size   = batch * (int) sizeof (u64);
+
+      if (send_all (client->fd, &operation, sizeof (operation)) == false) goto fail;
+      if (send_all (client->fd, &in_size,   sizeof (in_size))   == false) goto fail;
+      if (send_all (client->fd, client->hash_buf, in_size)      == false) goto fail;
+    }
+
+    for (int idx = 0; idx < worker->clients_cnt; idx++)
+    {
+      client_t *client = &worker->clients[idx];
+
+      int out_size = 0;
+
+      if (recv_all (client->fd, &out_size, sizeof (out_size)) == false) goto fail;
+
+      if (out_size != batch) goto fail;
+
+      if (recv_all (client->fd, client->reply_buf, out_size) == false) goto fail;
+
+      for (int hash_idx = 0; hash_idx < out_size; hash_idx++) worker->rejects += client->reply_buf[hash_idx];
+
+      const u8 operation = BRAIN_OPERATION_COMMIT;
+
+      if (send_all (client->fd, &operation, sizeof (operation)) == false) goto fail;
+    }
+
+    const double latency = now () - t_start;
+
+    worker->latency_sum += latency;
+
+    if (latency > worker->latency_max) worker->latency_max = latency;
+
+    worker->rounds++;
+    worker->hashes += (u64) worker->clients_cnt * batch;
+  }
+
+  return NULL;
+
+  fail:
+
+  fprintf (stderr, "link failed: %s\n", strerror (errno));
+
+  worker->failed = true;
+
+  return NULL;
+}
+
+static void usage (const char *prog)
+{
+  fprintf (stderr, "Usage: %s [options]\n\n", prog);
+  fprintf (stderr, "  --host=HOST       brain server host (127.0.0.1)\n");
+  fprintf (stderr, "  --port=PORT       brain server port (6863)\n");
+  fprintf (stderr, "  --password=PW     brain server password (required)\n");
+  fprintf (stderr, "  --session=HEX     brain session (0xdeadbeef)\n");
+  fprintf (stderr, "  --clients=N       client links (64)\n");
+  fprintf (stderr, "  --threads=N       threads driving the links (4)\n");
+  fprintf (stderr, "  --batch=N         candidate hashes per lookup (16384)\n");
+  fprintf (stderr, "  --seconds=N       runtime (10)\n");
+  fprintf (stderr, "  --shared=PCT      percentage of hashes from the space shared by all clients (25)\n");
+}
+
+int main (int argc, char **argv)
+{
+  options_t options;
+
+  options.host     = "127.0.0.1";
+  options.port     = 6863;
+  options.password = NULL;
+  options.session  = 0xdeadbeef;
+  options.clients  = 64;
+  options.threads  = 4;
+  options.batch    = 16384;
+  options.seconds  = 10;
+  options.shared   = 25;
+
+  static const struct option long_options[] =
+  {
+    {"host",     required_argument, NULL, 'h'},
+    {"port",     required_argument, NULL, 'p'},
+    {"password", required_argument, NULL, 'w'},
+    {"session",  required_argument, NULL, 's'},
+    {"clients",  required_argument, NULL, 'c'},
+    {"threads",  required_argument, NULL, 't'},
+    {"batch",    required_argument, NULL, 'b'},
+    {"seconds",  required_argument, NULL, 'S'},
+    {"shared",   required_argument, NULL, 'r'},
+    {NULL,       0,                 NULL,  0 }
+  };
+
+  int c;
+
+  while ((c = getopt_long (argc, argv, "", long_options, NULL)) != -1)
+  {
+    switch (c)
+    {
+      case 'h': options.host     = optarg;                                break;
+      case 'p': options.port     = atoi (optarg);                         break;
+      case 'w': options.password = optarg;                                break;
+      case 's': options.session  = (u32) strtoul (optarg, NULL, 16);      break;
+      case 'c': options.clients  = atoi (optarg);                         break;
+      case 't': options.threads  = atoi (optarg);                         break;
+      case 'b': options.batch    = atoi (optarg);                         break;
+      case 'S': options.seconds  = atoi (optarg);                         break;
+      case 'r': options.shared   = atoi (optarg);                         break;
+      default:  usage (argv[0]);                                          return -1;
+    }
+  }
+
+  if ((options.password == NULL) || (options.clients < 1) || (options.threads < 1) || (options.batch < 1) || (options.seconds < 1))
+  {
+    usage (argv[0]);
+
+    return -1;
+  }
+
+  if (options.threads > options.clients) options.threads = options.clients;
+
+  struct rlimit rl;
+
+  if (getrlimit (RLIMIT_NOFILE, &rl) == 0)
+  {
+    rl.rlim_cur = rl.rlim_max;
+
+    setrlimit (RLIMIT_NOFILE, &rl);
+  }
+
+  struct sockaddr_in sa;
+
+  memset (&sa, 0, sizeof (sa));
+
+  sa.sin_family = AF_INET;
+  sa.sin_port   = htons (options.port);
+
+  struct addrinfo hints;
+
+  memset (&hints, 0, sizeof (hints));
+
+  hints.ai_family   = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+
+  struct addrinfo *address_info = NULL;
+
+  const int rc_getaddrinfo = getaddrinfo (options.host, NULL, &hints, &address_info);
+
+  if (rc_getaddrinfo != 0)
+  {
+    fprintf (stderr, "%s: %s\n", options.host, gai_strerror (rc_getaddrinfo));
+
+    return -1;
+  }
+
+  sa.sin_addr = ((struct sockaddr_in *) address_info->ai_addr)->sin_addr;
+
+  freeaddrinfo (address_info);
+
+  // connect all clients first, the handshake is not part of the measurement
+
+  client_t *clients = (client_t *) calloc (options.clients, sizeof (client_t));
+
+  const double t_connect = now ();
+
+  for (int client_idx = 0; client_idx < options.clients; client_idx++)
+  {
+    client_t *client = &clients[client_idx];
+
+    client->fd = client_connect (&options, &sa, client_idx);
+
+    if (client->fd == -1) return -1;
+
+    client->hash_buf  = (u64 *) malloc (options.batch * sizeof (u64));
+    client->reply_buf = (u8  *) malloc (options.batch * sizeof (u8));
+  }
+
+  printf ("Connected %d clients in %.2f s\n", options.clients, now () - t_connect);
+
+  worker_t  *workers = (worker_t  *) calloc (options.threads, sizeof (worker_t));
+  pthread_t *thr     = (pthread_t *) calloc (options.threads, sizeof (pthread_t));
+
+  for (int thread_idx = 0, client_idx = 0; thread_idx < options.threads; thread_idx++)
+  {
+    worker_t *worker = &workers[thread_idx];
+
+    const int clients_cnt = options.clients / options.threads + ((thread_idx < (options.clients % options.threads)) ? 1 : 0);
+
+    worker->options     = &options;
+    worker->clients     = clients + client_idx;
+    worker->clients_cnt = clients_cnt;
+    worker->rng         = 0x9e3779b97f4a7c15ULL * (u64) (thread_idx + 1) ^ (u64) time (NULL);
+
+    client_idx += clients_cnt;
+
+    pthread_create (&thr[thread_idx], NULL, worker_run, worker);
+  }
+
+  const double t_start = now ();
+
+  start_flag = true;
+
+  sleep (options.seconds);
+
+  stop_flag = true;
+
+  for (int thread_idx = 0; thread_idx < options.threads; thread_idx++) pthread_join (thr[thread_idx], NULL);
+
+  const double runtime = now () - t_start;
+
+  u64    rounds      = 0;
+  u64    hashes      = 0;
+  u64    rejects     = 0;
+  double latency_sum = 0;
+  double latency_max = 0;
+  bool   failed      = false;
+
+  for (int thread_idx = 0; thread_idx < options.threads; thread_idx++)
+  {
+    rounds      += workers[thread_idx].rounds;
+    hashes      += workers[thread_idx].hashes;
+    rejects     += workers[thread_idx].rejects;
+    latency_sum += workers[thread_idx].latency_sum;
+
+    if (workers[thread_idx].latency_max > latency_max) latency_max = workers[thread_idx].latency_max;
+
+    if (workers[thread_idx].failed == true) failed = true;
+  }
+
+  const u64 lookups = hashes / options.batch;
+
+  printf ("Clients.....: %d on %d threads, %d hashes per lookup\n", options.clients, options.threads, options.batch);
+  printf ("Lookups.....: %" PRIu64 " (%.1f/s)\n", lookups, (double) lookups / runtime);
+  printf ("Hashes......: %" PRIu64 " (%.2f M/s), %.1f%% rejected\n", hashes, (double) hashes / runtime / 1e6, (hashes) ? 100.0 * (double) rejects / (double) hashes : 0.0);
+  printf ("Round trip..: %.2f ms avg, %.2f ms max (all links of a thread)\n", (rounds) ? latency_sum / (double) rounds * 1e3 : 0.0, latency_max * 1e3);
+
+  for (int client_idx = 0; client_idx < options.clients; client_idx++)
+  {
+    close (clients[client_idx].fd);
+
+    free (clients[client_idx].hash_buf);
+    free (clients[client_idx].reply_buf);
+  }
+
+  free (clients);
+  free (workers);
+  free (thr);
+
+  return (failed == true) ? -1 : 0;
+}